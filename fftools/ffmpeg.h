@@ -169,6 +169,7 @@ typedef struct OptionsContext {
     int thread_queue_size;
     int input_sync_ref;
     int find_stream_info;
+    int group_audio_dec;
 
     SpecifierOptList ts_scale;
     SpecifierOptList dump_attachment;
@@ -432,6 +433,8 @@ typedef struct Decoder {
     uint64_t         decode_errors;
 } Decoder;
 
+typedef struct DecoderGroup DecoderGroup;
+
 typedef struct InputStream {
     const AVClass        *class;
 
@@ -820,6 +823,20 @@ int dec_init(Decoder **pdec, Scheduler *sch,
              AVFrame *param_out);
 void dec_free(Decoder **pdec);
 
+/**
+ * Create a group of decoders that are run on a single thread.
+ *
+ * @param index group index used for naming the thread
+ * @param log_parent logging context the group's messages are attached to
+ */
+int dec_group_alloc(DecoderGroup **pg, Scheduler *sch, int index, void *log_parent);
+void dec_group_free(DecoderGroup **pg);
+/**
+ * Add a decoder created with dec_init() to the group. Must be called before
+ * the scheduler is started.
+ */
+int dec_group_add(DecoderGroup *g, Decoder *dec);
+
 /*
  * Called by filters to connect decoder's output to given filtergraph input.
  *
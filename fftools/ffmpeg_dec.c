@@ -115,6 +115,20 @@ typedef struct DecThreadContext {
     AVPacket        *pkt;
 } DecThreadContext;
 
+// decoders sharing a single thread, see sch_add_dec_group()
+struct DecoderGroup {
+    const AVClass   *class;
+    void            *log_parent;
+    int              index;
+
+    Scheduler       *sch;
+    unsigned         sch_idx;
+
+    // in the order of their indices in the scheduler group
+    DecoderPriv    **decoders;
+    int           nb_decoders;
+};
+
 void dec_free(Decoder **pdec)
 {
     Decoder *dec = *pdec;
@@ -909,101 +923,102 @@ fail:
     return AVERROR(ENOMEM);
 }
 
-static int decoder_thread(void *arg)
+/**
+ * Process a packet or EOF received from the scheduler.
+ *
+ * @param input_status return value of the call that received the packet
+ * @return 0 when more packets should be decoded, AVERROR_EOF on normal
+ *         termination, another negative error code on failure
+ */
+static int dec_thread_packet(DecoderPriv *dp, DecThreadContext *dt, int input_status)
 {
-    DecoderPriv  *dp = arg;
-    DecThreadContext dt;
-    int ret = 0, input_status = 0;
-
-    ret = dec_thread_init(&dt);
-    if (ret < 0)
-        goto finish;
-
-    dec_thread_set_name(dp);
-
-    while (!input_status) {
-        int flush_buffers, have_data;
-
-        input_status  = sch_dec_receive(dp->sch, dp->sch_idx, dt.pkt);
-        have_data     = input_status >= 0 &&
-            (dt.pkt->buf || dt.pkt->side_data_elems ||
-             (intptr_t)dt.pkt->opaque == PKT_OPAQUE_SUB_HEARTBEAT ||
-             (intptr_t)dt.pkt->opaque == PKT_OPAQUE_FIX_SUB_DURATION);
-        flush_buffers = input_status >= 0 && !have_data;
-        if (!have_data)
-            av_log(dp, AV_LOG_VERBOSE, "Decoder thread received %s packet\n",
-                   flush_buffers ? "flush" : "EOF");
-
-        // this is a standalone decoder that has not been initialized yet
-        if (!dp->dec_ctx) {
-            if (flush_buffers)
-                continue;
-            if (input_status < 0) {
-                av_log(dp, AV_LOG_ERROR,
-                       "Cannot initialize a standalone decoder\n");
-                ret = input_status;
-                goto finish;
-            }
-
-            ret = dec_standalone_open(dp, dt.pkt);
-            if (ret < 0)
-                goto finish;
+    int flush_buffers, have_data, ret;
+
+    have_data     = input_status >= 0 &&
+        (dt->pkt->buf || dt->pkt->side_data_elems ||
+         (intptr_t)dt->pkt->opaque == PKT_OPAQUE_SUB_HEARTBEAT ||
+         (intptr_t)dt->pkt->opaque == PKT_OPAQUE_FIX_SUB_DURATION);
+    flush_buffers = input_status >= 0 && !have_data;
+    if (!have_data)
+        av_log(dp, AV_LOG_VERBOSE, "Decoder thread received %s packet\n",
+               flush_buffers ? "flush" : "EOF");
+
+    // this is a standalone decoder that has not been initialized yet
+    if (!dp->dec_ctx) {
+        if (flush_buffers)
+            return 0;
+        if (input_status < 0) {
+            av_log(dp, AV_LOG_ERROR,
+                   "Cannot initialize a standalone decoder\n");
+            return input_status;
         }
 
-        ret = packet_decode(dp, have_data ? dt.pkt : NULL, dt.frame);
+        ret = dec_standalone_open(dp, dt->pkt);
+        if (ret < 0)
+            return ret;
+    }
 
-        av_packet_unref(dt.pkt);
-        av_frame_unref(dt.frame);
+    ret = packet_decode(dp, have_data ? dt->pkt : NULL, dt->frame);
 
-        // AVERROR_EOF  - EOF from the decoder
-        // AVERROR_EXIT - EOF from the scheduler
-        // we treat them differently when flushing
-        if (ret == AVERROR_EXIT) {
-            ret = AVERROR_EOF;
-            flush_buffers = 0;
-        }
+    av_packet_unref(dt->pkt);
+    av_frame_unref(dt->frame);
 
-        if (ret == AVERROR_EOF) {
-            av_log(dp, AV_LOG_VERBOSE, "Decoder returned EOF, %s\n",
-                   flush_buffers ? "resetting" : "finishing");
+    // AVERROR_EOF  - EOF from the decoder
+    // AVERROR_EXIT - EOF from the scheduler
+    // we treat them differently when flushing
+    if (ret == AVERROR_EXIT) {
+        ret = AVERROR_EOF;
+        flush_buffers = 0;
+    }
 
-            if (!flush_buffers)
-                break;
+    if (ret == AVERROR_EOF) {
+        av_log(dp, AV_LOG_VERBOSE, "Decoder returned EOF, %s\n",
+               flush_buffers ? "resetting" : "finishing");
 
-            /* report last frame duration to the scheduler */
-            if (dp->dec_ctx->codec_type == AVMEDIA_TYPE_AUDIO) {
-                dt.pkt->pts       = dp->last_frame_pts + dp->last_frame_duration_est;
-                dt.pkt->time_base = dp->last_frame_tb;
-            }
+        if (!flush_buffers)
+            return AVERROR_EOF;
 
-            avcodec_flush_buffers(dp->dec_ctx);
-        } else if (ret < 0) {
-            av_log(dp, AV_LOG_ERROR, "Error processing packet in decoder: %s\n",
-                   av_err2str(ret));
-            break;
+        /* report last frame duration to the scheduler */
+        if (dp->dec_ctx->codec_type == AVMEDIA_TYPE_AUDIO) {
+            dt->pkt->pts       = dp->last_frame_pts + dp->last_frame_duration_est;
+            dt->pkt->time_base = dp->last_frame_tb;
         }
+
+        avcodec_flush_buffers(dp->dec_ctx);
+    } else if (ret < 0) {
+        av_log(dp, AV_LOG_ERROR, "Error processing packet in decoder: %s\n",
+               av_err2str(ret));
+        return ret;
     }
 
+    return input_status < 0 ? AVERROR_EOF : 0;
+}
+
+/**
+ * Send the EOF timestamp downstream after the decoder terminated with ret.
+ */
+static int dec_thread_finish(DecoderPriv *dp, DecThreadContext *dt, int ret)
+{
     // EOF is normal thread termination
     if (ret == AVERROR_EOF)
         ret = 0;
 
     // on success send EOF timestamp to our downstreams
-    if (ret >= 0) {
+    if (ret >= 0 && dp->dec_ctx) {
         float err_rate;
 
-        av_frame_unref(dt.frame);
+        av_frame_unref(dt->frame);
 
-        dt.frame->opaque    = (void*)(intptr_t)FRAME_OPAQUE_EOF;
-        dt.frame->pts       = dp->last_frame_pts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE :
-                              dp->last_frame_pts + dp->last_frame_duration_est;
-        dt.frame->time_base = dp->last_frame_tb;
+        dt->frame->opaque    = (void*)(intptr_t)FRAME_OPAQUE_EOF;
+        dt->frame->pts       = dp->last_frame_pts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE :
+                               dp->last_frame_pts + dp->last_frame_duration_est;
+        dt->frame->time_base = dp->last_frame_tb;
 
-        ret = sch_dec_send(dp->sch, dp->sch_idx, 0, dt.frame);
+        ret = sch_dec_send(dp->sch, dp->sch_idx, 0, dt->frame);
         if (ret < 0 && ret != AVERROR_EOF) {
             av_log(dp, AV_LOG_FATAL,
                    "Error signalling EOF timestamp: %s\n", av_err2str(ret));
-            goto finish;
+            return ret;
         }
         ret = 0;
 
@@ -1017,12 +1032,139 @@ static int decoder_thread(void *arg)
             av_log(dp, AV_LOG_VERBOSE, "Decode error rate %g\n", err_rate);
     }
 
+    return ret;
+}
+
+static int decoder_thread(void *arg)
+{
+    DecoderPriv  *dp = arg;
+    DecThreadContext dt;
+    int ret = 0;
+
+    ret = dec_thread_init(&dt);
+    if (ret < 0)
+        goto finish;
+
+    dec_thread_set_name(dp);
+
+    while (!ret) {
+        int input_status = sch_dec_receive(dp->sch, dp->sch_idx, dt.pkt);
+        ret = dec_thread_packet(dp, &dt, input_status);
+    }
+
+    ret = dec_thread_finish(dp, &dt, ret);
+
+finish:
+    dec_thread_uninit(&dt);
+
+    return ret;
+}
+
+static int decoder_group_thread(void *arg)
+{
+    DecoderGroup *g = arg;
+    DecThreadContext dt;
+    char name[16];
+    int ret;
+
+    ret = dec_thread_init(&dt);
+    if (ret < 0)
+        goto finish;
+
+    snprintf(name, sizeof(name), "decgroup%d", g->index);
+    ff_thread_setname(name);
+
+    while (1) {
+        DecoderPriv *dp;
+        int input_status, idx;
+
+        input_status = sch_dec_group_receive(g->sch, g->sch_idx, &idx, dt.pkt);
+        if (idx < 0) {
+            ret = input_status == AVERROR_EOF ? 0 : input_status;
+            break;
+        }
+        dp = g->decoders[idx];
+
+        ret = dec_thread_packet(dp, &dt, input_status);
+        if (!ret)
+            continue;
+
+        // this decoder is done, the others carry on unless it failed
+        ret = dec_thread_finish(dp, &dt, ret);
+        ret = err_merge(ret, sch_dec_group_finish(g->sch, g->sch_idx, idx));
+        if (ret < 0)
+            break;
+    }
+
 finish:
     dec_thread_uninit(&dt);
 
     return ret;
 }
 
+static const AVClass dec_group_class = {
+    .class_name                = "DecoderGroup",
+    .version                   = LIBAVUTIL_VERSION_INT,
+    .parent_log_context_offset = offsetof(DecoderGroup, log_parent),
+};
+
+int dec_group_alloc(DecoderGroup **pg, Scheduler *sch, int index, void *log_parent)
+{
+    DecoderGroup *g;
+    int ret;
+
+    *pg = NULL;
+
+    g = av_mallocz(sizeof(*g));
+    if (!g)
+        return AVERROR(ENOMEM);
+
+    g->class      = &dec_group_class;
+    g->index      = index;
+    g->log_parent = log_parent;
+
+    ret = sch_add_dec_group(sch, decoder_group_thread, g);
+    if (ret < 0) {
+        av_freep(&g);
+        return ret;
+    }
+    g->sch     = sch;
+    g->sch_idx = ret;
+
+    *pg = g;
+
+    return 0;
+}
+
+void dec_group_free(DecoderGroup **pg)
+{
+    DecoderGroup *g = *pg;
+
+    if (!g)
+        return;
+
+    av_freep(&g->decoders);
+    av_freep(pg);
+}
+
+int dec_group_add(DecoderGroup *g, Decoder *d)
+{
+    DecoderPriv *dp = dp_from_dec(d);
+    int ret;
+
+    ret = sch_dec_group_add(g->sch, g->sch_idx, dp->sch_idx);
+    if (ret < 0)
+        return ret;
+
+    av_assert0(ret == g->nb_decoders);
+    ret = GROW_ARRAY(g->decoders, g->nb_decoders);
+    if (ret < 0)
+        return ret;
+    g->decoders[g->nb_decoders - 1] = dp;
+
+    return 0;
+}
+
 int dec_request_view(Decoder *d, const ViewSpecifier *vs,
                      SchedulerNode *src)
 {
@@ -122,6 +122,10 @@ typedef struct Demuxer {
     /* number of times input stream should be looped */
     int                   loop;
     int                   have_audio_dec;
+
+    /* decode all the audio streams on a single thread */
+    int                   group_audio_dec;
+    DecoderGroup         *audio_dec_group;
     /* duration of the looped segment of the input file */
     Timestamp             duration;
     /* pts with the smallest/largest values ever seen */
@@ -899,6 +903,8 @@ void ifile_close(InputFile **pf)
         ist_free(&f->streams[i]);
     av_freep(&f->streams);
 
+    dec_group_free(&d->audio_dec_group);
+
     avformat_close_input(&f->ctx);
 
     av_packet_free(&d->pkt_heartbeat);
@@ -991,6 +997,19 @@ int ist_use(InputStream *ist, int decoding_needed,
         if (ret < 0)
             return ret;
 
+        if (is_audio && d->group_audio_dec) {
+            if (!d->audio_dec_group) {
+                ret = dec_group_alloc(&d->audio_dec_group, d->sch,
+                                      d->f.index, d);
+                if (ret < 0)
+                    return ret;
+            }
+
+            ret = dec_group_add(d->audio_dec_group, ist->decoder);
+            if (ret < 0)
+                return ret;
+        }
+
         d->have_audio_dec |= is_audio;
     }
 
@@ -1865,6 +1884,7 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
     f->input_ts_offset = o->input_ts_offset;
     f->ts_offset  = o->input_ts_offset - (copy_ts ? (start_at_zero && ic->start_time != AV_NOPTS_VALUE ? ic->start_time : 0) : timestamp);
     d->accurate_seek   = o->accurate_seek;
+    d->group_audio_dec = o->group_audio_dec;
     d->loop = o->loop;
     d->nb_streams_warn = ic->nb_streams;
 
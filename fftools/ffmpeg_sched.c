@@ -87,7 +87,13 @@ typedef struct SchDec {
 
     SchTask             task;
     // Queue for receiving input packets, one stream.
+    // For grouped decoders, this is the queue of the group, with one stream
+    // for each decoder in it.
     ThreadQueue        *queue;
+    unsigned            queue_idx;
+
+    // Index of the decoder group in Scheduler.dec_groups, or -1
+    int                 group_idx;
 
     // Queue for sending post-flush end timestamps back to the source
     AVThreadMessageQueue *queue_end_ts;
@@ -97,6 +103,22 @@ typedef struct SchDec {
     AVFrame            *send_frame;
 } SchDec;
 
+typedef struct SchDecGroup {
+    const AVClass      *class;
+
+    // indices of the decoders in this group in Scheduler.dec
+    unsigned           *dec_idx;
+    unsigned         nb_dec_idx;
+
+    SchTask             task;
+    // Queue for receiving input packets, one stream per decoder.
+    ThreadQueue        *queue;
+
+    // Index in dec_idx of the decoder that received the last packet, which
+    // may need to send back a post-flush end timestamp
+    int                 last_dec;
+} SchDecGroup;
+
 typedef struct SchSyncQueue {
     SyncQueue          *sq;
     AVFrame            *frame;
@@ -293,6 +315,9 @@ struct Scheduler {
     SchDec             *dec;
     unsigned         nb_dec;
 
+    SchDecGroup        *dec_groups;
+    unsigned         nb_dec_groups;
+
     SchEnc             *enc;
     unsigned         nb_enc;
 
@@ -507,7 +532,9 @@ void sch_free(Scheduler **psch)
     for (unsigned i = 0; i < sch->nb_dec; i++) {
         SchDec *dec = &sch->dec[i];
 
-        tq_free(&dec->queue);
+        // the queues of grouped decoders are freed with the group
+        if (dec->group_idx < 0)
+            tq_free(&dec->queue);
 
         av_thread_message_queue_free(&dec->queue_end_ts);
 
@@ -524,6 +551,14 @@ void sch_free(Scheduler **psch)
     }
     av_freep(&sch->dec);
 
+    for (unsigned i = 0; i < sch->nb_dec_groups; i++) {
+        SchDecGroup *g = &sch->dec_groups[i];
+
+        tq_free(&g->queue);
+        av_freep(&g->dec_idx);
+    }
+    av_freep(&sch->dec_groups);
+
     for (unsigned i = 0; i < sch->nb_enc; i++) {
         SchEnc *enc = &sch->enc[i];
 
@@ -753,6 +788,7 @@ int sch_add_dec(Scheduler *sch, SchThreadFunc func, void *ctx, int send_end_ts)
     task_init(sch, &dec->task, SCH_NODE_TYPE_DEC, idx, func, ctx);
 
     dec->class      = &sch_dec_class;
+    dec->group_idx  = -1;
     dec->send_frame = av_frame_alloc();
     if (!dec->send_frame)
         return AVERROR(ENOMEM);
@@ -774,6 +810,60 @@ int sch_add_dec(Scheduler *sch, SchThreadFunc func, void *ctx, int send_end_ts)
     return idx;
 }
 
+static const AVClass sch_dec_group_class = {
+    .class_name                = "SchDecGroup",
+    .version                   = LIBAVUTIL_VERSION_INT,
+    .parent_log_context_offset = offsetof(SchDecGroup, task.func_arg),
+};
+
+int sch_add_dec_group(Scheduler *sch, SchThreadFunc func, void *ctx)
+{
+    const unsigned idx = sch->nb_dec_groups;
+
+    SchDecGroup *g;
+    int ret;
+
+    ret = GROW_ARRAY(sch->dec_groups, sch->nb_dec_groups);
+    if (ret < 0)
+        return ret;
+
+    g = &sch->dec_groups[idx];
+
+    task_init(sch, &g->task, SCH_NODE_TYPE_DEC_GROUP, idx, func, ctx);
+
+    g->class    = &sch_dec_group_class;
+    g->last_dec = -1;
+
+    return idx;
+}
+
+int sch_dec_group_add(Scheduler *sch, unsigned group_idx, unsigned dec_idx)
+{
+    SchDecGroup *g;
+    SchDec *dec;
+    int ret;
+
+    av_assert0(group_idx < sch->nb_dec_groups);
+    g = &sch->dec_groups[group_idx];
+
+    av_assert0(dec_idx < sch->nb_dec);
+    dec = &sch->dec[dec_idx];
+
+    av_assert0(dec->group_idx < 0 && sch->state == SCH_STATE_UNINIT);
+
+    ret = GROW_ARRAY(g->dec_idx, g->nb_dec_idx);
+    if (ret < 0)
+        return ret;
+    g->dec_idx[g->nb_dec_idx - 1] = dec_idx;
+
+    // packets will be sent to the group queue, allocated in start_prepare()
+    tq_free(&dec->queue);
+    dec->group_idx = group_idx;
+    dec->queue_idx = g->nb_dec_idx - 1;
+
+    return g->nb_dec_idx - 1;
+}
+
 static const AVClass sch_enc_class = {
     .class_name                = "SchEnc",
     .version                   = LIBAVUTIL_VERSION_INT,
@@ -1489,6 +1579,28 @@ static int start_prepare(Scheduler *sch)
         }
     }
 
+    for (unsigned i = 0; i < sch->nb_dec_groups; i++) {
+        SchDecGroup *g = &sch->dec_groups[i];
+
+        // keep as much buffering per decoder as with separate queues
+        ret = queue_alloc(&g->queue, g->nb_dec_idx,
+                          g->nb_dec_idx * DEFAULT_PACKET_THREAD_QUEUE_SIZE,
+                          QUEUE_PACKETS);
+        if (ret < 0)
+            return ret;
+
+        for (unsigned j = 0; j < g->nb_dec_idx; j++) {
+            SchDec *dec = &sch->dec[g->dec_idx[j]];
+
+            if (dec->src.type != SCH_NODE_TYPE_DEMUX) {
+                av_log(g, AV_LOG_ERROR,
+                       "Only decoders of demuxed streams can be grouped\n");
+                return AVERROR(EINVAL);
+            }
+            dec->queue = g->queue;
+        }
+    }
+
     for (unsigned i = 0; i < sch->nb_enc; i++) {
         SchEnc *enc = &sch->enc[i];
 
@@ -1628,11 +1740,22 @@ int sch_start(Scheduler *sch)
     for (unsigned i = 0; i < sch->nb_dec; i++) {
         SchDec *dec = &sch->dec[i];
 
+        if (dec->group_idx >= 0)
+            continue;
+
         ret = task_start(&dec->task);
         if (ret < 0)
             goto fail;
     }
 
+    for (unsigned i = 0; i < sch->nb_dec_groups; i++) {
+        SchDecGroup *g = &sch->dec_groups[i];
+
+        ret = task_start(&g->task);
+        if (ret < 0)
+            goto fail;
+    }
+
     for (unsigned i = 0; i < sch->nb_demux; i++) {
         SchDemux *d = &sch->demux[i];
 
@@ -1934,7 +2057,7 @@ demux_stream_send_to_dst(Scheduler *sch, const SchedulerNode dst,
 
     ret = (dst.type == SCH_NODE_TYPE_MUX) ?
           send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, pkt) :
-          tq_send(sch->dec[dst.idx].queue, 0, pkt);
+          tq_send(sch->dec[dst.idx].queue, sch->dec[dst.idx].queue_idx, pkt);
     if (ret == AVERROR_EOF)
         goto finish;
 
@@ -1944,7 +2067,7 @@ finish:
     if (dst.type == SCH_NODE_TYPE_MUX)
         send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, NULL);
     else
-        tq_send_finish(sch->dec[dst.idx].queue, 0);
+        tq_send_finish(sch->dec[dst.idx].queue, sch->dec[dst.idx].queue_idx);
 
     *dst_finished = 1;
     return AVERROR_EOF;
@@ -2001,7 +2124,7 @@ static int demux_flush(Scheduler *sch, SchDemux *d, AVPacket *pkt)
 
             dec = &sch->dec[dst->idx];
 
-            ret = tq_send(dec->queue, 0, pkt);
+            ret = tq_send(dec->queue, dec->queue_idx, pkt);
             if (ret < 0)
                 return ret;
 
@@ -2121,7 +2244,7 @@ int sch_mux_sub_heartbeat(Scheduler *sch, unsigned mux_idx, unsigned stream_idx,
         if (ret < 0)
             return ret;
 
-        tq_send(dst->queue, 0, mux->sub_heartbeat_pkt);
+        tq_send(dst->queue, dst->queue_idx, mux->sub_heartbeat_pkt);
     }
 
     return 0;
@@ -2154,31 +2277,72 @@ static int mux_done(Scheduler *sch, unsigned mux_idx)
     return 0;
 }
 
-int sch_dec_receive(Scheduler *sch, unsigned dec_idx, AVPacket *pkt)
+static int dec_send_end_ts(SchDec *dec, const AVPacket *pkt)
 {
-    SchDec *dec;
-    int ret, dummy;
-
-    av_assert0(dec_idx < sch->nb_dec);
-    dec = &sch->dec[dec_idx];
-
     // the decoder should have given us post-flush end timestamp in pkt
     if (dec->expect_end_ts) {
         Timestamp ts = (Timestamp){ .ts = pkt->pts, .tb = pkt->time_base };
-        ret = av_thread_message_queue_send(dec->queue_end_ts, &ts, 0);
+        int ret = av_thread_message_queue_send(dec->queue_end_ts, &ts, 0);
         if (ret < 0)
             return ret;
 
         dec->expect_end_ts = 0;
     }
 
+    return 0;
+}
+
+static void dec_check_flush(SchDec *dec, const AVPacket *pkt)
+{
+    // got a flush packet, on the next call to the receive function the
+    // decoder will give us post-flush end timestamp
+    if (!pkt->data && !pkt->side_data_elems && dec->queue_end_ts)
+        dec->expect_end_ts = 1;
+}
+
+int sch_dec_receive(Scheduler *sch, unsigned dec_idx, AVPacket *pkt)
+{
+    SchDec *dec;
+    int ret, dummy;
+
+    av_assert0(dec_idx < sch->nb_dec);
+    dec = &sch->dec[dec_idx];
+
+    av_assert0(dec->group_idx < 0);
+
+    ret = dec_send_end_ts(dec, pkt);
+    if (ret < 0)
+        return ret;
+
     ret = tq_receive(dec->queue, &dummy, pkt);
     av_assert0(dummy <= 0);
 
-    // got a flush packet, on the next call to this function the decoder
-    // will give us post-flush end timestamp
-    if (ret >= 0 && !pkt->data && !pkt->side_data_elems && dec->queue_end_ts)
-        dec->expect_end_ts = 1;
+    if (ret >= 0)
+        dec_check_flush(dec, pkt);
+
+    return ret;
+}
+
+int sch_dec_group_receive(Scheduler *sch, unsigned group_idx,
+                          int *dec_idx, AVPacket *pkt)
+{
+    SchDecGroup *g;
+    int ret;
+
+    av_assert0(group_idx < sch->nb_dec_groups);
+    g = &sch->dec_groups[group_idx];
+
+    if (g->last_dec >= 0) {
+        ret = dec_send_end_ts(&sch->dec[g->dec_idx[g->last_dec]], pkt);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = tq_receive(g->queue, dec_idx, pkt);
+    g->last_dec = *dec_idx;
+
+    if (ret >= 0)
+        dec_check_flush(&sch->dec[g->dec_idx[*dec_idx]], pkt);
 
     return ret;
 }
@@ -2279,7 +2443,7 @@ static int dec_done(Scheduler *sch, unsigned dec_idx)
     SchDec *dec = &sch->dec[dec_idx];
     int ret = 0;
 
-    tq_receive_finish(dec->queue, 0);
+    tq_receive_finish(dec->queue, dec->queue_idx);
 
     // make sure our source does not get stuck waiting for end timestamps
     // that will never arrive
@@ -2299,6 +2463,32 @@ static int dec_done(Scheduler *sch, unsigned dec_idx)
     return ret;
 }
 
+int sch_dec_group_finish(Scheduler *sch, unsigned group_idx, unsigned dec_idx)
+{
+    SchDecGroup *g;
+
+    av_assert0(group_idx < sch->nb_dec_groups);
+    g = &sch->dec_groups[group_idx];
+
+    av_assert0(dec_idx < g->nb_dec_idx);
+
+    return dec_done(sch, g->dec_idx[dec_idx]);
+}
+
+static int dec_group_done(Scheduler *sch, unsigned group_idx)
+{
+    SchDecGroup *g = &sch->dec_groups[group_idx];
+    int ret = 0;
+
+    // finishing a decoder more than once is harmless
+    for (unsigned i = 0; i < g->nb_dec_idx; i++) {
+        int err = dec_done(sch, g->dec_idx[i]);
+        ret = err_merge(ret, err);
+    }
+
+    return ret;
+}
+
 int sch_enc_receive(Scheduler *sch, unsigned enc_idx, AVFrame *frame)
 {
     SchEnc *enc;
@@ -2326,7 +2516,7 @@ static int enc_send_to_dst(Scheduler *sch, const SchedulerNode dst,
 
     ret = (dst.type == SCH_NODE_TYPE_MUX) ?
           send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, pkt) :
-          tq_send(sch->dec[dst.idx].queue, 0, pkt);
+          tq_send(sch->dec[dst.idx].queue, sch->dec[dst.idx].queue_idx, pkt);
     if (ret == AVERROR_EOF)
         goto finish;
 
@@ -2336,7 +2526,7 @@ finish:
     if (dst.type == SCH_NODE_TYPE_MUX)
         send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, NULL);
     else
-        tq_send_finish(sch->dec[dst.idx].queue, 0);
+        tq_send_finish(sch->dec[dst.idx].queue, sch->dec[dst.idx].queue_idx);
 
     *dst_finished = 1;
 
@@ -2518,6 +2708,7 @@ static int task_cleanup(Scheduler *sch, SchedulerNode node)
     case SCH_NODE_TYPE_DEMUX:       return demux_done (sch, node.idx);
     case SCH_NODE_TYPE_MUX:         return mux_done   (sch, node.idx);
     case SCH_NODE_TYPE_DEC:         return dec_done   (sch, node.idx);
+    case SCH_NODE_TYPE_DEC_GROUP:   return dec_group_done(sch, node.idx);
     case SCH_NODE_TYPE_ENC:         return enc_done   (sch, node.idx);
     case SCH_NODE_TYPE_FILTER_IN:   return filter_done(sch, node.idx);
     default: av_assert0(0);
@@ -2594,9 +2785,20 @@ int sch_stop(Scheduler *sch, int64_t *finish_ts)
         ret = err_merge(ret, err);
     }
 
+    for (unsigned i = 0; i < sch->nb_dec_groups; i++) {
+        SchDecGroup *g = &sch->dec_groups[i];
+
+        err = task_stop(sch, &g->task);
+        ret = err_merge(ret, err);
+    }
+
     for (unsigned i = 0; i < sch->nb_dec; i++) {
         SchDec *dec = &sch->dec[i];
 
+        // grouped decoders were stopped with their group
+        if (dec->group_idx >= 0)
+            continue;
+
         err = task_stop(sch, &dec->task);
         ret = err_merge(ret, err);
     }
@@ -98,6 +98,7 @@ enum SchedulerNodeType {
     SCH_NODE_TYPE_ENC,
     SCH_NODE_TYPE_FILTER_IN,
     SCH_NODE_TYPE_FILTER_OUT,
+    SCH_NODE_TYPE_DEC_GROUP,
 };
 
 typedef struct SchedulerNode {
@@ -191,6 +192,37 @@ int sch_add_dec(Scheduler *sch, SchThreadFunc func, void *ctx, int send_end_ts);
  */
 int sch_add_dec_output(Scheduler *sch, unsigned dec_idx);
 
+/**
+ * Add a decoder group to the scheduler.
+ *
+ * The decoders in a group share a single task and packet queue, instead of
+ * each running in its own thread. This is meant for many lightweight decoders
+ * fed by the same demuxer, such as audio tracks, for which handing every
+ * packet over to a different thread costs more than decoding it.
+ *
+ * @param func Function executed as the decoder group task. It receives
+ *             packets for all the decoders in the group with
+ *             sch_dec_group_receive().
+ * @param ctx Group state; will be passed to func and used for logging.
+ *
+ * @retval ">=0" Index of the newly-created decoder group.
+ * @retval "<0"  Error code.
+ */
+int sch_add_dec_group(Scheduler *sch, SchThreadFunc func, void *ctx);
+
+/**
+ * Move a decoder into a decoder group. Must be called before sch_start().
+ * The task function passed to sch_add_dec() for this decoder is then never
+ * run, and the decoder must not call sch_dec_receive().
+ *
+ * @param group_idx index previously returned by sch_add_dec_group()
+ * @param dec_idx index previously returned by sch_add_dec()
+ *
+ * @retval ">=0" Index of the decoder in the group.
+ * @retval "<0"  Error code.
+ */
+int sch_dec_group_add(Scheduler *sch, unsigned group_idx, unsigned dec_idx);
+
 /**
  * Add a filtergraph to the scheduler.
  *
@@ -378,6 +410,43 @@ int sch_demux_send(Scheduler *sch, unsigned demux_idx, struct AVPacket *pkt,
  */
 int sch_dec_receive(Scheduler *sch, unsigned dec_idx, struct AVPacket *pkt);
 
+/**
+ * Called by decoder group tasks to receive a packet for one of their decoders.
+ *
+ * This works like sch_dec_receive() for the decoder whose index is written to
+ * dec_idx; in particular, after a flush packet the post-flush end timestamp
+ * of that decoder must be written to pkt on the next call to this function.
+ * Packets are returned in the order they were sent, across all decoders, so
+ * the group task can keep decoding without waiting as long as packets are
+ * queued for any of them.
+ *
+ * @param group_idx Decoder group index previously returned by
+ *                  sch_add_dec_group().
+ * @param[out] dec_idx Index in the group of the decoder the packet or EOF is
+ *                     for, or -1 when all the decoders in the group are done.
+ *
+ * @retval "non-negative value" success
+ * @retval AVERROR_EOF no more packets will arrive for the decoder in dec_idx,
+ *                     or for any decoder when dec_idx is -1
+ * @retval "another negative error code" other failure
+ */
+int sch_dec_group_receive(Scheduler *sch, unsigned group_idx,
+                          int *dec_idx, struct AVPacket *pkt);
+
+/**
+ * Called by decoder group tasks when one of their decoders will not decode
+ * any more packets, e.g. after receiving EOF for it. This does for the decoder
+ * what is otherwise done when the task of a standalone decoder exits.
+ *
+ * @param group_idx Decoder group index previously returned by
+ *                  sch_add_dec_group().
+ * @param dec_idx Index of the decoder in the group.
+ *
+ * @retval "non-negative value" success
+ * @retval "negative error code" failure
+ */
+int sch_dec_group_finish(Scheduler *sch, unsigned group_idx, unsigned dec_idx);
+
 /**
  * Called by decoder tasks to send a decoded frame downstream.
  *
@@ -821,6 +821,80 @@ static void copy_input_samples(AACEncContext *s, const AVFrame *frame)
     }
 }
 
+/**
+ * Run the quantizer, TNS, PNS and stereo searches for one channel element.
+ * Each thread works on its own copy of the encoder context, so the scratch
+ * buffers and the band cost cache are never shared between elements.
+ */
+static int encode_element_thread(AVCodecContext *avctx, void *arg,
+                                 int jobnr, int threadnr)
+{
+    AACEncContext *s  = avctx->priv_data;
+    AACEncContext *ts = s->thread[threadnr];
+    const FFPsyWindowInfo *wi;
+    ChannelElement *cpe = &s->cpe[jobnr];
+    SingleChannelElement *sce;
+    int i, ch, w, start_ch = 0;
+    int tag   = s->chan_map[jobnr + 1];
+    int chans = tag == TYPE_CPE ? 2 : 1;
+
+    for (i = 0; i < jobnr; i++)
+        start_ch += s->chan_map[i + 1] == TYPE_CPE ? 2 : 1;
+    wi = (const FFPsyWindowInfo *)arg + start_ch;
+
+    ts->lambda              = s->lambda;
+    ts->psy.bitres.alloc    = cpe->bits_alloc;
+    ts->random_state        = cpe->random_state;
+    ts->cur_type            = tag;
+
+    for (ch = 0; ch < chans; ch++) {
+        ts->cur_channel = start_ch + ch;
+        if (ts->options.pns && ts->coder->mark_pns)
+            ts->coder->mark_pns(ts, avctx, &cpe->ch[ch]);
+        ts->coder->search_for_quantizers(avctx, ts, &cpe->ch[ch], ts->lambda);
+    }
+    if (chans > 1
+        && wi[0].window_type[0] == wi[1].window_type[0]
+        && wi[0].window_shape   == wi[1].window_shape) {
+
+        cpe->common_window = 1;
+        for (w = 0; w < wi[0].num_windows; w++) {
+            if (wi[0].grouping[w] != wi[1].grouping[w]) {
+                cpe->common_window = 0;
+                break;
+            }
+        }
+    }
+    for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
+        sce = &cpe->ch[ch];
+        ts->cur_channel = start_ch + ch;
+        if (ts->options.tns && ts->coder->search_for_tns)
+            ts->coder->search_for_tns(ts, sce);
+        if (ts->options.tns && ts->coder->apply_tns_filt)
+            ts->coder->apply_tns_filt(ts, sce);
+        if (ts->options.pns && ts->coder->search_for_pns)
+            ts->coder->search_for_pns(ts, avctx, sce);
+    }
+    ts->cur_channel = start_ch;
+    if (ts->options.intensity_stereo) { /* Intensity Stereo */
+        if (ts->coder->search_for_is)
+            ts->coder->search_for_is(ts, avctx, cpe);
+        apply_intensity_stereo(cpe);
+    }
+    if (ts->options.mid_side) { /* Mid/Side stereo */
+        if (ts->options.mid_side == -1 && ts->coder->search_for_ms)
+            ts->coder->search_for_ms(ts, cpe);
+        else if (cpe->common_window)
+            memset(cpe->ms_mask, 1, sizeof(cpe->ms_mask));
+        apply_mid_side_stereo(cpe);
+    }
+    adjust_frame_information(cpe, chans);
+
+    cpe->random_state = ts->random_state;
+
+    return 0;
+}
+
 static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                             const AVFrame *frame, int *got_packet_ptr)
 {
@@ -960,8 +1034,6 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
             cpe->common_window = 0;
             memset(cpe->is_mask, 0, sizeof(cpe->is_mask));
             memset(cpe->ms_mask, 0, sizeof(cpe->ms_mask));
-            put_bits(&s->pb, 3, tag);
-            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             for (ch = 0; ch < chans; ch++) {
                 sce = &cpe->ch[ch];
                 coeffs[ch] = sce->coeffs;
@@ -979,52 +1051,27 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                     * (s->lambda / (avctx->global_quality ? avctx->global_quality : 120));
                 s->psy.bitres.alloc /= chans;
             }
+            cpe->bits_alloc = s->psy.bitres.alloc;
+            start_ch += chans;
+        }
+
+        /* Element analysis only touches per-element and per-thread state,
+         * so it can run concurrently; bitstream writing stays in order. */
+        avctx->execute2(avctx, encode_element_thread, windows, NULL, s->chan_map[0]);
+
+        start_ch = 0;
+        for (i = 0; i < s->chan_map[0]; i++) {
+            tag      = s->chan_map[i+1];
+            chans    = tag == TYPE_CPE ? 2 : 1;
+            cpe      = &s->cpe[i];
+            put_bits(&s->pb, 3, tag);
+            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             s->cur_type = tag;
-            for (ch = 0; ch < chans; ch++) {
-                s->cur_channel = start_ch + ch;
-                if (s->options.pns && s->coder->mark_pns)
-                    s->coder->mark_pns(s, avctx, &cpe->ch[ch]);
-                s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
-            }
-            if (chans > 1
-                && wi[0].window_type[0] == wi[1].window_type[0]
-                && wi[0].window_shape   == wi[1].window_shape) {
-
-                cpe->common_window = 1;
-                for (w = 0; w < wi[0].num_windows; w++) {
-                    if (wi[0].grouping[w] != wi[1].grouping[w]) {
-                        cpe->common_window = 0;
-                        break;
-                    }
-                }
-            }
-            for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
-                sce = &cpe->ch[ch];
-                s->cur_channel = start_ch + ch;
-                if (s->options.tns && s->coder->search_for_tns)
-                    s->coder->search_for_tns(s, sce);
-                if (s->options.tns && s->coder->apply_tns_filt)
-                    s->coder->apply_tns_filt(s, sce);
-                if (sce->tns.present)
+            for (ch = 0; ch < chans; ch++)
+                if (cpe->ch[ch].tns.present)
                     tns_mode = 1;
-                if (s->options.pns && s->coder->search_for_pns)
-                    s->coder->search_for_pns(s, avctx, sce);
-            }
-            s->cur_channel = start_ch;
-            if (s->options.intensity_stereo) { /* Intensity Stereo */
-                if (s->coder->search_for_is)
-                    s->coder->search_for_is(s, avctx, cpe);
-                if (cpe->is_mode) is_mode = 1;
-                apply_intensity_stereo(cpe);
-            }
-            if (s->options.mid_side) { /* Mid/Side stereo */
-                if (s->options.mid_side == -1 && s->coder->search_for_ms)
-                    s->coder->search_for_ms(s, cpe);
-                else if (cpe->common_window)
-                    memset(cpe->ms_mask, 1, sizeof(cpe->ms_mask));
-                apply_mid_side_stereo(cpe);
-            }
-            adjust_frame_information(cpe, chans);
+            if (cpe->is_mode)
+                is_mode = 1;
             if (chans == 2) {
                 put_bits(&s->pb, 1, cpe->common_window);
                 if (cpe->common_window) {
@@ -1137,6 +1184,13 @@ static av_cold int aac_encode_end(AVCodecContext *avctx)
 
     av_log(avctx, AV_LOG_INFO, "Qavg: %.3f\n", s->lambda_count ? s->lambda_sum / s->lambda_count : NAN);
 
+    for (int i = 1; i < s->nb_threads; i++) {
+        if (s->thread[i])
+            ff_lpc_end(&s->thread[i]->lpc);
+        av_freep(&s->thread[i]);
+    }
+    av_freep(&s->thread);
+
     av_tx_uninit(&s->mdct1024);
     av_tx_uninit(&s->mdct128);
     ff_psy_end(&s->psy);
@@ -1182,6 +1236,32 @@ static av_cold int alloc_buffers(AVCodecContext *avctx, AACEncContext *s)
     return 0;
 }
 
+static av_cold int alloc_thread_contexts(AVCodecContext *avctx, AACEncContext *s)
+{
+    int i, ret;
+    int nb_threads = avctx->active_thread_type & FF_THREAD_SLICE ?
+                     avctx->thread_count : 1;
+
+    s->thread = av_calloc(nb_threads, sizeof(*s->thread));
+    if (!s->thread)
+        return AVERROR(ENOMEM);
+    s->thread[0]     = s;
+    s->nb_threads    = nb_threads;
+    for (i = 1; i < nb_threads; i++) {
+        AACEncContext *ts = av_memdup(s, sizeof(*s));
+        if (!ts)
+            return AVERROR(ENOMEM);
+        s->thread[i] = ts;
+        memset(&ts->lpc, 0, sizeof(ts->lpc));
+        /* The LPC scratch buffer is used by TNS and must not be shared */
+        if ((ret = ff_lpc_init(&ts->lpc, 2*avctx->frame_size, TNS_MAX_ORDER,
+                               FF_LPC_TYPE_LEVINSON)) < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 static av_cold int aac_encode_init(AVCodecContext *avctx)
 {
     AACEncContext *s = avctx->priv_data;
@@ -1296,13 +1376,19 @@ static av_cold int aac_encode_init(AVCodecContext *avctx)
                            s->chan_map[0], grouping)) < 0)
         return ret;
     s->psypp = ff_psy_preprocess_init(avctx);
-    ff_lpc_init(&s->lpc, 2*avctx->frame_size, TNS_MAX_ORDER, FF_LPC_TYPE_LEVINSON);
+    if ((ret = ff_lpc_init(&s->lpc, 2*avctx->frame_size, TNS_MAX_ORDER, FF_LPC_TYPE_LEVINSON)) < 0)
+        return ret;
     s->random_state = 0x1f2e3d4c;
+    for (i = 0; i < s->chan_map[0]; i++)
+        s->cpe[i].random_state = s->random_state + i;
 
     ff_aacenc_dsp_init(&s->aacdsp);
 
     ff_af_queue_init(avctx, &s->afq);
 
+    if ((ret = alloc_thread_contexts(avctx, s)) < 0)
+        return ret;
+
     return 0;
 }
 
@@ -1338,7 +1424,8 @@ const FFCodec ff_aac_encoder = {
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_AAC,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_SMALL_LAST_FRAME,
+                      AV_CODEC_CAP_SMALL_LAST_FRAME |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(AACEncContext),
     .init           = aac_encode_init,
     FF_CODEC_ENCODE_CB(aac_encode_frame),
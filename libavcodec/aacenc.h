@@ -132,6 +132,8 @@ typedef struct ChannelElement {
     uint8_t ms_mask[128];     ///< Set if mid/side stereo is used for each scalefactor window band
     uint8_t is_mask[128];     ///< Set if intensity stereo is used
     // shared
+    int bits_alloc;           ///< per-channel bit allocation granted by psy for the current frame
+    int random_state;         ///< PNS noise generator state, kept per element so threaded output is bit-exact
     SingleChannelElement ch[2];
 } ChannelElement;
 
@@ -221,6 +223,9 @@ typedef struct AACEncContext {
     struct {
         float *samples;
     } buffer;
+
+    struct AACEncContext **thread;               ///< per-thread contexts for channel element analysis, thread[0] is this context
+    int nb_threads;
 } AACEncContext;
 
 void ff_quantize_band_cost_cache_init(struct AACEncContext *s);
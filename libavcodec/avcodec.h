@@ -373,6 +373,17 @@ typedef struct RcOverride{
  * Discard cropping information from SPS.
  */
 #define AV_CODEC_FLAG2_IGNORE_CROP    (1 << 16)
+/**
+ * Back the default frame buffer pools with huge pages, see
+ * av_buffer_alloc_hugepage().
+ */
+#define AV_CODEC_FLAG2_HUGEPAGES      (1 << 17)
+/**
+ * With frame threading, adjust the number of threads in use, up to
+ * thread_count, to the picture size and decoding speed. Unused threads drop
+ * their references to frames. Ignored by decoders that do not support it.
+ */
+#define AV_CODEC_FLAG2_ADAPTIVE_THREADS (1 << 18)
 
 /**
  * Show all frames before the first keyframe
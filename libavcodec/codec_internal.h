@@ -87,6 +87,12 @@
  * encoders do.
  */
 #define FF_CODEC_CAP_EOF_FLUSH              (1 << 10)
+/**
+ * The decoder supports AV_CODEC_FLAG2_ADAPTIVE_THREADS: its state can be
+ * dropped with flush() on an idle frame thread and restored later through
+ * update_thread_context() from the thread that decoded the previous packet.
+ */
+#define FF_CODEC_CAP_ADAPTIVE_THREADS       (1 << 11)
 
 /**
  * FFCodec.codec_tags termination value
@@ -29,6 +29,7 @@
 #endif
 
 #include "libavutil/avassert.h"
+#include "libavutil/buffer.h"
 #include "libavutil/channel_layout.h"
 #include "libavutil/common.h"
 #include "libavutil/emms.h"
@@ -57,6 +58,36 @@
 #include "thread.h"
 #include "threadprogress.h"
 
+/**
+ * Pool of side data buffers of one type, so that side data attached to
+ * every frame does not have to be allocated anew each time.
+ */
+typedef struct SideDataPool {
+    AVBufferPool *pool;
+    size_t size;
+    /**
+     * Initial contents of the buffers, or NULL to leave them uninitialized.
+     */
+    void *init;
+} SideDataPool;
+
+/**
+ * Side data types that get pooled buffers. Only types with a fixed payload
+ * size are listed; variable-size ones like ICC profiles are not pooled.
+ */
+static const struct {
+    enum AVFrameSideDataType type;
+    size_t size;    ///< payload size, 0 if it is defined by libavutil
+} pooled_side_data[] = {
+    { AV_FRAME_DATA_PANSCAN,                    sizeof(AVPanScan)    },
+    { AV_FRAME_DATA_AFD,                        1                    },
+    { AV_FRAME_DATA_DISPLAYMATRIX,              9 * sizeof(int32_t)  },
+    { AV_FRAME_DATA_S12M_TIMECODE,              4 * sizeof(uint32_t) },
+    { AV_FRAME_DATA_VIEW_ID,                    sizeof(int)          },
+    { AV_FRAME_DATA_MASTERING_DISPLAY_METADATA, 0                    },
+    { AV_FRAME_DATA_CONTENT_LIGHT_LEVEL,        0                    },
+};
+
 typedef struct DecodeContext {
     AVCodecInternal avci;
 
@@ -97,6 +128,11 @@ typedef struct DecodeContext {
     int lcevc_frame;
     int width;
     int height;
+
+    /**
+     * Indexed like pooled_side_data[], created on first use.
+     */
+    SideDataPool side_data_pools[FF_ARRAY_ELEMS(pooled_side_data)];
 } DecodeContext;
 
 static DecodeContext *decode_ctx(AVCodecInternal *avci)
@@ -2102,11 +2138,55 @@ static int side_data_pref(const AVCodecContext *avctx, AVFrameSideData ***sd,
 }
 
 
+/**
+ * Return the pool for side data of the given type and size, or NULL if such
+ * side data is not pooled.
+ */
+static SideDataPool *side_data_pool(DecodeContext *dc,
+                                    enum AVFrameSideDataType type, size_t size)
+{
+    for (int i = 0; i < FF_ARRAY_ELEMS(pooled_side_data); i++)
+        if (pooled_side_data[i].type == type)
+            return pooled_side_data[i].size == size ? &dc->side_data_pools[i] : NULL;
+
+    return NULL;
+}
+
+/**
+ * Initialize p for buffers of the given size. The pool takes ownership
+ * of init, even on failure.
+ */
+static int side_data_pool_init(SideDataPool *p, size_t size, void *init)
+{
+    p->pool = av_buffer_pool_init(size, NULL);
+    if (!p->pool) {
+        av_free(init);
+        return AVERROR(ENOMEM);
+    }
+    p->size = size;
+    p->init = init;
+
+    return 0;
+}
+
+static AVBufferRef *side_data_pool_get(SideDataPool *p)
+{
+    AVBufferRef *buf = av_buffer_pool_get(p->pool);
+
+    if (buf && p->init)
+        memcpy(buf->data, p->init, p->size);
+
+    return buf;
+}
+
 int ff_frame_new_side_data(const AVCodecContext *avctx, AVFrame *frame,
                            enum AVFrameSideDataType type, size_t size,
                            AVFrameSideData **psd)
 {
-    AVFrameSideData *sd;
+    DecodeContext *dc = decode_ctx(avctx->internal);
+    SideDataPool *p = side_data_pool(dc, type, size);
+    AVFrameSideData *sd = NULL;
+    AVBufferRef *buf;
 
     if (side_data_pref(avctx, &frame->side_data, &frame->nb_side_data, type)) {
         if (psd)
@@ -2114,7 +2194,20 @@ int ff_frame_new_side_data(const AVCodecContext *avctx, AVFrame *frame,
         return 0;
     }
 
-    sd = av_frame_new_side_data(frame, type, size);
+    if (p) {
+        if (!p->pool && side_data_pool_init(p, size, NULL) < 0)
+            buf = NULL;
+        else
+            buf = side_data_pool_get(p);
+    } else {
+        buf = av_buffer_alloc(size);
+    }
+
+    if (buf) {
+        sd = av_frame_new_side_data_from_buf(frame, type, buf);
+        if (!sd)
+            av_buffer_unref(&buf);
+    }
     if (psd)
         *psd = sd;
 
@@ -2153,23 +2246,27 @@ int ff_decode_mastering_display_new_ext(const AVCodecContext *avctx,
                                         AVFrameSideData ***sd, int *nb_sd,
                                         struct AVMasteringDisplayMetadata **mdm)
 {
+    DecodeContext *dc = decode_ctx(avctx->internal);
+    SideDataPool *p = side_data_pool(dc, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA, 0);
     AVBufferRef *buf;
-    size_t size;
 
     if (side_data_pref(avctx, sd, nb_sd, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA)) {
         *mdm = NULL;
         return 0;
     }
 
-    *mdm = av_mastering_display_metadata_alloc_size(&size);
-    if (!*mdm)
-        return AVERROR(ENOMEM);
+    /* the structure size and defaults come from the libavutil in use */
+    if (!p->pool) {
+        size_t size;
+        void *init = av_mastering_display_metadata_alloc_size(&size);
+        if (!init || side_data_pool_init(p, size, init) < 0)
+            return AVERROR(ENOMEM);
+    }
 
-    buf = av_buffer_create((uint8_t *)*mdm, size, NULL, NULL, 0);
-    if (!buf) {
-        av_freep(mdm);
+    buf = side_data_pool_get(p);
+    if (!buf)
         return AVERROR(ENOMEM);
-    }
+    *mdm = (AVMasteringDisplayMetadata *)buf->data;
 
     if (!av_frame_side_data_add(sd, nb_sd, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA,
                                 &buf, 0)) {
@@ -2184,37 +2281,34 @@ int ff_decode_mastering_display_new_ext(const AVCodecContext *avctx,
 int ff_decode_mastering_display_new(const AVCodecContext *avctx, AVFrame *frame,
                                     AVMasteringDisplayMetadata **mdm)
 {
-    if (side_data_pref(avctx, &frame->side_data, &frame->nb_side_data,
-                       AV_FRAME_DATA_MASTERING_DISPLAY_METADATA)) {
-        *mdm = NULL;
-        return 0;
-    }
-
-    *mdm = av_mastering_display_metadata_create_side_data(frame);
-    return *mdm ? 0 : AVERROR(ENOMEM);
+    return ff_decode_mastering_display_new_ext(avctx, &frame->side_data,
+                                               &frame->nb_side_data, mdm);
 }
 
 int ff_decode_content_light_new_ext(const AVCodecContext *avctx,
                                     AVFrameSideData ***sd, int *nb_sd,
                                     AVContentLightMetadata **clm)
 {
+    DecodeContext *dc = decode_ctx(avctx->internal);
+    SideDataPool *p = side_data_pool(dc, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL, 0);
     AVBufferRef *buf;
-    size_t size;
 
     if (side_data_pref(avctx, sd, nb_sd, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL)) {
         *clm = NULL;
         return 0;
     }
 
-    *clm = av_content_light_metadata_alloc(&size);
-    if (!*clm)
-        return AVERROR(ENOMEM);
+    if (!p->pool) {
+        size_t size;
+        void *init = av_content_light_metadata_alloc(&size);
+        if (!init || side_data_pool_init(p, size, init) < 0)
+            return AVERROR(ENOMEM);
+    }
 
-    buf = av_buffer_create((uint8_t *)*clm, size, NULL, NULL, 0);
-    if (!buf) {
-        av_freep(clm);
+    buf = side_data_pool_get(p);
+    if (!buf)
         return AVERROR(ENOMEM);
-    }
+    *clm = (AVContentLightMetadata *)buf->data;
 
     if (!av_frame_side_data_add(sd, nb_sd, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL,
                                 &buf, 0)) {
@@ -2229,14 +2323,8 @@ int ff_decode_content_light_new_ext(const AVCodecContext *avctx,
 int ff_decode_content_light_new(const AVCodecContext *avctx, AVFrame *frame,
                                 AVContentLightMetadata **clm)
 {
-    if (side_data_pref(avctx, &frame->side_data, &frame->nb_side_data,
-                       AV_FRAME_DATA_CONTENT_LIGHT_LEVEL)) {
-        *clm = NULL;
-        return 0;
-    }
-
-    *clm = av_content_light_metadata_create_side_data(frame);
-    return *clm ? 0 : AVERROR(ENOMEM);
+    return ff_decode_content_light_new_ext(avctx, &frame->side_data,
+                                           &frame->nb_side_data, clm);
 }
 
 int ff_copy_palette(void *dst, const AVPacket *src, void *logctx)
@@ -2320,4 +2408,9 @@ void ff_decode_internal_uninit(AVCodecContext *avctx)
     DecodeContext *dc = decode_ctx(avci);
 
     av_refstruct_unref(&dc->lcevc);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(dc->side_data_pools); i++) {
+        av_buffer_pool_uninit(&dc->side_data_pools[i].pool);
+        av_freep(&dc->side_data_pools[i].init);
+    }
 }
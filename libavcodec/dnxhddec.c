@@ -35,14 +35,30 @@
 #define  UNCHECKED_BITSTREAM_READER 1
 #include "get_bits.h"
 #include "dnxhddata.h"
+#include "dnxhddsp.h"
 #include "idctdsp.h"
 #include "profiles.h"
 #include "thread.h"
 
+#define DNXHD_AC_LUT_BITS 12
+
+/**
+ * Joint lookup for an AC codeword together with its sign bit, the optional
+ * level extension bits and the optional run codeword.
+ */
+typedef struct ACLUTEntry {
+    int16_t level;  ///< signed level, 0 for the end of block code
+    uint8_t len;    ///< bits consumed, 0 if the sequence does not fit
+    uint8_t run;    ///< zero coefficients preceding this one
+} ACLUTEntry;
+
 typedef struct RowContext {
     DECLARE_ALIGNED(32, int16_t, blocks)[12][64];
-    int luma_scale[64];
-    int chroma_scale[64];
+    /* quantizer scales and rounding terms, in permuted coefficient order */
+    DECLARE_ALIGNED(32, int32_t, luma_scale)[64];
+    DECLARE_ALIGNED(32, int32_t, chroma_scale)[64];
+    DECLARE_ALIGNED(32, int32_t, luma_round)[64];
+    DECLARE_ALIGNED(32, int32_t, chroma_round)[64];
     GetBitContext gb;
     int last_dc[3];
     int last_qscale;
@@ -65,7 +81,10 @@ typedef struct DNXHDContext {
     int data_offset;                    // End of mb_scan_index, where macroblocks start
     int cur_field;                      ///< current interlaced field
     VLC ac_vlc, dc_vlc, run_vlc;
+    ACLUTEntry ac_lut[1 << DNXHD_AC_LUT_BITS];
+    int ac_lut_index_bits;              ///< index_bits ac_lut was built for, 0 if none
     IDCTDSPContext idsp;
+    DNXHDDSPContext dnxdsp;
     uint8_t permutated_scantable[64];
     const CIDEntry *cid_table;
     int bit_depth; // 8, 10, 12 or 0 if not initialized at all.
@@ -74,6 +93,7 @@ typedef struct DNXHDContext {
     int lla;
     int mbaff;
     int act;
+    int level_bias;
     int (*decode_dct_block)(const struct DNXHDContext *ctx,
                             RowContext *row, int n);
 } DNXHDContext;
@@ -98,6 +118,7 @@ static av_cold int dnxhd_decode_init(AVCodecContext *avctx)
 
     ctx->avctx = avctx;
     ctx->cid = -1;
+    ff_dnxhddsp_init(&ctx->dnxdsp);
     if (avctx->colorspace == AVCOL_SPC_UNSPECIFIED) {
         avctx->colorspace = AVCOL_SPC_BT709;
     }
@@ -112,8 +133,71 @@ static av_cold int dnxhd_decode_init(AVCodecContext *avctx)
     return 0;
 }
 
+static void dnxhd_fill_ac_lut(DNXHDContext *ctx, unsigned code, int len,
+                              int level, int run)
+{
+    ACLUTEntry *entry = ctx->ac_lut + (code << (DNXHD_AC_LUT_BITS - len));
+
+    for (int i = 0; i < 1 << (DNXHD_AC_LUT_BITS - len); i++)
+        entry[i] = (ACLUTEntry){ .level = level, .len = len, .run = run };
+}
+
+/**
+ * Build the joint AC lookup table: every bit sequence of codeword, sign,
+ * extension bits and run codeword short enough to be resolved by a single
+ * DNXHD_AC_LUT_BITS bit peek gets an entry, everything else falls back to
+ * the VLC tables.
+ */
+static void dnxhd_init_ac_lut(DNXHDContext *ctx, int index_bits)
+{
+    const CIDEntry *cid_table = ctx->cid_table;
+
+    memset(ctx->ac_lut, 0, sizeof(ctx->ac_lut));
+
+    for (int s = 0; s < 257; s++) {
+        unsigned code = cid_table->ac_codes[s];
+        int len   = cid_table->ac_bits[s];
+        int level = cid_table->ac_info[2 * s + 0];
+        int flags = cid_table->ac_info[2 * s + 1];
+        int extra = flags & 1 ? index_bits : 0;
+
+        if (!len)
+            continue;
+        if (s == cid_table->eob_index) {
+            if (len <= DNXHD_AC_LUT_BITS)
+                dnxhd_fill_ac_lut(ctx, code, len, 0, 0);
+            continue;
+        }
+        if (len + 1 + extra > DNXHD_AC_LUT_BITS)
+            continue;
+
+        for (int sign = 0; sign < 2; sign++) {
+            for (int ext = 0; ext < 1 << extra; ext++) {
+                unsigned code2 = (code << 1 | sign) << extra | ext;
+                int len2 = len + 1 + extra;
+                int val  = level + (ext << 7);
+
+                if (sign)
+                    val = -val;
+                if (!(flags & 2)) {
+                    dnxhd_fill_ac_lut(ctx, code2, len2, val, 0);
+                    continue;
+                }
+                for (int r = 0; r < 62; r++) {
+                    int rlen = cid_table->run_bits[r];
+                    if (rlen && len2 + rlen <= DNXHD_AC_LUT_BITS)
+                        dnxhd_fill_ac_lut(ctx, code2 << rlen | cid_table->run_codes[r],
+                                          len2 + rlen, val, cid_table->run[r]);
+                }
+            }
+        }
+    }
+    ctx->ac_lut_index_bits = index_bits;
+}
+
 static int dnxhd_init_vlc(DNXHDContext *ctx, uint32_t cid, int bitdepth)
 {
+    int index_bits = bitdepth > 8 ? 6 : 4;
     int ret;
     if (cid != ctx->cid) {
         const CIDEntry *cid_table = ff_dnxhd_get_cid_table(cid);
@@ -150,7 +234,10 @@ static int dnxhd_init_vlc(DNXHDContext *ctx, uint32_t cid, int bitdepth)
             goto out;
 
         ctx->cid = cid;
+        ctx->ac_lut_index_bits = 0;
     }
+    if (ctx->ac_lut_index_bits != index_bits)
+        dnxhd_init_ac_lut(ctx, index_bits);
     ret = 0;
 out:
     if (ret < 0)
@@ -253,24 +340,31 @@ static int dnxhd_decode_header(DNXHDContext *ctx, AVFrame *frame,
             return AVERROR_INVALIDDATA;
         } else if (bitdepth == 10) {
             ctx->decode_dct_block = dnxhd_decode_dct_block_10_444;
+            ctx->level_bias       = 32;
             ctx->pix_fmt = ctx->act ? AV_PIX_FMT_YUV444P10
                                     : AV_PIX_FMT_GBRP10;
         } else {
             ctx->decode_dct_block = dnxhd_decode_dct_block_12_444;
+            ctx->level_bias       = 32;
             ctx->pix_fmt = ctx->act ? AV_PIX_FMT_YUV444P12
                                     : AV_PIX_FMT_GBRP12;
         }
     } else if (bitdepth == 12) {
         ctx->decode_dct_block = dnxhd_decode_dct_block_12;
+        ctx->level_bias       = 8;
         ctx->pix_fmt = AV_PIX_FMT_YUV422P12;
     } else if (bitdepth == 10) {
-        if (ctx->avctx->profile == AV_PROFILE_DNXHR_HQX)
+        if (ctx->avctx->profile == AV_PROFILE_DNXHR_HQX) {
             ctx->decode_dct_block = dnxhd_decode_dct_block_10_444;
-        else
+            ctx->level_bias       = 32;
+        } else {
             ctx->decode_dct_block = dnxhd_decode_dct_block_10;
+            ctx->level_bias       = 8;
+        }
         ctx->pix_fmt = AV_PIX_FMT_YUV422P10;
     } else {
         ctx->decode_dct_block = dnxhd_decode_dct_block_8;
+        ctx->level_bias       = 32;
         ctx->pix_fmt = AV_PIX_FMT_YUV422P;
     }
 
@@ -356,14 +450,11 @@ static av_always_inline int dnxhd_decode_dct_block(const DNXHDContext *ctx,
                                                    RowContext *row,
                                                    int n,
                                                    int index_bits,
-                                                   int level_bias,
                                                    int level_shift,
                                                    int dc_shift)
 {
-    int i, j, index1, len, flags;
-    int level, component, sign;
-    const int *scale;
-    const uint8_t *weight_matrix;
+    int i, j, index1, len, level, component, sign;
+    const int32_t *scale, *round;
     const uint8_t *ac_info = ctx->cid_table->ac_info;
     int16_t *block = row->blocks[n];
     const int eob_index     = ctx->cid_table->eob_index;
@@ -374,22 +465,22 @@ static av_always_inline int dnxhd_decode_dct_block(const DNXHDContext *ctx,
 
     if (!ctx->is_444) {
         if (n & 2) {
-            component     = 1 + (n & 1);
-            scale = row->chroma_scale;
-            weight_matrix = ctx->cid_table->chroma_weight;
+            component = 1 + (n & 1);
+            scale     = row->chroma_scale;
+            round     = row->chroma_round;
         } else {
-            component     = 0;
-            scale = row->luma_scale;
-            weight_matrix = ctx->cid_table->luma_weight;
+            component = 0;
+            scale     = row->luma_scale;
+            round     = row->luma_round;
         }
     } else {
         component = (n >> 1) % 3;
         if (component) {
             scale = row->chroma_scale;
-            weight_matrix = ctx->cid_table->chroma_weight;
+            round = row->chroma_round;
         } else {
             scale = row->luma_scale;
-            weight_matrix = ctx->cid_table->luma_weight;
+            round = row->luma_round;
         }
     }
 
@@ -406,32 +497,49 @@ static av_always_inline int dnxhd_decode_dct_block(const DNXHDContext *ctx,
         level = (NEG_USR32(sign ^ level, len) ^ sign) - sign;
         row->last_dc[component] += level * (1 << dc_shift);
     }
-    block[0] = row->last_dc[component];
 
+    /* Most codes are resolved by a single ac_lut lookup. With a SIMD
+     * dequant_block() the signed levels are stored as is and the whole
+     * block is dequantized at once afterwards. */
     i = 0;
+    for (;;) {
+        ACLUTEntry entry;
 
-    UPDATE_CACHE(bs, &row->gb);
-    GET_VLC(index1, bs, &row->gb, ctx->ac_vlc.table,
-            DNXHD_VLC_BITS, 2);
+        UPDATE_CACHE(bs, &row->gb);
+        entry = ctx->ac_lut[SHOW_UBITS(bs, &row->gb, DNXHD_AC_LUT_BITS)];
+        if (entry.len) {
+            SKIP_BITS(bs, &row->gb, entry.len);
+            if (!entry.level)
+                break;
+            level = entry.level;
+            i    += entry.run;
+        } else {
+            int flags;
+
+            GET_VLC(index1, bs, &row->gb, ctx->ac_vlc.table,
+                    DNXHD_VLC_BITS, 2);
+            if (index1 == eob_index)
+                break;
 
-    while (index1 != eob_index) {
-        level = ac_info[2*index1+0];
-        flags = ac_info[2*index1+1];
+            level = ac_info[2*index1+0];
+            flags = ac_info[2*index1+1];
 
-        sign = SHOW_SBITS(bs, &row->gb, 1);
-        SKIP_BITS(bs, &row->gb, 1);
+            sign = SHOW_SBITS(bs, &row->gb, 1);
+            SKIP_BITS(bs, &row->gb, 1);
 
-        if (flags & 1) {
-            level += SHOW_UBITS(bs, &row->gb, index_bits) << 7;
-            SKIP_BITS(bs, &row->gb, index_bits);
-        }
+            if (flags & 1) {
+                level += SHOW_UBITS(bs, &row->gb, index_bits) << 7;
+                SKIP_BITS(bs, &row->gb, index_bits);
+            }
 
-        if (flags & 2) {
-            int run;
-            UPDATE_CACHE(bs, &row->gb);
-            GET_VLC(run, bs, &row->gb, ctx->run_vlc.table,
-                    DNXHD_VLC_BITS, 2);
-            i += run;
+            if (flags & 2) {
+                int run;
+                UPDATE_CACHE(bs, &row->gb);
+                GET_VLC(run, bs, &row->gb, ctx->run_vlc.table,
+                        DNXHD_VLC_BITS, 2);
+                i += run;
+            }
+            level = (level ^ sign) - sign;
         }
 
         if (++i > 63) {
@@ -440,19 +548,18 @@ static av_always_inline int dnxhd_decode_dct_block(const DNXHDContext *ctx,
             break;
         }
 
-        j      = ctx->permutated_scantable[i];
-        level *= scale[i];
-        level += scale[i] >> 1;
-        if (level_bias < 32 || weight_matrix[i] != level_bias)
-            level += level_bias; // 1<<(level_shift-1)
-        level >>= level_shift;
-
-        block[j] = (level ^ sign) - sign;
-
-        UPDATE_CACHE(bs, &row->gb);
-        GET_VLC(index1, bs, &row->gb, ctx->ac_vlc.table,
-                DNXHD_VLC_BITS, 2);
+        j = ctx->permutated_scantable[i];
+        if (!ctx->dnxdsp.batch_dequant) {
+            sign  = level >> 31;
+            level = (int)(FFABS(level) * (unsigned)scale[j] + round[j]) >> level_shift;
+            level = (level ^ sign) - sign;
+        }
+        block[j] = level;
     }
+
+    if (ctx->dnxdsp.batch_dequant)
+        ctx->dnxdsp.dequant_block(block, scale, round, level_shift);
+    block[0] = row->last_dc[component];
 error:
     CLOSE_READER(bs, &row->gb);
     return ret;
@@ -461,31 +568,31 @@ error:
 static int dnxhd_decode_dct_block_8(const DNXHDContext *ctx,
                                     RowContext *row, int n)
 {
-    return dnxhd_decode_dct_block(ctx, row, n, 4, 32, 6, 0);
+    return dnxhd_decode_dct_block(ctx, row, n, 4, 6, 0);
 }
 
 static int dnxhd_decode_dct_block_10(const DNXHDContext *ctx,
                                      RowContext *row, int n)
 {
-    return dnxhd_decode_dct_block(ctx, row, n, 6, 8, 4, 0);
+    return dnxhd_decode_dct_block(ctx, row, n, 6, 4, 0);
 }
 
 static int dnxhd_decode_dct_block_10_444(const DNXHDContext *ctx,
                                          RowContext *row, int n)
 {
-    return dnxhd_decode_dct_block(ctx, row, n, 6, 32, 6, 0);
+    return dnxhd_decode_dct_block(ctx, row, n, 6, 6, 0);
 }
 
 static int dnxhd_decode_dct_block_12(const DNXHDContext *ctx,
                                      RowContext *row, int n)
 {
-    return dnxhd_decode_dct_block(ctx, row, n, 6, 8, 4, 2);
+    return dnxhd_decode_dct_block(ctx, row, n, 6, 4, 2);
 }
 
 static int dnxhd_decode_dct_block_12_444(const DNXHDContext *ctx,
                                          RowContext *row, int n)
 {
-    return dnxhd_decode_dct_block(ctx, row, n, 6, 32, 4, 2);
+    return dnxhd_decode_dct_block(ctx, row, n, 6, 4, 2);
 }
 
 static int dnxhd_decode_macroblock(const DNXHDContext *ctx, RowContext *row,
@@ -522,9 +629,18 @@ static int dnxhd_decode_macroblock(const DNXHDContext *ctx, RowContext *row,
     }
 
     if (qscale != row->last_qscale) {
+        const uint8_t *luma_weight   = ctx->cid_table->luma_weight;
+        const uint8_t *chroma_weight = ctx->cid_table->chroma_weight;
+        int bias = ctx->level_bias;
+
         for (i = 0; i < 64; i++) {
-            row->luma_scale[i]   = qscale * ctx->cid_table->luma_weight[i];
-            row->chroma_scale[i] = qscale * ctx->cid_table->chroma_weight[i];
+            int j = ctx->permutated_scantable[i];
+            row->luma_scale[j]   = qscale * luma_weight[i];
+            row->chroma_scale[j] = qscale * chroma_weight[i];
+            row->luma_round[j]   = (row->luma_scale[j] >> 1) +
+                                   (bias < 32 || luma_weight[i] != bias ? bias : 0);
+            row->chroma_round[j] = (row->chroma_scale[j] >> 1) +
+                                   (bias < 32 || chroma_weight[i] != bias ? bias : 0);
         }
         row->last_qscale = qscale;
     }
@@ -628,8 +744,11 @@ static int dnxhd_decode_frame(AVCodecContext *avctx, AVFrame *picture,
 
     ff_dlog(avctx, "frame size %d\n", buf_size);
 
-    for (i = 0; i < avctx->thread_count; i++)
-        ctx->rows[i].format = -1;
+    /* the scale tables depend on the profile and the IDCT permutation */
+    for (i = 0; i < avctx->thread_count; i++) {
+        ctx->rows[i].format      = -1;
+        ctx->rows[i].last_qscale = -1;
+    }
 
 decode_coding_unit:
     if ((ret = dnxhd_decode_header(ctx, picture, buf, buf_size, first_field)) < 0)
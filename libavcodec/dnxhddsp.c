@@ -0,0 +1,47 @@
+/*
+ * DNxHD/DNxHR decoder DSP functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+#include "dnxhddsp.h"
+
+static void dequant_block_c(int16_t block[64], const int32_t scale[64],
+                            const int32_t round[64], int shift)
+{
+    for (int k = 0; k < 64; k++) {
+        int level = block[k];
+        if (level) {
+            int sign = level >> 31;
+            level = (int)(FFABS(level) * (unsigned)scale[k] + round[k]) >> shift;
+            block[k] = (level ^ sign) - sign;
+        }
+    }
+}
+
+av_cold void ff_dnxhddsp_init(DNXHDDSPContext *c)
+{
+    c->dequant_block = dequant_block_c;
+    c->batch_dequant = 0;
+
+#if ARCH_X86
+    ff_dnxhddsp_init_x86(c);
+#endif
+}
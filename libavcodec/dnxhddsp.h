@@ -0,0 +1,47 @@
+/*
+ * DNxHD/DNxHR decoder DSP functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_DNXHDDSP_H
+#define AVCODEC_DNXHDDSP_H
+
+#include <stdint.h>
+
+typedef struct DNXHDDSPContext {
+    /**
+     * Dequantize a block of signed coefficient levels in place.
+     * Every nonzero level v becomes
+     * sign(v) * ((|v| * scale[k] + round[k]) >> shift),
+     * truncated to 16 bits; zero levels are left untouched.
+     * block must be 32-byte aligned, scale and round 16-byte aligned.
+     */
+    void (*dequant_block)(int16_t block[64], const int32_t scale[64],
+                          const int32_t round[64], int shift);
+
+    /**
+     * Set if dequant_block() is faster than dequantizing each coefficient
+     * as it is parsed, which is the case for the SIMD versions only.
+     */
+    int batch_dequant;
+} DNXHDDSPContext;
+
+void ff_dnxhddsp_init(DNXHDDSPContext *c);
+void ff_dnxhddsp_init_x86(DNXHDDSPContext *c);
+
+#endif /* AVCODEC_DNXHDDSP_H */
@@ -485,34 +485,7 @@ static int huf_uncompress(const EXRContext *s,
     return huf_decode(&td->vlc, gb, nBits, td->run_sym, dst_size, dst);
 }
 
-static inline void wdec14(uint16_t l, uint16_t h, uint16_t *a, uint16_t *b)
-{
-    int16_t ls = l;
-    int16_t hs = h;
-    int hi     = hs;
-    int ai     = ls + (hi & 1) + (hi >> 1);
-    int16_t as = ai;
-    int16_t bs = ai - hi;
-
-    *a = as;
-    *b = bs;
-}
-
-#define NBITS      16
-#define A_OFFSET  (1 << (NBITS - 1))
-#define MOD_MASK  ((1 << NBITS) - 1)
-
-static inline void wdec16(uint16_t l, uint16_t h, uint16_t *a, uint16_t *b)
-{
-    int m  = l;
-    int d  = h;
-    int bb = (m - (d >> 1)) & MOD_MASK;
-    int aa = (d + bb - A_OFFSET) & MOD_MASK;
-    *b = bb;
-    *a = aa;
-}
-
-static void wav_decode(uint16_t *in, int nx, int ox,
+static void wav_decode(const ExrDSPContext *dsp, uint16_t *in, int nx, int ox,
                        int ny, int oy, uint16_t mx)
 {
     int w14 = (mx < (1 << 14));
@@ -540,21 +513,32 @@ static void wav_decode(uint16_t *in, int nx, int ox,
             uint16_t *px = py;
             uint16_t *ex = py + ox * (nx - p2);
 
+            /* the finest level of a 16-bit channel works on contiguous pairs */
+            if (p == 1 && ox == 1) {
+                int pairs = (nx >> 1) & ~15;
+
+                if (w14)
+                    dsp->wav_decode14(px, px + oy, pairs);
+                else
+                    dsp->wav_decode16(px, px + oy, pairs);
+                px += 2 * pairs;
+            }
+
             for (; px <= ex; px += ox2) {
                 uint16_t *p01 = px + ox1;
                 uint16_t *p10 = px + oy1;
                 uint16_t *p11 = p10 + ox1;
 
                 if (w14) {
-                    wdec14(*px, *p10, &i00, &i10);
-                    wdec14(*p01, *p11, &i01, &i11);
-                    wdec14(i00, i01, px, p01);
-                    wdec14(i10, i11, p10, p11);
+                    ff_exr_wdec14(*px, *p10, &i00, &i10);
+                    ff_exr_wdec14(*p01, *p11, &i01, &i11);
+                    ff_exr_wdec14(i00, i01, px, p01);
+                    ff_exr_wdec14(i10, i11, p10, p11);
                 } else {
-                    wdec16(*px, *p10, &i00, &i10);
-                    wdec16(*p01, *p11, &i01, &i11);
-                    wdec16(i00, i01, px, p01);
-                    wdec16(i10, i11, p10, p11);
+                    ff_exr_wdec16(*px, *p10, &i00, &i10);
+                    ff_exr_wdec16(*p01, *p11, &i01, &i11);
+                    ff_exr_wdec16(i00, i01, px, p01);
+                    ff_exr_wdec16(i10, i11, p10, p11);
                 }
             }
 
@@ -562,9 +546,9 @@ static void wav_decode(uint16_t *in, int nx, int ox,
                 uint16_t *p10 = px + oy1;
 
                 if (w14)
-                    wdec14(*px, *p10, &i00, p10);
+                    ff_exr_wdec14(*px, *p10, &i00, p10);
                 else
-                    wdec16(*px, *p10, &i00, p10);
+                    ff_exr_wdec16(*px, *p10, &i00, p10);
 
                 *px = i00;
             }
@@ -578,9 +562,9 @@ static void wav_decode(uint16_t *in, int nx, int ox,
                 uint16_t *p01 = px + ox1;
 
                 if (w14)
-                    wdec14(*px, *p01, &i00, p01);
+                    ff_exr_wdec14(*px, *p01, &i00, p01);
                 else
-                    wdec16(*px, *p01, &i00, p01);
+                    ff_exr_wdec16(*px, *p01, &i00, p01);
 
                 *px = i00;
             }
@@ -645,7 +629,7 @@ static int piz_uncompress(const EXRContext *s, const uint8_t *src, int ssize,
             pixel_half_size = 2;
 
         for (j = 0; j < pixel_half_size; j++)
-            wav_decode(ptr + j, td->xsize, pixel_half_size, td->ysize,
+            wav_decode(&s->dsp, ptr + j, td->xsize, pixel_half_size, td->ysize,
                        td->xsize * pixel_half_size, maxval);
         ptr += td->xsize * td->ysize * pixel_half_size;
     }
@@ -1395,14 +1379,22 @@ static int decode_block(AVCodecContext *avctx, void *tdata,
                                 f = powf(f, one_gamma);
                             AV_WN32A(ptr_x, av_float2int(f));
                         }
+                    } else if (!HAVE_BIGENDIAN && step == 4) {
+                        memcpy(ptr_x, src, xsize * 4);
+                        ptr_x += xsize * 4;
                     } else {
                         for (int x = 0; x < xsize; x++, ptr_x += step)
                             AV_WN32A(ptr_x, bytestream_get_le32(&src));
                     }
                 } else if (s->pixel_type == EXR_HALF) {
                     // 16-bit
-                    for (int x = 0; x < xsize; x++, ptr_x += step)
-                        AV_WN16A(ptr_x, bytestream_get_le16(&src));
+                    if (!HAVE_BIGENDIAN && step == 2) {
+                        memcpy(ptr_x, src, xsize * 2);
+                        ptr_x += xsize * 2;
+                    } else {
+                        for (int x = 0; x < xsize; x++, ptr_x += step)
+                            AV_WN16A(ptr_x, bytestream_get_le16(&src));
+                    }
                 }
 
                 // Zero out the end if xmax+1 is not w
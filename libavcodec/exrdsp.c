@@ -56,10 +56,29 @@ static void predictor_scalar(uint8_t *src, ptrdiff_t size)
     }
 }
 
+#define WAV_DECODE(bits)                                                    \
+static void wav_decode ## bits ## _scalar(uint16_t *row0, uint16_t *row1,   \
+                                          ptrdiff_t n)                      \
+{                                                                           \
+    for (ptrdiff_t i = 0; i < 2 * n; i += 2) {                              \
+        uint16_t i00, i01, i10, i11;                                        \
+                                                                            \
+        ff_exr_wdec ## bits(row0[i],     row1[i],     &i00, &i10);          \
+        ff_exr_wdec ## bits(row0[i + 1], row1[i + 1], &i01, &i11);          \
+        ff_exr_wdec ## bits(i00, i01, &row0[i], &row0[i + 1]);              \
+        ff_exr_wdec ## bits(i10, i11, &row1[i], &row1[i + 1]);              \
+    }                                                                       \
+}
+
+WAV_DECODE(14)
+WAV_DECODE(16)
+
 av_cold void ff_exrdsp_init(ExrDSPContext *c)
 {
     c->reorder_pixels   = reorder_pixels_scalar;
     c->predictor        = predictor_scalar;
+    c->wav_decode14     = wav_decode14_scalar;
+    c->wav_decode16     = wav_decode16_scalar;
 
 #if ARCH_RISCV
     ff_exrdsp_init_riscv(c);
@@ -22,11 +22,47 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "libavutil/attributes.h"
+
 typedef struct ExrDSPContext {
     void (*reorder_pixels)(uint8_t *dst, const uint8_t *src, ptrdiff_t size);
     void (*predictor)(uint8_t *src, ptrdiff_t size);
+
+    /**
+     * Inverse PIZ wavelet on the finest level, in place, for two adjacent
+     * rows of n interleaved low/high pairs of a single 16-bit channel.
+     * wav_decode14 is used when all values fit in 14 bits, wav_decode16
+     * otherwise. n must be a multiple of 16.
+     */
+    void (*wav_decode14)(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+    void (*wav_decode16)(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
 } ExrDSPContext;
 
+static av_always_inline void ff_exr_wdec14(uint16_t l, uint16_t h,
+                                           uint16_t *a, uint16_t *b)
+{
+    int16_t ls = l;
+    int16_t hs = h;
+    int hi     = hs;
+    int ai     = ls + (hi & 1) + (hi >> 1);
+    int16_t as = ai;
+    int16_t bs = ai - hi;
+
+    *a = as;
+    *b = bs;
+}
+
+static av_always_inline void ff_exr_wdec16(uint16_t l, uint16_t h,
+                                           uint16_t *a, uint16_t *b)
+{
+    int m  = l;
+    int d  = h;
+    int bb = (m - (d >> 1)) & 0xFFFF;
+    int aa = (d + bb - 0x8000) & 0xFFFF;
+    *b = bb;
+    *a = aa;
+}
+
 void ff_exrdsp_init(ExrDSPContext *c);
 void ff_exrdsp_init_riscv(ExrDSPContext *c);
 void ff_exrdsp_init_x86(ExrDSPContext *c);
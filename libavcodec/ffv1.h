@@ -241,18 +241,29 @@ static inline av_flatten int get_symbol_inline(RangeCoder *c, uint8_t *state,
     if (get_rac(c, state + 0))
         return 0;
     else {
-        int e;
+        int e = 0;
         unsigned a;
-        e = 0;
-        while (get_rac(c, state + 1 + FFMIN(e, 9))) { // 1..10
+
+        /* Short exponents are by far the most common, handle them without
+         * clamping the context index, mirroring put_symbol_inline(). */
+        while (e < 10 && get_rac(c, state + 1 + e)) // 1..10
             e++;
-            if (e > 31)
-                return AVERROR_INVALIDDATA;
+        if (e == 10) {
+            while (get_rac(c, state + 1 + 9)) {
+                e++;
+                if (e > 31)
+                    return AVERROR_INVALIDDATA;
+            }
         }
 
         a = 1;
-        for (int i = e - 1; i >= 0; i--)
-            a += a + get_rac(c, state + 22 + FFMIN(i, 9));  // 22..31
+        if (e <= 10) {
+            for (int i = e - 1; i >= 0; i--)
+                a += a + get_rac(c, state + 22 + i);  // 22..31
+        } else {
+            for (int i = e - 1; i >= 0; i--)
+                a += a + get_rac(c, state + 22 + FFMIN(i, 9));  // 22..31
+        }
 
         e = -(is_signed && get_rac(c, state + 11 + FFMIN(e, 10))); // 11..21
         return (a ^ e) - e;
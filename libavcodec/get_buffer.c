@@ -62,6 +62,11 @@ static void frame_pool_free(AVRefStructOpaque unused, void *obj)
         av_buffer_pool_uninit(&pool->pools[i]);
 }
 
+static AVBufferRef *pool_alloc_hugepage(size_t size)
+{
+    return av_buffer_alloc_hugepage(size, 0);
+}
+
 static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
 {
     FramePool *pool = avctx->internal->pool;
@@ -122,6 +127,8 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
                 pool->pools[i] = av_buffer_pool_init(size[i] + 16 + STRIDE_ALIGN - 1,
                                                      CONFIG_MEMORY_POISONING ?
                                                         NULL :
+                                                     avctx->flags2 & AV_CODEC_FLAG2_HUGEPAGES ?
+                                                        pool_alloc_hugepage :
                                                         av_buffer_allocz);
                 if (!pool->pools[i]) {
                     ret = AVERROR(ENOMEM);
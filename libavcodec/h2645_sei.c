@@ -781,11 +781,12 @@ int ff_h2645_sei_to_frame(AVFrame *frame, H2645SEI *sei,
          sei->display_orientation.vflip)) {
         H2645SEIDisplayOrientation *o = &sei->display_orientation;
         double angle = o->anticlockwise_rotation * 360 / (double) (1 << 16);
-        AVFrameSideData *rotation = av_frame_new_side_data(frame,
-                                                           AV_FRAME_DATA_DISPLAYMATRIX,
-                                                           sizeof(int32_t) * 9);
-        if (!rotation)
-            return AVERROR(ENOMEM);
+        AVFrameSideData *rotation;
+
+        ret = ff_frame_new_side_data(avctx, frame, AV_FRAME_DATA_DISPLAYMATRIX,
+                                     sizeof(int32_t) * 9, &rotation);
+        if (ret < 0)
+            return ret;
 
         /* av_display_rotation_set() expects the angle in the clockwise
          * direction, hence the first minus.
@@ -796,9 +797,11 @@ int ff_h2645_sei_to_frame(AVFrame *frame, H2645SEI *sei,
          * we can create display matrices as desired by negating
          * the degree once for every flip applied. */
         angle = -angle * (1 - 2 * !!o->hflip) * (1 - 2 * !!o->vflip);
-        av_display_rotation_set((int32_t *)rotation->data, angle);
-        av_display_matrix_flip((int32_t *)rotation->data,
-                                o->hflip, o->vflip);
+        if (rotation) {
+            av_display_rotation_set((int32_t *)rotation->data, angle);
+            av_display_matrix_flip((int32_t *)rotation->data,
+                                    o->hflip, o->vflip);
+        }
     }
 
     if (sei->a53_caption.buf_ref) {
@@ -819,9 +822,12 @@ FF_ENABLE_DEPRECATION_WARNINGS
         return ret;
 
     if (sei->afd.present) {
-        AVFrameSideData *sd = av_frame_new_side_data(frame, AV_FRAME_DATA_AFD,
-                                                     sizeof(uint8_t));
+        AVFrameSideData *sd;
 
+        ret = ff_frame_new_side_data(avctx, frame, AV_FRAME_DATA_AFD,
+                                     sizeof(uint8_t), &sd);
+        if (ret < 0)
+            return ret;
         if (sd) {
             *sd->data = sei->afd.active_format_description;
             sei->afd.present = 0;
@@ -1003,12 +1003,8 @@ void ff_hevc_hls_residual_coding(HEVCLocalContext *lc, const HEVCPPS *pps,
 
     const uint8_t *scan_x_cg, *scan_y_cg, *scan_x_off, *scan_y_off;
 
-    ptrdiff_t stride = s->cur_frame->f->linesize[c_idx];
-    int hshift = sps->hshift[c_idx];
-    int vshift = sps->vshift[c_idx];
-    uint8_t *dst = &s->cur_frame->f->data[c_idx][(y0 >> vshift) * stride +
-                                          ((x0 >> hshift) << sps->pixel_shift)];
-    int16_t *coeffs = (int16_t*)(c_idx ? lc->edge_emu_buffer2 : lc->edge_emu_buffer);
+    ReconBlock *const blk = ff_hevc_recon_block(lc, x0, y0, log2_trafo_size, c_idx);
+    int16_t *coeffs = ff_hevc_recon_coeffs(lc, blk);
     uint8_t significant_coeff_group_flag[8][8] = {{0}};
     int explicit_rdpcm_flag = 0;
     int explicit_rdpcm_dir_flag;
@@ -1022,8 +1018,6 @@ void ff_hevc_hls_residual_coding(HEVCLocalContext *lc, const HEVCPPS *pps,
     int pred_mode_intra = (c_idx == 0) ? lc->tu.intra_pred_mode :
                                          lc->tu.intra_pred_mode_c;
 
-    memset(coeffs, 0, trafo_size * trafo_size * sizeof(int16_t));
-
     // Derive QP for dequant
     if (!lc->cu.cu_transquant_bypass_flag) {
         static const int qp_c[] = { 29, 30, 31, 32, 33, 33, 34, 34, 35, 35, 36, 36, 37, 37 };
@@ -1436,38 +1430,29 @@ void ff_hevc_hls_residual_coding(HEVCLocalContext *lc, const HEVCPPS *pps,
         }
     }
 
+    blk->rdpcm = -1;
     if (lc->cu.cu_transquant_bypass_flag) {
+        blk->residual = RESIDUAL_BYPASS;
         if (explicit_rdpcm_flag || (sps->implicit_rdpcm_enabled &&
-                                    (pred_mode_intra == 10 || pred_mode_intra == 26))) {
-            int mode = sps->implicit_rdpcm_enabled ? (pred_mode_intra == 26) : explicit_rdpcm_dir_flag;
-
-            s->hevcdsp.transform_rdpcm(coeffs, log2_trafo_size, mode);
-        }
+                                    (pred_mode_intra == 10 || pred_mode_intra == 26)))
+            blk->rdpcm = sps->implicit_rdpcm_enabled ? (pred_mode_intra == 26) : explicit_rdpcm_dir_flag;
     } else {
         if (transform_skip_flag) {
-            int rot = sps->transform_skip_rotation_enabled &&
-                      log2_trafo_size == 2 &&
-                      lc->cu.pred_mode == MODE_INTRA;
-            if (rot) {
-                for (i = 0; i < 8; i++)
-                    FFSWAP(int16_t, coeffs[i], coeffs[16 - i - 1]);
-            }
-
-            s->hevcdsp.dequant(coeffs, log2_trafo_size);
+            blk->residual = RESIDUAL_SKIP;
+            blk->rotate   = sps->transform_skip_rotation_enabled &&
+                            log2_trafo_size == 2 &&
+                            lc->cu.pred_mode == MODE_INTRA;
 
             if (explicit_rdpcm_flag || (sps->implicit_rdpcm_enabled &&
                                         lc->cu.pred_mode == MODE_INTRA &&
-                                        (pred_mode_intra == 10 || pred_mode_intra == 26))) {
-                int mode = explicit_rdpcm_flag ? explicit_rdpcm_dir_flag : (pred_mode_intra == 26);
-
-                s->hevcdsp.transform_rdpcm(coeffs, log2_trafo_size, mode);
-            }
+                                        (pred_mode_intra == 10 || pred_mode_intra == 26)))
+                blk->rdpcm = explicit_rdpcm_flag ? explicit_rdpcm_dir_flag : (pred_mode_intra == 26);
         } else if (lc->cu.pred_mode == MODE_INTRA && c_idx == 0 && log2_trafo_size == 2) {
-            s->hevcdsp.transform_4x4_luma(coeffs);
+            blk->residual = RESIDUAL_DST;
         } else {
             int max_xy = FFMAX(last_significant_coeff_x, last_significant_coeff_y);
             if (max_xy == 0)
-                s->hevcdsp.idct_dc[log2_trafo_size - 2](coeffs);
+                blk->residual = RESIDUAL_IDCT_DC;
             else {
                 int col_limit = last_significant_coeff_x + last_significant_coeff_y + 4;
                 if (max_xy < 4)
@@ -1476,18 +1461,17 @@ void ff_hevc_hls_residual_coding(HEVCLocalContext *lc, const HEVCPPS *pps,
                     col_limit = FFMIN(8, col_limit);
                 else if (max_xy < 12)
                     col_limit = FFMIN(24, col_limit);
-                s->hevcdsp.idct[log2_trafo_size - 2](coeffs, col_limit);
+                blk->residual  = RESIDUAL_IDCT;
+                blk->col_limit = col_limit;
             }
         }
     }
     if (lc->tu.cross_pf) {
-        int16_t *coeffs_y = (int16_t*)lc->edge_emu_buffer;
-
-        for (i = 0; i < (trafo_size * trafo_size); i++) {
-            coeffs[i] = coeffs[i] + ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-        }
+        blk->res_scale_val = lc->tu.res_scale_val;
+        blk->coeffs_y      = lc->recon_coeffs_y;
     }
-    s->hevcdsp.add_residual[log2_trafo_size-2](dst, coeffs, stride);
+    if (c_idx == 0)
+        lc->recon_coeffs_y = blk->coeffs;
 }
 
 void ff_hevc_hls_mvd_coding(HEVCLocalContext *lc, int x0, int y0, int log2_cb_size)
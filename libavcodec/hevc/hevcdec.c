@@ -29,6 +29,7 @@
 #include "libavutil/avstring.h"
 #include "libavutil/common.h"
 #include "libavutil/container_fifo.h"
+#include "libavutil/crc.h"
 #include "libavutil/film_grain_params.h"
 #include "libavutil/internal.h"
 #include "libavutil/md5.h"
@@ -1323,6 +1324,150 @@ static int hls_cross_component_pred(HEVCLocalContext *lc, int idx)
     return 0;
 }
 
+ReconBlock *ff_hevc_recon_block(HEVCLocalContext *lc, int x0, int y0,
+                                int log2_size, int c_idx)
+{
+    ReconBlock *blk = &lc->recon_blocks[lc->nb_recon_blocks - 1];
+
+    // the residual of an intra block follows its prediction
+    if (lc->nb_recon_blocks && blk->x0 == x0 && blk->y0 == y0 &&
+        blk->c_idx == c_idx && blk->log2_size == log2_size &&
+        blk->residual == RESIDUAL_NONE)
+        return blk;
+
+    av_assert1(lc->nb_recon_blocks < MAX_RECON_BLOCKS);
+    blk = &lc->recon_blocks[lc->nb_recon_blocks++];
+    blk->x0            = x0;
+    blk->y0            = y0;
+    blk->c_idx         = c_idx;
+    blk->log2_size     = log2_size;
+    blk->intra_pred    = 0;
+    blk->residual      = RESIDUAL_NONE;
+    blk->rotate        = 0;
+    blk->rdpcm         = -1;
+    blk->res_scale_val = 0;
+    return blk;
+}
+
+int16_t *ff_hevc_recon_coeffs(HEVCLocalContext *lc, ReconBlock *blk)
+{
+    int16_t *coeffs = lc->recon_coeffs + lc->nb_recon_coeffs;
+    int size = 1 << (2 * blk->log2_size);
+
+    av_assert1(lc->nb_recon_coeffs + size <= FF_ARRAY_ELEMS(lc->recon_coeffs));
+    blk->coeffs          = lc->nb_recon_coeffs;
+    lc->nb_recon_coeffs += size;
+    memset(coeffs, 0, size * sizeof(*coeffs));
+    return coeffs;
+}
+
+static void intra_pred_block(HEVCLocalContext *lc, int x0, int y0,
+                             int log2_size, int c_idx)
+{
+    ReconBlock *blk = ff_hevc_recon_block(lc, x0, y0, log2_size, c_idx);
+
+    blk->intra_pred      = 1;
+    blk->intra_pred_mode = c_idx ? lc->tu.intra_pred_mode_c : lc->tu.intra_pred_mode;
+    blk->na              = lc->na;
+}
+
+static void cross_component_block(HEVCLocalContext *lc, int x0, int y0,
+                                  int log2_size, int c_idx)
+{
+    ReconBlock *blk;
+
+    if (!lc->tu.res_scale_val)
+        return;
+
+    blk = ff_hevc_recon_block(lc, x0, y0, log2_size, c_idx);
+    ff_hevc_recon_coeffs(lc, blk);
+    blk->residual      = RESIDUAL_BYPASS;
+    blk->res_scale_val = lc->tu.res_scale_val;
+    blk->coeffs_y      = lc->recon_coeffs_y;
+}
+
+static void transform_block(const HEVCContext *s, HEVCLocalContext *lc,
+                            const ReconBlock *blk)
+{
+    int16_t *coeffs = lc->recon_coeffs + blk->coeffs;
+    int log2_size   = blk->log2_size;
+
+    switch (blk->residual) {
+    case RESIDUAL_SKIP:
+        if (blk->rotate) {
+            for (int i = 0; i < 8; i++)
+                FFSWAP(int16_t, coeffs[i], coeffs[16 - i - 1]);
+        }
+        s->hevcdsp.dequant(coeffs, log2_size);
+        break;
+    case RESIDUAL_DST:
+        s->hevcdsp.transform_4x4_luma(coeffs);
+        break;
+    case RESIDUAL_IDCT_DC:
+        s->hevcdsp.idct_dc[log2_size - 2](coeffs);
+        break;
+    case RESIDUAL_IDCT:
+        s->hevcdsp.idct[log2_size - 2](coeffs, blk->col_limit);
+        break;
+    }
+    if (blk->rdpcm >= 0)
+        s->hevcdsp.transform_rdpcm(coeffs, log2_size, blk->rdpcm);
+
+    if (blk->res_scale_val) {
+        const int16_t *coeffs_y = lc->recon_coeffs + blk->coeffs_y;
+
+        for (int i = 0; i < 1 << (2 * log2_size); i++)
+            coeffs[i] += (blk->res_scale_val * coeffs_y[i]) >> 3;
+    }
+}
+
+/**
+ * Reconstruct the blocks queued since the last call. The residuals do not
+ * depend on the picture, so all inverse transforms are run first; the
+ * predictions and additions then follow in decoding order.
+ */
+static void hls_reconstruct(HEVCLocalContext *lc, const HEVCPPS *pps)
+{
+    const HEVCContext *const s = lc->parent;
+    const HEVCSPS   *const sps = pps->sps;
+    const AVFrame *const frame = s->cur_frame->f;
+    // intra_pred() takes its mode and neighbours from lc
+    const NeighbourAvailable na = lc->na;
+    const int intra_pred_mode   = lc->tu.intra_pred_mode;
+    const int intra_pred_mode_c = lc->tu.intra_pred_mode_c;
+
+    for (int i = 0; i < lc->nb_recon_blocks; i++) {
+        const ReconBlock *blk = &lc->recon_blocks[i];
+        if (blk->residual != RESIDUAL_NONE)
+            transform_block(s, lc, blk);
+    }
+
+    for (int i = 0; i < lc->nb_recon_blocks; i++) {
+        const ReconBlock *blk = &lc->recon_blocks[i];
+        const int c_idx       = blk->c_idx;
+
+        if (blk->intra_pred) {
+            lc->na                   = blk->na;
+            lc->tu.intra_pred_mode   = blk->intra_pred_mode;
+            lc->tu.intra_pred_mode_c = blk->intra_pred_mode;
+            s->hpc.intra_pred[blk->log2_size - 2](lc, pps, blk->x0, blk->y0, c_idx);
+        }
+        if (blk->residual != RESIDUAL_NONE) {
+            ptrdiff_t stride = frame->linesize[c_idx];
+            uint8_t *dst = &frame->data[c_idx][(blk->y0 >> sps->vshift[c_idx]) * stride +
+                                               ((blk->x0 >> sps->hshift[c_idx]) << sps->pixel_shift)];
+
+            s->hevcdsp.add_residual[blk->log2_size - 2](dst, lc->recon_coeffs + blk->coeffs, stride);
+        }
+    }
+
+    lc->nb_recon_blocks      = 0;
+    lc->nb_recon_coeffs      = 0;
+    lc->na                   = na;
+    lc->tu.intra_pred_mode   = intra_pred_mode;
+    lc->tu.intra_pred_mode_c = intra_pred_mode_c;
+}
+
 static int hls_transform_unit(HEVCLocalContext *lc,
                               const HEVCLayerContext *l,
                               const HEVCPPS *pps, const HEVCSPS *sps,
@@ -1339,7 +1484,7 @@ static int hls_transform_unit(HEVCLocalContext *lc,
         int trafo_size = 1 << log2_trafo_size;
         ff_hevc_set_neighbour_available(lc, x0, y0, trafo_size, trafo_size, sps->log2_ctb_size);
 
-        s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, x0, y0, 0);
+        intra_pred_block(lc, x0, y0, log2_trafo_size, 0);
     }
 
     if (cbf_luma || cbf_cb[0] || cbf_cr[0] ||
@@ -1426,27 +1571,14 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                 if (lc->cu.pred_mode == MODE_INTRA) {
                     ff_hevc_set_neighbour_available(lc, x0, y0 + (i << log2_trafo_size_c),
                                                     trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                    s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0 + (i << log2_trafo_size_c), 1);
+                    intra_pred_block(lc, x0, y0 + (i << log2_trafo_size_c), log2_trafo_size_c, 1);
                 }
                 if (cbf_cb[i])
                     ff_hevc_hls_residual_coding(lc, pps, x0, y0 + (i << log2_trafo_size_c),
                                                 log2_trafo_size_c, scan_idx_c, 1);
-                else
-                    if (lc->tu.cross_pf) {
-                        ptrdiff_t stride = s->cur_frame->f->linesize[1];
-                        int hshift = sps->hshift[1];
-                        int vshift = sps->vshift[1];
-                        const int16_t *coeffs_y = (int16_t*)lc->edge_emu_buffer;
-                        int16_t *coeffs   = (int16_t*)lc->edge_emu_buffer2;
-                        int size = 1 << log2_trafo_size_c;
-
-                        uint8_t *dst = &s->cur_frame->f->data[1][(y0 >> vshift) * stride +
-                                                              ((x0 >> hshift) << sps->pixel_shift)];
-                        for (i = 0; i < (size * size); i++) {
-                            coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-                        }
-                        s->hevcdsp.add_residual[log2_trafo_size_c-2](dst, coeffs, stride);
-                    }
+                else if (lc->tu.cross_pf)
+                    cross_component_block(lc, x0, y0 + (i << log2_trafo_size_c),
+                                          log2_trafo_size_c, 1);
             }
 
             if (lc->tu.cross_pf) {
@@ -1456,27 +1588,14 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                 if (lc->cu.pred_mode == MODE_INTRA) {
                     ff_hevc_set_neighbour_available(lc, x0, y0 + (i << log2_trafo_size_c),
                                                     trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                    s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0 + (i << log2_trafo_size_c), 2);
+                    intra_pred_block(lc, x0, y0 + (i << log2_trafo_size_c), log2_trafo_size_c, 2);
                 }
                 if (cbf_cr[i])
                     ff_hevc_hls_residual_coding(lc, pps, x0, y0 + (i << log2_trafo_size_c),
                                                 log2_trafo_size_c, scan_idx_c, 2);
-                else
-                    if (lc->tu.cross_pf) {
-                        ptrdiff_t stride = s->cur_frame->f->linesize[2];
-                        int hshift = sps->hshift[2];
-                        int vshift = sps->vshift[2];
-                        const int16_t *coeffs_y = (int16_t*)lc->edge_emu_buffer;
-                        int16_t *coeffs   = (int16_t*)lc->edge_emu_buffer2;
-                        int size = 1 << log2_trafo_size_c;
-
-                        uint8_t *dst = &s->cur_frame->f->data[2][(y0 >> vshift) * stride +
-                                                          ((x0 >> hshift) << sps->pixel_shift)];
-                        for (i = 0; i < (size * size); i++) {
-                            coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-                        }
-                        s->hevcdsp.add_residual[log2_trafo_size_c-2](dst, coeffs, stride);
-                    }
+                else if (lc->tu.cross_pf)
+                    cross_component_block(lc, x0, y0 + (i << log2_trafo_size_c),
+                                          log2_trafo_size_c, 2);
             }
         } else if (sps->chroma_format_idc && blk_idx == 3) {
             int trafo_size_h = 1 << (log2_trafo_size + 1);
@@ -1485,7 +1604,7 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                 if (lc->cu.pred_mode == MODE_INTRA) {
                     ff_hevc_set_neighbour_available(lc, xBase, yBase + (i << log2_trafo_size),
                                                     trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                    s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase + (i << log2_trafo_size), 1);
+                    intra_pred_block(lc, xBase, yBase + (i << log2_trafo_size), log2_trafo_size, 1);
                 }
                 if (cbf_cb[i])
                     ff_hevc_hls_residual_coding(lc, pps, xBase, yBase + (i << log2_trafo_size),
@@ -1495,7 +1614,7 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                 if (lc->cu.pred_mode == MODE_INTRA) {
                     ff_hevc_set_neighbour_available(lc, xBase, yBase + (i << log2_trafo_size),
                                                 trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                    s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase + (i << log2_trafo_size), 2);
+                    intra_pred_block(lc, xBase, yBase + (i << log2_trafo_size), log2_trafo_size, 2);
                 }
                 if (cbf_cr[i])
                     ff_hevc_hls_residual_coding(lc, pps, xBase, yBase + (i << log2_trafo_size),
@@ -1508,26 +1627,26 @@ static int hls_transform_unit(HEVCLocalContext *lc,
             int trafo_size_v = 1 << (log2_trafo_size_c + sps->vshift[1]);
             ff_hevc_set_neighbour_available(lc, x0, y0, trafo_size_h, trafo_size_v,
                                             sps->log2_ctb_size);
-            s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0, 1);
-            s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0, 2);
+            intra_pred_block(lc, x0, y0, log2_trafo_size_c, 1);
+            intra_pred_block(lc, x0, y0, log2_trafo_size_c, 2);
             if (sps->chroma_format_idc == 2) {
                 ff_hevc_set_neighbour_available(lc, x0, y0 + (1 << log2_trafo_size_c),
                                                 trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0 + (1 << log2_trafo_size_c), 1);
-                s->hpc.intra_pred[log2_trafo_size_c - 2](lc, pps, x0, y0 + (1 << log2_trafo_size_c), 2);
+                intra_pred_block(lc, x0, y0 + (1 << log2_trafo_size_c), log2_trafo_size_c, 1);
+                intra_pred_block(lc, x0, y0 + (1 << log2_trafo_size_c), log2_trafo_size_c, 2);
             }
         } else if (blk_idx == 3) {
             int trafo_size_h = 1 << (log2_trafo_size + 1);
             int trafo_size_v = 1 << (log2_trafo_size + sps->vshift[1]);
             ff_hevc_set_neighbour_available(lc, xBase, yBase,
                                             trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-            s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase, 1);
-            s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase, 2);
+            intra_pred_block(lc, xBase, yBase, log2_trafo_size, 1);
+            intra_pred_block(lc, xBase, yBase, log2_trafo_size, 2);
             if (sps->chroma_format_idc == 2) {
                 ff_hevc_set_neighbour_available(lc, xBase, yBase + (1 << log2_trafo_size),
                                                 trafo_size_h, trafo_size_v, sps->log2_ctb_size);
-                s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase + (1 << log2_trafo_size), 1);
-                s->hpc.intra_pred[log2_trafo_size - 2](lc, pps, xBase, yBase + (1 << log2_trafo_size), 2);
+                intra_pred_block(lc, xBase, yBase + (1 << log2_trafo_size), log2_trafo_size, 1);
+                intra_pred_block(lc, xBase, yBase + (1 << log2_trafo_size), log2_trafo_size, 2);
             }
         }
     }
@@ -2625,6 +2744,10 @@ static int hls_coding_unit(HEVCLocalContext *lc, const HEVCContext *s,
 
     set_ct_depth(sps, l->tab_ct_depth, x0, y0, log2_cb_size, lc->ct_depth);
 
+    // the following CUs may predict from this one through the current picture
+    if (pps->pps_curr_pic_ref_enabled_flag)
+        hls_reconstruct(lc, pps);
+
     return 0;
 }
 
@@ -2808,6 +2931,7 @@ static int hls_decode_entry(HEVCContext *s, GetBitContext *gb)
         l->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
 
         more_data = hls_coding_quadtree(lc, l, pps, sps, x_ctb, y_ctb, sps->log2_ctb_size, 0);
+        hls_reconstruct(lc, pps);
         if (more_data < 0) {
             l->tab_slice_address[ctb_addr_rs] = -1;
             return more_data;
@@ -2879,6 +3003,7 @@ static int hls_decode_entry_wpp(AVCodecContext *avctx, void *hevc_lclist,
         l->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
 
         more_data = hls_coding_quadtree(lc, l, pps, sps, x_ctb, y_ctb, sps->log2_ctb_size, 0);
+        hls_reconstruct(lc, pps);
 
         if (more_data < 0) {
             ret = more_data;
@@ -3437,74 +3562,179 @@ fail:
     return ret;
 }
 
-static int verify_md5(HEVCContext *s, AVFrame *frame)
+typedef struct PictureHashContext {
+    HEVCContext *s;
+    const AVFrame *frame;
+    const AVPixFmtDescriptor *desc;
+    int pixel_shift;
+    size_t buf_stride;
+    uint8_t md5[3][16];
+    uint32_t hash[3];   ///< CRC or checksum
+} PictureHashContext;
+
+/* picture_checksum of the decoded picture hash SEI; the xor mask is the
+ * same for both bytes of a sample, so this works in native byte order */
+static uint32_t checksum_row(const uint8_t *src, int w, int y, int pixel_shift)
 {
-    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    const int y_mask = (y & 0xFF) ^ (y >> 8);
+    uint32_t sum = 0;
+
+    // x >> 8 is constant within blocks of 256 samples
+    for (int x0 = 0; x0 < w; x0 += 256) {
+        const int mask = y_mask ^ (x0 >> 8);
+        const int n    = FFMIN(w - x0, 256) << pixel_shift;
+        const uint8_t *p = src + (x0 << pixel_shift);
+
+        for (int i = 0; i < n; i++)
+            sum += p[i] ^ ((i >> pixel_shift) ^ mask);
+    }
+    return sum;
+}
+
+static int hash_plane(AVCodecContext *avctx, void *arg, int plane, int threadnr)
+{
+    PictureHashContext *ctx = arg;
+    HEVCContext *s          = ctx->s;
+    const AVFrame *frame    = ctx->frame;
+    const int pixel_shift   = ctx->pixel_shift;
+    const int hash_type     = s->sei.picture_hash.hash_type;
+    const AVCRC *crc_tab    = av_crc_get_table(AV_CRC_16_CCITT);
+    int width  = s->avctx->coded_width;
+    int height = s->avctx->coded_height;
+    int w = (plane == 1 || plane == 2) ? (width  >> ctx->desc->log2_chroma_w) : width;
+    int h = (plane == 1 || plane == 2) ? (height >> ctx->desc->log2_chroma_h) : height;
+    /* The CRC is CRC-16/CCITT over the picture followed by 16 zero bits
+     * with an initial value of 0xFFFF, which equals the plain CRC with
+     * an initial value of 0x1D0F. */
+    uint32_t hash = hash_type == 1 ? av_bswap16(0x1D0F) : 0;
+
+    if (hash_type == 0)
+        av_md5_init(s->md5_ctx[plane]);
+    for (int j = 0; j < h; j++) {
+        const uint8_t *src = frame->data[plane] + j * frame->linesize[plane];
+
+        if (hash_type == 2) {
+            hash += checksum_row(src, w, j, pixel_shift);
+            continue;
+        }
+#if HAVE_BIGENDIAN
+        if (pixel_shift) {
+            uint8_t *buf = s->checksum_buf + plane * ctx->buf_stride;
+            s->bdsp.bswap16_buf((uint16_t *) buf, (const uint16_t *) src, w);
+            src = buf;
+        }
+#endif
+        if (hash_type == 0)
+            av_md5_update(s->md5_ctx[plane], src, w << pixel_shift);
+        else
+            hash = av_crc(crc_tab, hash, src, w << pixel_shift);
+    }
+
+    if (hash_type == 0)
+        av_md5_final(s->md5_ctx[plane], ctx->md5[plane]);
+    else
+        ctx->hash[plane] = hash_type == 1 ? av_bswap16(hash) : hash;
+    return 0;
+}
+
+/* With no reordering the picture has already been queued for output by
+ * hevc_frame_start(), so flag the queued copy too. */
+static void flag_queued_frame(HEVCContext *s, const HEVCFrame *out, int flags)
+{
+    const AVFrame *src = out->needs_fg ? out->frame_grain : out->f;
+
+    for (size_t i = 0; i < av_container_fifo_can_read(s->output_fifo); i++) {
+        AVFrame *f;
+
+        if (av_container_fifo_peek(s->output_fifo, (void **)&f, i) < 0)
+            break;
+        if (f->data[0] == src->data[0])
+            f->decode_error_flags |= flags;
+    }
+}
+
+static int verify_picture_hash(HEVCContext *s, HEVCFrame *out)
+{
+    static const char *const hash_names[] = { "MD5", "CRC", "checksum" };
+    AVFrame *frame = out->f;
+    const HEVCSEIPictureHash *sei = &s->sei.picture_hash;
+    PictureHashContext ctx = {
+        .s     = s,
+        .frame = frame,
+        .desc  = av_pix_fmt_desc_get(frame->format),
+    };
     char msg_buf[4 * (50 + 2 * 2 * 16 /* MD5-size */)];
-    int pixel_shift;
+    int nb_planes;
     int err = 0;
-    int i, j;
+    int i;
 
-    if (!desc)
+    if (!ctx.desc)
         return AVERROR(EINVAL);
 
-    pixel_shift = desc->comp[0].depth > 8;
+    ctx.pixel_shift = ctx.desc->comp[0].depth > 8;
+    for (nb_planes = 0; nb_planes < 3 && frame->data[nb_planes]; nb_planes++)
+        /* nothing */;
 
     /* the checksums are LE, so we have to byteswap for >8bpp formats
      * on BE arches */
 #if HAVE_BIGENDIAN
-    if (pixel_shift && !s->checksum_buf) {
+    if (ctx.pixel_shift && sei->hash_type != 2) {
+        ctx.buf_stride = FFMAX3(frame->linesize[0], frame->linesize[1],
+                                frame->linesize[2]);
         av_fast_malloc(&s->checksum_buf, &s->checksum_buf_size,
-                       FFMAX3(frame->linesize[0], frame->linesize[1],
-                              frame->linesize[2]));
+                       nb_planes * ctx.buf_stride);
         if (!s->checksum_buf)
             return AVERROR(ENOMEM);
     }
 #endif
 
-    msg_buf[0] = '\0';
-    for (i = 0; frame->data[i]; i++) {
-        int width  = s->avctx->coded_width;
-        int height = s->avctx->coded_height;
-        int w = (i == 1 || i == 2) ? (width  >> desc->log2_chroma_w) : width;
-        int h = (i == 1 || i == 2) ? (height >> desc->log2_chroma_h) : height;
-        uint8_t md5[16];
-
-        av_md5_init(s->md5_ctx);
-        for (j = 0; j < h; j++) {
-            const uint8_t *src = frame->data[i] + j * frame->linesize[i];
-#if HAVE_BIGENDIAN
-            if (pixel_shift) {
-                s->bdsp.bswap16_buf((uint16_t *) s->checksum_buf,
-                                    (const uint16_t *) src, w);
-                src = s->checksum_buf;
-            }
-#endif
-            av_md5_update(s->md5_ctx, src, w << pixel_shift);
-        }
-        av_md5_final(s->md5_ctx, md5);
+    /* the planes are independent, hash them on the slice threads if any */
+    s->avctx->execute2(s->avctx, hash_plane, &ctx, NULL, nb_planes);
 
+    msg_buf[0] = '\0';
+    for (i = 0; i < nb_planes; i++) {
 #define MD5_PRI "%016" PRIx64 "%016" PRIx64
 #define MD5_PRI_ARG(buf) AV_RB64(buf), AV_RB64((const uint8_t*)(buf) + 8)
 
-        if (!memcmp(md5, s->sei.picture_hash.md5[i], 16)) {
-            av_strlcatf(msg_buf, sizeof(msg_buf),
-                        "plane %d - correct " MD5_PRI "; ",
-                        i, MD5_PRI_ARG(md5));
+        if (sei->hash_type == 0) {
+            if (!memcmp(ctx.md5[i], sei->md5[i], 16)) {
+                av_strlcatf(msg_buf, sizeof(msg_buf),
+                            "plane %d - correct " MD5_PRI "; ",
+                            i, MD5_PRI_ARG(ctx.md5[i]));
+            } else {
+                av_strlcatf(msg_buf, sizeof(msg_buf),
+                           "mismatching checksum of plane %d - " MD5_PRI " != " MD5_PRI "; ",
+                            i, MD5_PRI_ARG(ctx.md5[i]), MD5_PRI_ARG(sei->md5[i]));
+                err = AVERROR_INVALIDDATA;
+            }
         } else {
-            av_strlcatf(msg_buf, sizeof(msg_buf),
-                       "mismatching checksum of plane %d - " MD5_PRI " != " MD5_PRI "; ",
-                        i, MD5_PRI_ARG(md5), MD5_PRI_ARG(s->sei.picture_hash.md5[i]));
-            err = AVERROR_INVALIDDATA;
+            uint32_t expected = sei->hash_type == 1 ? sei->crc[i] : sei->checksum[i];
+
+            if (ctx.hash[i] == expected) {
+                av_strlcatf(msg_buf, sizeof(msg_buf),
+                            "plane %d - correct %08"PRIx32"; ", i, ctx.hash[i]);
+            } else {
+                av_strlcatf(msg_buf, sizeof(msg_buf),
+                            "mismatching checksum of plane %d - %08"PRIx32" != %08"PRIx32"; ",
+                            i, ctx.hash[i], expected);
+                err = AVERROR_INVALIDDATA;
+            }
         }
     }
 
+    if (err < 0) {
+        frame->decode_error_flags |= FF_DECODE_ERROR_INVALID_BITSTREAM;
+        if (out->needs_fg)
+            out->frame_grain->decode_error_flags |= FF_DECODE_ERROR_INVALID_BITSTREAM;
+        flag_queued_frame(s, out, FF_DECODE_ERROR_INVALID_BITSTREAM);
+    }
+
     av_log(s->avctx, err < 0 ? AV_LOG_ERROR : AV_LOG_DEBUG,
-           "Verifying checksum for frame with POC %d: %s\n",
-           s->poc, msg_buf);
+           "Verifying %s for frame with POC %d: %s\n",
+           hash_names[sei->hash_type], s->poc, msg_buf);
 
     return err;
-    }
+}
 
 static int hevc_frame_end(HEVCContext *s, HEVCLayerContext *l)
 {
@@ -3539,13 +3769,13 @@ static int hevc_frame_end(HEVCContext *s, HEVCLayerContext *l)
         }
     } else {
         if (s->avctx->err_recognition & AV_EF_CRCCHECK &&
-            s->sei.picture_hash.is_md5) {
-            ret = verify_md5(s, out->f);
+            s->sei.picture_hash.present) {
+            ret = verify_picture_hash(s, out);
             if (ret < 0 && s->avctx->err_recognition & AV_EF_EXPLODE)
                 return ret;
         }
     }
-    s->sei.picture_hash.is_md5 = 0;
+    s->sei.picture_hash.present = 0;
 
     av_log(s->avctx, AV_LOG_DEBUG, "Decoded frame with POC %zu/%d.\n",
            l - s->layers, s->poc);
@@ -3958,7 +4188,8 @@ static av_cold int hevc_decode_free(AVCodecContext *avctx)
     ff_dovi_ctx_unref(&s->dovi_ctx);
     av_buffer_unref(&s->rpu_buf);
 
-    av_freep(&s->md5_ctx);
+    for (int i = 0; i < FF_ARRAY_ELEMS(s->md5_ctx); i++)
+        av_freep(&s->md5_ctx[i]);
 
 
     ff_hevc_output_frame_construction_ctx_unref(s);
@@ -4029,9 +4260,11 @@ static av_cold int hevc_init_context(AVCodecContext *avctx)
         }
     }
 
-    s->md5_ctx = av_md5_alloc();
-    if (!s->md5_ctx)
-        return AVERROR(ENOMEM);
+    for (int i = 0; i < FF_ARRAY_ELEMS(s->md5_ctx); i++) {
+        s->md5_ctx[i] = av_md5_alloc();
+        if (!s->md5_ctx[i])
+            return AVERROR(ENOMEM);
+    }
 
     ff_bswapdsp_init(&s->bdsp);
 
@@ -181,6 +181,15 @@ enum ScanType {
     SCAN_VERT,
 };
 
+enum ResidualType {
+    RESIDUAL_NONE = 0,
+    RESIDUAL_BYPASS,    ///< the coefficients are the residual
+    RESIDUAL_SKIP,      ///< transform_skip_flag
+    RESIDUAL_DST,       ///< 4x4 intra luma
+    RESIDUAL_IDCT_DC,
+    RESIDUAL_IDCT,
+};
+
 typedef struct HEVCCABACState {
     uint8_t state[HEVC_CONTEXTS];
     uint8_t stat_coeff[HEVC_STAT_COEFFS];
@@ -348,6 +357,31 @@ typedef struct TransformUnit {
     uint8_t cross_pf;
 } TransformUnit;
 
+/**
+ * A prediction and/or residual block of the current CTB, queued while the
+ * CTB is parsed and reconstructed once it is complete.
+ */
+typedef struct ReconBlock {
+    int x0, y0;
+    uint8_t c_idx;
+    uint8_t log2_size;
+
+    uint8_t intra_pred;
+    uint8_t intra_pred_mode;
+    NeighbourAvailable na;
+
+    uint8_t residual;       ///< enum ResidualType
+    uint8_t rotate;
+    int8_t  rdpcm;          ///< rdpcm direction, -1 if rdpcm is not used
+    uint8_t col_limit;
+    int8_t  res_scale_val;  ///< cross-component prediction from coeffs_y
+    int     coeffs;         ///< offset of the coefficients in recon_coeffs
+    int     coeffs_y;
+} ReconBlock;
+
+/* at most one prediction/residual block per 4x4 block of each component */
+#define MAX_RECON_BLOCKS (3 * MAX_PB_SIZE * MAX_PB_SIZE / 16)
+
 typedef struct DBParams {
     int beta_offset;
     int tc_offset;
@@ -442,6 +476,14 @@ typedef struct HEVCLocalContext {
     PredictionUnit pu;
     NeighbourAvailable na;
 
+    /* The blocks of the current CTB are parsed first and reconstructed
+     * together, so that the inverse transforms run back to back. */
+    ReconBlock recon_blocks[MAX_RECON_BLOCKS];
+    int nb_recon_blocks;
+    int nb_recon_coeffs;
+    int recon_coeffs_y;
+    DECLARE_ALIGNED(32, int16_t, recon_coeffs)[3 * MAX_PB_SIZE * MAX_PB_SIZE];
+
 #define BOUNDARY_LEFT_SLICE     (1 << 0)
 #define BOUNDARY_LEFT_TILE      (1 << 1)
 #define BOUNDARY_UPPER_SLICE    (1 << 2)
@@ -522,7 +564,7 @@ typedef struct HEVCContext {
 
     HEVCParamSets ps;
     HEVCSEI sei;
-    struct AVMD5 *md5_ctx;
+    struct AVMD5 *md5_ctx[3];
 
     /// candidate references for the current frame
     RefPicList rps[NB_RPS_TYPE];
@@ -728,6 +770,9 @@ int ff_hevc_cu_qp_delta_sign_flag(HEVCLocalContext *lc);
 int ff_hevc_cu_qp_delta_abs(HEVCLocalContext *lc);
 int ff_hevc_cu_chroma_qp_offset_flag(HEVCLocalContext *lc);
 int ff_hevc_cu_chroma_qp_offset_idx(HEVCLocalContext *lc, int chroma_qp_offset_list_len_minus1);
+ReconBlock *ff_hevc_recon_block(HEVCLocalContext *lc, int x0, int y0,
+                                int log2_size, int c_idx);
+int16_t *ff_hevc_recon_coeffs(HEVCLocalContext *lc, ReconBlock *blk);
 void ff_hevc_hls_residual_coding(HEVCLocalContext *lc, const HEVCPPS *pps,
                                  int x0, int y0,
                                  int log2_trafo_size, enum ScanType scan_idx,
@@ -63,7 +63,7 @@ typedef struct HEVCOutputFrameConstructionContext {
     uint64_t output_poc_ooorder_counter;
 } HEVCOutputFrameConstructionContext;
 
-static void hevc_output_frame_construction_ctx_free(FFRefStructOpaque opaque, void *obj)
+static void hevc_output_frame_construction_ctx_free(AVRefStructOpaque opaque, void *obj)
 {
     HEVCOutputFrameConstructionContext * ctx = (HEVCOutputFrameConstructionContext *)obj;
 
@@ -84,7 +84,7 @@ int ff_hevc_output_frame_construction_ctx_alloc(HEVCContext *s)
     }
 
     s->output_frame_construction_ctx =
-        ff_refstruct_alloc_ext(sizeof(*(s->output_frame_construction_ctx)),
+        av_refstruct_alloc_ext(sizeof(*(s->output_frame_construction_ctx)),
                                0, NULL, hevc_output_frame_construction_ctx_free);
     if (!s->output_frame_construction_ctx)
         return AVERROR(ENOMEM);
@@ -96,14 +96,14 @@ int ff_hevc_output_frame_construction_ctx_alloc(HEVCContext *s)
 
 void ff_hevc_output_frame_construction_ctx_replace(HEVCContext *dst, HEVCContext *src)
 {
-    ff_refstruct_replace(&dst->output_frame_construction_ctx,
+    av_refstruct_replace(&dst->output_frame_construction_ctx,
                          src->output_frame_construction_ctx);
 }
 
 void ff_hevc_output_frame_construction_ctx_unref(HEVCContext *s)
 {
     if (s->output_frame_construction_ctx &&
-        ff_refstruct_exclusive(s->output_frame_construction_ctx)) {
+        av_refstruct_exclusive(s->output_frame_construction_ctx)) {
 
         HEVCOutputFrameConstructionContext * ctx = s->output_frame_construction_ctx;
 
@@ -127,7 +127,7 @@ void ff_hevc_output_frame_construction_ctx_unref(HEVCContext *s)
        av_assert0(ff_mutex_unlock(&ctx->mutex) == 0);
     }
 
-    ff_refstruct_unref(&s->output_frame_construction_ctx);
+    av_refstruct_unref(&s->output_frame_construction_ctx);
 }
 
 void ff_hevc_unref_frame(HEVCFrame *frame, int flags)
@@ -231,13 +231,14 @@ static HEVCFrame *alloc_frame(HEVCContext *s, HEVCLayerContext *l)
         // add view ID side data if it's nontrivial
         if (!ff_hevc_is_alpha_video(s) && (vps->nb_layers > 1 || view_id)) {
             HEVCSEITDRDI *tdrdi = &s->sei.tdrdi;
-            AVFrameSideData *sd = av_frame_side_data_new(&frame->f->side_data,
-                                                         &frame->f->nb_side_data,
-                                                         AV_FRAME_DATA_VIEW_ID,
-                                                         sizeof(int), 0);
-            if (!sd)
+            AVFrameSideData *sd;
+
+            ret = ff_frame_new_side_data(s->avctx, frame->f, AV_FRAME_DATA_VIEW_ID,
+                                         sizeof(int), &sd);
+            if (ret < 0)
                 goto fail;
-            *(int*)sd->data = view_id;
+            if (sd)
+                *(int*)sd->data = view_id;
 
             if (tdrdi->num_ref_displays) {
                 AVStereo3D *stereo_3d;
@@ -714,7 +715,7 @@ int ff_hevc_output_frames(HEVCContext *s,
                     }
                     s->output_frame_construction_ctx->output_poc = output_poc;
 
-                    ret = ff_container_fifo_write(s->output_fifo, output_frame);
+                    ret = av_container_fifo_write(s->output_fifo, output_frame, AV_CONTAINER_FIFO_FLAG_REF);
                 }
 /*
                 if (frame->flags & HEVC_FRAME_FLAG_CORRUPT)
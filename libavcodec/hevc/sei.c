@@ -32,20 +32,21 @@ static int decode_nal_sei_decoded_picture_hash(HEVCSEIPictureHash *s,
 {
     int cIdx;
     uint8_t hash_type;
-    //uint16_t picture_crc;
-    //uint32_t picture_checksum;
     hash_type = bytestream2_get_byte(gb);
+    if (hash_type > 2)
+        return 0;
 
     for (cIdx = 0; cIdx < 3/*((s->sps->chroma_format_idc == 0) ? 1 : 3)*/; cIdx++) {
         if (hash_type == 0) {
-            s->is_md5 = 1;
             bytestream2_get_buffer(gb, s->md5[cIdx], sizeof(s->md5[cIdx]));
         } else if (hash_type == 1) {
-            // picture_crc = get_bits(gb, 16);
+            s->crc[cIdx] = bytestream2_get_be16(gb);
         } else if (hash_type == 2) {
-            // picture_checksum = get_bits_long(gb, 32);
+            s->checksum[cIdx] = bytestream2_get_be32(gb);
         }
     }
+    s->hash_type = hash_type;
+    s->present   = 1;
     return 0;
 }
 
@@ -163,8 +163,11 @@ static inline int ff_hevc_sei_pict_struct_is_frame_picture(HEVC_SEI_PicStructTyp
 
 
 typedef struct HEVCSEIPictureHash {
-    uint8_t       md5[3][16];
-    uint8_t is_md5;
+    uint8_t  md5[3][16];
+    uint16_t crc[3];
+    uint32_t checksum[3];
+    uint8_t  hash_type;     ///< 0: MD5, 1: CRC, 2: checksum
+    uint8_t  present;
 } HEVCSEIPictureHash;
 
 typedef struct HEVCSEIFramePacking {
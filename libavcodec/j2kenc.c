@@ -109,6 +109,23 @@ typedef struct {
    double *layer_rates;
 } Jpeg2000Tile;
 
+/** A single code-block to be tier-1 coded by one of the slice threads */
+typedef struct Jpeg2000CblkJob {
+    const Jpeg2000Component *comp;
+    const Jpeg2000Band *band;
+    Jpeg2000Cblk *cblk;
+    int x0, y0;         ///< position of the code-block in comp->i_data
+    int width, height;
+    int bandpos;
+    int64_t lambda;     ///< slope used for truncation, unused with layer rates
+} Jpeg2000CblkJob;
+
+/** Per thread tier-1 state and the slope range of the passes it coded */
+typedef struct Jpeg2000ThreadContext {
+    Jpeg2000T1Context t1;
+    double slope_min, slope_max;
+} Jpeg2000ThreadContext;
+
 typedef struct {
     AVClass *class;
     AVCodecContext *avctx;
@@ -144,6 +161,12 @@ typedef struct {
     int prog;
     int nlayers;
     char *lr_str;
+
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned int cblk_jobs_allocated;
+    Jpeg2000ThreadContext *thread;
+    int nb_threads;
+    int *dwt_ret;       ///< per component DWT result, ncomponents entries
 } Jpeg2000EncoderContext;
 
 
@@ -704,8 +727,8 @@ static void encode_clnpass(Jpeg2000T1Context *t1, int width, int height, int ban
         }
 }
 
-static void encode_cblk(Jpeg2000EncoderContext *s, Jpeg2000T1Context *t1, Jpeg2000Cblk *cblk, Jpeg2000Tile *tile,
-                        int width, int height, int bandpos, int lev)
+static void encode_cblk(Jpeg2000T1Context *t1, Jpeg2000Cblk *cblk,
+                        int width, int height, int bandpos)
 {
     int pass_t = 2, passno, x, y, max=0, nmsedec, bpno;
     int64_t wmsedec = 0;
@@ -1213,27 +1236,12 @@ static void makelayer(Jpeg2000EncoderContext *s, int layno, double thresh, Jpeg2
                         if (thresh < 0) {
                             n = cblk->npasses;
                         } else {
+                            /* hull slopes decrease, take the last point at or
+                             * above the threshold */
                             for (passno = cblk->ninclpasses; passno < cblk->npasses; passno++) {
-                                int32_t dr;
-                                double dd;
-                                Jpeg2000Pass *pass = &cblk->passes[passno];
-
-                                if (n == 0) {
-                                    dr = pass->rate;
-                                    dd = pass->disto;
-                                } else {
-                                    dr = pass->rate - cblk->passes[n - 1].rate;
-                                    dd = pass->disto - cblk->passes[n-1].disto;
-                                }
-
-                                if (!dr) {
-                                    if (dd != 0.0) {
-                                        n = passno + 1;
-                                    }
-                                    continue;
-                                }
-
-                                if (thresh - (dd / dr) < DBL_EPSILON)
+                                double slope = cblk->passes[passno].slope;
+
+                                if (slope > 0 && thresh - slope < DBL_EPSILON)
                                     n = passno + 1;
                             }
                         }
@@ -1268,54 +1276,15 @@ static void makelayer(Jpeg2000EncoderContext *s, int layno, double thresh, Jpeg2
 
 static void makelayers(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
 {
-    int precno, compno, reslevelno, bandno, cblkno, lev, passno, layno;
-    int i;
+    int layno, i;
     double min = DBL_MAX;
     double max = 0;
     double thresh;
 
-    Jpeg2000CodingStyle *codsty = &s->codsty;
-
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = tile->comp + compno;
-
-        for (reslevelno = 0, lev = codsty->nreslevels-1; reslevelno < codsty->nreslevels; reslevelno++, lev--){
-            Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
-
-            for (precno = 0; precno < reslevel->num_precincts_x * reslevel->num_precincts_y; precno++){
-                for (bandno = 0; bandno < reslevel->nbands ; bandno++){
-                    Jpeg2000Band *band = reslevel->band + bandno;
-                    Jpeg2000Prec *prec = band->prec + precno;
-
-                    for (cblkno = 0; cblkno < prec->nb_codeblocks_height * prec->nb_codeblocks_width; cblkno++){
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
-                        for (passno = 0; passno < cblk->npasses; passno++) {
-                            Jpeg2000Pass *pass = &cblk->passes[passno];
-                            int dr;
-                            double dd, drslope;
-
-                            if (passno == 0) {
-                                dr = (int32_t)pass->rate;
-                                dd = pass->disto;
-                            } else {
-                                dr = (int32_t)(pass->rate - cblk->passes[passno - 1].rate);
-                                dd = pass->disto - cblk->passes[passno - 1].disto;
-                            }
-
-                            if (dr <= 0)
-                                continue;
-
-                            drslope = dd / dr;
-                            if (drslope < min)
-                                min = drslope;
-
-                            if (drslope > max)
-                                max = drslope;
-                        }
-                    }
-                }
-            }
-        }
+    /* the tier-1 workers recorded the slope range of the passes they coded */
+    for (i = 0; i < s->nb_threads; i++) {
+        min = FFMIN(min, s->thread[i].slope_min);
+        max = FFMAX(max, s->thread[i].slope_max);
     }
 
     for (layno = 0; layno < s->nlayers; layno++) {
@@ -1328,6 +1297,7 @@ static void makelayers(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
         } else {
             for (i = 0; i < 128; i++) {
                 uint8_t *stream_pos = s->buf;
+                double prev_lo = lo, prev_hi = hi, prev_stable = stable_thresh;
                 int ret;
                 thresh = (lo + hi) / 2;
                 makelayer(s, layno, thresh, tile, 0);
@@ -1335,12 +1305,16 @@ static void makelayers(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
                 memset(stream_pos, 0, s->buf - stream_pos);
                 if ((s->buf - stream_pos > ceil(tile->layer_rates[layno])) || ret < 0) {
                     lo = thresh;
-                    s->buf = stream_pos;
-                    continue;
+                } else {
+                    hi = thresh;
+                    stable_thresh = thresh;
                 }
-                hi = thresh;
-                stable_thresh = thresh;
                 s->buf = stream_pos;
+                /* Each trial only depends on lo and hi, so once an iteration
+                 * leaves the search state unchanged all remaining ones would
+                 * repeat it. */
+                if (lo == prev_lo && hi == prev_hi && stable_thresh == prev_stable)
+                    break;
             }
         }
         if (good_thresh >= 0.0)
@@ -1353,77 +1327,159 @@ static int getcut(Jpeg2000Cblk *cblk, uint64_t lambda)
 {
     int passno, res = 0;
     for (passno = 0; passno < cblk->npasses; passno++){
-        int dr;
-        int64_t dd;
+        double slope = cblk->passes[passno].slope;
 
-        dr = cblk->passes[passno].rate
-           - (res ? cblk->passes[res-1].rate : 0);
-        dd = cblk->passes[passno].disto
-           - (res ? cblk->passes[res-1].disto : 0);
-
-        if (dd  >= dr * lambda)
+        if (slope > 0 && slope >= lambda)
             res = passno+1;
     }
     return res;
 }
 
-static void truncpasses(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
+static void truncate_cblk(Jpeg2000Cblk *cblk, int64_t lambda)
 {
-    int precno, compno, reslevelno, bandno, cblkno, lev;
-    Jpeg2000CodingStyle *codsty = &s->codsty;
-
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = tile->comp + compno;
+    cblk->ninclpasses = getcut(cblk, lambda);
+    cblk->layers[0].data_start = cblk->data;
+    cblk->layers[0].cum_passes = cblk->ninclpasses;
+    cblk->layers[0].npasses = cblk->ninclpasses;
+    if (cblk->ninclpasses)
+        cblk->layers[0].data_len = cblk->passes[cblk->ninclpasses - 1].rate;
+}
 
-        for (reslevelno = 0, lev = codsty->nreslevels-1; reslevelno < codsty->nreslevels; reslevelno++, lev--){
-            Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
+/**
+ * Find the truncation points on the lower convex hull of the rate-distortion
+ * curve of a code-block. Only these are considered by the rate allocation,
+ * each with the slope of the hull segment ending at it, so that cutting a
+ * code-block at a given slope is optimal in the PCRD sense.
+ */
+static void compute_hull(Jpeg2000Cblk *cblk)
+{
+    int hull[JPEG2000_MAX_PASSES];
+    int passno, nhull = 0;
 
-            for (precno = 0; precno < reslevel->num_precincts_x * reslevel->num_precincts_y; precno++){
-                for (bandno = 0; bandno < reslevel->nbands ; bandno++){
-                    int bandpos = bandno + (reslevelno > 0);
-                    Jpeg2000Band *band = reslevel->band + bandno;
-                    Jpeg2000Prec *prec = band->prec + precno;
+    for (passno = 0; passno < cblk->npasses; passno++) {
+        Jpeg2000Pass *pass = &cblk->passes[passno];
 
-                    int64_t dwt_norm = dwt_norms[codsty->transform == FF_DWT53][bandpos][lev] * (int64_t)band->i_stepsize >> 15;
-                    int64_t lambda_prime = av_rescale(s->lambda, 1 << WMSEDEC_SHIFT, dwt_norm * dwt_norm);
-                    for (cblkno = 0; cblkno < prec->nb_codeblocks_height * prec->nb_codeblocks_width; cblkno++){
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
+        pass->slope = 0;
+        while (1) {
+            const Jpeg2000Pass *prev = nhull ? &cblk->passes[hull[nhull - 1]] : NULL;
+            int dr     = pass->rate  - (prev ? prev->rate  : 0);
+            int64_t dd = pass->disto - (prev ? prev->disto : 0);
+            double slope;
 
-                        cblk->ninclpasses = getcut(cblk, lambda_prime);
-                        cblk->layers[0].data_start = cblk->data;
-                        cblk->layers[0].cum_passes = cblk->ninclpasses;
-                        cblk->layers[0].npasses = cblk->ninclpasses;
-                        if (cblk->ninclpasses)
-                            cblk->layers[0].data_len = cblk->passes[cblk->ninclpasses - 1].rate;
-                    }
+            if (dd <= 0)
+                break;
+            if (dr <= 0) {
+                if (!prev) {
+                    /* free distortion reduction, always included */
+                    pass->slope = DBL_MAX;
+                    hull[nhull++] = passno;
+                    break;
                 }
+                slope = DBL_MAX;
+            } else {
+                slope = (double)dd / dr;
+            }
+            /* the previous point lies above the segment to this one */
+            if (prev && slope >= prev->slope) {
+                cblk->passes[hull[--nhull]].slope = 0;
+                continue;
+            }
+            pass->slope = slope;
+            hull[nhull++] = passno;
+            break;
+        }
+    }
+}
+
+static void update_slope_range(Jpeg2000ThreadContext *thread, const Jpeg2000Cblk *cblk)
+{
+    int passno;
+
+    for (passno = 0; passno < cblk->npasses; passno++) {
+        double slope = cblk->passes[passno].slope;
+
+        if (slope <= 0 || slope == DBL_MAX)
+            continue;
+
+        thread->slope_min = FFMIN(thread->slope_min, slope);
+        thread->slope_max = FFMAX(thread->slope_max, slope);
+    }
+}
+
+static int dwt_component(AVCodecContext *avctx, void *arg, int compno, int threadnr)
+{
+    Jpeg2000Component *comp = ((Jpeg2000Tile *)arg)->comp + compno;
+
+    return ff_dwt_encode(&comp->dwt, comp->i_data);
+}
+
+static int encode_cblk_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000EncoderContext *s = avctx->priv_data;
+    Jpeg2000ThreadContext *thread = &s->thread[threadnr];
+    Jpeg2000T1Context *t1 = &thread->t1;
+    const Jpeg2000CblkJob *job = &s->cblk_jobs[jobnr];
+    const Jpeg2000Component *comp = job->comp;
+    int comp_width = comp->coord[0][1] - comp->coord[0][0];
+    int y, x;
+
+    if (s->codsty.transform == FF_DWT53){
+        for (y = 0; y < job->height; y++){
+            const int *src = comp->i_data + comp_width * (job->y0 + y) + job->x0;
+            int *ptr = t1->data + y*t1->stride;
+            for (x = 0; x < job->width; x++){
+                *ptr++ = src[x] * (1 << NMSEDEC_FRACBITS);
+            }
+        }
+    } else{
+        for (y = 0; y < job->height; y++){
+            const int *src = comp->i_data + comp_width * (job->y0 + y) + job->x0;
+            int *ptr = t1->data + y*t1->stride;
+            for (x = 0; x < job->width; x++){
+                *ptr = src[x];
+                *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / job->band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
+                ptr++;
             }
         }
     }
+
+    encode_cblk(t1, job->cblk, job->width, job->height, job->bandpos);
+    compute_hull(job->cblk);
+
+    if (s->compression_rate_enc)
+        update_slope_range(thread, job->cblk);
+    else
+        truncate_cblk(job->cblk, job->lambda);
+    return 0;
 }
 
 static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno)
 {
-    int compno, reslevelno, bandno, ret;
-    Jpeg2000T1Context t1;
+    int compno, reslevelno, bandno, ret, nb_jobs = 0, i;
     Jpeg2000CodingStyle *codsty = &s->codsty;
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = s->tile[tileno].comp + compno;
+    Jpeg2000CblkJob *jobs;
 
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
+    av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
+    s->avctx->execute2(s->avctx, dwt_component, tile, s->dwt_ret, s->ncomponents);
+    for (compno = 0; compno < s->ncomponents; compno++)
+        if (s->dwt_ret[compno] < 0)
+            return s->dwt_ret[compno];
+    av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
 
-        av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
-        if ((ret = ff_dwt_encode(&comp->dwt, comp->i_data)) < 0)
-            return ret;
-        av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
+    /* Gather the code-blocks of all components and subbands, they are
+     * independent and get tier-1 coded in parallel. */
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = tile->comp + compno;
 
         for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
             Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
+            int lev = codsty->nreslevels - reslevelno - 1;
 
             for (bandno = 0; bandno < reslevel->nbands ; bandno++){
                 Jpeg2000Band *band = reslevel->band + bandno;
                 Jpeg2000Prec *prec = band->prec; // we support only 1 precinct per band ATM in the encoder
                 int cblkx, cblky, cblkno=0, xx0, x0, xx1, y0, yy0, yy1, bandpos;
+                int64_t dwt_norm, lambda_prime;
                 yy0 = bandno == 0 ? 0 : comp->reslevel[reslevelno-1].coord[1][1] - comp->reslevel[reslevelno-1].coord[1][0];
                 y0 = yy0;
                 yy1 = FFMIN(ff_jpeg2000_ceildivpow2(band->coord[1][0] + 1, band->log2_cblk_height) << band->log2_cblk_height,
@@ -1433,6 +1489,15 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                     continue;
 
                 bandpos = bandno + (reslevelno > 0);
+                dwt_norm = dwt_norms[codsty->transform == FF_DWT53][bandpos][lev] * (int64_t)band->i_stepsize >> 15;
+                lambda_prime = av_rescale(s->lambda, 1 << WMSEDEC_SHIFT, dwt_norm * dwt_norm);
+
+                jobs = av_fast_realloc(s->cblk_jobs, &s->cblk_jobs_allocated,
+                                       (nb_jobs + prec->nb_codeblocks_width * prec->nb_codeblocks_height) *
+                                       sizeof(*s->cblk_jobs));
+                if (!jobs)
+                    return AVERROR(ENOMEM);
+                s->cblk_jobs = jobs;
 
                 for (cblky = 0; cblky < prec->nb_codeblocks_height; cblky++){
                     if (reslevelno == 0 || bandno == 1)
@@ -1444,32 +1509,26 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                                 band->coord[0][1]) - band->coord[0][0] + xx0;
 
                     for (cblkx = 0; cblkx < prec->nb_codeblocks_width; cblkx++, cblkno++){
-                        int y, x;
-                        if (codsty->transform == FF_DWT53){
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr++ = comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x] * (1 << NMSEDEC_FRACBITS);
-                                }
-                            }
-                        } else{
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr = (comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x]);
-                                    *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
-                                    ptr++;
-                                }
-                            }
-                        }
-                        if (!prec->cblk[cblkno].data)
-                            prec->cblk[cblkno].data = av_malloc(1 + 8192);
-                        if (!prec->cblk[cblkno].passes)
-                            prec->cblk[cblkno].passes = av_malloc_array(JPEG2000_MAX_PASSES, sizeof (*prec->cblk[cblkno].passes));
-                        if (!prec->cblk[cblkno].data || !prec->cblk[cblkno].passes)
+                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
+
+                        if (!cblk->data)
+                            cblk->data = av_malloc(1 + 8192);
+                        if (!cblk->passes)
+                            cblk->passes = av_malloc_array(JPEG2000_MAX_PASSES, sizeof (*cblk->passes));
+                        if (!cblk->data || !cblk->passes)
                             return AVERROR(ENOMEM);
-                        encode_cblk(s, &t1, prec->cblk + cblkno, tile, xx1 - xx0, yy1 - yy0,
-                                    bandpos, codsty->nreslevels - reslevelno - 1);
+
+                        s->cblk_jobs[nb_jobs++] = (Jpeg2000CblkJob) {
+                            .comp    = comp,
+                            .band    = band,
+                            .cblk    = cblk,
+                            .x0      = xx0,
+                            .y0      = yy0,
+                            .width   = xx1 - xx0,
+                            .height  = yy1 - yy0,
+                            .bandpos = bandpos,
+                            .lambda  = lambda_prime,
+                        };
                         xx0 = xx1;
                         xx1 = FFMIN(xx1 + (1 << band->log2_cblk_width), band->coord[0][1] - band->coord[0][0] + x0);
                     }
@@ -1478,14 +1537,18 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                 }
             }
         }
-        av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
     }
 
+    for (i = 0; i < s->nb_threads; i++) {
+        s->thread[i].slope_min = DBL_MAX;
+        s->thread[i].slope_max = 0;
+    }
+    s->avctx->execute2(s->avctx, encode_cblk_job, NULL, NULL, nb_jobs);
+    av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
+
     av_log(s->avctx, AV_LOG_DEBUG, "rate control\n");
     if (s->compression_rate_enc)
         makelayers(s, tile);
-    else
-        truncpasses(s, tile);
 
     if ((ret = encode_packets(s, tile, tileno, s->nlayers)) < 0)
         return ret;
@@ -1785,6 +1848,14 @@ static av_cold int j2kenc_init(AVCodecContext *avctx)
 
     ff_thread_once(&init_static_once, init_luts);
 
+    s->nb_threads = FFMAX(avctx->thread_count, 1);
+    s->thread  = av_calloc(s->nb_threads, sizeof(*s->thread));
+    s->dwt_ret = av_calloc(s->ncomponents, sizeof(*s->dwt_ret));
+    if (!s->thread || !s->dwt_ret)
+        return AVERROR(ENOMEM);
+    for (i = 0; i < s->nb_threads; i++)
+        s->thread[i].t1.stride = (1 << codsty->log2_cblk_width) + 2;
+
     init_quantization(s);
     if ((ret=init_tiles(s)) < 0)
         return ret;
@@ -1799,6 +1870,9 @@ static int j2kenc_destroy(AVCodecContext *avctx)
     Jpeg2000EncoderContext *s = avctx->priv_data;
 
     cleanup(s);
+    av_freep(&s->thread);
+    av_freep(&s->dwt_ret);
+    av_freep(&s->cblk_jobs);
     return 0;
 }
 
@@ -1840,7 +1914,7 @@ const FFCodec ff_jpeg2000_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_JPEG2000,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
-                      AV_CODEC_CAP_FRAME_THREADS,
+                      AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(Jpeg2000EncoderContext),
     .init           = j2kenc_init,
     FF_CODEC_ENCODE_CB(encode_frame),
@@ -168,6 +168,7 @@ typedef struct Jpeg2000QuantStyle {
 typedef struct Jpeg2000Pass {
     uint16_t rate;
     int64_t disto;
+    double slope;   ///< R-D slope of the convex hull segment ending here, 0 if off the hull (encoder)
     uint8_t flushed[4];
     int flushed_len;
 } Jpeg2000Pass;
@@ -2214,91 +2214,137 @@ static inline void mct_decode(const Jpeg2000DecoderContext *s, Jpeg2000Tile *til
 }
 
 
-static inline int tile_codeblocks(const Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
+/* Decode and dequantize a single code-block, return 1 if it had coded data */
+static int decode_codeblock(const Jpeg2000DecoderContext *s, Jpeg2000T1Context *t1,
+                            Jpeg2000Component *comp, Jpeg2000CodingStyle *codsty,
+                            Jpeg2000Band *band, Jpeg2000Cblk *cblk,
+                            int bandpos, int M_b)
+{
+    int x, y, ret;
+
+    if (cblk->modes & JPEG2000_CTSY_HTJ2K_F)
+        ret = ff_jpeg2000_decode_htj2k(s, codsty, t1, cblk,
+                                       cblk->coord[0][1] - cblk->coord[0][0],
+                                       cblk->coord[1][1] - cblk->coord[1][0],
+                                       M_b, comp->roi_shift);
+    else
+        ret = decode_cblk(s, codsty, t1, cblk,
+                          cblk->coord[0][1] - cblk->coord[0][0],
+                          cblk->coord[1][1] - cblk->coord[1][0],
+                          bandpos, comp->roi_shift, M_b);
+
+    if (!ret)
+        return 0;
+
+    x = cblk->coord[0][0] - band->coord[0][0];
+    y = cblk->coord[1][0] - band->coord[1][0];
+
+    if (codsty->transform == FF_DWT97)
+        dequantization_float(x, y, cblk, comp, t1, band, M_b);
+    else if (codsty->transform == FF_DWT97_INT)
+        dequantization_int_97(x, y, cblk, comp, t1, band, M_b);
+    else
+        dequantization_int(x, y, cblk, comp, t1, band, M_b);
+
+    return 1;
+}
+
+static void component_dwt(Jpeg2000Component *comp, const Jpeg2000CodingStyle *codsty)
 {
+    ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
+}
+
+/**
+ * Iterate over all code-blocks of a tile component. Calls fn for each of
+ * them and returns the number of code-blocks or a negative error code.
+ */
+static int foreach_codeblock(const Jpeg2000DecoderContext *s, Jpeg2000Tile *tile, int compno,
+                             int (*fn)(void *opaque, Jpeg2000Component *comp,
+                                       Jpeg2000CodingStyle *codsty, Jpeg2000Band *band,
+                                       Jpeg2000Cblk *cblk, int bandpos, int M_b),
+                             void *opaque)
+{
+    Jpeg2000Component *comp      = tile->comp   + compno;
+    Jpeg2000CodingStyle *codsty  = tile->codsty + compno;
+    Jpeg2000QuantStyle *quantsty = tile->qntsty + compno;
+    int reslevelno, bandno, subbandno = 0, nb_cblks = 0;
+
+    /* Loop on resolution levels */
+    for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
+        Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
+        /* Loop on bands */
+        for (bandno = 0; bandno < rlevel->nbands; bandno++, subbandno++) {
+            int nb_precincts, precno;
+            Jpeg2000Band *band = rlevel->band + bandno;
+            int cblkno = 0, bandpos;
+            /* See Rec. ITU-T T.800, Equation E-2 */
+            int M_b = quantsty->expn[subbandno] + quantsty->nguardbits - 1;
+
+            bandpos = bandno + (reslevelno > 0);
+
+            if (band->coord[0][0] == band->coord[0][1] ||
+                band->coord[1][0] == band->coord[1][1])
+                continue;
+
+            if ((codsty->cblk_style & JPEG2000_CTSY_HTJ2K_F) && M_b >= 31) {
+                avpriv_request_sample(s->avctx, "JPEG2000_CTSY_HTJ2K_F and M_b >= 31");
+                return AVERROR_PATCHWELCOME;
+            }
+
+            nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
+            /* Loop on precincts */
+            for (precno = 0; precno < nb_precincts; precno++) {
+                Jpeg2000Prec *prec = band->prec + precno;
+
+                /* Loop on codeblocks */
+                for (cblkno = 0;
+                     cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+                     cblkno++) {
+                    int ret = fn(opaque, comp, codsty, band, prec->cblk + cblkno,
+                                 bandpos, M_b);
+                    if (ret < 0)
+                        return ret;
+                    nb_cblks++;
+                } /* end cblk */
+            } /*end prec */
+        } /* end band */
+    } /* end reslevel */
+
+    return nb_cblks;
+}
+
+typedef struct TileDecodeState {
+    const Jpeg2000DecoderContext *s;
     Jpeg2000T1Context t1;
+    int coded;
+} TileDecodeState;
 
-    int compno, reslevelno, bandno;
+static int decode_codeblock_cb(void *opaque, Jpeg2000Component *comp,
+                               Jpeg2000CodingStyle *codsty, Jpeg2000Band *band,
+                               Jpeg2000Cblk *cblk, int bandpos, int M_b)
+{
+    TileDecodeState *st = opaque;
 
-    /* Loop on tile components */
-    for (compno = 0; compno < s->ncomponents; compno++) {
-        Jpeg2000Component *comp      = tile->comp   + compno;
-        Jpeg2000CodingStyle *codsty  = tile->codsty + compno;
-        Jpeg2000QuantStyle *quantsty = tile->qntsty + compno;
-
-        int coded = 0;
-        int subbandno = 0;
-
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
-
-        /* Loop on resolution levels */
-        for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
-            Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
-            /* Loop on bands */
-            for (bandno = 0; bandno < rlevel->nbands; bandno++, subbandno++) {
-                int nb_precincts, precno;
-                Jpeg2000Band *band = rlevel->band + bandno;
-                int cblkno = 0, bandpos;
-                /* See Rec. ITU-T T.800, Equation E-2 */
-                int M_b = quantsty->expn[subbandno] + quantsty->nguardbits - 1;
-
-                bandpos = bandno + (reslevelno > 0);
-
-                if (band->coord[0][0] == band->coord[0][1] ||
-                    band->coord[1][0] == band->coord[1][1])
-                    continue;
+    st->t1.stride = (1<<codsty->log2_cblk_width) + 2;
+    if (decode_codeblock(st->s, &st->t1, comp, codsty, band, cblk, bandpos, M_b))
+        st->coded = 1;
+    return 0;
+}
 
-                if ((codsty->cblk_style & JPEG2000_CTSY_HTJ2K_F) && M_b >= 31) {
-                    avpriv_request_sample(s->avctx, "JPEG2000_CTSY_HTJ2K_F and M_b >= 31");
-                    return AVERROR_PATCHWELCOME;
-                }
+static inline int tile_codeblocks(const Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
+{
+    TileDecodeState st = { .s = s };
+    int compno, ret;
 
-                nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
-                /* Loop on precincts */
-                for (precno = 0; precno < nb_precincts; precno++) {
-                    Jpeg2000Prec *prec = band->prec + precno;
-
-                    /* Loop on codeblocks */
-                    for (cblkno = 0;
-                         cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height;
-                         cblkno++) {
-                        int x, y, ret;
-
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
-
-                        if (cblk->modes & JPEG2000_CTSY_HTJ2K_F)
-                            ret = ff_jpeg2000_decode_htj2k(s, codsty, &t1, cblk,
-                                                           cblk->coord[0][1] - cblk->coord[0][0],
-                                                           cblk->coord[1][1] - cblk->coord[1][0],
-                                                           M_b, comp->roi_shift);
-                        else
-                            ret = decode_cblk(s, codsty, &t1, cblk,
-                                              cblk->coord[0][1] - cblk->coord[0][0],
-                                              cblk->coord[1][1] - cblk->coord[1][0],
-                                              bandpos, comp->roi_shift, M_b);
-
-                        if (ret)
-                            coded = 1;
-                        else
-                            continue;
-                        x = cblk->coord[0][0] - band->coord[0][0];
-                        y = cblk->coord[1][0] - band->coord[1][0];
-
-                        if (codsty->transform == FF_DWT97)
-                            dequantization_float(x, y, cblk, comp, &t1, band, M_b);
-                        else if (codsty->transform == FF_DWT97_INT)
-                            dequantization_int_97(x, y, cblk, comp, &t1, band, M_b);
-                        else
-                            dequantization_int(x, y, cblk, comp, &t1, band, M_b);
-                   } /* end cblk */
-                } /*end prec */
-            } /* end band */
-        } /* end reslevel */
+    /* Loop on tile components */
+    for (compno = 0; compno < s->ncomponents; compno++) {
+        st.coded = 0;
+        if ((ret = foreach_codeblock(s, tile, compno, decode_codeblock_cb, &st)) < 0)
+            return ret;
 
         /* inverse DWT */
-        if (coded)
-            ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
-
+        if (st.coded)
+            component_dwt(tile->comp + compno, tile->codsty + compno);
     } /*end comp */
     return 0;
 }
@@ -2370,17 +2416,9 @@ WRITE_FRAME(16, uint16_t)
 
 #undef WRITE_FRAME
 
-static int jpeg2000_decode_tile(AVCodecContext *avctx, void *td,
-                                int jobnr, int threadnr)
+static void tile_reconstruct(const Jpeg2000DecoderContext *s, Jpeg2000Tile *tile,
+                             AVFrame *picture)
 {
-    const Jpeg2000DecoderContext *s = avctx->priv_data;
-    AVFrame *picture = td;
-    Jpeg2000Tile *tile = s->tile + jobnr;
-
-    int ret = tile_codeblocks(s, tile);
-    if (ret < 0)
-        return ret;
-
     /* inverse MCT transformation */
     if (tile->codsty[0].mct)
         mct_decode(s, tile);
@@ -2395,6 +2433,125 @@ static int jpeg2000_decode_tile(AVCodecContext *avctx, void *td,
 
         write_frame_16(s, tile, picture, precision);
     }
+}
+
+static int jpeg2000_decode_tile(AVCodecContext *avctx, void *td,
+                                int jobnr, int threadnr)
+{
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+    AVFrame *picture = td;
+    Jpeg2000Tile *tile = s->tile + jobnr;
+
+    int ret = tile_codeblocks(s, tile);
+    if (ret < 0)
+        return ret;
+
+    tile_reconstruct(s, tile, picture);
+
+    return 0;
+}
+
+static int add_cblk_job(void *opaque, Jpeg2000Component *comp,
+                        Jpeg2000CodingStyle *codsty, Jpeg2000Band *band,
+                        Jpeg2000Cblk *cblk, int bandpos, int M_b)
+{
+    Jpeg2000DecoderContext *s = opaque;
+    Jpeg2000CblkJob *job;
+
+    job = av_fast_realloc(s->cblk_jobs, &s->cblk_jobs_allocated,
+                          (s->nb_cblk_jobs + 1) * sizeof(*s->cblk_jobs));
+    if (!job)
+        return AVERROR(ENOMEM);
+    s->cblk_jobs = job;
+
+    job = &s->cblk_jobs[s->nb_cblk_jobs++];
+    job->comp    = comp;
+    job->codsty  = codsty;
+    job->band    = band;
+    job->cblk    = cblk;
+    job->bandpos = bandpos;
+    job->M_b     = M_b;
+    job->compidx = s->nb_comp_jobs;
+    job->coded   = 0;
+
+    return 0;
+}
+
+static int decode_cblk_thread(AVCodecContext *avctx, void *td,
+                              int jobnr, int threadnr)
+{
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+    Jpeg2000CblkJob *job = &s->cblk_jobs[jobnr];
+    Jpeg2000T1Context t1;
+
+    t1.stride  = (1 << job->codsty->log2_cblk_width) + 2;
+    job->coded = decode_codeblock(s, &t1, job->comp, job->codsty, job->band,
+                                  job->cblk, job->bandpos, job->M_b);
+
+    return 0;
+}
+
+static int component_dwt_thread(AVCodecContext *avctx, void *td,
+                                int jobnr, int threadnr)
+{
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+    int tileno = jobnr / s->ncomponents;
+    int compno = jobnr % s->ncomponents;
+
+    if (s->comp_coded[jobnr])
+        component_dwt(s->tile[tileno].comp + compno, s->tile[tileno].codsty + compno);
+
+    return 0;
+}
+
+static int tile_reconstruct_thread(AVCodecContext *avctx, void *td,
+                                   int jobnr, int threadnr)
+{
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    tile_reconstruct(s, s->tile + jobnr, td);
+
+    return 0;
+}
+
+/**
+ * Decode all tiles with code-block granularity instead of one job per tile.
+ * Used when there are fewer tiles than threads, which is the common case
+ * for single-tile DCI and IMF content. Tier-1 decoding of all code-blocks
+ * of all components and resolutions runs first, then the inverse DWT of
+ * every component and finally the inverse MCT and output of every tile.
+ */
+static int decode_tiles_by_codeblock(AVCodecContext *avctx, AVFrame *picture)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+    int nb_tiles = s->numXtiles * s->numYtiles;
+    int ret;
+
+    s->nb_cblk_jobs = 0;
+    s->nb_comp_jobs = 0;
+    av_fast_malloc(&s->comp_coded, &s->comp_coded_allocated,
+                   nb_tiles * s->ncomponents);
+    if (!s->comp_coded)
+        return AVERROR(ENOMEM);
+    memset(s->comp_coded, 0, nb_tiles * s->ncomponents);
+
+    for (int tileno = 0; tileno < nb_tiles; tileno++) {
+        for (int compno = 0; compno < s->ncomponents; compno++) {
+            ret = foreach_codeblock(s, s->tile + tileno, compno, add_cblk_job, s);
+            if (ret < 0)
+                return ret;
+            s->nb_comp_jobs++;
+        }
+    }
+
+    avctx->execute2(avctx, decode_cblk_thread, NULL, NULL, s->nb_cblk_jobs);
+
+    for (int i = 0; i < s->nb_cblk_jobs; i++)
+        if (s->cblk_jobs[i].coded)
+            s->comp_coded[s->cblk_jobs[i].compidx] = 1;
+
+    avctx->execute2(avctx, component_dwt_thread, NULL, NULL, s->nb_comp_jobs);
+    avctx->execute2(avctx, tile_reconstruct_thread, picture, NULL, nb_tiles);
 
     return 0;
 }
@@ -2827,6 +2984,17 @@ static av_cold int jpeg2000_decode_init(AVCodecContext *avctx)
     return 0;
 }
 
+static av_cold int jpeg2000_decode_close(AVCodecContext *avctx)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    av_freep(&s->cblk_jobs);
+    av_freep(&s->comp_coded);
+    s->cblk_jobs_allocated = s->comp_coded_allocated = 0;
+
+    return 0;
+}
+
 static int jpeg2000_decode_frame(AVCodecContext *avctx, AVFrame *picture,
                                  int *got_frame, AVPacket *avpkt)
 {
@@ -2900,7 +3068,12 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, AVFrame *picture,
         if (++x == s->ncomponents)
             picture->flags |= AV_FRAME_FLAG_LOSSLESS;
 
-    avctx->execute2(avctx, jpeg2000_decode_tile, picture, NULL, s->numXtiles * s->numYtiles);
+    if (avctx->active_thread_type & FF_THREAD_SLICE &&
+        s->numXtiles * s->numYtiles < avctx->thread_count) {
+        if ((ret = decode_tiles_by_codeblock(avctx, picture)) < 0)
+            goto end;
+    } else
+        avctx->execute2(avctx, jpeg2000_decode_tile, picture, NULL, s->numXtiles * s->numYtiles);
 
     jpeg2000_dec_cleanup(s);
 
@@ -2941,6 +3114,7 @@ const FFCodec ff_jpeg2000_decoder = {
     .priv_data_size   = sizeof(Jpeg2000DecoderContext),
     .init             = jpeg2000_decode_init,
     FF_CODEC_DECODE_CB(jpeg2000_decode_frame),
+    .close            = jpeg2000_decode_close,
     .p.priv_class     = &jpeg2000_class,
     .p.max_lowres     = 5,
     .p.profiles       = NULL_IF_CONFIG_SMALL(ff_jpeg2000_profiles),
@@ -70,6 +70,18 @@ typedef struct Jpeg2000Tile {
     int coord[2][2];                    // border coordinates {{x0, x1}, {y0, y1}}
 } Jpeg2000Tile;
 
+/* A code-block scheduled for tier-1 decoding on its own thread */
+typedef struct Jpeg2000CblkJob {
+    Jpeg2000Component   *comp;
+    Jpeg2000CodingStyle *codsty;
+    Jpeg2000Band        *band;
+    Jpeg2000Cblk        *cblk;
+    int                 bandpos;
+    int                 M_b;
+    int                 compidx;    // index of the tile component the code-block belongs to
+    int                 coded;      // set by the worker if the code-block had coded data
+} Jpeg2000CblkJob;
+
 typedef struct Jpeg2000DecoderContext {
     AVClass         *class;
     AVCodecContext  *avctx;
@@ -118,6 +130,14 @@ typedef struct Jpeg2000DecoderContext {
     uint8_t         Ccap15_b05; // HTREV(= 0) or HTIRV(= 1) ?
     uint8_t         HT_B; // The parameter B for MAGBp value (see Table 4 in the Rec. ITU-T T.814 | ISO/IEC 15444-15)
 
+    /* code-block level threading */
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned        cblk_jobs_allocated;
+    int             nb_cblk_jobs;
+    uint8_t         *comp_coded;    // per tile component, set if any code-block was coded
+    unsigned        comp_coded_allocated;
+    int             nb_comp_jobs;
+
     /*options parameters*/
     int             reduction_factor;
 } Jpeg2000DecoderContext;
@@ -25,6 +25,10 @@
  * Discrete wavelet transform
  */
 
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
 #include "libavutil/error.h"
 #include "libavutil/macros.h"
 #include "libavutil/mem.h"
@@ -324,11 +328,60 @@ static void sr_1d53(unsigned *p, int i0, int i1)
         p[2 * i + 1] += (int)(p[2 * i] + p[2 * i + 2]) >> 1;
 }
 
+static void lift53_even_c(int32_t *p, int n)
+{
+    uint32_t *q = (uint32_t *)p;
+
+    for (int i = 0; i < n; i++, q += 2 * FF_DWT_STRIP)
+        for (int j = 0; j < FF_DWT_STRIP; j++)
+            q[j] -= (int)(q[j - FF_DWT_STRIP] + q[j + FF_DWT_STRIP] + 2) >> 2;
+}
+
+static void lift53_odd_c(int32_t *p, int n)
+{
+    uint32_t *q = (uint32_t *)p;
+
+    for (int i = 0; i < n; i++, q += 2 * FF_DWT_STRIP)
+        for (int j = 0; j < FF_DWT_STRIP; j++)
+            q[j] += (int)(q[j - FF_DWT_STRIP] + q[j + FF_DWT_STRIP]) >> 1;
+}
+
+/* Copy the rows above i0 and from i1 on from their mirror images. */
+static void extend_rows(void *p, int i0, int i1, int n, size_t size)
+{
+    uint8_t *row = p;
+    size_t stride = FF_DWT_STRIP * size;
+
+    for (int i = 1; i <= n; i++) {
+        memcpy(row + (i0 - i) * stride, row + (i0 + i) * stride, stride);
+        memcpy(row + (i1 + i - 1) * stride, row + (i1 - i - 1) * stride, stride);
+    }
+}
+
+/* Same as sr_1d53() on FF_DWT_STRIP columns at once. */
+static void sr_strip53(const DWTContext *s, int32_t *p, int i0, int i1)
+{
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (int j = 0; j < FF_DWT_STRIP; j++)
+                p[FF_DWT_STRIP + j] >>= 1;
+        return;
+    }
+
+    extend_rows(p, i0, i1, 2, sizeof(*p));
+
+    s->lift53_even(p + FF_DWT_STRIP * 2 * (i0 >> 1),
+                   (i1 >> 1) + 1 - (i0 >> 1));
+    s->lift53_odd(p + FF_DWT_STRIP * (2 * (i0 >> 1) + 1),
+                  (i1 >> 1) - (i0 >> 1));
+}
+
 static void dwt_decode53(DWTContext *s, int *t)
 {
     int lev;
     int w     = s->linelen[s->ndeclevels - 1][0];
     int32_t *line = s->i_linebuf;
+    int32_t *strip = s->i_linebuf + 3 * FF_DWT_STRIP;
     line += 3;
 
     for (lev = 0; lev < s->ndeclevels; lev++) {
@@ -356,19 +409,19 @@ static void dwt_decode53(DWTContext *s, int *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * FF_DWT_STRIP;
+        for (lp = 0; lp < lh; lp += FF_DWT_STRIP) {
+            int i, j = 0, n = FFMIN(lh - lp, FF_DWT_STRIP) * sizeof(*l);
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
+                memcpy(l + i * FF_DWT_STRIP, t + w * j + lp, n);
             for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
+                memcpy(l + i * FF_DWT_STRIP, t + w * j + lp, n);
 
-            sr_1d53(line, mv, mv + lv);
+            sr_strip53(s, strip, mv, mv + lv);
 
             for (i = 0; i < lv; i++)
-                t[w * i + lp] = l[i];
+                memcpy(t + w * i + lp, l + i * FF_DWT_STRIP, n);
         }
     }
 }
@@ -400,11 +453,47 @@ static void sr_1d97_float(float *p, int i0, int i1)
         p[2 * i + 1] += F_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]);
 }
 
+static void lift_float_c(float *p, float coef, int n)
+{
+    for (int i = 0; i < n; i++, p += 2 * FF_DWT_STRIP)
+        for (int j = 0; j < FF_DWT_STRIP; j++)
+            p[j] += coef * (p[j - FF_DWT_STRIP] + p[j + FF_DWT_STRIP]);
+}
+
+/* Same as sr_1d97_float() on FF_DWT_STRIP columns at once. */
+static void sr_strip97_float(const DWTContext *s, float *p, int i0, int i1)
+{
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (int j = 0; j < FF_DWT_STRIP; j++)
+                p[FF_DWT_STRIP + j] *= F_LFTG_K/2;
+        else
+            for (int j = 0; j < FF_DWT_STRIP; j++)
+                p[j] *= F_LFTG_X;
+        return;
+    }
+
+    extend_rows(p, i0, i1, 4, sizeof(*p));
+
+    s->lift_float(p + FF_DWT_STRIP * 2 * ((i0 >> 1) - 1), -F_LFTG_DELTA,
+                  (i1 >> 1) + 3 - (i0 >> 1));
+    /* step 4 */
+    s->lift_float(p + FF_DWT_STRIP * (2 * ((i0 >> 1) - 1) + 1), -F_LFTG_GAMMA,
+                  (i1 >> 1) + 2 - (i0 >> 1));
+    /*step 5*/
+    s->lift_float(p + FF_DWT_STRIP * 2 * (i0 >> 1), F_LFTG_BETA,
+                  (i1 >> 1) + 1 - (i0 >> 1));
+    /* step 6 */
+    s->lift_float(p + FF_DWT_STRIP * (2 * (i0 >> 1) + 1), F_LFTG_ALPHA,
+                  (i1 >> 1) - (i0 >> 1));
+}
+
 static void dwt_decode97_float(DWTContext *s, float *t)
 {
     int lev;
     int w       = s->linelen[s->ndeclevels - 1][0];
     float *line = s->f_linebuf;
+    float *strip = s->f_linebuf + 5 * FF_DWT_STRIP;
     float *data = t;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
@@ -433,19 +522,19 @@ static void dwt_decode97_float(DWTContext *s, float *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * FF_DWT_STRIP;
+        for (lp = 0; lp < lh; lp += FF_DWT_STRIP) {
+            int i, j = 0, n = FFMIN(lh - lp, FF_DWT_STRIP) * sizeof(*l);
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * FF_DWT_STRIP, data + w * j + lp, n);
             for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * FF_DWT_STRIP, data + w * j + lp, n);
 
-            sr_1d97_float(line, mv, mv + lv);
+            sr_strip97_float(s, strip, mv, mv + lv);
 
             for (i = 0; i < lv; i++)
-                data[w * i + lp] = l[i];
+                memcpy(data + w * i + lp, l + i * FF_DWT_STRIP, n);
         }
     }
 }
@@ -558,9 +647,12 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
             for (j = 0; j < 2; j++)
                 b[i][j] = (b[i][j] + 1) >> 1;
         }
+    /* The vertical pass of the inverse 9/7 float and 5/3 transforms works
+     * on strips of FF_DWT_STRIP columns, the other passes on single lines.
+     * Zeroed so that the unused columns of the last strip are defined. */
     switch (type) {
     case FF_DWT97:
-        s->f_linebuf = av_malloc_array((maxlen + 12), sizeof(*s->f_linebuf));
+        s->f_linebuf = av_calloc((maxlen + 12) * FF_DWT_STRIP, sizeof(*s->f_linebuf));
         if (!s->f_linebuf)
             return AVERROR(ENOMEM);
         break;
@@ -570,13 +662,21 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
             return AVERROR(ENOMEM);
         break;
     case FF_DWT53:
-        s->i_linebuf = av_malloc_array((maxlen +  6), sizeof(*s->i_linebuf));
+        s->i_linebuf = av_calloc((maxlen +  6) * FF_DWT_STRIP, sizeof(*s->i_linebuf));
         if (!s->i_linebuf)
             return AVERROR(ENOMEM);
         break;
     default:
         return -1;
     }
+
+    s->lift_float  = lift_float_c;
+    s->lift53_even = lift53_even_c;
+    s->lift53_odd  = lift53_odd_c;
+#if ARCH_X86
+    ff_jpeg2000dwt_init_x86(s);
+#endif
+
     return 0;
 }
 
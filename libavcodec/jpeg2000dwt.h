@@ -33,6 +33,7 @@
 #define F_LFTG_K      1.230174104914001f
 #define F_LFTG_X      0.812893066115961f
 #define I_PRESHIFT 8
+#define FF_DWT_STRIP 16 ///< number of columns lifted together by the vertical pass
 
 enum DWTType {
     FF_DWT97,
@@ -49,6 +50,15 @@ typedef struct DWTContext {
     uint8_t type;                        ///< 0 for 9/7; 1 for 5/3
     int32_t *i_linebuf;                  ///< int buffer used by transform
     float   *f_linebuf;                  ///< float buffer used by transform
+
+    /**
+     * Vertical lifting steps of the inverse transform. Each one updates n
+     * rows of FF_DWT_STRIP samples, two rows apart and starting at p, from
+     * the rows directly above and below them.
+     */
+    void (*lift_float)(float *p, float coef, int n);  ///< p += coef * (above + below)
+    void (*lift53_even)(int32_t *p, int n);            ///< p -= (above + below + 2) >> 2
+    void (*lift53_odd)(int32_t *p, int n);             ///< p += (above + below) >> 1
 } DWTContext;
 
 /**
@@ -66,4 +76,6 @@ int ff_dwt_decode(DWTContext *s, void *t);
 
 void ff_dwt_destroy(DWTContext *s);
 
+void ff_jpeg2000dwt_init_x86(DWTContext *s);
+
 #endif /* AVCODEC_JPEG2000DWT_H */
@@ -92,6 +92,7 @@ typedef struct Mpeg1Context {
     int extradata_decoded;
     int vbv_delay;
     int64_t timecode_frame_start;  /*< GOP timecode frame start number, in non drop frame format */
+    int64_t timecode_output;       /*< timecode to export with the picture output for this packet */
 } Mpeg1Context;
 
 /* as H.263, but only 17 codes */
@@ -800,8 +801,36 @@ static int mpeg_decode_update_thread_context(AVCodecContext *avctx,
     if (err)
         return err;
 
-    if (!s->context_initialized)
-        memcpy(s + 1, s1 + 1, sizeof(Mpeg1Context) - sizeof(MpegEncContext));
+    /* Sequence and GOP headers are parsed once per packet by one thread;
+     * everything later pictures depend on has to be passed on. */
+    memcpy(s->intra_matrix,        s1->intra_matrix,        sizeof(s->intra_matrix));
+    memcpy(s->inter_matrix,        s1->inter_matrix,        sizeof(s->inter_matrix));
+    memcpy(s->chroma_intra_matrix, s1->chroma_intra_matrix, sizeof(s->chroma_intra_matrix));
+    memcpy(s->chroma_inter_matrix, s1->chroma_inter_matrix, sizeof(s->chroma_inter_matrix));
+
+    err = av_buffer_replace(&ctx->a53_buf_ref, ctx_from->a53_buf_ref);
+    if (err < 0)
+        return err;
+
+    ctx->pan_scan             = ctx_from->pan_scan;
+    ctx->stereo3d_type        = ctx_from->stereo3d_type;
+    ctx->has_stereo3d         = ctx_from->has_stereo3d;
+    ctx->cc_format            = ctx_from->cc_format;
+    ctx->afd                  = ctx_from->afd;
+    ctx->has_afd              = ctx_from->has_afd;
+    ctx->aspect_ratio_info    = ctx_from->aspect_ratio_info;
+    ctx->save_aspect          = ctx_from->save_aspect;
+    ctx->save_width           = ctx_from->save_width;
+    ctx->save_height          = ctx_from->save_height;
+    ctx->save_progressive_seq = ctx_from->save_progressive_seq;
+    ctx->frame_rate_ext       = ctx_from->frame_rate_ext;
+    ctx->frame_rate_index     = ctx_from->frame_rate_index;
+    ctx->sync                 = ctx_from->sync;
+    ctx->closed_gop           = ctx_from->closed_gop;
+    ctx->tmpgexs              = ctx_from->tmpgexs;
+    ctx->extradata_decoded    = ctx_from->extradata_decoded;
+    ctx->vbv_delay            = ctx_from->vbv_delay;
+    ctx->timecode_frame_start = ctx_from->timecode_frame_start;
 
     return 0;
 }
@@ -1332,8 +1361,14 @@ static int mpeg_field_start(Mpeg1Context *s1, const uint8_t *buf, int buf_size)
             s1->has_afd = 0;
         }
 
-        if (HAVE_THREADS && (avctx->active_thread_type & FF_THREAD_FRAME))
-            ff_thread_finish_setup(avctx);
+        /* The GOP timecode goes with the next picture to be output. Take it
+         * now, while the next frame thread cannot copy it yet. */
+        if (s1->timecode_frame_start != -1 &&
+            (s->pict_type == AV_PICTURE_TYPE_B || s->low_delay ||
+             (s->last_pic.ptr && !s->last_pic.ptr->dummy))) {
+            s1->timecode_output      = s1->timecode_frame_start;
+            s1->timecode_frame_start = -1;
+        }
     } else { // second field
         second_field = 1;
         if (!s->cur_pic.ptr) {
@@ -1375,6 +1410,12 @@ static int mpeg_field_start(Mpeg1Context *s1, const uint8_t *buf, int buf_size)
         }
     }
 
+    /* A field pair shares one frame and one thread; the next thread may
+     * only start once the header of the second field has been parsed. */
+    if (HAVE_THREADS && (avctx->active_thread_type & FF_THREAD_FRAME) &&
+        (s->picture_structure == PICT_FRAME || second_field))
+        ff_thread_finish_setup(avctx);
+
     return 0;
 }
 
@@ -2479,7 +2520,10 @@ static int decode_chunks(AVCodecContext *avctx, AVFrame *picture,
                         }
                     }
                 }
-                if (s2->pict_type == AV_PICTURE_TYPE_I || (s2->avctx->flags2 & AV_CODEC_FLAG2_SHOW_ALL))
+                /* Only write on change: later slices run after setup has
+                 * finished, when the next frame thread may read sync. */
+                if (!s->sync && (s2->pict_type == AV_PICTURE_TYPE_I ||
+                                 (s2->avctx->flags2 & AV_CODEC_FLAG2_SHOW_ALL)))
                     s->sync = 1;
                 if (!s2->next_pic.ptr) {
                     /* Skip P-frames if we do not have a reference frame or
@@ -2619,23 +2663,22 @@ static int mpeg_decode_frame(AVCodecContext *avctx, AVFrame *picture,
         }
     }
 
+    s->timecode_output = -1;
     ret = decode_chunks(avctx, picture, got_output, buf, buf_size);
     if (ret<0 || *got_output) {
         ff_mpv_unref_picture(&s2->cur_pic);
 
-        if (s->timecode_frame_start != -1 && *got_output) {
+        if (s->timecode_output != -1 && *got_output) {
             char tcbuf[AV_TIMECODE_STR_SIZE];
             AVFrameSideData *tcside = av_frame_new_side_data(picture,
                                                              AV_FRAME_DATA_GOP_TIMECODE,
                                                              sizeof(int64_t));
             if (!tcside)
                 return AVERROR(ENOMEM);
-            memcpy(tcside->data, &s->timecode_frame_start, sizeof(int64_t));
+            memcpy(tcside->data, &s->timecode_output, sizeof(int64_t));
 
-            av_timecode_make_mpeg_tc_string(tcbuf, s->timecode_frame_start);
+            av_timecode_make_mpeg_tc_string(tcbuf, s->timecode_output);
             av_dict_set(&picture->metadata, "timecode", tcbuf, 0);
-
-            s->timecode_frame_start = -1;
         }
     }
 
@@ -2671,7 +2714,8 @@ const FFCodec ff_mpeg1video_decoder = {
     .close                 = mpeg_decode_end,
     FF_CODEC_DECODE_CB(mpeg_decode_frame),
     .p.capabilities        = AV_CODEC_CAP_DRAW_HORIZ_BAND | AV_CODEC_CAP_DR1 |
-                             AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                             AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                             AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal         = FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
     .flush                 = flush,
     .p.max_lowres          = 3,
@@ -2730,10 +2774,12 @@ const FFCodec ff_mpeg2video_decoder = {
     .close          = mpeg_decode_end,
     FF_CODEC_DECODE_CB(mpeg_decode_frame),
     .p.capabilities = AV_CODEC_CAP_DRAW_HORIZ_BAND | AV_CODEC_CAP_DR1 |
-                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
     .flush          = flush,
     .p.max_lowres   = 3,
+    UPDATE_THREAD_CONTEXT(mpeg_decode_update_thread_context),
     .p.profiles     = NULL_IF_CONFIG_SMALL(ff_mpeg2_video_profiles),
     .hw_configs     = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_MPEG2_DXVA2_HWACCEL
@@ -2775,10 +2821,12 @@ const FFCodec ff_mpegvideo_decoder = {
     .close          = mpeg_decode_end,
     FF_CODEC_DECODE_CB(mpeg_decode_frame),
     .p.capabilities = AV_CODEC_CAP_DRAW_HORIZ_BAND | AV_CODEC_CAP_DR1 |
-                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
     .flush          = flush,
     .p.max_lowres   = 3,
+    UPDATE_THREAD_CONTEXT(mpeg_decode_update_thread_context),
 };
 
 typedef struct IPUContext {
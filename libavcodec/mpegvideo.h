@@ -522,6 +522,7 @@ typedef struct MpegEncContext {
     AVFrame *tmp_frames[MAX_B_FRAMES + 2];
     int b_frame_strategy;
     int b_sensitivity;
+    int b_scenecut;
 
     /* frame skip options for encoding */
     int frame_skip_threshold;
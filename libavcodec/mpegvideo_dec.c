@@ -442,8 +442,18 @@ void ff_mpeg_flush(AVCodecContext *avctx)
 
 void ff_mpv_report_decode_progress(MpegEncContext *s)
 {
-    if (s->pict_type != AV_PICTURE_TYPE_B && !s->partitioned_frame && !s->er.error_occurred)
+    if (s->pict_type == AV_PICTURE_TYPE_B || s->partitioned_frame || s->er.error_occurred)
+        return;
+
+    if (s->picture_structure == PICT_FRAME) {
         ff_thread_progress_report(&s->cur_pic.ptr->progress, s->mb_y);
+    } else if (!s->first_field) {
+        /* Progress is counted in frame MB rows with both fields decoded.
+         * A row of field MBs covers two frame MB rows, which are complete
+         * once the second field has reached them; the first field alone
+         * never completes a frame row. */
+        ff_thread_progress_report(&s->cur_pic.ptr->progress, s->mb_y | 1);
+    }
 }
 
 
@@ -843,9 +853,10 @@ static inline void MPV_motion_lowres(MpegEncContext *s,
 static int lowest_referenced_row(MpegEncContext *s, int dir)
 {
     int my_max = INT_MIN, my_min = INT_MAX, qpel_shift = !s->quarter_sample;
+    int field_pic = s->picture_structure != PICT_FRAME;
     int off, mvs;
 
-    if (s->picture_structure != PICT_FRAME || s->mcsel)
+    if (s->mcsel)
         goto unhandled;
 
     switch (s->mv_type) {
@@ -858,6 +869,9 @@ static int lowest_referenced_row(MpegEncContext *s, int dir)
         case MV_TYPE_8X8:
             mvs = 4;
             break;
+        case MV_TYPE_FIELD:
+            mvs = field_pic ? 1 : 2;
+            break;
         default:
             goto unhandled;
     }
@@ -870,6 +884,17 @@ static int lowest_referenced_row(MpegEncContext *s, int dir)
 
     off = ((FFMAX(-my_min, my_max) << qpel_shift) + 63) >> 6;
 
+    /* Field MVs of frame pictures are in field lines: scale them to frame
+     * lines and allow for the opposite parity and the half-pel tap. */
+    if (s->mv_type == MV_TYPE_FIELD && !field_pic)
+        off = ((FFMAX(-my_min, my_max) << qpel_shift) * 2 + 12 + 63) >> 6;
+
+    /* Field MVs are in field lines and a field MB row spans two frame MB
+     * rows; either field of the reference may be used, so wait for the
+     * bottom one of the pair. */
+    if (field_pic)
+        return av_clip((((s->mb_y >> 1) + off) << 1) + 1, 0, s->mb_height - 1);
+
     return av_clip(s->mb_y + off, 0, s->mb_height - 1);
 unhandled:
     return s->mb_height - 1;
@@ -931,8 +956,7 @@ void mpv_reconstruct_mb_internal(MpegEncContext *s, int16_t block[12][64],
 
     if (!s->mb_intra) {
         /* motion handling */
-        if (HAVE_THREADS && is_mpeg12 != DEFINITELY_MPEG12_H261 &&
-            s->avctx->active_thread_type & FF_THREAD_FRAME) {
+        if (HAVE_THREADS && s->avctx->active_thread_type & FF_THREAD_FRAME) {
             if (s->mv_dir & MV_DIR_FORWARD) {
                 ff_thread_progress_await(&s->last_pic.ptr->progress,
                                          lowest_referenced_row(s, 0));
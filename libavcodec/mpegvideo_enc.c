@@ -705,6 +705,11 @@ av_cold int ff_mpv_encode_init(AVCodecContext *avctx)
                "notice: b_frame_strategy only affects the first pass\n");
         s->b_frame_strategy = 0;
     }
+    if (s->b_scenecut && (avctx->flags & AV_CODEC_FLAG_PASS2)) {
+        av_log(avctx, AV_LOG_INFO,
+               "notice: b_scenecut only affects the first pass\n");
+        s->b_scenecut = 0;
+    }
 
     i = av_gcd(avctx->time_base.den, avctx->time_base.num);
     if (i > 1) {
@@ -1213,6 +1218,53 @@ static int get_intra_count(MpegEncContext *s, const uint8_t *src,
     return acc;
 }
 
+/**
+ * Return the luma source of a queued input picture; unless it is shared or
+ * kept for VBV re-encoding, it is stored INPLACE_OFFSET into the buffer.
+ */
+static const uint8_t *input_luma(const MpegEncContext *s, const MPVPicture *pic)
+{
+    int inplace = !pic->shared && !s->avctx->rc_buffer_size;
+
+    return pic->f->data[0] + (inplace ? INPLACE_OFFSET : 0);
+}
+
+static int intra_count_thread(AVCodecContext *avctx, void *arg,
+                              int jobnr, int threadnr)
+{
+    MpegEncContext *s = avctx->priv_data;
+    const int i = *(const int *)arg + jobnr;
+    MPVPicture *const cur = s->input_picture[i];
+    const uint8_t *prev;
+
+    if (!cur || cur->b_frame_score)
+        return 0;
+
+    /* the picture before input_picture[0] is the reconstructed reference */
+    if (i)
+        prev = input_luma(s, s->input_picture[i - 1]);
+    else if (s->next_pic.ptr)
+        prev = s->next_pic.ptr->f->data[0];
+    else
+        return 0;
+
+    cur->b_frame_score = get_intra_count(s, input_luma(s, cur), prev,
+                                         s->linesize) + 1;
+    emms_c();
+    return 0;
+}
+
+/**
+ * Set b_frame_score of the look-ahead pictures first..last that do not
+ * have one yet. Each picture is only compared to its predecessor, so the
+ * pictures are scored in parallel.
+ */
+static void score_lookahead(MpegEncContext *s, int first, int last)
+{
+    s->avctx->execute2(s->avctx, intra_count_thread, &first, NULL,
+                       last - first + 1);
+}
+
 /**
  * Allocates new buffers for an AVFrame and copies the properties
  * from another AVFrame.
@@ -1451,31 +1503,120 @@ static int encode_frame(AVCodecContext *c, const AVFrame *frame, AVPacket *pkt)
     return size;
 }
 
+typedef struct BFrameEstimate {
+    int p_lambda, b_lambda, lambda2;
+    int64_t rd[MAX_B_FRAMES + 1];   ///< rate-distortion cost per B-frame count, or a negative error code
+} BFrameEstimate;
+
+/**
+ * Trial-encode the downscaled look-ahead frames with jobnr B-frames
+ * between references. The trials are independent of each other,
+ * so they run as separate jobs.
+ */
+static int estimate_b_count_thread(AVCodecContext *avctx, void *arg,
+                                   int jobnr, int threadnr)
+{
+    MpegEncContext *s  = avctx->priv_data;
+    BFrameEstimate *be = arg;
+    const int scale    = s->brd_scale;
+    const int j        = jobnr;
+    AVCodecContext *c  = NULL;
+    AVPacket *pkt      = NULL;
+    AVFrame *frame     = NULL;
+    int64_t rd = 0;
+    int i, out_size, ret;
+
+    pkt   = av_packet_alloc();
+    frame = av_frame_alloc();
+    c     = avcodec_alloc_context3(NULL);
+    if (!pkt || !frame || !c) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    c->width        = s->width  >> scale;
+    c->height       = s->height >> scale;
+    c->flags        = AV_CODEC_FLAG_QSCALE | AV_CODEC_FLAG_PSNR;
+    c->flags       |= s->avctx->flags & AV_CODEC_FLAG_QPEL;
+    c->mb_decision  = s->avctx->mb_decision;
+    c->me_cmp       = s->avctx->me_cmp;
+    c->mb_cmp       = s->avctx->mb_cmp;
+    c->me_sub_cmp   = s->avctx->me_sub_cmp;
+    c->pix_fmt      = AV_PIX_FMT_YUV420P;
+    c->time_base    = s->avctx->time_base;
+    c->max_b_frames = s->max_b_frames;
+
+    ret = avcodec_open2(c, s->avctx->codec, NULL);
+    if (ret < 0)
+        goto fail;
+
+    /* The shrunk frames are shared by all trials; only the per-trial
+     * picture type and quality go into a private reference. */
+    for (i = 0; i < s->max_b_frames + 2; i++) {
+        int is_p = i && ((i - 1) % (j + 1) == j || i - 1 == s->max_b_frames);
+
+        ret = av_frame_ref(frame, s->tmp_frames[i]);
+        if (ret < 0)
+            goto fail;
+        if (!i) {
+            frame->pict_type = AV_PICTURE_TYPE_I;
+            frame->quality   = 1 * FF_QP2LAMBDA;
+        } else {
+            frame->pict_type = is_p ? AV_PICTURE_TYPE_P : AV_PICTURE_TYPE_B;
+            frame->quality   = is_p ? be->p_lambda : be->b_lambda;
+        }
+
+        out_size = encode_frame(c, frame, pkt);
+        av_frame_unref(frame);
+        if (out_size < 0) {
+            ret = out_size;
+            goto fail;
+        }
+
+        //rd += (out_size * lambda2) >> FF_LAMBDA_SHIFT;
+        if (i)
+            rd += (out_size * (uint64_t)be->lambda2) >> (FF_LAMBDA_SHIFT - 3);
+    }
+
+    /* get the delayed frames */
+    out_size = encode_frame(c, NULL, pkt);
+    if (out_size < 0) {
+        ret = out_size;
+        goto fail;
+    }
+    rd += (out_size * (uint64_t)be->lambda2) >> (FF_LAMBDA_SHIFT - 3);
+
+    rd += c->error[0] + c->error[1] + c->error[2];
+    ret = 0;
+
+fail:
+    avcodec_free_context(&c);
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    be->rd[j] = ret < 0 ? ret : rd;
+    return ret;
+}
+
 static int estimate_best_b_count(MpegEncContext *s)
 {
-    AVPacket *pkt;
+    BFrameEstimate be;
     const int scale = s->brd_scale;
     int width  = s->width  >> scale;
     int height = s->height >> scale;
-    int i, j, out_size, p_lambda, b_lambda, lambda2;
+    int i, j, nb_trials;
     int64_t best_rd  = INT64_MAX;
     int best_b_count = -1;
-    int ret = 0;
 
     av_assert0(scale >= 0 && scale <= 3);
 
-    pkt = av_packet_alloc();
-    if (!pkt)
-        return AVERROR(ENOMEM);
-
     //emms_c();
-    p_lambda = s->last_lambda_for[AV_PICTURE_TYPE_P];
+    be.p_lambda = s->last_lambda_for[AV_PICTURE_TYPE_P];
     //p_lambda * FFABS(s->avctx->b_quant_factor) + s->avctx->b_quant_offset;
-    b_lambda = s->last_lambda_for[AV_PICTURE_TYPE_B];
-    if (!b_lambda) // FIXME we should do this somewhere else
-        b_lambda = p_lambda;
-    lambda2  = (b_lambda * b_lambda + (1 << FF_LAMBDA_SHIFT) / 2) >>
-               FF_LAMBDA_SHIFT;
+    be.b_lambda = s->last_lambda_for[AV_PICTURE_TYPE_B];
+    if (!be.b_lambda) // FIXME we should do this somewhere else
+        be.b_lambda = be.p_lambda;
+    be.lambda2  = (be.b_lambda * be.b_lambda + (1 << FF_LAMBDA_SHIFT) / 2) >>
+                  FF_LAMBDA_SHIFT;
 
     for (i = 0; i < s->max_b_frames + 2; i++) {
         const MPVPicture *pre_input_ptr = i ? s->input_picture[i - 1] :
@@ -1509,92 +1650,39 @@ static int estimate_best_b_count(MpegEncContext *s)
         }
     }
 
-    for (j = 0; j < s->max_b_frames + 1; j++) {
-        AVCodecContext *c;
-        int64_t rd = 0;
-
-        if (!s->input_picture[j])
+    for (nb_trials = 0; nb_trials < s->max_b_frames + 1; nb_trials++)
+        if (!s->input_picture[nb_trials])
             break;
 
-        c = avcodec_alloc_context3(NULL);
-        if (!c) {
-            ret = AVERROR(ENOMEM);
-            goto fail;
-        }
-
-        c->width        = width;
-        c->height       = height;
-        c->flags        = AV_CODEC_FLAG_QSCALE | AV_CODEC_FLAG_PSNR;
-        c->flags       |= s->avctx->flags & AV_CODEC_FLAG_QPEL;
-        c->mb_decision  = s->avctx->mb_decision;
-        c->me_cmp       = s->avctx->me_cmp;
-        c->mb_cmp       = s->avctx->mb_cmp;
-        c->me_sub_cmp   = s->avctx->me_sub_cmp;
-        c->pix_fmt      = AV_PIX_FMT_YUV420P;
-        c->time_base    = s->avctx->time_base;
-        c->max_b_frames = s->max_b_frames;
-
-        ret = avcodec_open2(c, s->avctx->codec, NULL);
-        if (ret < 0)
-            goto fail;
-
-
-        s->tmp_frames[0]->pict_type = AV_PICTURE_TYPE_I;
-        s->tmp_frames[0]->quality   = 1 * FF_QP2LAMBDA;
-
-        out_size = encode_frame(c, s->tmp_frames[0], pkt);
-        if (out_size < 0) {
-            ret = out_size;
-            goto fail;
-        }
-
-        //rd += (out_size * lambda2) >> FF_LAMBDA_SHIFT;
-
-        for (i = 0; i < s->max_b_frames + 1; i++) {
-            int is_p = i % (j + 1) == j || i == s->max_b_frames;
-
-            s->tmp_frames[i + 1]->pict_type = is_p ?
-                                     AV_PICTURE_TYPE_P : AV_PICTURE_TYPE_B;
-            s->tmp_frames[i + 1]->quality   = is_p ? p_lambda : b_lambda;
-
-            out_size = encode_frame(c, s->tmp_frames[i + 1], pkt);
-            if (out_size < 0) {
-                ret = out_size;
-                goto fail;
-            }
-
-            rd += (out_size * (uint64_t)lambda2) >> (FF_LAMBDA_SHIFT - 3);
-        }
-
-        /* get the delayed frames */
-        out_size = encode_frame(c, NULL, pkt);
-        if (out_size < 0) {
-            ret = out_size;
-            goto fail;
-        }
-        rd += (out_size * (uint64_t)lambda2) >> (FF_LAMBDA_SHIFT - 3);
-
-        rd += c->error[0] + c->error[1] + c->error[2];
+    s->avctx->execute2(s->avctx, estimate_b_count_thread, &be, NULL, nb_trials);
 
-        if (rd < best_rd) {
-            best_rd = rd;
+    for (j = 0; j < nb_trials; j++) {
+        if (be.rd[j] < 0)
+            return be.rd[j];
+        if (be.rd[j] < best_rd) {
+            best_rd = be.rd[j];
             best_b_count = j;
         }
-
-fail:
-        avcodec_free_context(&c);
-        av_packet_unref(pkt);
-        if (ret < 0) {
-            best_b_count = ret;
-            break;
-        }
     }
 
-    av_packet_free(&pkt);
-
     return best_b_count;
 }
 
+/**
+ * Check whether the scored look-ahead picture i starts a new scene, i.e.
+ * most of it is better coded intra than predicted from the picture before
+ * it, while picture i + 1 can again be predicted from it. The second test
+ * keeps high motion, where every picture looks intra, from being cut.
+ */
+static int is_scene_cut(const MpegEncContext *s, int i, int n)
+{
+    const MPVPicture *next = i < n ? s->input_picture[i + 1] : NULL;
+    int score = s->input_picture[i]->b_frame_score - 1;
+
+    return next && score > s->mb_num / 2 &&
+           2 * (next->b_frame_score - 1) < score;
+}
+
 /**
  * Determines whether an input picture is discarded or not
  * and if not determines the length of the next chain of B frames
@@ -1655,16 +1743,7 @@ static int set_bframe_chain_length(MpegEncContext *s)
                 b_frames--;
         } else if (s->b_frame_strategy == 1) {
             int i;
-            for (i = 1; i < s->max_b_frames + 1; i++) {
-                if (s->input_picture[i] &&
-                    s->input_picture[i]->b_frame_score == 0) {
-                    s->input_picture[i]->b_frame_score =
-                        get_intra_count(s,
-                                        s->input_picture[i    ]->f->data[0],
-                                        s->input_picture[i - 1]->f->data[0],
-                                        s->linesize) + 1;
-                }
-            }
+            score_lookahead(s, 1, s->max_b_frames);
             for (i = 0; i < s->max_b_frames + 1; i++) {
                 if (!s->input_picture[i] ||
                     s->input_picture[i]->b_frame_score - 1 >
@@ -1688,6 +1767,20 @@ static int set_bframe_chain_length(MpegEncContext *s)
 
         emms_c();
 
+        if (s->b_scenecut && b_frames) {
+            /* Do not let a B-frame chain straddle a scene change: the last
+             * picture before the cut becomes the reference and the next
+             * chain starts with an intra picture at the cut. */
+            score_lookahead(s, 0, s->max_b_frames);
+            for (int i = 0; i <= b_frames; i++) {
+                if (is_scene_cut(s, i, s->max_b_frames)) {
+                    s->input_picture[i]->f->pict_type = AV_PICTURE_TYPE_I;
+                    b_frames = FFMAX(i - 1, 0);
+                    break;
+                }
+            }
+        }
+
         for (int i = b_frames - 1; i >= 0; i--) {
             int type = s->input_picture[i]->f->pict_type;
             if (type && type != AV_PICTURE_TYPE_B)
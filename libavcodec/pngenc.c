@@ -26,6 +26,7 @@
 #include "lossless_videoencdsp.h"
 #include "png.h"
 #include "apng.h"
+#include "pngencdsp.h"
 #include "zlib_wrapper.h"
 
 #include "libavutil/avassert.h"
@@ -42,6 +43,22 @@
 
 #define IOBUF_SIZE 4096
 
+/* minimum number of rows compressed as one independent deflate stream */
+#define SLICE_MIN_ROWS 16
+#define DEFLATE_WINDOW_SIZE (1 << MAX_WBITS)
+
+typedef struct PNGEncSlice {
+    FFZStream zstream;          ///< raw deflate stream of this slice
+    uint8_t *crow_base;         ///< filtered row scratch buffer
+    uint8_t *dict;              ///< filtered tail of the previous slice
+    unsigned dict_size;
+    uint8_t *buf;               ///< compressed output
+    unsigned buf_size;
+    int len;                    ///< bytes of compressed output
+    uLong adler;                ///< Adler-32 of the uncompressed slice
+    int ret;
+} PNGEncSlice;
+
 typedef struct APNGFctlChunk {
     uint32_t sequence_number;
     uint32_t width, height;
@@ -53,6 +70,7 @@ typedef struct APNGFctlChunk {
 typedef struct PNGEncContext {
     AVClass *class;
     LLVidEncDSPContext llvidencdsp;
+    PNGEncDSPContext pngencdsp;
 
     uint8_t *bytestream;
     uint8_t *bytestream_start;
@@ -62,6 +80,9 @@ typedef struct PNGEncContext {
 
     FFZStream zstream;
     uint8_t buf[IOBUF_SIZE];
+    int compression_level;
+    PNGEncSlice *slices;
+    int nb_slices;
     int dpi;                     ///< Physical pixel density, in dots per inch, if set
     int dpm;                     ///< Physical pixel density, in dots per meter, if set
 
@@ -123,34 +144,6 @@ static void png_get_interlaced_row(uint8_t *dst, int row_size,
     }
 }
 
-static void sub_png_paeth_prediction(uint8_t *dst, const uint8_t *src, const uint8_t *top,
-                                     int w, int bpp)
-{
-    int i;
-    for (i = 0; i < w; i++) {
-        int a, b, c, p, pa, pb, pc;
-
-        a = src[i - bpp];
-        b = top[i];
-        c = top[i - bpp];
-
-        p  = b - c;
-        pc = a - c;
-
-        pa = abs(p);
-        pb = abs(pc);
-        pc = abs(p + pc);
-
-        if (pa <= pb && pa <= pc)
-            p = a;
-        else if (pb <= pc)
-            p = b;
-        else
-            p = c;
-        dst[i] = src[i] - p;
-    }
-}
-
 static void sub_left_prediction(PNGEncContext *c, uint8_t *dst, const uint8_t *src, int bpp, int size)
 {
     const uint8_t *src1 = src + bpp;
@@ -185,13 +178,12 @@ static void png_filter_row(PNGEncContext *c, uint8_t *dst, int filter_type,
     case PNG_FILTER_VALUE_AVG:
         for (i = 0; i < bpp; i++)
             dst[i] = src[i] - (top[i] >> 1);
-        for (; i < size; i++)
-            dst[i] = src[i] - ((src[i - bpp] + top[i]) >> 1);
+        c->pngencdsp.sub_avg_prediction(dst + i, src + i, top + i, size - i, bpp);
         break;
     case PNG_FILTER_VALUE_PAETH:
         for (i = 0; i < bpp; i++)
             dst[i] = src[i] - top[i];
-        sub_png_paeth_prediction(dst + i, src + i, top + i, size - i, bpp);
+        c->pngencdsp.sub_paeth_prediction(dst + i, src + i, top + i, size - i, bpp);
         break;
     }
 }
@@ -506,6 +498,155 @@ static int encode_headers(AVCodecContext *avctx, const AVFrame *pict)
     return 0;
 }
 
+static int slice_deflate(PNGEncSlice *sl, int flush)
+{
+    z_stream *const zstream = &sl->zstream.zstream;
+    int ret;
+
+    do {
+        if (!zstream->avail_out) {
+            size_t len = zstream->next_out - sl->buf;
+            uint8_t *buf = av_fast_realloc(sl->buf, &sl->buf_size, len + IOBUF_SIZE);
+            if (!buf)
+                return AVERROR(ENOMEM);
+            sl->buf            = buf;
+            zstream->next_out  = buf + len;
+            zstream->avail_out = sl->buf_size - len;
+        }
+        ret = deflate(zstream, flush);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+            return AVERROR_EXTERNAL;
+    } while (flush == Z_FINISH ? ret != Z_STREAM_END :
+             zstream->avail_in || (flush != Z_NO_FLUSH && !zstream->avail_out));
+    return 0;
+}
+
+/**
+ * Filter and compress a group of rows into an independent raw deflate
+ * stream. All but the last stream end with a sync flush, so the streams
+ * can simply be concatenated; each one is primed with the filtered tail
+ * of the preceding rows to keep the compression ratio close to a single
+ * stream.
+ */
+static int encode_slice(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    PNGEncContext *s        = avctx->priv_data;
+    const AVFrame *const p  = arg;
+    PNGEncSlice *const sl   = &s->slices[jobnr];
+    z_stream *const zstream = &sl->zstream.zstream;
+    const int bpp           = s->bits_per_pixel >> 3;
+    const int row_size      = (p->width * s->bits_per_pixel + 7) >> 3;
+    const int y_start       = p->height *  jobnr      / s->nb_slices;
+    const int y_end         = p->height * (jobnr + 1) / s->nb_slices;
+    const int last          = jobnr == s->nb_slices - 1;
+    uint8_t *const crow_buf = sl->crow_base + 15;
+    const uint8_t *top = NULL;
+    uint8_t *crow;
+    uLong bound;
+    int ret;
+
+    sl->ret = 0;
+    sl->len = 0;
+    if (deflateReset(zstream) != Z_OK)
+        return sl->ret = AVERROR_EXTERNAL;
+
+    if (y_start) {
+        int dict_rows = FFMIN(y_start, (DEFLATE_WINDOW_SIZE + row_size) / (row_size + 1));
+        int dict_len  = dict_rows * (row_size + 1);
+
+        av_fast_malloc(&sl->dict, &sl->dict_size, dict_len);
+        if (!sl->dict)
+            return sl->ret = AVERROR(ENOMEM);
+        for (int y = y_start - dict_rows; y < y_start; y++) {
+            const uint8_t *ptr = p->data[0] + y * p->linesize[0];
+            crow = png_choose_filter(s, crow_buf, ptr, y ? ptr - p->linesize[0] : NULL,
+                                     row_size, bpp);
+            memcpy(sl->dict + (y - y_start + dict_rows) * (row_size + 1), crow, row_size + 1);
+        }
+        if (dict_len > DEFLATE_WINDOW_SIZE) {
+            ret = deflateSetDictionary(zstream, sl->dict + dict_len - DEFLATE_WINDOW_SIZE,
+                                       DEFLATE_WINDOW_SIZE);
+        } else
+            ret = deflateSetDictionary(zstream, sl->dict, dict_len);
+        if (ret != Z_OK)
+            return sl->ret = AVERROR_EXTERNAL;
+        top = p->data[0] + (y_start - 1) * p->linesize[0];
+    }
+
+    /* room for the zlib header and trailer around the raw streams */
+    bound = deflateBound(zstream, (uLong)(y_end - y_start) * (row_size + 1)) + 64;
+    av_fast_malloc(&sl->buf, &sl->buf_size, bound);
+    if (!sl->buf)
+        return sl->ret = AVERROR(ENOMEM);
+    zstream->next_out  = sl->buf + (jobnr ? 0 : 2);
+    zstream->avail_out = sl->buf_size - (jobnr ? 0 : 2) - (last ? 4 : 0);
+
+    sl->adler = adler32(0, Z_NULL, 0);
+    for (int y = y_start; y < y_end; y++) {
+        const uint8_t *ptr = p->data[0] + y * p->linesize[0];
+        crow = png_choose_filter(s, crow_buf, ptr, top, row_size, bpp);
+        sl->adler = adler32(sl->adler, crow, row_size + 1);
+        zstream->next_in  = crow;
+        zstream->avail_in = row_size + 1;
+        if ((ret = slice_deflate(sl, Z_NO_FLUSH)) < 0)
+            return sl->ret = ret;
+        top = ptr;
+    }
+    if ((ret = slice_deflate(sl, last ? Z_FINISH : Z_SYNC_FLUSH)) < 0)
+        return sl->ret = ret;
+
+    sl->len = zstream->next_out - sl->buf;
+    if (last && sl->buf_size - sl->len < 4) {
+        uint8_t *buf = av_fast_realloc(sl->buf, &sl->buf_size, sl->len + 4);
+        if (!buf)
+            return sl->ret = AVERROR(ENOMEM);
+        sl->buf = buf;
+    }
+    return 0;
+}
+
+static int encode_frame_slices(AVCodecContext *avctx, const AVFrame *pict)
+{
+    PNGEncContext *s   = avctx->priv_data;
+    const int row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
+    PNGEncSlice *sl;
+    uLong adler;
+    int level_flags, header;
+
+    avctx->execute2(avctx, encode_slice, (void *)pict, NULL, s->nb_slices);
+
+    for (int i = 0; i < s->nb_slices; i++)
+        if (s->slices[i].ret < 0)
+            return s->slices[i].ret;
+
+    /* zlib header matching what deflateInit() would write */
+    level_flags = s->compression_level == Z_DEFAULT_COMPRESSION ? 2 :
+                  s->compression_level < 2 ? 0 :
+                  s->compression_level < 6 ? 1 :
+                  s->compression_level == 6 ? 2 : 3;
+    header  = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8 | level_flags << 6;
+    header += 31 - header % 31;
+    AV_WB16(s->slices[0].buf, header);
+
+    adler = s->slices[0].adler;
+    for (int i = 1; i < s->nb_slices; i++) {
+        int rows = pict->height * (i + 1) / s->nb_slices - pict->height * i / s->nb_slices;
+        adler = adler32_combine(adler, s->slices[i].adler,
+                                (z_off_t)rows * (row_size + 1));
+    }
+    sl = &s->slices[s->nb_slices - 1];
+    AV_WB32(sl->buf + sl->len, adler);
+    sl->len += 4;
+
+    for (int i = 0; i < s->nb_slices; i++) {
+        sl = &s->slices[i];
+        if (s->bytestream_end - s->bytestream < sl->len + 12)
+            return AVERROR_BUG;
+        png_write_image_data(avctx, sl->buf, sl->len);
+    }
+    return 0;
+}
+
 static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
 {
     PNGEncContext *s       = avctx->priv_data;
@@ -518,6 +659,9 @@ static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
     uint8_t *progressive_buf = NULL;
     uint8_t *top_buf         = NULL;
 
+    if (s->nb_slices)
+        return encode_frame_slices(avctx, pict);
+
     row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
 
     crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
@@ -1123,6 +1267,7 @@ static av_cold int png_enc_init(AVCodecContext *avctx)
     }
 
     ff_llvidencdsp_init(&s->llvidencdsp);
+    ff_pngencdsp_init(&s->pngencdsp);
 
     if (avctx->pix_fmt == AV_PIX_FMT_MONOBLACK)
         s->filter_type = PNG_FILTER_VALUE_NONE;
@@ -1184,6 +1329,32 @@ static av_cold int png_enc_init(AVCodecContext *avctx)
     compression_level = avctx->compression_level == FF_COMPRESSION_DEFAULT
                       ? Z_DEFAULT_COMPRESSION
                       : av_clip(avctx->compression_level, 0, 9);
+    s->compression_level = compression_level;
+
+    if (avctx->active_thread_type & FF_THREAD_SLICE && !s->is_progressive) {
+        int nb_slices = FFMIN(avctx->thread_count, avctx->height / SLICE_MIN_ROWS);
+        int row_size  = (avctx->width * s->bits_per_pixel + 7) >> 3;
+
+        if (nb_slices > 1) {
+            s->slices = av_calloc(nb_slices, sizeof(*s->slices));
+            if (!s->slices)
+                return AVERROR(ENOMEM);
+            s->nb_slices = nb_slices;
+            for (int i = 0; i < nb_slices; i++) {
+                PNGEncSlice *sl = &s->slices[i];
+                int ret;
+
+                sl->crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
+                if (!sl->crow_base)
+                    return AVERROR(ENOMEM);
+                ret = ff_deflate_init2(&sl->zstream, compression_level,
+                                       -MAX_WBITS, avctx);
+                if (ret < 0)
+                    return ret;
+            }
+        }
+    }
+
     return ff_deflate_init(&s->zstream, compression_level, avctx);
 }
 
@@ -1192,6 +1363,15 @@ static av_cold int png_enc_close(AVCodecContext *avctx)
     PNGEncContext *s = avctx->priv_data;
 
     ff_deflate_end(&s->zstream);
+    for (int i = 0; i < s->nb_slices; i++) {
+        PNGEncSlice *sl = &s->slices[i];
+        ff_deflate_end(&sl->zstream);
+        av_freep(&sl->crow_base);
+        av_freep(&sl->dict);
+        av_freep(&sl->buf);
+    }
+    av_freep(&s->slices);
+    s->nb_slices = 0;
     av_frame_free(&s->last_frame);
     av_frame_free(&s->prev_frame);
     av_freep(&s->last_frame_packet);
@@ -1228,6 +1408,7 @@ const FFCodec ff_png_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_PNG,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(PNGEncContext),
     .init           = png_enc_init,
@@ -1240,7 +1421,8 @@ const FFCodec ff_png_encoder = {
                   AV_PIX_FMT_GRAY16BE, AV_PIX_FMT_YA16BE,
                   AV_PIX_FMT_MONOBLACK),
     .p.priv_class   = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_ICC_PROFILES,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP |
+                      FF_CODEC_CAP_ICC_PROFILES,
 };
 
 const FFCodec ff_apng_encoder = {
@@ -1260,5 +1442,6 @@ const FFCodec ff_apng_encoder = {
                   AV_PIX_FMT_GRAY8, AV_PIX_FMT_GRAY8A,
                   AV_PIX_FMT_GRAY16BE, AV_PIX_FMT_YA16BE),
     .p.priv_class   = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_ICC_PROFILES,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP |
+                      FF_CODEC_CAP_ICC_PROFILES,
 };
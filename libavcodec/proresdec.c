@@ -31,6 +31,7 @@
 #include "libavutil/internal.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
+#include "libavutil/thread.h"
 
 #include "avcodec.h"
 #include "codec_internal.h"
@@ -130,8 +131,97 @@ static void unpack_alpha_12(GetBitContext *gb, uint16_t *dst, int num_coeffs,
     }
 }
 
+// adaptive codebook switching according to previous run/level values,
+// as classes of identical codebooks
+#define AC_RUN_CLASSES 6
+#define AC_LEV_CLASSES 6
+static const uint8_t run_class_cb[AC_RUN_CLASSES] = { 0x06, 0x05, 0x04, 0x29, 0x28, 0x4C };
+static const uint8_t run_to_class[16] = { 0, 0, 1, 1, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 5 };
+static const uint8_t lev_class_cb[AC_LEV_CLASSES] = { 0x04, 0x0A, 0x05, 0x06, 0x28, 0x4C };
+static const uint8_t lev_to_class[10] = { 0, 1, 2, 3, 0, 4, 4, 4, 4, 5 };
+
+#define AC_STATE(run, level) (run_to_class[FFMIN(run, 15)] * AC_LEV_CLASSES + \
+                              lev_to_class[FFMIN(level, 9)])
+
+#define AC_LUT_BITS 9
+
+/**
+ * One AC coefficient (run, level and sign codewords) decoded from the
+ * next AC_LUT_BITS bits of the bitstream in a given codebook state.
+ *
+ * Entries deliberately hold a single coefficient. The shortest ones take
+ * 3 bits, but only 15-25% of the lookups in real streams find a second
+ * coefficient within AC_LUT_BITS, and the larger entries needed for a pair
+ * double the size of the table, which made decoding slower overall.
+ */
+typedef struct ACLUTEntry {
+    uint8_t len;    ///< total length in bits, 0 if it does not fit in AC_LUT_BITS
+    uint8_t run;
+    int8_t  level;
+    uint8_t state;  ///< codebook state for the next coefficient
+} ACLUTEntry;
+
+static ACLUTEntry ac_lut[AC_RUN_CLASSES * AC_LEV_CLASSES][1 << AC_LUT_BITS];
+
+/* Same as DECODE_CODEWORD() on a left-aligned 32-bit buffer. */
+static av_cold int lut_codeword(uint32_t buf, unsigned codebook, int *len)
+{
+    unsigned switch_bits =  codebook & 3;
+    unsigned rice_order  =  codebook >> 5;
+    unsigned exp_order   = (codebook >> 2) & 7;
+    unsigned q, bits;
+
+    if (!buf)
+        return -1;
+    q = 31 - av_log2(buf);
+
+    if (q > switch_bits) {
+        bits = exp_order - switch_bits + (q << 1);
+        if (bits > 31)
+            return -1;
+        *len = bits;
+        return (buf >> (32 - bits)) - (1 << exp_order) +
+               ((switch_bits + 1) << rice_order);
+    } else if (rice_order) {
+        *len = q + 1 + rice_order;
+        return (q << rice_order) + ((buf << (q + 1)) >> (32 - rice_order));
+    }
+    *len = q + 1;
+    return q;
+}
+
+static av_cold void init_ac_lut(void)
+{
+    for (int state = 0; state < FF_ARRAY_ELEMS(ac_lut); state++) {
+        unsigned run_cb = run_class_cb[state / AC_LEV_CLASSES];
+        unsigned lev_cb = lev_class_cb[state % AC_LEV_CLASSES];
+
+        for (unsigned bits = 0; bits < 1 << AC_LUT_BITS; bits++) {
+            ACLUTEntry *e = &ac_lut[state][bits];
+            uint32_t buf  = bits << (32 - AC_LUT_BITS);
+            int run, level, run_len, lev_len;
+
+            run = lut_codeword(buf, run_cb, &run_len);
+            if (run < 0 || run_len >= AC_LUT_BITS)
+                continue;
+            level = lut_codeword(buf << run_len, lev_cb, &lev_len);
+            if (level < 0 || run_len + lev_len >= AC_LUT_BITS)
+                continue;
+            level += 1;
+            if (run > UINT8_MAX || level > INT8_MAX)
+                continue;
+
+            e->len   = run_len + lev_len + 1;
+            e->run   = run;
+            e->level = (buf << (run_len + lev_len)) >> 31 ? -level : level;
+            e->state = AC_STATE(run, level);
+        }
+    }
+}
+
 static av_cold int decode_init(AVCodecContext *avctx)
 {
+    static AVOnce init_static_once = AV_ONCE_INIT;
     ProresContext *ctx = avctx->priv_data;
 
     avctx->bits_per_raw_sample = 10;
@@ -179,6 +269,8 @@ static av_cold int decode_init(AVCodecContext *avctx)
 
     ctx->pix_fmt = AV_PIX_FMT_NONE;
 
+    ff_thread_once(&init_static_once, init_ac_lut);
+
     return 0;
 }
 
@@ -476,23 +568,24 @@ static av_always_inline int decode_dc_coeffs(GetBitContext *gb, int16_t *out,
     return 0;
 }
 
-// adaptive codebook switching lut according to previous run/level values
-static const uint8_t run_to_cb[16] = { 0x06, 0x06, 0x05, 0x05, 0x04, 0x29, 0x29, 0x29, 0x29, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x4C };
-static const uint8_t lev_to_cb[10] = { 0x04, 0x0A, 0x05, 0x06, 0x04, 0x28, 0x28, 0x28, 0x28, 0x4C };
-
+/**
+ * Decode the AC coefficients of a slice. With use_lut, coefficients whose
+ * run, level and sign codewords fit in AC_LUT_BITS are decoded with a
+ * single table lookup; the output is identical either way.
+ */
 static av_always_inline int decode_ac_coeffs(AVCodecContext *avctx, GetBitContext *gb,
-                                             int16_t *out, int blocks_per_slice)
+                                             int16_t *out, int blocks_per_slice,
+                                             int use_lut)
 {
     const ProresContext *ctx = avctx->priv_data;
     int block_mask, sign;
     unsigned pos, run, level;
     int max_coeffs, i, bits_left;
     int log2_block_count = av_log2(blocks_per_slice);
+    int state = AC_STATE(4, 2);
 
     OPEN_READER(re, gb);
     UPDATE_CACHE_32(re, gb);
-    run   = 4;
-    level = 2;
 
     max_coeffs = 64 << log2_block_count;
     block_mask = blocks_per_slice - 1;
@@ -502,14 +595,33 @@ static av_always_inline int decode_ac_coeffs(AVCodecContext *avctx, GetBitContex
         if (bits_left <= 0 || (bits_left < 32 && !SHOW_UBITS(re, gb, bits_left)))
             break;
 
-        DECODE_CODEWORD(run, run_to_cb[FFMIN(run,  15)], LAST_SKIP_BITS);
+        if (use_lut) {
+            const ACLUTEntry *e;
+
+            UPDATE_CACHE(re, gb);
+            e = &ac_lut[state][SHOW_UBITS(re, gb, AC_LUT_BITS)];
+            if (e->len) {
+                pos += e->run + 1;
+                if (pos >= max_coeffs) {
+                    av_log(avctx, AV_LOG_ERROR, "ac tex damaged %d, %d\n", pos, max_coeffs);
+                    return AVERROR_INVALIDDATA;
+                }
+                SKIP_BITS(re, gb, e->len);
+                i = pos >> log2_block_count;
+                out[((pos & block_mask) << 6) + ctx->scan[i]] = e->level;
+                state = e->state;
+                continue;
+            }
+        }
+
+        DECODE_CODEWORD(run, run_class_cb[state / AC_LEV_CLASSES], LAST_SKIP_BITS);
         pos += run + 1;
         if (pos >= max_coeffs) {
             av_log(avctx, AV_LOG_ERROR, "ac tex damaged %d, %d\n", pos, max_coeffs);
             return AVERROR_INVALIDDATA;
         }
 
-        DECODE_CODEWORD(level, lev_to_cb[FFMIN(level, 9)], SKIP_BITS);
+        DECODE_CODEWORD(level, lev_class_cb[state % AC_LEV_CLASSES], SKIP_BITS);
         level += 1;
 
         i = pos >> log2_block_count;
@@ -517,6 +629,7 @@ static av_always_inline int decode_ac_coeffs(AVCodecContext *avctx, GetBitContex
         sign = SHOW_SBITS(re, gb, 1);
         SKIP_BITS(re, gb, 1);
         out[((pos & block_mask) << 6) + ctx->scan[i]] = ((level ^ sign) - sign);
+        state = AC_STATE(run, level);
     }
 
     CLOSE_READER(re, gb);
@@ -542,7 +655,7 @@ static int decode_slice_luma(AVCodecContext *avctx, SliceContext *slice,
 
     if ((ret = decode_dc_coeffs(&gb, blocks, blocks_per_slice)) < 0)
         return ret;
-    if ((ret = decode_ac_coeffs(avctx, &gb, blocks, blocks_per_slice)) < 0)
+    if ((ret = decode_ac_coeffs(avctx, &gb, blocks, blocks_per_slice, 1)) < 0)
         return ret;
 
     block = blocks;
@@ -576,7 +689,7 @@ static int decode_slice_chroma(AVCodecContext *avctx, SliceContext *slice,
 
     if ((ret = decode_dc_coeffs(&gb, blocks, blocks_per_slice)) < 0)
         return ret;
-    if ((ret = decode_ac_coeffs(avctx, &gb, blocks, blocks_per_slice)) < 0)
+    if ((ret = decode_ac_coeffs(avctx, &gb, blocks, blocks_per_slice, 1)) < 0)
         return ret;
 
     block = blocks;
@@ -49,6 +49,17 @@
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+/**
+ * With AV_CODEC_FLAG2_ADAPTIVE_THREADS, the number of threads in use is
+ * reconsidered after this many decoded packets.
+ */
+#define ADAPT_WINDOW 8
+/**
+ * Smallest picture area worth giving a thread of its own.
+ */
+#define ADAPT_PIXELS_PER_THREAD (320 * 240)
 
 enum {
     /// Set when the thread is awaiting a packet.
@@ -100,9 +111,13 @@ typedef struct PerThreadContext {
      */
     DecodedFrames df;
     int     result;                 ///< The result of the last codec decode/encode() call.
+    int64_t decode_time;            ///< Time spent on the last packet, in microseconds.
 
     atomic_int state;
 
+    int submitted;                  ///< Set while the output of the last packet has not been returned.
+    int parked;                     ///< Set when the codec state was dropped while the thread is unused.
+
     int die;                        ///< Set when the thread should exit.
 
     int hwaccel_serializing;
@@ -148,7 +163,25 @@ typedef struct FrameThreadContext {
     AVPacket *next_pkt;
 
     int next_decoding;             ///< The next context to submit a packet to.
-    int next_finished;             ///< The next context to return output from.
+
+    /**
+     * Indices of the threads in submission order, from the oldest one
+     * whose output has not been returned yet.
+     */
+    int *submitted;
+    int  submitted_start;
+    int  nb_submitted;
+
+    int nb_threads;                ///< Number of PerThreadContexts created so far.
+    int max_threads;               ///< Number of PerThreadContexts that may be used.
+    int nb_active;                 ///< Number of threads packets are submitted to.
+
+    /* AV_CODEC_FLAG2_ADAPTIVE_THREADS state, see adapt_thread_count() */
+    int     adaptive;              ///< Set if the flag is set and the codec supports it.
+    int     nb_window;             ///< Packets decoded in the current window.
+    int64_t decode_time;           ///< Time spent decoding them.
+    int64_t user_time;             ///< Time spent by the caller between calls.
+    int64_t user_time_start;       ///< When the last call returned.
 
     /* hwaccel state for thread-unsafe hwaccels is temporarily stored here in
      * order to transfer its ownership to the next decoding thread without the
@@ -280,6 +313,7 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
             p->hwaccel_serializing = 1;
         }
 
+        p->decode_time = av_gettime_relative();
         ret = 0;
         while (ret >= 0) {
             AVFrame *frame;
@@ -305,6 +339,7 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
             ff_thread_finish_setup(avctx);
 
 alloc_fail:
+        p->decode_time = av_gettime_relative() - p->decode_time;
         if (p->hwaccel_serializing) {
             /* wipe hwaccel state for thread-unsafe hwaccels to avoid stale
              * pointers lying around;
@@ -561,12 +596,104 @@ static int submit_packet(PerThreadContext *p, AVCodecContext *user_avctx,
     pthread_cond_signal(&p->input_cond);
     pthread_mutex_unlock(&p->mutex);
 
+    p->submitted = 1;
+    p->parked    = 0;
+    fctx->submitted[(fctx->submitted_start + fctx->nb_submitted++) %
+                    user_avctx->thread_count] = p - fctx->threads;
+
     fctx->prev_thread = p;
-    fctx->next_decoding = (fctx->next_decoding + 1) % p->avctx->thread_count;
+    fctx->next_decoding = (fctx->next_decoding + 1) % fctx->nb_active;
 
     return 0;
 }
 
+static av_cold int init_thread(PerThreadContext *p, int *threads_to_free,
+                               FrameThreadContext *fctx, AVCodecContext *avctx,
+                               const FFCodec *codec, int first);
+static av_cold void free_thread(PerThreadContext *p, const FFCodec *codec);
+
+/**
+ * Drop the output and the codec state of a thread that is not decoding.
+ */
+static void flush_thread(PerThreadContext *p)
+{
+    decoded_frames_flush(&p->df);
+    p->result    = 0;
+    p->submitted = 0;
+
+    avcodec_flush_buffers(p->avctx);
+}
+
+/**
+ * Flush an unused thread like ff_thread_flush() does, so that it does not
+ * keep references to frames. When it is used again, submit_packet() restores
+ * its state from the previous thread, as after a flush.
+ */
+static void park_thread(FrameThreadContext *fctx, PerThreadContext *p)
+{
+    if (p->parked || p->submitted || p == fctx->prev_thread)
+        return;
+
+    flush_thread(p);
+    p->parked = 1;
+}
+
+/**
+ * Pick the number of threads to use from the picture size and from how long
+ * packets take to decode compared to how long the caller takes to consume
+ * each frame: enough packets need to be in flight to hide the decoding
+ * latency, and small pictures are not worth many threads.
+ */
+static void adapt_thread_count(AVCodecContext *avctx, FrameThreadContext *fctx,
+                               const PerThreadContext *p)
+{
+    int64_t pixels = (int64_t)avctx->width * avctx->height;
+    int nb_active, max_threads = fctx->max_threads;
+
+    fctx->decode_time += p->decode_time;
+    if (++fctx->nb_window < ADAPT_WINDOW)
+        return;
+
+    if (pixels > 0)
+        max_threads = FFMIN(max_threads, (pixels + ADAPT_PIXELS_PER_THREAD - 1) /
+                                         ADAPT_PIXELS_PER_THREAD);
+    nb_active = fctx->decode_time / FFMAX(fctx->user_time, 1) + 1;
+    nb_active = av_clip(nb_active, 1, max_threads);
+
+    /* threads are only created once they are needed */
+    while (fctx->nb_threads < nb_active) {
+        PerThreadContext *np = &fctx->threads[fctx->nb_threads];
+        int err = init_thread(np, &fctx->nb_threads, fctx, avctx,
+                              ffcodec(avctx->codec), 0);
+        if (err < 0) {
+            av_log(avctx, AV_LOG_WARNING, "Could not create frame thread: %s\n",
+                   av_err2str(err));
+            /* drop the failed context, so that flushing and freeing only
+             * ever see working threads */
+            if (np - fctx->threads < fctx->nb_threads) {
+                free_thread(np, ffcodec(avctx->codec));
+                memset(np, 0, sizeof(*np));
+                fctx->nb_threads--;
+            }
+            fctx->max_threads = nb_active = fctx->nb_threads;
+            break;
+        }
+    }
+
+    if (nb_active != fctx->nb_active && (avctx->debug & FF_DEBUG_THREADS))
+        av_log(avctx, AV_LOG_DEBUG, "Using %d frame threads\n", nb_active);
+
+    for (int i = nb_active; i < fctx->nb_threads; i++)
+        park_thread(fctx, &fctx->threads[i]);
+    fctx->nb_active = nb_active;
+    if (fctx->next_decoding >= nb_active)
+        fctx->next_decoding = 0;
+
+    fctx->nb_window   = 0;
+    fctx->decode_time = 0;
+    fctx->user_time   = 0;
+}
+
 int ff_thread_receive_frame(AVCodecContext *avctx, AVFrame *frame)
 {
     FrameThreadContext *fctx = avctx->internal->thread_ctx;
@@ -576,28 +703,35 @@ int ff_thread_receive_frame(AVCodecContext *avctx, AVFrame *frame)
      * go forward while we are in this function */
     async_unlock(fctx);
 
+    if (fctx->user_time_start)
+        fctx->user_time += av_gettime_relative() - fctx->user_time_start;
+
     /* submit packets to threads while there are no buffered results to return */
     while (!fctx->df.nb_f && !fctx->result) {
-        PerThreadContext *p;
-
-        /* get a packet to be submitted to the next thread */
-        av_packet_unref(fctx->next_pkt);
-        ret = ff_decode_get_packet(avctx, fctx->next_pkt);
-        if (ret < 0 && ret != AVERROR_EOF)
-            goto finish;
-
-        ret = submit_packet(&fctx->threads[fctx->next_decoding], avctx,
-                            fctx->next_pkt);
-        if (ret < 0)
-             goto finish;
-
-        /* do not return any frames until all threads have something to do */
-        if (fctx->next_decoding != fctx->next_finished &&
-            !avctx->internal->draining)
-            continue;
+        PerThreadContext *p = &fctx->threads[fctx->next_decoding];
+
+        /* after the number of threads changed, the next thread may still
+         * have output from an earlier packet to return first */
+        if (!p->submitted) {
+            /* get a packet to be submitted to the next thread */
+            av_packet_unref(fctx->next_pkt);
+            ret = ff_decode_get_packet(avctx, fctx->next_pkt);
+            if (ret < 0 && ret != AVERROR_EOF)
+                goto finish;
+
+            ret = submit_packet(p, avctx, fctx->next_pkt);
+            if (ret < 0)
+                 goto finish;
+
+            /* do not return any frames until all threads have something to do */
+            if (!fctx->threads[fctx->next_decoding].submitted &&
+                !avctx->internal->draining)
+                continue;
+        }
 
-        p                   = &fctx->threads[fctx->next_finished];
-        fctx->next_finished = (fctx->next_finished + 1) % avctx->thread_count;
+        p = &fctx->threads[fctx->submitted[fctx->submitted_start]];
+        fctx->submitted_start = (fctx->submitted_start + 1) % avctx->thread_count;
+        fctx->nb_submitted--;
 
         if (atomic_load(&p->state) != STATE_INPUT_READY) {
             pthread_mutex_lock(&p->progress_mutex);
@@ -609,8 +743,15 @@ int ff_thread_receive_frame(AVCodecContext *avctx, AVFrame *frame)
         update_context_from_thread(avctx, p->avctx, 1);
         fctx->result = p->result;
         p->result    = 0;
+        p->submitted = 0;
         if (p->df.nb_f)
             FFSWAP(DecodedFrames, fctx->df, p->df);
+
+        if (fctx->adaptive) {
+            adapt_thread_count(avctx, fctx, p);
+            if (p - fctx->threads >= fctx->nb_active)
+                park_thread(fctx, p);
+        }
     }
 
     /* a thread may return multiple frames AND an error
@@ -624,6 +765,8 @@ int ff_thread_receive_frame(AVCodecContext *avctx, AVFrame *frame)
     }
 
 finish:
+    if (fctx->adaptive)
+        fctx->user_time_start = av_gettime_relative();
     async_lock(fctx);
     return ret;
 }
@@ -750,61 +893,66 @@ DEFINE_OFFSET_ARRAY(PerThreadContext, per_thread, pthread_init_cnt,
                     (OFF(input_cond), OFF(progress_cond), OFF(output_cond)));
 #undef OFF
 
-av_cold void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
+static av_cold void free_thread(PerThreadContext *p, const FFCodec *codec)
 {
-    FrameThreadContext *fctx = avctx->internal->thread_ctx;
-    const FFCodec *codec = ffcodec(avctx->codec);
-    int i;
+    AVCodecContext *ctx = p->avctx;
 
-    park_frame_worker_threads(fctx, thread_count);
+    if (ctx->internal) {
+        if (p->thread_init == INITIALIZED) {
+            pthread_mutex_lock(&p->mutex);
+            p->die = 1;
+            pthread_cond_signal(&p->input_cond);
+            pthread_mutex_unlock(&p->mutex);
 
-    for (i = 0; i < thread_count; i++) {
-        PerThreadContext *p = &fctx->threads[i];
-        AVCodecContext *ctx = p->avctx;
+            pthread_join(p->thread, NULL);
+        }
+        if (codec->close && p->thread_init != UNINITIALIZED)
+            codec->close(ctx);
 
-        if (ctx->internal) {
-            if (p->thread_init == INITIALIZED) {
-                pthread_mutex_lock(&p->mutex);
-                p->die = 1;
-                pthread_cond_signal(&p->input_cond);
-                pthread_mutex_unlock(&p->mutex);
+        /* When using a threadsafe hwaccel, this is where
+         * each thread's context is uninit'd and freed. */
+        ff_hwaccel_uninit(ctx);
 
-                pthread_join(p->thread, NULL);
-            }
-            if (codec->close && p->thread_init != UNINITIALIZED)
-                codec->close(ctx);
+        if (ctx->priv_data) {
+            if (codec->p.priv_class)
+                av_opt_free(ctx->priv_data);
+            av_freep(&ctx->priv_data);
+        }
 
-            /* When using a threadsafe hwaccel, this is where
-             * each thread's context is uninit'd and freed. */
-            ff_hwaccel_uninit(ctx);
+        av_refstruct_unref(&ctx->internal->pool);
+        av_packet_free(&ctx->internal->in_pkt);
+        av_packet_free(&ctx->internal->last_pkt_props);
+        ff_decode_internal_uninit(ctx);
+        av_freep(&ctx->internal);
+        av_buffer_unref(&ctx->hw_frames_ctx);
+        av_frame_side_data_free(&ctx->decoded_side_data,
+                                &ctx->nb_decoded_side_data);
+    }
 
-            if (ctx->priv_data) {
-                if (codec->p.priv_class)
-                    av_opt_free(ctx->priv_data);
-                av_freep(&ctx->priv_data);
-            }
+    decoded_frames_free(&p->df);
 
-            av_refstruct_unref(&ctx->internal->pool);
-            av_packet_free(&ctx->internal->in_pkt);
-            av_packet_free(&ctx->internal->last_pkt_props);
-            ff_decode_internal_uninit(ctx);
-            av_freep(&ctx->internal);
-            av_buffer_unref(&ctx->hw_frames_ctx);
-            av_frame_side_data_free(&ctx->decoded_side_data,
-                                    &ctx->nb_decoded_side_data);
-        }
+    ff_pthread_free(p, per_thread_offsets);
+    av_packet_free(&p->avpkt);
+
+    av_freep(&p->avctx);
+}
 
-        decoded_frames_free(&p->df);
+av_cold void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
+{
+    FrameThreadContext *fctx = avctx->internal->thread_ctx;
+    const FFCodec *codec = ffcodec(avctx->codec);
+    int i;
 
-        ff_pthread_free(p, per_thread_offsets);
-        av_packet_free(&p->avpkt);
+    thread_count = FFMIN(thread_count, fctx->nb_threads);
+    park_frame_worker_threads(fctx, thread_count);
 
-        av_freep(&p->avctx);
-    }
+    for (i = 0; i < thread_count; i++)
+        free_thread(&fctx->threads[i], codec);
 
     decoded_frames_free(&fctx->df);
     av_packet_free(&fctx->next_pkt);
 
+    av_freep(&fctx->submitted);
     av_freep(&fctx->threads);
     ff_pthread_free(fctx, thread_ctx_offsets);
 
@@ -927,7 +1075,7 @@ av_cold int ff_frame_thread_init(AVCodecContext *avctx)
     int thread_count = avctx->thread_count;
     const FFCodec *codec = ffcodec(avctx->codec);
     FrameThreadContext *fctx;
-    int err, i = 0;
+    int err;
 
     if (!thread_count) {
         int nb_cpus = av_cpu_count();
@@ -963,17 +1111,28 @@ av_cold int ff_frame_thread_init(AVCodecContext *avctx)
     if (codec->p.type == AVMEDIA_TYPE_VIDEO)
         avctx->delay = avctx->thread_count - 1;
 
-    fctx->threads = av_calloc(thread_count, sizeof(*fctx->threads));
-    if (!fctx->threads) {
+    fctx->threads   = av_calloc(thread_count, sizeof(*fctx->threads));
+    fctx->submitted = av_calloc(thread_count, sizeof(*fctx->submitted));
+    if (!fctx->threads || !fctx->submitted) {
         err = AVERROR(ENOMEM);
         goto error;
     }
-
-    for (; i < thread_count; ) {
-        PerThreadContext *p  = &fctx->threads[i];
-        int first = !i;
-
-        err = init_thread(p, &i, fctx, avctx, codec, first);
+    fctx->max_threads = thread_count;
+    fctx->adaptive    = (avctx->flags2 & AV_CODEC_FLAG2_ADAPTIVE_THREADS) &&
+                        (codec->caps_internal & FF_CODEC_CAP_ADAPTIVE_THREADS);
+
+    /* with adaptive threads, start with one thread and create more
+     * in adapt_thread_count() */
+    if (fctx->adaptive)
+        fctx->nb_active = 1;
+    else
+        fctx->nb_active = thread_count;
+
+    while (fctx->nb_threads < fctx->nb_active) {
+        PerThreadContext *p  = &fctx->threads[fctx->nb_threads];
+        int first = !fctx->nb_threads;
+
+        err = init_thread(p, &fctx->nb_threads, fctx, avctx, codec, first);
         if (err < 0)
             goto error;
     }
@@ -981,7 +1140,7 @@ av_cold int ff_frame_thread_init(AVCodecContext *avctx)
     return 0;
 
 error:
-    ff_frame_thread_free(avctx, i);
+    ff_frame_thread_free(avctx, fctx->nb_threads);
     return err;
 }
 
@@ -992,26 +1151,22 @@ av_cold void ff_thread_flush(AVCodecContext *avctx)
 
     if (!fctx) return;
 
-    park_frame_worker_threads(fctx, avctx->thread_count);
+    park_frame_worker_threads(fctx, fctx->nb_threads);
     if (fctx->prev_thread) {
         if (fctx->prev_thread != &fctx->threads[0])
             update_context_from_thread(fctx->threads[0].avctx, fctx->prev_thread->avctx, 0);
     }
 
-    fctx->next_decoding = fctx->next_finished = 0;
+    fctx->next_decoding   = 0;
+    fctx->submitted_start = 0;
+    fctx->nb_submitted    = 0;
     fctx->prev_thread = NULL;
 
     decoded_frames_flush(&fctx->df);
     fctx->result = 0;
 
-    for (i = 0; i < avctx->thread_count; i++) {
-        PerThreadContext *p = &fctx->threads[i];
-
-        decoded_frames_flush(&p->df);
-        p->result = 0;
-
-        avcodec_flush_buffers(p->avctx);
-    }
+    for (i = 0; i < fctx->nb_threads; i++)
+        flush_thread(&fctx->threads[i]);
 }
 
 int ff_thread_can_start_frame(AVCodecContext *avctx)
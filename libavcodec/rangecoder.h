@@ -87,18 +87,18 @@ static inline int get_rac_count(RangeCoder *c)
 static inline void put_rac(RangeCoder *c, uint8_t *const state, int bit)
 {
     int range1 = (c->range * (*state)) >> 8;
+    int range0 = c->range - range1;
+    int mask   = -(bit != 0);
 
     av_assert2(*state);
     av_assert2(range1 < c->range);
     av_assert2(range1 > 0);
-    if (!bit) {
-        c->range -= range1;
-        *state    = c->zero_state[*state];
-    } else {
-        c->low  += c->range - range1;
-        c->range = range1;
-        *state   = c->one_state[*state];
-    }
+
+    /* The coded bits are poorly predictable, so select the new interval
+     * with masks instead of branching on the bit. */
+    *state   = bit ? c->one_state[*state] : c->zero_state[*state];
+    c->low  += range0 & mask;
+    c->range = range0 ^ ((range0 ^ range1) & mask);
 
     if (c->range < 0x100)
         renorm_encoder(c);
@@ -118,21 +118,19 @@ static inline void refill(RangeCoder *c)
 static inline int get_rac(RangeCoder *c, uint8_t *const state)
 {
     int range1 = (c->range * (*state)) >> 8;
+    int bit, mask;
 
     c->range -= range1;
-    if (c->low < c->range) {
-        *state = c->zero_state[*state];
-        if (c->range < 0x100)
-            refill(c);
-        return 0;
-    } else {
-        c->low  -= c->range;
-        *state   = c->one_state[*state];
-        c->range = range1;
-        if (c->range < 0x100)
-            refill(c);
-        return 1;
-    }
+    bit       = c->low >= c->range;
+    mask      = -bit;
+
+    *state    = bit ? c->one_state[*state] : c->zero_state[*state];
+    c->low   -= c->range & mask;
+    c->range ^= (c->range ^ range1) & mask;
+
+    if (c->range < 0x100)
+        refill(c);
+    return bit;
 }
 
 #endif /* AVCODEC_RANGECODER_H */
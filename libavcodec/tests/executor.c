@@ -0,0 +1,95 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Run a tree of tasks, each of which submits its children from inside the
+ * executor like the VVC decoder does, and check every task runs exactly once,
+ * after its parent.
+ */
+
+#include "libavcodec/executor.c"
+
+#include "libavutil/tests/executor_workload.h"
+
+#define PRIORITIES 3
+
+typedef struct Task {
+    FFTask task;
+    int idx;
+} Task;
+
+static void submit(Workload *w, int idx)
+{
+    Task *t = w->tasks + idx;
+
+    t->idx           = idx;
+    t->task.priority = idx % PRIORITIES;
+    ff_executor_execute(w->e, &t->task);
+}
+
+static int run(FFTask *_t, void *local_context, void *user_data)
+{
+    Task *t     = (Task *)_t;
+    Workload *w = user_data;
+
+    workload_run(w, t->idx);
+
+    for (int i = 1; i <= FANOUT; i++) {
+        const int child = t->idx * FANOUT + i;
+        if (child < w->nb_tasks)
+            submit(w, child);
+    }
+
+    workload_task_done(w);
+    return 0;
+}
+
+static int run_workload(int nb_tasks, int work, int thread_count, int64_t *elapsed)
+{
+    Workload w;
+    FFExecutor *e;
+    FFTaskCallbacks cb = {
+        .user_data          = &w,
+        .local_context_size = 1,
+        .priorities         = PRIORITIES,
+        .run                = run,
+    };
+    int64_t start;
+
+    if (workload_init(&w, sizeof(Task), nb_tasks, work) < 0)
+        return -1;
+
+    w.e = e = ff_executor_alloc(&cb, thread_count);
+    if (!e) {
+        workload_uninit(&w, thread_count);
+        return -1;
+    }
+
+    start = av_gettime_relative();
+    submit(&w, 0);
+    workload_wait(&w);
+    *elapsed = av_gettime_relative() - start;
+
+    ff_executor_free(&e);
+    return workload_uninit(&w, thread_count);
+}
+
+int main(int argc, char **argv)
+{
+    return workload_main(argc, argv, 2000);
+}
@@ -0,0 +1,323 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * FFV1 lossless round trip: encodes synthetic frames with several coder
+ * configurations, checks that decoding restores them exactly and prints
+ * the CRC of the bytestream so that any change to the coded bits is
+ * caught by the reference. With -t it reports encode and decode speed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "libavutil/common.h"
+#include "libavutil/crc.h"
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
+#include "libavcodec/avcodec.h"
+
+typedef struct TestConfig {
+    enum AVPixelFormat pix_fmt;
+    int level;
+    const char *coder;
+    int context;
+    int slices;
+} TestConfig;
+
+static const TestConfig configs[] = {
+    { AV_PIX_FMT_YUV420P,   1, "rice",      0, 0 },
+    { AV_PIX_FMT_YUV420P,   3, "range_def", 0, 4 },
+    { AV_PIX_FMT_YUV420P,   3, "range_tab", 1, 4 },
+    { AV_PIX_FMT_YUV422P10, 3, "range_tab", 0, 6 },
+    { AV_PIX_FMT_YUVA420P,  3, "range_def", 1, 4 },
+    { AV_PIX_FMT_GBRP10,    3, "range_tab", 0, 4 },
+    { AV_PIX_FMT_GBRP12,    3, "range_def", 1, 4 },
+    { AV_PIX_FMT_GRAY16,    3, "range_tab", 0, 4 },
+};
+
+typedef struct RoundTrip {
+    uint32_t crc;
+    size_t size;
+    int64_t enc_time, dec_time;
+} RoundTrip;
+
+static int plane_height(const AVPixFmtDescriptor *desc, int plane, int height)
+{
+    if ((plane == 1 || plane == 2) && !(desc->flags & AV_PIX_FMT_FLAG_RGB))
+        return AV_CEIL_RSHIFT(height, desc->log2_chroma_h);
+    return height;
+}
+
+/* Smooth gradients plus noise, so that both the prediction and the
+ * context modelling see varied input. */
+static void fill_frame(AVFrame *frame, AVLFG *lfg, int n)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    int depth = desc->comp[0].depth;
+    int max   = (1 << depth) - 1;
+
+    for (int p = 0; p < av_pix_fmt_count_planes(frame->format); p++) {
+        int bytes = av_image_get_linesize(frame->format, frame->width, p);
+        int w     = depth > 8 ? bytes / 2 : bytes;
+        int h     = plane_height(desc, p, frame->height);
+
+        for (int y = 0; y < h; y++) {
+            uint8_t *line = frame->data[p] + y * frame->linesize[p];
+
+            for (int x = 0; x < w; x++) {
+                int v = ((x * (p + 3) + y * (5 - p) + n * 7) << (depth - 8)) +
+                        (av_lfg_get(lfg) & ((1 << (depth - 5)) - 1));
+
+                v &= max;
+                if (depth > 8)
+                    ((uint16_t *)line)[x] = v;
+                else
+                    line[x] = v;
+            }
+        }
+    }
+}
+
+static int compare_frames(const AVFrame *a, const AVFrame *b)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(a->format);
+
+    if (a->format != b->format || a->width != b->width || a->height != b->height)
+        return 1;
+
+    for (int p = 0; p < av_pix_fmt_count_planes(a->format); p++) {
+        int bytes = av_image_get_linesize(a->format, a->width, p);
+
+        for (int y = 0; y < plane_height(desc, p, a->height); y++)
+            if (memcmp(a->data[p] + y * a->linesize[p],
+                       b->data[p] + y * b->linesize[p], bytes))
+                return 1;
+    }
+    return 0;
+}
+
+static int round_trip(const TestConfig *cfg, int width, int height,
+                      int nb_frames, RoundTrip *res)
+{
+    const AVCodec *enc = avcodec_find_encoder(AV_CODEC_ID_FFV1);
+    const AVCodec *dec = avcodec_find_decoder(AV_CODEC_ID_FFV1);
+    const AVCRC *crc_tab = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    AVCodecContext *ectx = NULL, *dctx = NULL;
+    AVFrame **src = NULL, *out = NULL;
+    AVPacket *pkt = NULL;
+    AVLFG lfg;
+    int64_t t;
+    int decoded = 0, ret;
+
+    memset(res, 0, sizeof(*res));
+    res->crc = UINT32_MAX;
+    av_lfg_init(&lfg, 0xFF71);
+
+    src  = av_calloc(nb_frames, sizeof(*src));
+    out  = av_frame_alloc();
+    pkt  = av_packet_alloc();
+    ectx = avcodec_alloc_context3(enc);
+    dctx = avcodec_alloc_context3(dec);
+    if (!src || !out || !pkt || !ectx || !dctx) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    for (int i = 0; i < nb_frames; i++) {
+        if (!(src[i] = av_frame_alloc())) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        src[i]->format = cfg->pix_fmt;
+        src[i]->width  = width;
+        src[i]->height = height;
+        src[i]->pts    = i;
+        if ((ret = av_frame_get_buffer(src[i], 0)) < 0)
+            goto end;
+        fill_frame(src[i], &lfg, i);
+    }
+
+    ectx->width     = width;
+    ectx->height    = height;
+    ectx->pix_fmt   = cfg->pix_fmt;
+    ectx->time_base = (AVRational){ 1, 25 };
+    ectx->level     = cfg->level;
+    ectx->slices    = cfg->slices;
+    ectx->flags    |= AV_CODEC_FLAG_BITEXACT;
+    av_opt_set(ectx->priv_data, "coder", cfg->coder, 0);
+    av_opt_set_int(ectx->priv_data, "context", cfg->context, 0);
+    if ((ret = avcodec_open2(ectx, enc, NULL)) < 0)
+        goto end;
+
+    if (ectx->extradata_size) {
+        dctx->extradata = av_mallocz(ectx->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!dctx->extradata) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        memcpy(dctx->extradata, ectx->extradata, ectx->extradata_size);
+        dctx->extradata_size = ectx->extradata_size;
+    }
+    dctx->width  = width;
+    dctx->height = height;
+    if ((ret = avcodec_open2(dctx, dec, NULL)) < 0)
+        goto end;
+
+    for (int i = 0; i <= nb_frames; i++) {
+        t   = av_gettime_relative();
+        ret = avcodec_send_frame(ectx, i < nb_frames ? src[i] : NULL);
+        if (ret < 0)
+            goto end;
+
+        while ((ret = avcodec_receive_packet(ectx, pkt)) >= 0) {
+            res->enc_time += av_gettime_relative() - t;
+            res->crc       = av_crc(crc_tab, res->crc, pkt->data, pkt->size);
+            res->size     += pkt->size;
+
+            t   = av_gettime_relative();
+            ret = avcodec_send_packet(dctx, pkt);
+            av_packet_unref(pkt);
+            if (ret < 0)
+                goto end;
+            while ((ret = avcodec_receive_frame(dctx, out)) >= 0) {
+                res->dec_time += av_gettime_relative() - t;
+                if (decoded >= nb_frames || compare_frames(src[decoded], out)) {
+                    fprintf(stderr, "Frame %d does not match the input\n", decoded);
+                    ret = AVERROR_BUG;
+                    goto end;
+                }
+                decoded++;
+                av_frame_unref(out);
+                t = av_gettime_relative();
+            }
+            if (ret != AVERROR(EAGAIN))
+                goto end;
+            t = av_gettime_relative();
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+
+    if (decoded != nb_frames) {
+        fprintf(stderr, "Decoded %d of %d frames\n", decoded, nb_frames);
+        ret = AVERROR_BUG;
+        goto end;
+    }
+    res->crc ^= UINT32_MAX;
+    ret = 0;
+
+end:
+    for (int i = 0; src && i < nb_frames; i++)
+        av_frame_free(&src[i]);
+    av_freep(&src);
+    av_frame_free(&out);
+    av_packet_free(&pkt);
+    avcodec_free_context(&ectx);
+    avcodec_free_context(&dctx);
+    return ret;
+}
+
+static void help(void)
+{
+    printf("ffv1 [-t] [-s <width>x<height>] [-n <frames>]\n"
+           "-t          speed test, 1920x1080 unless -s is given\n"
+           "-s          frame size\n"
+           "-n          number of frames\n");
+}
+
+#if !HAVE_GETOPT
+#include "compat/getopt.c"
+#endif
+
+int main(int argc, char **argv)
+{
+    int width = 0, height = 0, nb_frames = 0;
+    int speed = 0;
+    int err = 0;
+    int c;
+
+    for (;;) {
+        c = getopt(argc, argv, "ts:n:h");
+        if (c == -1)
+            break;
+        switch (c) {
+        case 't':
+            speed = 1;
+            break;
+        case 's':
+            if (sscanf(optarg, "%dx%d", &width, &height) != 2 ||
+                width <= 0 || height <= 0) {
+                help();
+                return 1;
+            }
+            break;
+        case 'n':
+            nb_frames = atoi(optarg);
+            break;
+        default:
+        case 'h':
+            help();
+            return 0;
+        }
+    }
+
+    if (!avcodec_find_encoder(AV_CODEC_ID_FFV1) ||
+        !avcodec_find_decoder(AV_CODEC_ID_FFV1))
+        return 0;
+
+    if (!width) {
+        width  = speed ? 1920 :  96;
+        height = speed ? 1080 :  64;
+    }
+    if (nb_frames <= 0)
+        nb_frames = speed ? 10 : 3;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(configs); i++) {
+        const TestConfig *cfg = &configs[i];
+        RoundTrip res;
+        int ret = round_trip(cfg, width, height, nb_frames, &res);
+
+        printf("%-10s level %d %-9s context %d slices %d: ",
+               av_get_pix_fmt_name(cfg->pix_fmt), cfg->level, cfg->coder,
+               cfg->context, cfg->slices);
+        if (ret < 0) {
+            printf("failed (%s)\n", av_err2str(ret));
+            err = 1;
+        } else if (speed) {
+            printf("%zu bytes, encode %0.2f ms/frame, decode %0.2f ms/frame\n",
+                   res.size, res.enc_time / 1000.0 / nb_frames,
+                   res.dec_time / 1000.0 / nb_frames);
+        } else {
+            printf("%zu bytes, crc 0x%08"PRIx32"\n", res.size, res.crc);
+        }
+    }
+
+    return err;
+}
@@ -0,0 +1,486 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Synthesizes a 16x16 HEVC IDR picture made of a single PCM coding unit,
+ * followed by a decoded picture hash SEI, and checks that the decoder
+ * verifies MD5, CRC and checksum hashes and flags a corrupted sample.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/log.h"
+#include "libavutil/md5.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/defs.h"
+#include "libavcodec/put_bits.h"
+#include "libavcodec/put_golomb.h"
+
+#define W 16
+#define H 16
+#define NB_SAMPLES (W * H + 2 * (W / 2) * (H / 2))
+
+typedef struct CABACEncoder {
+    PutBitContext *pb;
+    unsigned low, range;
+    int outstanding, first_bit;
+} CABACEncoder;
+
+static void cabac_put_bit(CABACEncoder *c, int b)
+{
+    if (c->first_bit)
+        c->first_bit = 0;
+    else
+        put_bits(c->pb, 1, b);
+    for (; c->outstanding; c->outstanding--)
+        put_bits(c->pb, 1, !b);
+}
+
+static void cabac_renorm(CABACEncoder *c)
+{
+    while (c->range < 256) {
+        if (c->low < 256) {
+            cabac_put_bit(c, 0);
+        } else if (c->low >= 512) {
+            c->low -= 512;
+            cabac_put_bit(c, 1);
+        } else {
+            c->low -= 256;
+            c->outstanding++;
+        }
+        c->range <<= 1;
+        c->low   <<= 1;
+    }
+}
+
+static void cabac_init(CABACEncoder *c, PutBitContext *pb)
+{
+    c->pb          = pb;
+    c->low         = 0;
+    c->range       = 510;
+    c->outstanding = 0;
+    c->first_bit   = 1;
+}
+
+/* Only the most probable symbol of a context in state 0 is ever coded. */
+static void cabac_put_mps_state0(CABACEncoder *c)
+{
+    static const uint8_t lps_range_state0[4] = { 128, 176, 208, 240 };
+
+    c->range -= lps_range_state0[(c->range >> 6) & 3];
+    cabac_renorm(c);
+}
+
+/* Codes a terminating bin equal to 1 and flushes the encoder. */
+static void cabac_put_terminate(CABACEncoder *c)
+{
+    c->range -= 2;
+    c->low   += c->range;
+    c->range  = 2;
+    cabac_renorm(c);
+    cabac_put_bit(c, (c->low >> 9) & 1);
+    put_bits(c->pb, 2, ((c->low >> 7) & 3) | 1);
+}
+
+static void put_trailing_bits(PutBitContext *pb)
+{
+    put_bits(pb, 1, 1);
+    align_put_bits(pb);
+}
+
+static void put_ptl(PutBitContext *pb, int bit_depth)
+{
+    int profile = bit_depth > 8 ? 2 : 1;
+
+    put_bits(pb, 2, 0);             // general_profile_space
+    put_bits(pb, 1, 0);             // general_tier_flag
+    put_bits(pb, 5, profile);
+    put_bits32(pb, 1U << (31 - profile));
+    put_bits(pb, 4, 0x9);           // progressive, !interlaced, !non_packed, frame_only
+    put_bits(pb, 22, 0);
+    put_bits(pb, 22, 0);
+    put_bits(pb, 8, 30);            // general_level_idc
+}
+
+static void put_vps(PutBitContext *pb, int bit_depth)
+{
+    put_bits(pb, 4, 0);             // vps_video_parameter_set_id
+    put_bits(pb, 2, 3);             // base layer internal/available
+    put_bits(pb, 6, 0);             // vps_max_layers_minus1
+    put_bits(pb, 3, 0);             // vps_max_sub_layers_minus1
+    put_bits(pb, 1, 1);             // vps_temporal_id_nesting_flag
+    put_bits(pb, 16, 0xffff);
+    put_ptl(pb, bit_depth);
+    put_bits(pb, 1, 1);             // vps_sub_layer_ordering_info_present_flag
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    put_bits(pb, 6, 0);             // vps_max_layer_id
+    set_ue_golomb(pb, 0);           // vps_num_layer_sets_minus1
+    put_bits(pb, 1, 0);             // vps_timing_info_present_flag
+    put_bits(pb, 1, 0);             // vps_extension_flag
+}
+
+static void put_sps(PutBitContext *pb, int bit_depth)
+{
+    put_bits(pb, 4, 0);             // sps_video_parameter_set_id
+    put_bits(pb, 3, 0);             // sps_max_sub_layers_minus1
+    put_bits(pb, 1, 1);             // sps_temporal_id_nesting_flag
+    put_ptl(pb, bit_depth);
+    set_ue_golomb(pb, 0);           // sps_seq_parameter_set_id
+    set_ue_golomb(pb, 1);           // chroma_format_idc
+    set_ue_golomb(pb, W);
+    set_ue_golomb(pb, H);
+    put_bits(pb, 1, 0);             // conformance_window_flag
+    set_ue_golomb(pb, bit_depth - 8);
+    set_ue_golomb(pb, bit_depth - 8);
+    set_ue_golomb(pb, 0);           // log2_max_pic_order_cnt_lsb_minus4
+    put_bits(pb, 1, 1);             // sps_sub_layer_ordering_info_present_flag
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);           // 8x8 minimum coding block
+    set_ue_golomb(pb, 2);           // 32x32 CTB
+    set_ue_golomb(pb, 0);           // 4x4 minimum transform block
+    set_ue_golomb(pb, 2);           // 16x16 maximum transform block
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    put_bits(pb, 1, 0);             // scaling_list_enabled_flag
+    put_bits(pb, 1, 0);             // amp_enabled_flag
+    put_bits(pb, 1, 0);             // sample_adaptive_offset_enabled_flag
+    put_bits(pb, 1, 1);             // pcm_enabled_flag
+    put_bits(pb, 4, bit_depth - 1);
+    put_bits(pb, 4, bit_depth - 1);
+    set_ue_golomb(pb, 1);           // 16x16 minimum PCM block
+    set_ue_golomb(pb, 0);           // 16x16 maximum PCM block
+    put_bits(pb, 1, 1);             // pcm_loop_filter_disabled_flag
+    set_ue_golomb(pb, 0);           // num_short_term_ref_pic_sets
+    put_bits(pb, 1, 0);             // long_term_ref_pics_present_flag
+    put_bits(pb, 1, 0);             // sps_temporal_mvp_enabled_flag
+    put_bits(pb, 1, 0);             // strong_intra_smoothing_enabled_flag
+    put_bits(pb, 1, 0);             // vui_parameters_present_flag
+    put_bits(pb, 1, 0);             // sps_extension_present_flag
+}
+
+static void put_pps(PutBitContext *pb)
+{
+    set_ue_golomb(pb, 0);           // pps_pic_parameter_set_id
+    set_ue_golomb(pb, 0);           // pps_seq_parameter_set_id
+    put_bits(pb, 7, 0);             // dependent slices ... cabac_init_present_flag
+    set_ue_golomb(pb, 0);
+    set_ue_golomb(pb, 0);
+    set_se_golomb(pb, 0);           // init_qp_minus26
+    put_bits(pb, 3, 0);             // constrained intra, transform skip, cu_qp_delta
+    set_se_golomb(pb, 0);
+    set_se_golomb(pb, 0);
+    put_bits(pb, 7, 0);             // slice chroma qp offsets ... loop filter across slices
+    put_bits(pb, 1, 1);             // deblocking_filter_control_present_flag
+    put_bits(pb, 1, 0);             // deblocking_filter_override_enabled_flag
+    put_bits(pb, 1, 1);             // pps_deblocking_filter_disabled_flag
+    put_bits(pb, 2, 0);             // scaling list, lists modification
+    set_ue_golomb(pb, 0);           // log2_parallel_merge_level_minus2
+    put_bits(pb, 2, 0);             // slice header extension, pps extension
+}
+
+static void put_slice(PutBitContext *pb, const uint16_t *samples, int bit_depth)
+{
+    CABACEncoder c;
+
+    put_bits(pb, 1, 1);             // first_slice_segment_in_pic_flag
+    put_bits(pb, 1, 0);             // no_output_of_prior_pics_flag
+    set_ue_golomb(pb, 0);           // slice_pic_parameter_set_id
+    set_ue_golomb(pb, 2);           // slice_type I
+    set_se_golomb(pb, 0);           // slice_qp_delta
+    put_trailing_bits(pb);          // byte_alignment()
+
+    /* The CTB crosses the picture boundary so the 32x32 split is implied;
+     * the 16x16 split_cu_flag context starts in state 0 at QP 26. */
+    cabac_init(&c, pb);
+    cabac_put_mps_state0(&c);       // split_cu_flag = 0
+    cabac_put_terminate(&c);        // pcm_flag = 1
+    align_put_bits(pb);             // pcm_alignment_zero_bit
+    for (int i = 0; i < NB_SAMPLES; i++)
+        put_bits(pb, bit_depth, samples[i]);
+
+    cabac_init(&c, pb);
+    cabac_put_terminate(&c);        // end_of_slice_segment_flag = 1
+    align_put_bits(pb);             // the last flushed bit is the stop bit
+}
+
+static void plane_geometry(int plane, int *w, int *h, int *offset)
+{
+    *w      = plane ? W / 2 : W;
+    *h      = plane ? H / 2 : H;
+    *offset = plane ? W * H + (plane - 1) * (W / 2) * (H / 2) : 0;
+}
+
+/* The hashes are computed here from the definitions in H.265 D.3.19,
+ * independently of the decoder implementation. */
+static void put_picture_hash(PutBitContext *pb, const uint16_t *samples,
+                             int bit_depth, int hash_type)
+{
+    static const int hash_sizes[] = { 16, 2, 4 };
+    int bytes = bit_depth > 8 ? 2 : 1;
+
+    put_bits(pb, 8, 132);           // decoded_picture_hash
+    put_bits(pb, 8, 1 + 3 * hash_sizes[hash_type]);
+    put_bits(pb, 8, hash_type);
+
+    for (int plane = 0; plane < 3; plane++) {
+        uint8_t buf[W * H * 2];
+        int w, h, offset, len = 0;
+
+        plane_geometry(plane, &w, &h, &offset);
+        for (int i = 0; i < w * h; i++) {
+            buf[len++] = samples[offset + i] & 0xff;
+            if (bytes > 1)
+                buf[len++] = samples[offset + i] >> 8;
+        }
+
+        if (hash_type == 0) {
+            uint8_t md5[16];
+
+            av_md5_sum(md5, buf, len);
+            for (int i = 0; i < 16; i++)
+                put_bits(pb, 8, md5[i]);
+        } else if (hash_type == 1) {
+            unsigned crc = 0xffff;
+
+            for (int i = 0; i < len + 2; i++) {
+                int byte = i < len ? buf[i] : 0;
+
+                for (int bit = 0; bit < 8; bit++) {
+                    int msb = (crc >> 15) & 1;
+                    int in  = (byte >> (7 - bit)) & 1;
+
+                    crc = (((crc << 1) + in) & 0xffff) ^ (msb * 0x1021);
+                }
+            }
+            put_bits(pb, 16, crc);
+        } else {
+            uint32_t sum = 0;
+
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    int mask = (x & 0xff) ^ (y & 0xff) ^ (x >> 8) ^ (y >> 8);
+                    int s    = samples[offset + y * w + x];
+
+                    sum += (s & 0xff) ^ mask;
+                    if (bytes > 1)
+                        sum += (s >> 8) ^ mask;
+                }
+            }
+            put_bits32(pb, sum);
+        }
+    }
+}
+
+/* Wraps the RBSP in pb into an Annex B NAL unit at dst. */
+static int put_nal(uint8_t *dst, int type, PutBitContext *pb)
+{
+    int rbsp_size = put_bytes_output(pb);
+    const uint8_t *rbsp = pb->buf;
+    int len = 0, zeros = 0;
+
+    dst[len++] = 0;
+    dst[len++] = 0;
+    dst[len++] = 0;
+    dst[len++] = 1;
+    dst[len++] = type << 1;
+    dst[len++] = 1;
+    for (int i = 0; i < rbsp_size; i++) {
+        if (zeros == 2 && rbsp[i] <= 3) {
+            dst[len++] = 3;
+            zeros = 0;
+        }
+        dst[len++] = rbsp[i];
+        zeros = rbsp[i] ? 0 : zeros + 1;
+    }
+    return len;
+}
+
+static int build_access_unit(uint8_t *dst, const uint16_t *samples,
+                             const uint16_t *coded, int bit_depth, int hash_type)
+{
+    uint8_t rbsp[2048];
+    PutBitContext pb;
+    int len = 0;
+
+    init_put_bits(&pb, rbsp, sizeof(rbsp));
+    put_vps(&pb, bit_depth);
+    put_trailing_bits(&pb);
+    flush_put_bits(&pb);
+    len += put_nal(dst + len, 32, &pb);
+
+    init_put_bits(&pb, rbsp, sizeof(rbsp));
+    put_sps(&pb, bit_depth);
+    put_trailing_bits(&pb);
+    flush_put_bits(&pb);
+    len += put_nal(dst + len, 33, &pb);
+
+    init_put_bits(&pb, rbsp, sizeof(rbsp));
+    put_pps(&pb);
+    put_trailing_bits(&pb);
+    flush_put_bits(&pb);
+    len += put_nal(dst + len, 34, &pb);
+
+    init_put_bits(&pb, rbsp, sizeof(rbsp));
+    put_slice(&pb, coded, bit_depth);
+    flush_put_bits(&pb);
+    len += put_nal(dst + len, 19, &pb);
+
+    init_put_bits(&pb, rbsp, sizeof(rbsp));
+    put_picture_hash(&pb, samples, bit_depth, hash_type);
+    put_trailing_bits(&pb);
+    flush_put_bits(&pb);
+    len += put_nal(dst + len, 40, &pb);
+
+    return len;
+}
+
+static int compare_frame(const AVFrame *frame, const uint16_t *samples, int bit_depth)
+{
+    for (int plane = 0; plane < 3; plane++) {
+        int w, h, offset;
+
+        plane_geometry(plane, &w, &h, &offset);
+        for (int y = 0; y < h; y++) {
+            const uint8_t *line = frame->data[plane] + y * frame->linesize[plane];
+
+            for (int x = 0; x < w; x++) {
+                int s = bit_depth > 8 ? ((const uint16_t *)line)[x] : line[x];
+
+                if (s != samples[offset + y * w + x])
+                    return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Returns the decode_error_flags of the decoded picture, or a negative
+ * error code if decoding failed. */
+static int decode(const uint8_t *data, int size, int threads, int explode,
+                  const uint16_t *samples, int bit_depth)
+{
+    const AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_HEVC);
+    AVCodecContext *avctx = avcodec_alloc_context3(codec);
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    int ret;
+
+    if (!avctx || !pkt || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    avctx->err_recognition = AV_EF_CRCCHECK | (explode ? AV_EF_EXPLODE : 0);
+    avctx->thread_count    = threads;
+    avctx->thread_type     = FF_THREAD_SLICE;
+    if ((ret = avcodec_open2(avctx, codec, NULL)) < 0)
+        goto end;
+
+    pkt->data = (uint8_t *)data;
+    pkt->size = size;
+    ret = avcodec_send_packet(avctx, pkt);
+    if (ret < 0)
+        goto end;
+    avcodec_send_packet(avctx, NULL);
+    ret = avcodec_receive_frame(avctx, frame);
+    if (ret < 0)
+        goto end;
+
+    if (compare_frame(frame, samples, bit_depth)) {
+        fprintf(stderr, "Decoded samples differ from the coded ones\n");
+        ret = AVERROR_BUG;
+        goto end;
+    }
+    ret = frame->decode_error_flags;
+
+end:
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    avcodec_free_context(&avctx);
+    return ret;
+}
+
+int main(void)
+{
+    static const char *const hash_names[] = { "MD5", "CRC", "checksum" };
+    static const int bit_depths[] = { 8, 10 };
+    uint8_t au[4096 + AV_INPUT_BUFFER_PADDING_SIZE];
+    uint16_t samples[NB_SAMPLES], corrupted[NB_SAMPLES];
+    int ret = 0;
+
+    if (!avcodec_find_decoder(AV_CODEC_ID_HEVC))
+        return 0;
+
+    av_log_set_level(AV_LOG_QUIET);
+
+    for (int d = 0; d < FF_ARRAY_ELEMS(bit_depths); d++) {
+        int bit_depth = bit_depths[d];
+
+        for (int i = 0; i < NB_SAMPLES; i++)
+            samples[i] = 1 + (i * 7919 + (i >> 4) * 31) % ((1 << bit_depth) - 1);
+
+        for (int hash_type = 0; hash_type < 3; hash_type++) {
+            for (int threads = 1; threads <= 3; threads += 2) {
+                int size, res;
+
+                memset(au, 0, sizeof(au));
+                size = build_access_unit(au, samples, samples, bit_depth, hash_type);
+                res  = decode(au, size, threads, 0, samples, bit_depth);
+                if (res != 0) {
+                    fprintf(stderr, "%d-bit %s, %d threads: intact picture "
+                            "reported %d\n", bit_depth, hash_names[hash_type],
+                            threads, res);
+                    ret = 1;
+                }
+
+                /* Damage one sample in each plane but keep the hash of
+                 * the original picture. */
+                memcpy(corrupted, samples, sizeof(samples));
+                corrupted[W * 3 + 5]               ^= 1;
+                corrupted[W * H + 9]               ^= 1 << (bit_depth - 1);
+                corrupted[NB_SAMPLES - 1]          ^= 2;
+                memset(au, 0, sizeof(au));
+                size = build_access_unit(au, samples, corrupted, bit_depth, hash_type);
+                res  = decode(au, size, threads, 0, corrupted, bit_depth);
+                if (res < 0 || !(res & FF_DECODE_ERROR_INVALID_BITSTREAM)) {
+                    fprintf(stderr, "%d-bit %s, %d threads: corrupted picture "
+                            "not flagged (%d)\n", bit_depth,
+                            hash_names[hash_type], threads, res);
+                    ret = 1;
+                }
+
+                res = decode(au, size, threads, 1, corrupted, bit_depth);
+                if (res != AVERROR_INVALIDDATA) {
+                    fprintf(stderr, "%d-bit %s, %d threads: corrupted picture "
+                            "did not fail with explode (%d)\n", bit_depth,
+                            hash_names[hash_type], threads, res);
+                    ret = 1;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
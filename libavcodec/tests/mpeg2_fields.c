@@ -0,0 +1,427 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Synthesizes an interlaced MPEG-2 stream made mostly of field pictures
+ * and checks that frame-threaded decoding gives the same pictures as
+ * single-threaded decoding.
+ *
+ * The first frame is an I field followed by a P field predicted from it.
+ * The other frames are P and B field pairs, plus one P and one B frame
+ * picture with field prediction. Every slice uses its own random field
+ * motion vector, pointing up to six field lines up or down, so that
+ * macroblocks read reference rows below their own. Intra macroblocks
+ * with random DC values keep the pictures from blurring out.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/lfg.h"
+#include "libavutil/md5.h"
+#include "libavutil/mem.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/put_bits.h"
+
+#define MB_W      8
+#define MB_H     12           /* in frame MB rows; a field has half of them */
+#define NB_FRAMES 13
+#define BUF_SIZE  (1 << 16)
+
+enum { PIC_I = 1, PIC_P, PIC_B };
+enum { TOP_FIELD = 1, BOTTOM_FIELD, FRAME_PICTURE };
+
+typedef struct Writer {
+    PutBitContext pb;
+    AVLFG lfg;
+    int type, structure;
+    int intra_frame;          /* the first field is an I field */
+    int pmv[2][2][2];         /* motion vector predictors, as in the decoder */
+    int dc_pred[3];
+} Writer;
+
+/* motion_code VLC for |code| 0..16, followed by a sign bit if nonzero */
+static const uint8_t mv_vlc[17][2] = {
+    { 0x1,  1 }, { 0x1,  2 }, { 0x1,  3 }, { 0x1,  4 }, { 0x3,  6 },
+    { 0x5,  7 }, { 0x4,  7 }, { 0x3,  7 }, { 0xb,  9 }, { 0xa,  9 },
+    { 0x9,  9 }, { 0x11, 10 }, { 0x10, 10 }, { 0xf, 10 }, { 0xe, 10 },
+    { 0xd, 10 }, { 0xc, 10 },
+};
+
+static const uint8_t dc_lum_vlc[9][2] = {
+    { 0x4, 3 }, { 0x0, 2 }, { 0x1, 2 }, { 0x5, 3 }, { 0x6, 3 },
+    { 0xe, 4 }, { 0x1e, 5 }, { 0x3e, 6 }, { 0x7e, 7 },
+};
+
+static const uint8_t dc_chroma_vlc[9][2] = {
+    { 0x0, 2 }, { 0x1, 2 }, { 0x2, 2 }, { 0x6, 3 }, { 0xe, 4 },
+    { 0x1e, 5 }, { 0x3e, 6 }, { 0x7e, 7 }, { 0xfe, 8 },
+};
+
+static int rand_range(AVLFG *lfg, int min, int max)
+{
+    return min + av_lfg_get(lfg) % (max - min + 1);
+}
+
+static void put_start_code(PutBitContext *pb, int code)
+{
+    align_put_bits(pb);
+    put_bits32(pb, 0x100 | code);
+}
+
+static void put_sequence_header(PutBitContext *pb)
+{
+    put_start_code(pb, 0xB3);
+    put_bits(pb, 12, 16 * MB_W);
+    put_bits(pb, 12, 16 * MB_H);
+    put_bits(pb,  4, 2);      /* aspect ratio 4:3 */
+    put_bits(pb,  4, 3);      /* 25 fps */
+    put_bits(pb, 18, 0x3FFFF);
+    put_bits(pb,  1, 1);      /* marker */
+    put_bits(pb, 10, 112);    /* vbv_buffer_size */
+    put_bits(pb,  3, 0);      /* constrained, no quant matrices */
+
+    put_start_code(pb, 0xB5);
+    put_bits(pb,  4, 1);      /* sequence extension */
+    put_bits(pb,  8, 0x48);   /* main profile, main level */
+    put_bits(pb,  1, 0);      /* progressive_sequence */
+    put_bits(pb,  2, 1);      /* 4:2:0 */
+    put_bits(pb,  4, 0);      /* size extensions */
+    put_bits(pb, 12, 0);      /* bit_rate extension */
+    put_bits(pb,  1, 1);      /* marker */
+    put_bits(pb,  8, 0);      /* vbv_buffer_size extension */
+    put_bits(pb,  1, 0);      /* low_delay */
+    put_bits(pb,  7, 0);      /* frame rate extension */
+
+    put_start_code(pb, 0xB8);
+    put_bits(pb, 12, 0);      /* time code up to the marker */
+    put_bits(pb,  1, 1);
+    put_bits(pb, 12, 0);
+    put_bits(pb,  2, 2);      /* closed GOP */
+}
+
+static void put_picture_header(Writer *w, int temporal_ref)
+{
+    PutBitContext *pb = &w->pb;
+
+    put_start_code(pb, 0x00);
+    put_bits(pb, 10, temporal_ref);
+    put_bits(pb,  3, w->type);
+    put_bits(pb, 16, 0xFFFF); /* vbv_delay */
+    if (w->type != PIC_I)
+        put_bits(pb, 4, 7);   /* full_pel_forward_vector, forward_f_code */
+    if (w->type == PIC_B)
+        put_bits(pb, 4, 7);
+    put_bits(pb, 1, 0);       /* extra_bit_picture */
+
+    put_start_code(pb, 0xB5);
+    put_bits(pb, 4, 8);       /* picture coding extension */
+    put_bits(pb, 4, w->type != PIC_I ? 1 : 15);
+    put_bits(pb, 4, w->type != PIC_I ? 1 : 15);
+    put_bits(pb, 4, w->type == PIC_B ? 1 : 15);
+    put_bits(pb, 4, w->type == PIC_B ? 1 : 15);
+    put_bits(pb, 2, 0);       /* intra_dc_precision */
+    put_bits(pb, 2, w->structure);
+    put_bits(pb, 1, w->structure == FRAME_PICTURE); /* top_field_first */
+    put_bits(pb, 9, 0);       /* frame_pred_frame_dct and the rest */
+}
+
+/* Code motion vector component v against the predictor, f_code 1. */
+static void put_motion(PutBitContext *pb, int v, int pred)
+{
+    int code = v - pred;
+
+    if (code < -16)
+        code += 32;
+    else if (code > 16)
+        code -= 32;
+    put_bits(pb, mv_vlc[FFABS(code)][1], mv_vlc[FFABS(code)][0]);
+    if (code)
+        put_bits(pb, 1, code < 0);
+}
+
+static void put_field_mv(Writer *w, int dir, const int mv[2][2], const int sel[2])
+{
+    int (*pmv)[2] = w->pmv[dir];
+
+    if (w->structure == FRAME_PICTURE) {
+        /* two field MVs, with the vertical predictor in frame units */
+        for (int j = 0; j < 2; j++) {
+            put_bits(&w->pb, 1, sel[j]);
+            put_motion(&w->pb, mv[j][0], pmv[j][0]);
+            put_motion(&w->pb, mv[j][1], pmv[j][1] >> 1);
+            pmv[j][0] = mv[j][0];
+            pmv[j][1] = mv[j][1] * 2;
+        }
+    } else {
+        put_bits(&w->pb, 1, sel[0]);
+        for (int k = 0; k < 2; k++) {
+            put_motion(&w->pb, mv[0][k], pmv[0][k]);
+            pmv[0][k] = pmv[1][k] = mv[0][k];
+        }
+    }
+}
+
+static void put_intra_mb(Writer *w)
+{
+    PutBitContext *pb = &w->pb;
+
+    if (w->type == PIC_I)
+        put_bits(pb, 1, 1);
+    else
+        put_bits(pb, 5, 3);
+    if (w->structure == FRAME_PICTURE)
+        put_bits(pb, 1, 0);   /* dct_type */
+
+    for (int i = 0; i < 6; i++) {
+        int c    = i < 4 ? 0 : i - 3;
+        int dc   = rand_range(&w->lfg, 16, 235);
+        int diff = dc - w->dc_pred[c];
+        int size = diff ? av_log2(FFABS(diff)) + 1 : 0;
+        const uint8_t *vlc = c ? dc_chroma_vlc[size] : dc_lum_vlc[size];
+
+        put_bits(pb, vlc[1], vlc[0]);
+        if (size)
+            put_bits(pb, size, diff > 0 ? diff : diff + (1 << size) - 1);
+        put_bits(pb, 2, 2);   /* end of block */
+        w->dc_pred[c] = dc;
+    }
+    memset(w->pmv, 0, sizeof(w->pmv));
+}
+
+/* MPEG-2 vectors must not point outside of the reference picture. */
+static void clip_field_mvs(const Writer *w, int mb_x, int row,
+                           const int src[2][2], int dst[2][2])
+{
+    int field_rows = w->structure == FRAME_PICTURE ? MB_H     : MB_H / 2;
+    int row_step   = w->structure == FRAME_PICTURE ? 16       : 32;
+
+    for (int j = 0; j < 2; j++) {
+        dst[j][0] = av_clip(src[j][0], -32 * mb_x, 32 * (MB_W - 1 - mb_x));
+        dst[j][1] = av_clip(src[j][1], -row_step * row,
+                            row_step * (field_rows - 1 - row));
+    }
+}
+
+static void put_slice(Writer *w, int row)
+{
+    PutBitContext *pb = &w->pb;
+    int mv[2][2][2], sel[2][2], mb_mv[2][2];
+
+    for (int dir = 0; dir < 2; dir++) {
+        for (int j = 0; j < 2; j++) {
+            mv[dir][j][0] = rand_range(&w->lfg, -10, 10);
+            mv[dir][j][1] = rand_range(&w->lfg, -12, 12);
+            /* the P field of an intra frame may only use the I field */
+            sel[dir][j]   = av_lfg_get(&w->lfg) & !w->intra_frame;
+        }
+    }
+
+    put_start_code(pb, row + 1);
+    put_bits(pb, 5, 8);       /* quantiser_scale_code */
+    put_bits(pb, 1, 0);       /* extra_bit_slice */
+
+    memset(w->pmv, 0, sizeof(w->pmv));
+    w->dc_pred[0] = w->dc_pred[1] = w->dc_pred[2] = 128;
+
+    for (int mb_x = 0; mb_x < MB_W; mb_x++) {
+        put_bits(pb, 1, 1);   /* macroblock_address_increment */
+
+        if (w->type == PIC_I || (w->type == PIC_P && (mb_x + 3 * row) % 7 == 0)) {
+            put_intra_mb(w);
+            continue;
+        }
+
+        if (w->type == PIC_P)
+            put_bits(pb, 3, 1);   /* forward MC, not coded */
+        else
+            put_bits(pb, 2, 2);   /* interpolated MC, not coded */
+        put_bits(pb, 2, 1);       /* field prediction */
+        for (int dir = 0; dir < 1 + (w->type == PIC_B); dir++) {
+            clip_field_mvs(w, mb_x, row, mv[dir], mb_mv);
+            put_field_mv(w, dir, mb_mv, sel[dir]);
+        }
+        w->dc_pred[0] = w->dc_pred[1] = w->dc_pred[2] = 128;
+    }
+}
+
+static void put_picture(Writer *w, int temporal_ref)
+{
+    int rows = w->structure == FRAME_PICTURE ? MB_H : MB_H / 2;
+
+    put_picture_header(w, temporal_ref);
+    for (int row = 0; row < rows; row++)
+        put_slice(w, row);
+}
+
+/**
+ * Write the stream in coding order, one packet per frame.
+ * @return the number of packets
+ */
+static int build_stream(uint8_t *buf, int *offsets)
+{
+    static const uint8_t display_order[NB_FRAMES] = {
+        0, 3, 1, 2, 6, 4, 5, 9, 7, 8, 12, 10, 11
+    };
+    Writer w = { 0 };
+
+    init_put_bits(&w.pb, buf, BUF_SIZE);
+    av_lfg_init(&w.lfg, 0x1F2F);
+    put_sequence_header(&w.pb);
+
+    for (int i = 0; i < NB_FRAMES; i++) {
+        int tr = display_order[i];
+
+        w.type        = tr % 3 ? PIC_B : tr ? PIC_P : PIC_I;
+        w.intra_frame = w.type == PIC_I;
+        if (tr == 6 || tr == 4) {
+            w.structure = FRAME_PICTURE;
+            put_picture(&w, tr);
+        } else {
+            w.structure = TOP_FIELD;
+            put_picture(&w, tr);
+            if (w.type == PIC_I)
+                w.type = PIC_P;
+            w.structure = BOTTOM_FIELD;
+            put_picture(&w, tr);
+        }
+        align_put_bits(&w.pb);
+        flush_put_bits(&w.pb);
+        offsets[i + 1] = put_bytes_output(&w.pb);
+    }
+    return NB_FRAMES;
+}
+
+static int decode(const uint8_t *buf, const int *offsets, int nb_packets,
+                  int threads, uint8_t (*md5s)[16], char *types)
+{
+    const AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_MPEG2VIDEO);
+    AVCodecContext *avctx = avcodec_alloc_context3(codec);
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    struct AVMD5 *md5 = av_md5_alloc();
+    int nb_frames = 0, ret;
+
+    if (!avctx || !pkt || !frame || !md5) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    avctx->thread_count = threads;
+    avctx->thread_type  = FF_THREAD_FRAME;
+    ret = avcodec_open2(avctx, codec, NULL);
+    if (ret < 0)
+        goto end;
+    if (threads > 1 && !(avctx->active_thread_type & FF_THREAD_FRAME)) {
+        fprintf(stderr, "Frame threading is not active\n");
+        ret = AVERROR_BUG;
+        goto end;
+    }
+
+    for (int i = 0; i <= nb_packets; i++) {
+        if (i < nb_packets) {
+            pkt->data = (uint8_t *)buf + offsets[i];
+            pkt->size = offsets[i + 1] - offsets[i];
+            ret = avcodec_send_packet(avctx, pkt);
+        } else {
+            ret = avcodec_send_packet(avctx, NULL);
+        }
+        if (ret < 0)
+            goto end;
+
+        while ((ret = avcodec_receive_frame(avctx, frame)) >= 0) {
+            if (nb_frames == NB_FRAMES || frame->decode_error_flags) {
+                fprintf(stderr, "Unexpected frame %d\n", nb_frames);
+                ret = AVERROR_INVALIDDATA;
+                goto end;
+            }
+            av_md5_init(md5);
+            for (int p = 0; p < 3; p++) {
+                int w = (16 * MB_W) >> !!p, h = (16 * MB_H) >> !!p;
+
+                for (int y = 0; y < h; y++)
+                    av_md5_update(md5, frame->data[p] + y * frame->linesize[p], w);
+            }
+            av_md5_final(md5, md5s[nb_frames]);
+            types[nb_frames++] = av_get_picture_type_char(frame->pict_type);
+            av_frame_unref(frame);
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+    ret = nb_frames;
+
+end:
+    av_free(md5);
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    avcodec_free_context(&avctx);
+    return ret;
+}
+
+int main(void)
+{
+    static const int thread_counts[] = { 2, 3, 8 };
+    uint8_t ref[NB_FRAMES][16], md5s[NB_FRAMES][16];
+    char ref_types[NB_FRAMES], types[NB_FRAMES];
+    int offsets[NB_FRAMES + 1] = { 0 };
+    uint8_t *buf;
+    int nb_packets, ret, err = 0;
+
+    if (!avcodec_find_decoder(AV_CODEC_ID_MPEG2VIDEO))
+        return 0;
+
+    buf = av_mallocz(BUF_SIZE + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!buf)
+        return 1;
+    nb_packets = build_stream(buf, offsets);
+
+    ret = decode(buf, offsets, nb_packets, 1, ref, ref_types);
+    if (ret != NB_FRAMES) {
+        fprintf(stderr, "Single-threaded decoding failed: %s\n",
+                ret < 0 ? av_err2str(ret) : "missing frames");
+        av_free(buf);
+        return 1;
+    }
+    for (int i = 0; i < NB_FRAMES; i++) {
+        printf("frame %2d %c ", i, ref_types[i]);
+        for (int j = 0; j < 16; j++)
+            printf("%02x", ref[i][j]);
+        printf("\n");
+    }
+
+    for (int t = 0; t < FF_ARRAY_ELEMS(thread_counts); t++) {
+        ret = decode(buf, offsets, nb_packets, thread_counts[t], md5s, types);
+        printf("%d frame threads: ", thread_counts[t]);
+        if (ret != NB_FRAMES) {
+            printf("failed (%s)\n", ret < 0 ? av_err2str(ret) : "missing frames");
+            err = 1;
+        } else if (memcmp(md5s, ref, sizeof(ref)) || memcmp(types, ref_types, sizeof(types))) {
+            printf("mismatch\n");
+            err = 1;
+        } else {
+            printf("ok\n");
+        }
+    }
+
+    av_free(buf);
+    return err;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Compare the table-driven AC coefficient decoding against the
+ * codeword-by-codeword decoder on random bitstreams.
+ */
+
+#include "libavcodec/proresdec.c"
+
+#include "libavutil/lfg.h"
+#include "libavutil/log.h"
+
+#define ITERATIONS 20000
+#define MAX_BYTES  512
+#define MAX_BLOCKS 32
+
+int main(void)
+{
+    AVCodecContext avctx = { 0 };
+    ProresContext ctx    = { 0 };
+    uint8_t buf[MAX_BYTES + AV_INPUT_BUFFER_PADDING_SIZE];
+    int16_t out_ref[MAX_BLOCKS * 64], out_new[MAX_BLOCKS * 64];
+    AVLFG lfg;
+    int errors = 0;
+
+    av_log_set_level(AV_LOG_QUIET);
+    av_lfg_init(&lfg, 0x12345678);
+    init_ac_lut();
+
+    avctx.priv_data = &ctx;
+
+    for (int n = 0; n < ITERATIONS; n++) {
+        GetBitContext gb;
+        int size             = 1 + av_lfg_get(&lfg) % MAX_BYTES;
+        int blocks_per_slice = 1 << (av_lfg_get(&lfg) % 6);
+        int sparse           = av_lfg_get(&lfg) % 4;
+        int ret_ref, ret_new;
+
+        ctx.scan = n & 1 ? ff_prores_interlaced_scan : ff_prores_progressive_scan;
+
+        /* mostly dense data for short codewords, some sparse data for
+         * long rice/exp-golomb codewords */
+        memset(buf, 0, sizeof(buf));
+        for (int i = 0; i < size; i++) {
+            unsigned r = av_lfg_get(&lfg);
+            for (int j = 0; j < sparse; j++)
+                r &= av_lfg_get(&lfg);
+            buf[i] = r;
+        }
+
+        memset(out_ref, 0, sizeof(out_ref));
+        memset(out_new, 0, sizeof(out_new));
+
+        init_get_bits8(&gb, buf, size);
+        ret_ref = decode_ac_coeffs(&avctx, &gb, out_ref, blocks_per_slice, 0);
+        init_get_bits8(&gb, buf, size);
+        ret_new = decode_ac_coeffs(&avctx, &gb, out_new, blocks_per_slice, 1);
+
+        if (ret_ref != ret_new ||
+            memcmp(out_ref, out_new, blocks_per_slice * 64 * sizeof(*out_ref))) {
+            fprintf(stderr, "mismatch at iteration %d (size %d, %d blocks)\n",
+                    n, size, blocks_per_slice);
+            errors++;
+        }
+    }
+
+    return !!errors;
+}
@@ -16,9 +16,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
 
+#include "libavutil/crc.h"
 #include "libavutil/error.h"
 #include "libavutil/lfg.h"
 #include "libavutil/log.h"
@@ -26,6 +28,7 @@
 #include "libavcodec/rangecoder.h"
 
 #define SIZE 1240
+#define CONTEXTS 32
 
 /**
  * Check if at the current position there is a valid looking termination
@@ -53,6 +56,56 @@ static int rac_check_termination(RangeCoder *c, int version)
     return 0;
 }
 
+/**
+ * Code skewed bits through many adaptive contexts and check the resulting
+ * bytestream against a fixed checksum, so that changes to the coder
+ * arithmetic which are not bit-exact are caught and not just the ones that
+ * break decodability.
+ */
+static int test_contexts(uint8_t *b, uint8_t *r)
+{
+    RangeCoder c;
+    uint8_t enc_state[CONTEXTS], dec_state[CONTEXTS];
+    const AVCRC *crc = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    uint32_t checksum;
+    int i, actual_length;
+    AVLFG prng;
+
+    av_lfg_init(&prng, 2);
+    for (i = 0; i < 8 * SIZE; i++) {
+        unsigned v = av_lfg_get(&prng);
+        /* the bit probability depends on the context */
+        r[i] = (v >> 8) % CONTEXTS | ((v & 0xFF) < 8 * ((v >> 8) % CONTEXTS)) << 7;
+    }
+
+    ff_init_range_encoder(&c, b, 9 * SIZE);
+    ff_build_rac_states(&c, (1LL << 32) / 20, 256 - 8);
+    memset(enc_state, 128, sizeof(enc_state));
+    for (i = 0; i < 8 * SIZE; i++)
+        put_rac(&c, enc_state + (r[i] & 0x7F), r[i] >> 7);
+    actual_length = ff_rac_terminate(&c, 0);
+
+    checksum = av_crc(crc, 0, b, actual_length);
+    if (checksum != 0x056C4FEC) {
+        av_log(NULL, AV_LOG_ERROR, "rac bytestream checksum mismatch %08"PRIX32"\n", checksum);
+        return 1;
+    }
+
+    ff_init_range_decoder(&c, b, actual_length);
+    memset(dec_state, 128, sizeof(dec_state));
+    for (i = 0; i < 8 * SIZE; i++)
+        if (get_rac(&c, dec_state + (r[i] & 0x7F)) != r[i] >> 7) {
+            av_log(NULL, AV_LOG_ERROR, "rac context failure at %d\n", i);
+            return 1;
+        }
+    if (memcmp(enc_state, dec_state, sizeof(enc_state))) {
+        av_log(NULL, AV_LOG_ERROR, "rac context state mismatch\n");
+        return 1;
+    }
+
+    return 0;
+}
+
 int main(void)
 {
     RangeCoder c;
@@ -99,5 +152,5 @@ int main(void)
         }
     }
 
-    return 0;
+    return test_contexts(b, r);
 }
@@ -0,0 +1,124 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/macros.h"
+#include "libavutil/mastering_display_metadata.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/decode.h"
+
+#define ERR(...) do { fprintf(stderr, __VA_ARGS__); ret = 1; goto end; } while (0)
+
+int main(void)
+{
+    const AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_RAWVIDEO);
+    AVCodecContext *avctx = NULL;
+    AVFrame *frame[2] = { NULL };
+    AVFrameSideData *sd;
+    AVMasteringDisplayMetadata *mdm;
+    AVContentLightMetadata *cll;
+    uint8_t *data[2];
+    static const size_t icc_sizes[] = { 100, 3000, 50 };
+    int ret = 0;
+
+    if (!codec)
+        return 0;
+
+    avctx    = avcodec_alloc_context3(codec);
+    frame[0] = av_frame_alloc();
+    frame[1] = av_frame_alloc();
+    if (!avctx || !frame[0] || !frame[1])
+        ERR("Allocation failed\n");
+
+    avctx->width   = 16;
+    avctx->height  = 16;
+    avctx->pix_fmt = AV_PIX_FMT_GRAY8;
+    if (avcodec_open2(avctx, codec, NULL) < 0)
+        ERR("Could not open the decoder\n");
+
+    /* Fixed-size type: buffers in use are distinct, released ones recycled. */
+    for (int i = 0; i < 2; i++) {
+        if (ff_frame_new_side_data(avctx, frame[i], AV_FRAME_DATA_DISPLAYMATRIX,
+                                   9 * sizeof(int32_t), &sd) < 0 || !sd)
+            ERR("Display matrix allocation %d failed\n", i);
+        memset(sd->data, i + 1, sd->size);
+        data[i] = sd->data;
+    }
+    if (data[0] == data[1])
+        ERR("Display matrix buffer shared between frames\n");
+
+    av_frame_unref(frame[0]);
+    if (ff_frame_new_side_data(avctx, frame[0], AV_FRAME_DATA_DISPLAYMATRIX,
+                               9 * sizeof(int32_t), &sd) < 0 || !sd)
+        ERR("Display matrix reallocation failed\n");
+    if (sd->data != data[0])
+        ERR("Display matrix buffer not recycled\n");
+    sd = av_frame_get_side_data(frame[1], AV_FRAME_DATA_DISPLAYMATRIX);
+    for (int i = 0; i < sd->size; i++)
+        if (sd->data[i] != 2)
+            ERR("Display matrix of the other frame modified\n");
+
+    /* A size that does not match the pooled one must still be honored. */
+    av_frame_unref(frame[0]);
+    if (ff_frame_new_side_data(avctx, frame[0], AV_FRAME_DATA_DISPLAYMATRIX,
+                               10 * sizeof(int32_t), &sd) < 0 || !sd)
+        ERR("Odd-sized display matrix allocation failed\n");
+    if (sd->size != 10 * sizeof(int32_t))
+        ERR("Odd-sized display matrix has size %zu\n", sd->size);
+
+    /* Variable-size type: never pooled, every size is honored. */
+    for (int i = 0; i < FF_ARRAY_ELEMS(icc_sizes); i++) {
+        av_frame_unref(frame[0]);
+        if (ff_frame_new_side_data(avctx, frame[0], AV_FRAME_DATA_ICC_PROFILE,
+                                   icc_sizes[i], &sd) < 0 || !sd)
+            ERR("ICC profile allocation %d failed\n", i);
+        if (sd->size != icc_sizes[i])
+            ERR("ICC profile has size %zu, expected %zu\n", sd->size, icc_sizes[i]);
+        memset(sd->data, 0xff, sd->size);
+    }
+
+    /* Recycled metadata buffers must start out from the defaults again. */
+    av_frame_unref(frame[0]);
+    if (ff_decode_mastering_display_new(avctx, frame[0], &mdm) < 0 || !mdm)
+        ERR("Mastering display allocation failed\n");
+    mdm->has_primaries = mdm->has_luminance = 1;
+    mdm->max_luminance = av_make_q(1000, 1);
+    av_frame_unref(frame[0]);
+    if (ff_decode_mastering_display_new(avctx, frame[0], &mdm) < 0 || !mdm)
+        ERR("Mastering display reallocation failed\n");
+    if (mdm->has_primaries || mdm->has_luminance || mdm->max_luminance.num)
+        ERR("Recycled mastering display metadata not reset\n");
+
+    if (ff_decode_content_light_new(avctx, frame[0], &cll) < 0 || !cll)
+        ERR("Content light level allocation failed\n");
+    cll->MaxCLL = cll->MaxFALL = 1000;
+    av_frame_unref(frame[0]);
+    if (ff_decode_content_light_new(avctx, frame[0], &cll) < 0 || !cll)
+        ERR("Content light level reallocation failed\n");
+    if (cll->MaxCLL || cll->MaxFALL)
+        ERR("Recycled content light level metadata not reset\n");
+
+end:
+    av_frame_free(&frame[0]);
+    av_frame_free(&frame[1]);
+    avcodec_free_context(&avctx);
+    return ret;
+}
@@ -33,6 +33,7 @@ DEFINE_OFFSET_ARRAY(ThreadProgress, thread_progress, init,
 av_cold int ff_thread_progress_init(ThreadProgress *pro, int init_mode)
 {
     atomic_init(&pro->progress, init_mode ? -1 : INT_MAX);
+    atomic_init(&pro->min_awaited, INT_MAX);
 #if HAVE_THREADS
     if (init_mode)
         return ff_pthread_init(pro, thread_progress_offsets);
@@ -55,8 +56,16 @@ void ff_thread_progress_report(ThreadProgress *pro, int n)
     if (atomic_load_explicit(&pro->progress, memory_order_relaxed) >= n)
         return;
 
+    /* Pairs with the store to min_awaited in ff_thread_progress_await():
+     * either the waiter sees the new progress or we see its request. */
+    atomic_store(&pro->progress, n);
+    if (atomic_load(&pro->min_awaited) > n)
+        return;
+
     ff_mutex_lock(&pro->progress_mutex);
-    atomic_store_explicit(&pro->progress, n, memory_order_release);
+    /* Every waiter is woken up; those that still have to wait
+     * register their request again. */
+    atomic_store_explicit(&pro->min_awaited, INT_MAX, memory_order_relaxed);
     ff_cond_broadcast(&pro->progress_cond);
     ff_mutex_unlock(&pro->progress_mutex);
 }
@@ -64,15 +73,21 @@ void ff_thread_progress_report(ThreadProgress *pro, int n)
 void ff_thread_progress_await(const ThreadProgress *pro_c, int n)
 {
     /* Casting const away here is safe, because we only read from progress
-     * and will leave pro_c in the same state upon leaving the function
-     * as it had at the beginning. */
+     * and only touch min_awaited, which is just a hint for the reporter. */
     ThreadProgress *pro = (ThreadProgress*)pro_c;
 
     if (atomic_load_explicit(&pro->progress, memory_order_acquire) >= n)
         return;
 
     ff_mutex_lock(&pro->progress_mutex);
-    while (atomic_load_explicit(&pro->progress, memory_order_relaxed) < n)
+    while (atomic_load_explicit(&pro->progress, memory_order_acquire) < n) {
+        /* Only register once we are about to sleep, so that a report that
+         * raced with taking the lock does not leave a stale request behind. */
+        if (atomic_load_explicit(&pro->min_awaited, memory_order_relaxed) > n)
+            atomic_store(&pro->min_awaited, n);
+        if (atomic_load(&pro->progress) >= n)
+            break;
         ff_cond_wait(&pro->progress_cond, &pro->progress_mutex);
+    }
     ff_mutex_unlock(&pro->progress_mutex);
 }
@@ -42,6 +42,8 @@
  */
 typedef struct ThreadProgress {
     atomic_int progress;
+    /* lowest progress value a thread currently waits for, INT_MAX if none */
+    atomic_int min_awaited;
     unsigned   init;
     AVMutex progress_mutex;
     AVCond  progress_cond;
@@ -72,12 +74,15 @@ void ff_thread_progress_destroy(ThreadProgress *pro);
 static inline void ff_thread_progress_reset(ThreadProgress *pro)
 {
     atomic_init(&pro->progress, pro->init ? -1 : INT_MAX);
+    atomic_init(&pro->min_awaited, INT_MAX);
 }
 
 /**
  * This function is a no-op in no-op mode; otherwise it notifies
  * other threads that a certain level of progress has been reached.
  * Later calls with lower values of progress have no effect.
+ * Waiting threads are only woken up once the progress they wait for
+ * has been reached; reports nobody waits for do not take the lock.
  */
 void ff_thread_progress_report(ThreadProgress *pro, int progress);
 
@@ -0,0 +1,71 @@
+;******************************************************************************
+;* x86 optimizations for DNxHD/DNxHR decoding
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_dnxhd_dequant_block(int16_t block[64], const int32_t scale[64],
+;                             const int32_t round[64], int shift)
+;------------------------------------------------------------------------------
+; Each iteration widens mmsize/2 coefficients to dwords. psignd both restores
+; the sign and keeps zero levels at zero; the shift pair truncates the result
+; to 16 bits the way the C store does, so packssdw never saturates.
+%macro DEQUANT_BLOCK 0
+cglobal dnxhd_dequant_block, 4, 5, 6, block, scale, round, shift, i
+    movd         xm5, shiftd
+    add       blockq, 128
+    add       scaleq, 256
+    add       roundq, 256
+    mov           iq, -128
+.loop:
+    pmovsxwd      m0, [blockq + iq]
+    pmovsxwd      m1, [blockq + iq + mmsize/2]
+    pabsd         m2, m0
+    pabsd         m3, m1
+    pmulld        m2, [scaleq + iq*2]
+    pmulld        m3, [scaleq + iq*2 + mmsize]
+    paddd         m2, [roundq + iq*2]
+    paddd         m3, [roundq + iq*2 + mmsize]
+    psrad         m2, xm5
+    psrad         m3, xm5
+    psignd        m2, m0
+    psignd        m3, m1
+    pslld         m2, 16
+    pslld         m3, 16
+    psrad         m2, 16
+    psrad         m3, 16
+    packssdw      m2, m3
+%if cpuflag(avx2)
+    vpermq        m2, m2, q3120
+%endif
+    mova [blockq + iq], m2
+    add           iq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse4
+DEQUANT_BLOCK
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+DEQUANT_BLOCK
+%endif
@@ -26,8 +26,13 @@
 
 %include "libavutil/x86/x86util.asm"
 
+SECTION_RODATA
+
+pw_8000: times 16 dw 0x8000
+
 cextern pb_15
 cextern pb_80
+cextern pw_1
 
 SECTION .text
 
@@ -116,3 +121,83 @@ PREDICTOR
 INIT_YMM avx2
 PREDICTOR
 %endif
+
+;------------------------------------------------------------------------------
+; void ff_wav_decode{14,16}(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+;------------------------------------------------------------------------------
+
+; l, h -> a, b
+%macro WDEC14 3 ; l/a, h/b, tmp
+    psraw            %3, %2, 1
+    paddw            %1, %3
+    pand             %3, %2, [pw_1]
+    paddw            %1, %3
+    psubw            %3, %1, %2
+    mova             %2, %3
+%endmacro
+
+%macro WDEC16 3 ; l/a, h/b, tmp
+    psrlw            %3, %2, 1
+    psubw            %1, %3
+    paddw            %3, %2, %1
+    pxor             %3, [pw_8000]
+    mova             %2, %1
+    mova             %1, %3
+%endmacro
+
+; Pairs are split into low and high halves with in-lane packs and merged
+; back with in-lane unpacks, so no lane crossing is needed for ymm.
+%macro WAV_DECODE 1 ; bits
+cglobal wav_decode%1, 3, 3, 8, row0, row1, n
+    test             nq, nq
+    jz .end
+.loop:
+    movu             m0, [row0q]
+    movu             m1, [row0q + mmsize]
+    movu             m2, [row1q]
+    movu             m3, [row1q + mmsize]
+    pslld            m4, m0, 16
+    pslld            m5, m1, 16
+    psrad            m4, 16
+    psrad            m5, 16
+    packssdw         m4, m5              ; row0 low
+    psrad            m0, 16
+    psrad            m1, 16
+    packssdw         m0, m1              ; row0 high
+    pslld            m5, m2, 16
+    pslld            m6, m3, 16
+    psrad            m5, 16
+    psrad            m6, 16
+    packssdw         m5, m6              ; row1 low
+    psrad            m2, 16
+    psrad            m3, 16
+    packssdw         m2, m3              ; row1 high
+    WDEC%1           m4, m5, m7
+    WDEC%1           m0, m2, m7
+    WDEC%1           m4, m0, m7
+    WDEC%1           m5, m2, m7
+    punpcklwd        m1, m4, m0
+    punpckhwd        m4, m0
+    punpcklwd        m3, m5, m2
+    punpckhwd        m5, m2
+    movu        [row0q], m1
+    movu [row0q + mmsize], m4
+    movu        [row1q], m3
+    movu [row1q + mmsize], m5
+    add           row0q, 2 * mmsize
+    add           row1q, 2 * mmsize
+    sub              nq, mmsize / 2
+    jg .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse2
+WAV_DECODE 14
+WAV_DECODE 16
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+WAV_DECODE 14
+WAV_DECODE 16
+%endif
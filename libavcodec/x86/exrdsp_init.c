@@ -32,12 +32,20 @@ void ff_predictor_avx(uint8_t *src, ptrdiff_t size);
 
 void ff_predictor_avx2(uint8_t *src, ptrdiff_t size);
 
+void ff_wav_decode14_sse2(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+void ff_wav_decode16_sse2(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+
+void ff_wav_decode14_avx2(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+void ff_wav_decode16_avx2(uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+
 av_cold void ff_exrdsp_init_x86(ExrDSPContext *dsp)
 {
     int cpu_flags = av_get_cpu_flags();
 
     if (EXTERNAL_SSE2(cpu_flags)) {
         dsp->reorder_pixels = ff_reorder_pixels_sse2;
+        dsp->wav_decode14   = ff_wav_decode14_sse2;
+        dsp->wav_decode16   = ff_wav_decode16_sse2;
     }
     if (EXTERNAL_SSSE3(cpu_flags)) {
         dsp->predictor = ff_predictor_ssse3;
@@ -48,5 +56,7 @@ av_cold void ff_exrdsp_init_x86(ExrDSPContext *dsp)
     if (EXTERNAL_AVX2_FAST(cpu_flags)) {
         dsp->reorder_pixels = ff_reorder_pixels_avx2;
         dsp->predictor      = ff_predictor_avx2;
+        dsp->wav_decode14   = ff_wav_decode14_avx2;
+        dsp->wav_decode16   = ff_wav_decode16_avx2;
     }
 }
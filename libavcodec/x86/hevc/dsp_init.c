@@ -174,17 +174,22 @@ FW_QPEL_FUNCS(8,  12, sse4)
 
 FW_PEL(32,  8, avx2)
 FW_PUT(pel, pel_pixels16, pixels16, 10, avx2)
+FW_PUT(pel, pel_pixels16, pixels16, 12, avx2)
 
 FW_EPEL(32,  8, avx2)
 FW_EPEL(16, 10, avx2)
+FW_EPEL(16, 12, avx2)
 
 FW_EPEL_HV(32,  8, avx2)
 FW_EPEL_HV(16, 10, avx2)
+FW_EPEL_HV(16, 12, avx2)
 
 FW_QPEL(32,  8, avx2)
 FW_QPEL(16, 10, avx2)
+FW_QPEL(16, 12, avx2)
 
 FW_QPEL_HV(16, 10, avx2)
+FW_QPEL_HV(16, 12, avx2)
 
 #endif
 #endif
@@ -274,41 +279,41 @@ void ff_hevc_put_hevc_bi_##name##W##_##bitd##_##opt(uint8_t *dst, ptrdiff_t dsts
 
 #if ARCH_X86_64 && HAVE_SSE4_EXTERNAL
 
-#define mc_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)                                       \
-void ff_hevc_put_hevc_##name##width1##_10_##opt1(int16_t *dst, const uint8_t *src, ptrdiff_t _srcstride,      \
+#define mc_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                                \
+void ff_hevc_put_hevc_##name##width1##_##bitd##_##opt1(int16_t *dst, const uint8_t *src, ptrdiff_t _srcstride, \
                                                  int height, intptr_t mx, intptr_t my, int width)             \
                                                                                                               \
 {                                                                                                             \
-    ff_hevc_put_hevc_##name##width2##_10_##opt1(dst, src, _srcstride, height, mx, my, width);                 \
-    ff_hevc_put_hevc_##name##width3##_10_##opt2(dst+ width2, src+ width4, _srcstride, height, mx, my, width); \
+    ff_hevc_put_hevc_##name##width2##_##bitd##_##opt1(dst, src, _srcstride, height, mx, my, width);           \
+    ff_hevc_put_hevc_##name##width3##_##bitd##_##opt2(dst+ width2, src+ width4, _srcstride, height, mx, my, width); \
 }
 
-#define mc_bi_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)                                    \
-void ff_hevc_put_hevc_bi_##name##width1##_10_##opt1(uint8_t *dst, ptrdiff_t dststride, const uint8_t *src,    \
+#define mc_bi_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                             \
+void ff_hevc_put_hevc_bi_##name##width1##_##bitd##_##opt1(uint8_t *dst, ptrdiff_t dststride, const uint8_t *src, \
                                                     ptrdiff_t _srcstride, const int16_t *src2,                \
                                                     int height, intptr_t mx, intptr_t my, int width)          \
 {                                                                                                             \
-    ff_hevc_put_hevc_bi_##name##width2##_10_##opt1(dst, dststride, src, _srcstride, src2,                     \
+    ff_hevc_put_hevc_bi_##name##width2##_##bitd##_##opt1(dst, dststride, src, _srcstride, src2,               \
                                                    height, mx, my, width);                                    \
-    ff_hevc_put_hevc_bi_##name##width3##_10_##opt2(dst+width4, dststride, src+width4, _srcstride, src2+width2,\
+    ff_hevc_put_hevc_bi_##name##width3##_##bitd##_##opt2(dst+width4, dststride, src+width4, _srcstride, src2+width2, \
                                                    height, mx, my, width);                                    \
 }
 
-#define mc_uni_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)                                   \
-void ff_hevc_put_hevc_uni_##name##width1##_10_##opt1(uint8_t *dst, ptrdiff_t dststride,                       \
+#define mc_uni_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                            \
+void ff_hevc_put_hevc_uni_##name##width1##_##bitd##_##opt1(uint8_t *dst, ptrdiff_t dststride,                 \
                                                      const uint8_t *src, ptrdiff_t _srcstride, int height,    \
                                                      intptr_t mx, intptr_t my, int width)                     \
 {                                                                                                             \
-    ff_hevc_put_hevc_uni_##name##width2##_10_##opt1(dst, dststride, src, _srcstride,                          \
+    ff_hevc_put_hevc_uni_##name##width2##_##bitd##_##opt1(dst, dststride, src, _srcstride,                    \
                                                       height, mx, my, width);                                 \
-    ff_hevc_put_hevc_uni_##name##width3##_10_##opt2(dst+width4, dststride, src+width4, _srcstride,            \
+    ff_hevc_put_hevc_uni_##name##width3##_##bitd##_##opt2(dst+width4, dststride, src+width4, _srcstride,      \
                                                       height, mx, my, width);                                 \
 }
 
-#define mc_rep_mixs_10(name, width1, width2, width3, opt1, opt2, width4)   \
-mc_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)            \
-mc_bi_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)         \
-mc_uni_rep_mix_10(name, width1, width2, width3, opt1, opt2, width4)
+#define mc_rep_mixs_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                               \
+mc_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                                        \
+mc_bi_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)                                     \
+mc_uni_rep_mix_hbd(name, bitd, width1, width2, width3, opt1, opt2, width4)
 
 #define mc_rep_mix_8(name, width1, width2, width3, opt1, opt2)                                                \
 void ff_hevc_put_hevc_##name##width1##_8_##opt1(int16_t *dst, const uint8_t *src, ptrdiff_t _srcstride,       \
@@ -353,16 +358,25 @@ mc_rep_mixs_8(epel_hv,    48, 32, 16, avx2, sse4)
 mc_rep_mixs_8(epel_h ,    48, 32, 16, avx2, sse4)
 mc_rep_mixs_8(epel_v ,    48, 32, 16, avx2, sse4)
 
-mc_rep_mix_10(pel_pixels, 24, 16, 8, avx2, sse4, 32)
-mc_bi_rep_mix_10(pel_pixels,24, 16, 8, avx2, sse4, 32)
-mc_rep_mixs_10(epel_hv,   24, 16, 8, avx2, sse4, 32)
-mc_rep_mixs_10(epel_h ,   24, 16, 8, avx2, sse4, 32)
-mc_rep_mixs_10(epel_v ,   24, 16, 8, avx2, sse4, 32)
+mc_rep_mix_hbd(pel_pixels,    10, 24, 16, 8, avx2, sse4, 32)
+mc_bi_rep_mix_hbd(pel_pixels, 10, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_hv,      10, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_h ,      10, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_v ,      10, 24, 16, 8, avx2, sse4, 32)
 
+mc_rep_mixs_hbd(qpel_h ,      10, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(qpel_v ,      10, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(qpel_hv,      10, 24, 16, 8, avx2, sse4, 32)
 
-mc_rep_mixs_10(qpel_h ,   24, 16, 8, avx2, sse4, 32)
-mc_rep_mixs_10(qpel_v ,   24, 16, 8, avx2, sse4, 32)
-mc_rep_mixs_10(qpel_hv,   24, 16, 8, avx2, sse4, 32)
+mc_rep_mix_hbd(pel_pixels,    12, 24, 16, 8, avx2, sse4, 32)
+mc_bi_rep_mix_hbd(pel_pixels, 12, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_hv,      12, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_h ,      12, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(epel_v ,      12, 24, 16, 8, avx2, sse4, 32)
+
+mc_rep_mixs_hbd(qpel_h ,      12, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(qpel_v ,      12, 24, 16, 8, avx2, sse4, 32)
+mc_rep_mixs_hbd(qpel_hv,      12, 24, 16, 8, avx2, sse4, 32)
 
 
 mc_rep_uni_func(pel_pixels, 8, 64, 128, avx2)//used for 10bit
@@ -378,6 +392,14 @@ mc_rep_bi_func(pel_pixels, 10, 16, 32, avx2)
 mc_rep_bi_func(pel_pixels, 10, 16, 48, avx2)
 mc_rep_bi_func(pel_pixels, 10, 32, 64, avx2)
 
+mc_rep_func(pel_pixels, 12, 16, 32, avx2)
+mc_rep_func(pel_pixels, 12, 16, 48, avx2)
+mc_rep_func(pel_pixels, 12, 32, 64, avx2)
+
+mc_rep_bi_func(pel_pixels, 12, 16, 32, avx2)
+mc_rep_bi_func(pel_pixels, 12, 16, 48, avx2)
+mc_rep_bi_func(pel_pixels, 12, 32, 64, avx2)
+
 mc_rep_funcs(epel_h, 8, 32, 64, avx2)
 
 mc_rep_funcs(epel_v, 8, 32, 64, avx2)
@@ -386,10 +408,18 @@ mc_rep_funcs(epel_h, 10, 16, 32, avx2)
 mc_rep_funcs(epel_h, 10, 16, 48, avx2)
 mc_rep_funcs(epel_h, 10, 32, 64, avx2)
 
+mc_rep_funcs(epel_h, 12, 16, 32, avx2)
+mc_rep_funcs(epel_h, 12, 16, 48, avx2)
+mc_rep_funcs(epel_h, 12, 32, 64, avx2)
+
 mc_rep_funcs(epel_v, 10, 16, 32, avx2)
 mc_rep_funcs(epel_v, 10, 16, 48, avx2)
 mc_rep_funcs(epel_v, 10, 32, 64, avx2)
 
+mc_rep_funcs(epel_v, 12, 16, 32, avx2)
+mc_rep_funcs(epel_v, 12, 16, 48, avx2)
+mc_rep_funcs(epel_v, 12, 32, 64, avx2)
+
 
 mc_rep_funcs(epel_hv,  8, 32, 64, avx2)
 
@@ -397,6 +427,10 @@ mc_rep_funcs(epel_hv, 10, 16, 32, avx2)
 mc_rep_funcs(epel_hv, 10, 16, 48, avx2)
 mc_rep_funcs(epel_hv, 10, 32, 64, avx2)
 
+mc_rep_funcs(epel_hv, 12, 16, 32, avx2)
+mc_rep_funcs(epel_hv, 12, 16, 48, avx2)
+mc_rep_funcs(epel_hv, 12, 32, 64, avx2)
+
 mc_rep_funcs(qpel_h, 8, 32, 64, avx2)
 mc_rep_mixs_8(qpel_h ,  48, 32, 16, avx2, sse4)
 
@@ -407,14 +441,26 @@ mc_rep_funcs(qpel_h, 10, 16, 32, avx2)
 mc_rep_funcs(qpel_h, 10, 16, 48, avx2)
 mc_rep_funcs(qpel_h, 10, 32, 64, avx2)
 
+mc_rep_funcs(qpel_h, 12, 16, 32, avx2)
+mc_rep_funcs(qpel_h, 12, 16, 48, avx2)
+mc_rep_funcs(qpel_h, 12, 32, 64, avx2)
+
 mc_rep_funcs(qpel_v, 10, 16, 32, avx2)
 mc_rep_funcs(qpel_v, 10, 16, 48, avx2)
 mc_rep_funcs(qpel_v, 10, 32, 64, avx2)
 
+mc_rep_funcs(qpel_v, 12, 16, 32, avx2)
+mc_rep_funcs(qpel_v, 12, 16, 48, avx2)
+mc_rep_funcs(qpel_v, 12, 32, 64, avx2)
+
 mc_rep_funcs(qpel_hv, 10, 16, 32, avx2)
 mc_rep_funcs(qpel_hv, 10, 16, 48, avx2)
 mc_rep_funcs(qpel_hv, 10, 32, 64, avx2)
 
+mc_rep_funcs(qpel_hv, 12, 16, 32, avx2)
+mc_rep_funcs(qpel_hv, 12, 16, 48, avx2)
+mc_rep_funcs(qpel_hv, 12, 32, 64, avx2)
+
 #endif //AVX2
 
 mc_rep_funcs(pel_pixels, 8, 16, 64, sse4)
@@ -607,18 +653,20 @@ mc_rep_bi_w(12, 8, 32, sse4)
 mc_rep_bi_w(12, 8, 48, sse4)
 mc_rep_bi_w(12, 8, 64, sse4)
 
-#define mc_uni_w_func(name, bitd, W, opt) \
-void ff_hevc_put_hevc_uni_w_##name##W##_##bitd##_##opt(uint8_t *_dst, ptrdiff_t _dststride,         \
+#define mc_uni_w_mix(name, bitd, W, opt1, opt2) \
+void ff_hevc_put_hevc_uni_w_##name##W##_##bitd##_##opt1(uint8_t *_dst, ptrdiff_t _dststride,        \
                                                        const uint8_t *_src, ptrdiff_t _srcstride,   \
                                                       int height, int denom,                        \
                                                       int _wx, int _ox,                             \
                                                       intptr_t mx, intptr_t my, int width)          \
 {                                                                                                   \
     LOCAL_ALIGNED_16(int16_t, temp, [71 * MAX_PB_SIZE]);                                            \
-    ff_hevc_put_hevc_##name##W##_##bitd##_##opt(temp, _src, _srcstride, height, mx, my, width);     \
-    ff_hevc_put_hevc_uni_w##W##_##bitd##_##opt(_dst, _dststride, temp, height, denom, _wx, _ox);\
+    ff_hevc_put_hevc_##name##W##_##bitd##_##opt1(temp, _src, _srcstride, height, mx, my, width);    \
+    ff_hevc_put_hevc_uni_w##W##_##bitd##_##opt2(_dst, _dststride, temp, height, denom, _wx, _ox);\
 }
 
+#define mc_uni_w_func(name, bitd, W, opt) mc_uni_w_mix(name, bitd, W, opt, opt)
+
 #define mc_uni_w_funcs(name, bitd, opt)      \
         mc_uni_w_func(name, bitd, 4, opt)    \
         mc_uni_w_func(name, bitd, 8, opt)    \
@@ -665,8 +713,8 @@ mc_uni_w_funcs(qpel_h, 12, sse4)
 mc_uni_w_funcs(qpel_v, 12, sse4)
 mc_uni_w_funcs(qpel_hv, 12, sse4)
 
-#define mc_bi_w_func(name, bitd, W, opt) \
-void ff_hevc_put_hevc_bi_w_##name##W##_##bitd##_##opt(uint8_t *_dst, ptrdiff_t _dststride,           \
+#define mc_bi_w_mix(name, bitd, W, opt1, opt2) \
+void ff_hevc_put_hevc_bi_w_##name##W##_##bitd##_##opt1(uint8_t *_dst, ptrdiff_t _dststride,          \
                                                       const uint8_t *_src, ptrdiff_t _srcstride,     \
                                                       const int16_t *_src2,                          \
                                                      int height, int denom,                          \
@@ -674,11 +722,13 @@ void ff_hevc_put_hevc_bi_w_##name##W##_##bitd##_##opt(uint8_t *_dst, ptrdiff_t _
                                                      intptr_t mx, intptr_t my, int width)            \
 {                                                                                                    \
     LOCAL_ALIGNED_16(int16_t, temp, [71 * MAX_PB_SIZE]);                                             \
-    ff_hevc_put_hevc_##name##W##_##bitd##_##opt(temp, _src, _srcstride, height, mx, my, width);      \
-    ff_hevc_put_hevc_bi_w##W##_##bitd##_##opt(_dst, _dststride, temp, _src2,                         \
-                                              height, denom, _wx0, _wx1, _ox0, _ox1);                \
+    ff_hevc_put_hevc_##name##W##_##bitd##_##opt1(temp, _src, _srcstride, height, mx, my, width);     \
+    ff_hevc_put_hevc_bi_w##W##_##bitd##_##opt2(_dst, _dststride, temp, _src2,                        \
+                                               height, denom, _wx0, _wx1, _ox0, _ox1);               \
 }
 
+#define mc_bi_w_func(name, bitd, W, opt) mc_bi_w_mix(name, bitd, W, opt, opt)
+
 #define mc_bi_w_funcs(name, bitd, opt)      \
         mc_bi_w_func(name, bitd, 4, opt)    \
         mc_bi_w_func(name, bitd, 8, opt)    \
@@ -724,6 +774,54 @@ mc_bi_w_func(epel_hv, 12, 6, sse4)
 mc_bi_w_funcs(qpel_h, 12, sse4)
 mc_bi_w_funcs(qpel_v, 12, sse4)
 mc_bi_w_funcs(qpel_hv, 12, sse4)
+
+#if HAVE_AVX2_EXTERNAL
+
+mc_rep_uni_w(10, 16, 32, avx2)
+mc_rep_uni_w(10, 16, 48, avx2)
+mc_rep_uni_w(10, 16, 64, avx2)
+
+mc_rep_uni_w(12, 16, 32, avx2)
+mc_rep_uni_w(12, 16, 48, avx2)
+mc_rep_uni_w(12, 16, 64, avx2)
+
+mc_rep_bi_w(10, 16, 32, avx2)
+mc_rep_bi_w(10, 16, 48, avx2)
+mc_rep_bi_w(10, 16, 64, avx2)
+
+mc_rep_bi_w(12, 16, 32, avx2)
+mc_rep_bi_w(12, 16, 48, avx2)
+mc_rep_bi_w(12, 16, 64, avx2)
+
+// there is no 24 wide AVX2 weighting, the SSE4 one is used for that width
+#define mc_w_funcs_avx2(name, bitd)                 \
+        mc_uni_w_func(name, bitd, 16, avx2)         \
+        mc_uni_w_mix(name, bitd, 24, avx2, sse4)    \
+        mc_uni_w_func(name, bitd, 32, avx2)         \
+        mc_uni_w_func(name, bitd, 48, avx2)         \
+        mc_uni_w_func(name, bitd, 64, avx2)         \
+        mc_bi_w_func(name, bitd, 16, avx2)          \
+        mc_bi_w_mix(name, bitd, 24, avx2, sse4)     \
+        mc_bi_w_func(name, bitd, 32, avx2)          \
+        mc_bi_w_func(name, bitd, 48, avx2)          \
+        mc_bi_w_func(name, bitd, 64, avx2)
+
+mc_w_funcs_avx2(pel_pixels, 10)
+mc_w_funcs_avx2(epel_h,     10)
+mc_w_funcs_avx2(epel_v,     10)
+mc_w_funcs_avx2(epel_hv,    10)
+mc_w_funcs_avx2(qpel_h,     10)
+mc_w_funcs_avx2(qpel_v,     10)
+mc_w_funcs_avx2(qpel_hv,    10)
+
+mc_w_funcs_avx2(pel_pixels, 12)
+mc_w_funcs_avx2(epel_h,     12)
+mc_w_funcs_avx2(epel_v,     12)
+mc_w_funcs_avx2(epel_hv,    12)
+mc_w_funcs_avx2(qpel_h,     12)
+mc_w_funcs_avx2(qpel_v,     12)
+mc_w_funcs_avx2(qpel_hv,    12)
+#endif //AVX2
 #endif //ARCH_X86_64 && HAVE_SSE4_EXTERNAL
 
 #define SAO_BAND_FILTER_FUNCS(bitd, opt)                                                                                   \
@@ -802,6 +900,22 @@ SAO_EDGE_FILTER_FUNCS(12, avx2)
         PEL_LINK(pointer, 7, my , mx , fname##32,  bitd, opt ); \
         PEL_LINK(pointer, 8, my , mx , fname##48,  bitd, opt ); \
         PEL_LINK(pointer, 9, my , mx , fname##64,  bitd, opt )
+#define PEL_LINKS_AVX2(pointer, my, mx, fname, bitd)            \
+        PEL_LINK(pointer, 5, my , mx , fname##16,  bitd, avx2); \
+        PEL_LINK(pointer, 6, my , mx , fname##24,  bitd, avx2); \
+        PEL_LINK(pointer, 7, my , mx , fname##32,  bitd, avx2); \
+        PEL_LINK(pointer, 8, my , mx , fname##48,  bitd, avx2); \
+        PEL_LINK(pointer, 9, my , mx , fname##64,  bitd, avx2)
+
+#define PEL_W_LINK(dst, idx1, idx2, idx3, name, D, opt) \
+dst ## _uni_w[idx1][idx2][idx3] = ff_hevc_put_hevc_uni_w_ ## name ## _ ## D ## _##opt; \
+dst ## _bi_w[idx1][idx2][idx3] = ff_hevc_put_hevc_bi_w_ ## name ## _ ## D ## _##opt
+#define PEL_W_LINKS_AVX2(pointer, my, mx, fname, bitd)            \
+        PEL_W_LINK(pointer, 5, my , mx , fname##16,  bitd, avx2); \
+        PEL_W_LINK(pointer, 6, my , mx , fname##24,  bitd, avx2); \
+        PEL_W_LINK(pointer, 7, my , mx , fname##32,  bitd, avx2); \
+        PEL_W_LINK(pointer, 8, my , mx , fname##48,  bitd, avx2); \
+        PEL_W_LINK(pointer, 9, my , mx , fname##64,  bitd, avx2)
 
 void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
 {
@@ -1191,6 +1305,16 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                 c->put_hevc_qpel_bi[7][1][1] = ff_hevc_put_hevc_bi_qpel_hv32_10_avx2;
                 c->put_hevc_qpel_bi[8][1][1] = ff_hevc_put_hevc_bi_qpel_hv48_10_avx2;
                 c->put_hevc_qpel_bi[9][1][1] = ff_hevc_put_hevc_bi_qpel_hv64_10_avx2;
+
+                PEL_W_LINKS_AVX2(c->put_hevc_epel, 0, 0, pel_pixels, 10);
+                PEL_W_LINKS_AVX2(c->put_hevc_epel, 0, 1, epel_h,     10);
+                PEL_W_LINKS_AVX2(c->put_hevc_epel, 1, 0, epel_v,     10);
+                PEL_W_LINKS_AVX2(c->put_hevc_epel, 1, 1, epel_hv,    10);
+
+                PEL_W_LINKS_AVX2(c->put_hevc_qpel, 0, 0, pel_pixels, 10);
+                PEL_W_LINKS_AVX2(c->put_hevc_qpel, 0, 1, qpel_h,     10);
+                PEL_W_LINKS_AVX2(c->put_hevc_qpel, 1, 0, qpel_v,     10);
+                PEL_W_LINKS_AVX2(c->put_hevc_qpel, 1, 1, qpel_hv,    10);
             }
             SAO_BAND_INIT(10, avx2);
             SAO_EDGE_INIT(10, avx2);
@@ -1246,7 +1370,54 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             c->idct_dc[2] = ff_hevc_idct_16x16_dc_12_avx2;
             c->idct_dc[3] = ff_hevc_idct_32x32_dc_12_avx2;
+            if (ARCH_X86_64) {
+                c->put_hevc_epel[5][0][0] = ff_hevc_put_hevc_pel_pixels16_12_avx2;
+                c->put_hevc_epel[6][0][0] = ff_hevc_put_hevc_pel_pixels24_12_avx2;
+                c->put_hevc_epel[7][0][0] = ff_hevc_put_hevc_pel_pixels32_12_avx2;
+                c->put_hevc_epel[8][0][0] = ff_hevc_put_hevc_pel_pixels48_12_avx2;
+                c->put_hevc_epel[9][0][0] = ff_hevc_put_hevc_pel_pixels64_12_avx2;
+
+                c->put_hevc_qpel[5][0][0] = ff_hevc_put_hevc_pel_pixels16_12_avx2;
+                c->put_hevc_qpel[6][0][0] = ff_hevc_put_hevc_pel_pixels24_12_avx2;
+                c->put_hevc_qpel[7][0][0] = ff_hevc_put_hevc_pel_pixels32_12_avx2;
+                c->put_hevc_qpel[8][0][0] = ff_hevc_put_hevc_pel_pixels48_12_avx2;
+                c->put_hevc_qpel[9][0][0] = ff_hevc_put_hevc_pel_pixels64_12_avx2;
 
+                c->put_hevc_epel_uni[5][0][0] = ff_hevc_put_hevc_uni_pel_pixels32_8_avx2;
+                c->put_hevc_epel_uni[6][0][0] = ff_hevc_put_hevc_uni_pel_pixels48_8_avx2;
+                c->put_hevc_epel_uni[7][0][0] = ff_hevc_put_hevc_uni_pel_pixels64_8_avx2;
+                c->put_hevc_epel_uni[8][0][0] = ff_hevc_put_hevc_uni_pel_pixels96_8_avx2;
+                c->put_hevc_epel_uni[9][0][0] = ff_hevc_put_hevc_uni_pel_pixels128_8_avx2;
+
+                c->put_hevc_qpel_uni[5][0][0] = ff_hevc_put_hevc_uni_pel_pixels32_8_avx2;
+                c->put_hevc_qpel_uni[6][0][0] = ff_hevc_put_hevc_uni_pel_pixels48_8_avx2;
+                c->put_hevc_qpel_uni[7][0][0] = ff_hevc_put_hevc_uni_pel_pixels64_8_avx2;
+                c->put_hevc_qpel_uni[8][0][0] = ff_hevc_put_hevc_uni_pel_pixels96_8_avx2;
+                c->put_hevc_qpel_uni[9][0][0] = ff_hevc_put_hevc_uni_pel_pixels128_8_avx2;
+
+                c->put_hevc_epel_bi[5][0][0] = ff_hevc_put_hevc_bi_pel_pixels16_12_avx2;
+                c->put_hevc_epel_bi[6][0][0] = ff_hevc_put_hevc_bi_pel_pixels24_12_avx2;
+                c->put_hevc_epel_bi[7][0][0] = ff_hevc_put_hevc_bi_pel_pixels32_12_avx2;
+                c->put_hevc_epel_bi[8][0][0] = ff_hevc_put_hevc_bi_pel_pixels48_12_avx2;
+                c->put_hevc_epel_bi[9][0][0] = ff_hevc_put_hevc_bi_pel_pixels64_12_avx2;
+
+                c->put_hevc_qpel_bi[5][0][0] = ff_hevc_put_hevc_bi_pel_pixels16_12_avx2;
+                c->put_hevc_qpel_bi[6][0][0] = ff_hevc_put_hevc_bi_pel_pixels24_12_avx2;
+                c->put_hevc_qpel_bi[7][0][0] = ff_hevc_put_hevc_bi_pel_pixels32_12_avx2;
+                c->put_hevc_qpel_bi[8][0][0] = ff_hevc_put_hevc_bi_pel_pixels48_12_avx2;
+                c->put_hevc_qpel_bi[9][0][0] = ff_hevc_put_hevc_bi_pel_pixels64_12_avx2;
+
+                PEL_W_LINKS_AVX2(c->put_hevc_epel, 0, 0, pel_pixels, 12);
+                PEL_W_LINKS_AVX2(c->put_hevc_qpel, 0, 0, pel_pixels, 12);
+
+                PEL_LINKS_AVX2(c->put_hevc_epel, 0, 1, epel_h,  12);
+                PEL_LINKS_AVX2(c->put_hevc_epel, 1, 0, epel_v,  12);
+                PEL_LINKS_AVX2(c->put_hevc_epel, 1, 1, epel_hv, 12);
+
+                PEL_LINKS_AVX2(c->put_hevc_qpel, 0, 1, qpel_h,  12);
+                PEL_LINKS_AVX2(c->put_hevc_qpel, 1, 0, qpel_v,  12);
+                PEL_LINKS_AVX2(c->put_hevc_qpel, 1, 1, qpel_hv, 12);
+            }
             SAO_BAND_INIT(12, avx2);
             SAO_EDGE_INIT(12, avx2);
         }
@@ -135,6 +135,9 @@ SECTION .text
 
 %define hevc_qpel_filters_avx2_14 hevc_qpel_filters_avx2_10
 
+%define hevc_epel_filters_avx2_12 hevc_epel_filters_avx2_10
+%define hevc_qpel_filters_avx2_12 hevc_qpel_filters_avx2_10
+
 %if ARCH_X86_64
 
 %macro SIMPLE_BILOAD 4   ;width, tab, r1, r2
@@ -421,8 +424,12 @@ SECTION .text
     movq        [%1+16], %3
 %endmacro
 %macro PEL_12STORE16 3
+%if cpuflag(avx2)
+    movu            [%1], %2
+%else
     PEL_12STORE8      %1, %2, %3
     movdqa       [%1+16], %3
+%endif
 %endmacro
 
 %macro PEL_10STORE2 3
@@ -1023,6 +1030,15 @@ cglobal hevc_put_hevc_bi_qpel_hv%1_%2, 8, 10, 16, dst, dststride, src, srcstride
     RET
 %endmacro
 
+; broadcast the low dword of m%1 to the whole register
+%macro WEIGHT_SPLATD 1
+%if cpuflag(avx2)
+    vpbroadcastd     m%1, xm%1
+%else
+    pshufd           m%1, m%1, 0
+%endif
+%endmacro
+
 %macro WEIGHTING_FUNCS 2
 %if WIN64 || ARCH_X86_32
 cglobal hevc_put_hevc_uni_w%1_%2, 4, 5, 7, dst, dststride, src, height, denom, wx, ox
@@ -1036,24 +1052,24 @@ cglobal hevc_put_hevc_uni_w%1_%2, 6, 6, 7, dst, dststride, src, height, denom, w
 %if %1 <= 4
     pxor             m1, m1
 %endif
-    movd             m2, wxm        ; WX
-    movd             m4, SHIFT      ; shift
+    movd            xm2, wxm        ; WX
+    movd            xm4, SHIFT      ; shift
 %if %1 <= 4
     punpcklwd        m2, m1
 %else
-    punpcklwd        m2, m2
+    punpcklwd       xm2, xm2
 %endif
     dec           SHIFT
     movdqu           m5, [pd_1]
-    movd             m6, SHIFT
-    pshufd           m2, m2, 0
+    movd            xm6, SHIFT
+    WEIGHT_SPLATD     2
     mov           SHIFT, oxm
-    pslld            m5, m6
+    pslld            m5, xm6
 %if %2 != 8
     shl           SHIFT, %2-8       ; ox << (bitd - 8)
 %endif
-    movd             m3, SHIFT      ; OX
-    pshufd           m3, m3, 0
+    movd            xm3, SHIFT      ; OX
+    WEIGHT_SPLATD     3
 %if WIN64 || ARCH_X86_32
     mov           SHIFT, heightm
 %endif
@@ -1063,7 +1079,7 @@ cglobal hevc_put_hevc_uni_w%1_%2, 6, 6, 7, dst, dststride, src, height, denom, w
     punpcklwd         m0, m1
     pmaddwd           m0, m2
     paddd             m0, m5
-    psrad             m0, m4
+    psrad             m0, xm4
     paddd             m0, m3
 %else
     pmulhw            m6, m0, m2
@@ -1072,8 +1088,8 @@ cglobal hevc_put_hevc_uni_w%1_%2, 6, 6, 7, dst, dststride, src, height, denom, w
     punpcklwd         m0, m6
     paddd             m0, m5
     paddd             m1, m5
-    psrad             m0, m4
-    psrad             m1, m4
+    psrad             m0, xm4
+    psrad             m1, xm4
     paddd             m0, m3
     paddd             m1, m3
 %endif
@@ -1095,36 +1111,36 @@ cglobal hevc_put_hevc_bi_w%1_%2, 4, 6, 10, dst, dststride, src, src2, height, de
 %if %1 <= 4
     pxor              m1, m1
 %endif
-    movd              m2, wx0m         ; WX0
+    movd             xm2, wx0m         ; WX0
     lea              r5d, [r5d+14-%2]  ; shift = 14 - bitd + denom
-    movd              m3, wx1m         ; WX1
-    movd              m0, r5d          ; shift
+    movd             xm3, wx1m         ; WX1
+    movd             xm0, r5d          ; shift
 %if %1 <= 4
     punpcklwd         m2, m1
     punpcklwd         m3, m1
 %else
-    punpcklwd         m2, m2
-    punpcklwd         m3, m3
+    punpcklwd        xm2, xm2
+    punpcklwd        xm3, xm3
 %endif
     inc              r5d
-    movd              m5, r5d          ; shift+1
-    pshufd            m2, m2, 0
+    movd             xm5, r5d          ; shift+1
+    WEIGHT_SPLATD      2
     mov              r5d, ox0m
-    pshufd            m3, m3, 0
+    WEIGHT_SPLATD      3
     add              r5d, ox1m
 %if %2 != 8
     shl              r5d, %2-8         ; ox << (bitd - 8)
 %endif
     inc              r5d
-    movd              m4, r5d          ; offset
-    pshufd            m4, m4, 0
+    movd             xm4, r5d          ; offset
+    WEIGHT_SPLATD      4
 %if UNIX64
 %define h heightd
 %else
     mov              r5d, heightm
 %define h r5d
 %endif
-    pslld             m4, m0
+    pslld             m4, xm0
 
 .loop:
    SIMPLE_LOAD        %1, 10, srcq,  m0
@@ -1136,7 +1152,7 @@ cglobal hevc_put_hevc_bi_w%1_%2, 4, 6, 10, dst, dststride, src, src2, height, de
     pmaddwd           m8, m2
     paddd             m0, m4
     paddd             m0, m8
-    psrad             m0, m5
+    psrad             m0, xm5
 %else
     pmulhw            m6, m0, m3
     pmullw            m0, m3
@@ -1150,8 +1166,8 @@ cglobal hevc_put_hevc_bi_w%1_%2, 4, 6, 10, dst, dststride, src, src2, height, de
     paddd             m1, m9
     paddd             m0, m4
     paddd             m1, m4
-    psrad             m0, m5
-    psrad             m1, m5
+    psrad             m0, xm5
+    psrad             m1, xm5
 %endif
     packssdw          m0, m1
 %if %2 == 8
@@ -1265,20 +1281,28 @@ HEVC_PUT_HEVC_QPEL_HV 8, 12
 %if HAVE_AVX2_EXTERNAL
 INIT_YMM avx2  ; adds ff_ and _avx2 to function name & enables 256b registers : m0 for 256b, xm0 for 128b. cpuflag(avx2) = 1 / notcpuflag(avx) = 0
 
+WEIGHTING_FUNCS 16, 10
+WEIGHTING_FUNCS 16, 12
+
 HEVC_BI_PEL_PIXELS 32, 8
 HEVC_BI_PEL_PIXELS 16, 10
+HEVC_BI_PEL_PIXELS 16, 12
 
 HEVC_PUT_HEVC_EPEL 32, 8
 HEVC_PUT_HEVC_EPEL 16, 10
+HEVC_PUT_HEVC_EPEL 16, 12
 
 HEVC_PUT_HEVC_EPEL_HV 16, 10
+HEVC_PUT_HEVC_EPEL_HV 16, 12
 HEVC_PUT_HEVC_EPEL_HV 32, 8
 
 HEVC_PUT_HEVC_QPEL 32, 8
 
 HEVC_PUT_HEVC_QPEL 16, 10
+HEVC_PUT_HEVC_QPEL 16, 12
 
 HEVC_PUT_HEVC_QPEL_HV 16, 10
+HEVC_PUT_HEVC_QPEL_HV 16, 12
 
 %endif ;AVX2
 %endif ; ARCH_X86_64
@@ -100,12 +100,6 @@ void ff_hevc_put_hevc_pel_pixels32_8_avx2(int16_t *dst, const uint8_t *_src, ptr
 void ff_hevc_put_hevc_pel_pixels48_8_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
 void ff_hevc_put_hevc_pel_pixels64_8_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
 
-void ff_hevc_put_hevc_pel_pixels16_10_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
-void ff_hevc_put_hevc_pel_pixels24_10_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
-void ff_hevc_put_hevc_pel_pixels32_10_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
-void ff_hevc_put_hevc_pel_pixels48_10_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
-void ff_hevc_put_hevc_pel_pixels64_10_avx2(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
-
 
 
 void ff_hevc_put_hevc_uni_pel_pixels32_8_avx2(uint8_t *dst, ptrdiff_t dststride,const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my,int width);
@@ -121,11 +115,17 @@ void ff_hevc_put_hevc_bi_pel_pixels32_8_avx2(uint8_t *_dst, ptrdiff_t _dststride
 void ff_hevc_put_hevc_bi_pel_pixels48_8_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
 void ff_hevc_put_hevc_bi_pel_pixels64_8_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
 
-void ff_hevc_put_hevc_bi_pel_pixels16_10_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
-void ff_hevc_put_hevc_bi_pel_pixels24_10_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
-void ff_hevc_put_hevc_bi_pel_pixels32_10_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
-void ff_hevc_put_hevc_bi_pel_pixels48_10_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
-void ff_hevc_put_hevc_bi_pel_pixels64_10_avx2(uint8_t *_dst, ptrdiff_t _dststride, const uint8_t *_src, ptrdiff_t _srcstride, const int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
+PEL_PROTOTYPE(pel_pixels16,10, avx2);
+PEL_PROTOTYPE(pel_pixels24,10, avx2);
+PEL_PROTOTYPE(pel_pixels32,10, avx2);
+PEL_PROTOTYPE(pel_pixels48,10, avx2);
+PEL_PROTOTYPE(pel_pixels64,10, avx2);
+
+PEL_PROTOTYPE(pel_pixels16,12, avx2);
+PEL_PROTOTYPE(pel_pixels24,12, avx2);
+PEL_PROTOTYPE(pel_pixels32,12, avx2);
+PEL_PROTOTYPE(pel_pixels48,12, avx2);
+PEL_PROTOTYPE(pel_pixels64,12, avx2);
 
 ///////////////////////////////////////////////////////////////////////////////
 // EPEL
@@ -154,6 +154,12 @@ PEL_PROTOTYPE(epel_h32,10, avx2);
 PEL_PROTOTYPE(epel_h48,10, avx2);
 PEL_PROTOTYPE(epel_h64,10, avx2);
 
+PEL_PROTOTYPE(epel_h16,12, avx2);
+PEL_PROTOTYPE(epel_h24,12, avx2);
+PEL_PROTOTYPE(epel_h32,12, avx2);
+PEL_PROTOTYPE(epel_h48,12, avx2);
+PEL_PROTOTYPE(epel_h64,12, avx2);
+
 PEL_PROTOTYPE(epel_v16, 8, avx2);
 PEL_PROTOTYPE(epel_v24, 8, avx2);
 PEL_PROTOTYPE(epel_v32, 8, avx2);
@@ -166,6 +172,12 @@ PEL_PROTOTYPE(epel_v32,10, avx2);
 PEL_PROTOTYPE(epel_v48,10, avx2);
 PEL_PROTOTYPE(epel_v64,10, avx2);
 
+PEL_PROTOTYPE(epel_v16,12, avx2);
+PEL_PROTOTYPE(epel_v24,12, avx2);
+PEL_PROTOTYPE(epel_v32,12, avx2);
+PEL_PROTOTYPE(epel_v48,12, avx2);
+PEL_PROTOTYPE(epel_v64,12, avx2);
+
 PEL_PROTOTYPE(epel_hv16, 8, avx2);
 PEL_PROTOTYPE(epel_hv24, 8, avx2);
 PEL_PROTOTYPE(epel_hv32, 8, avx2);
@@ -178,6 +190,12 @@ PEL_PROTOTYPE(epel_hv32,10, avx2);
 PEL_PROTOTYPE(epel_hv48,10, avx2);
 PEL_PROTOTYPE(epel_hv64,10, avx2);
 
+PEL_PROTOTYPE(epel_hv16,12, avx2);
+PEL_PROTOTYPE(epel_hv24,12, avx2);
+PEL_PROTOTYPE(epel_hv32,12, avx2);
+PEL_PROTOTYPE(epel_hv48,12, avx2);
+PEL_PROTOTYPE(epel_hv64,12, avx2);
+
 ///////////////////////////////////////////////////////////////////////////////
 // QPEL
 ///////////////////////////////////////////////////////////////////////////////
@@ -205,6 +223,12 @@ PEL_PROTOTYPE(qpel_h32,10, avx2);
 PEL_PROTOTYPE(qpel_h48,10, avx2);
 PEL_PROTOTYPE(qpel_h64,10, avx2);
 
+PEL_PROTOTYPE(qpel_h16,12, avx2);
+PEL_PROTOTYPE(qpel_h24,12, avx2);
+PEL_PROTOTYPE(qpel_h32,12, avx2);
+PEL_PROTOTYPE(qpel_h48,12, avx2);
+PEL_PROTOTYPE(qpel_h64,12, avx2);
+
 PEL_PROTOTYPE(qpel_v16, 8, avx2);
 PEL_PROTOTYPE(qpel_v24, 8, avx2);
 PEL_PROTOTYPE(qpel_v32, 8, avx2);
@@ -217,6 +241,12 @@ PEL_PROTOTYPE(qpel_v32,10, avx2);
 PEL_PROTOTYPE(qpel_v48,10, avx2);
 PEL_PROTOTYPE(qpel_v64,10, avx2);
 
+PEL_PROTOTYPE(qpel_v16,12, avx2);
+PEL_PROTOTYPE(qpel_v24,12, avx2);
+PEL_PROTOTYPE(qpel_v32,12, avx2);
+PEL_PROTOTYPE(qpel_v48,12, avx2);
+PEL_PROTOTYPE(qpel_v64,12, avx2);
+
 PEL_PROTOTYPE(qpel_hv16, 8, avx2);
 PEL_PROTOTYPE(qpel_hv24, 8, avx2);
 PEL_PROTOTYPE(qpel_hv32, 8, avx2);
@@ -229,10 +259,25 @@ PEL_PROTOTYPE(qpel_hv32,10, avx2);
 PEL_PROTOTYPE(qpel_hv48,10, avx2);
 PEL_PROTOTYPE(qpel_hv64,10, avx2);
 
+PEL_PROTOTYPE(qpel_hv16,12, avx2);
+PEL_PROTOTYPE(qpel_hv24,12, avx2);
+PEL_PROTOTYPE(qpel_hv32,12, avx2);
+PEL_PROTOTYPE(qpel_hv48,12, avx2);
+PEL_PROTOTYPE(qpel_hv64,12, avx2);
+
 WEIGHTING_PROTOTYPES(8, sse4);
 WEIGHTING_PROTOTYPES(10, sse4);
 WEIGHTING_PROTOTYPES(12, sse4);
 
+WEIGHTING_PROTOTYPE(16, 10, avx2);
+WEIGHTING_PROTOTYPE(32, 10, avx2);
+WEIGHTING_PROTOTYPE(48, 10, avx2);
+WEIGHTING_PROTOTYPE(64, 10, avx2);
+WEIGHTING_PROTOTYPE(16, 12, avx2);
+WEIGHTING_PROTOTYPE(32, 12, avx2);
+WEIGHTING_PROTOTYPE(48, 12, avx2);
+WEIGHTING_PROTOTYPE(64, 12, avx2);
+
 void ff_hevc_put_hevc_qpel_h4_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
 void ff_hevc_put_hevc_qpel_h8_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
 void ff_hevc_put_hevc_qpel_h16_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
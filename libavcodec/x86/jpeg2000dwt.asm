@@ -0,0 +1,135 @@
+;******************************************************************************
+;* SIMD-optimized JPEG2000 inverse DWT lifting steps
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pd_2: times 8 dd 2
+
+SECTION .text
+
+; A row is FF_DWT_STRIP (16) samples of 4 bytes, the rows being lifted are
+; two rows (128 bytes) apart.
+
+;***********************************************************************
+; void ff_jpeg2000_lift_float_<opt>(float *p, float coef, int n)
+;***********************************************************************
+%macro LIFT_FLOAT 0
+%if UNIX64
+cglobal jpeg2000_lift_float, 2, 2, 3, p, n
+%else
+cglobal jpeg2000_lift_float, 3, 3, 3, p, coef, n
+%endif
+%if ARCH_X86_32
+    VBROADCASTSS m0, coefm
+%else
+%if WIN64
+    SWAP 0, 1
+%endif
+    shufps      xm0, xm0, 0
+%if cpuflag(avx)
+    vinsertf128  m0, m0, xm0, 1
+%endif
+%endif
+    test         nd, nd
+    jle .end
+.loop:
+%assign i 0
+%rep 64 / mmsize
+    movu         m1, [pq + i - 64]
+    movu         m2, [pq + i + 64]
+    addps        m1, m2
+    mulps        m1, m0
+    movu         m2, [pq + i]
+    addps        m2, m1
+    movu  [pq + i], m2
+%assign i i + mmsize
+%endrep
+    add          pq, 128
+    dec          nd
+    jg .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse
+LIFT_FLOAT
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+LIFT_FLOAT
+%endif
+
+;***********************************************************************
+; void ff_jpeg2000_lift53_even_<opt>(int32_t *p, int n)
+; void ff_jpeg2000_lift53_odd_<opt>(int32_t *p, int n)
+;***********************************************************************
+%macro LIFT53 0
+cglobal jpeg2000_lift53_even, 2, 2, 3, p, n
+    mova         m2, [pd_2]
+    test         nd, nd
+    jle .end
+.loop:
+%assign i 0
+%rep 64 / mmsize
+    movu         m0, [pq + i - 64]
+    movu         m1, [pq + i + 64]
+    paddd        m0, m1
+    paddd        m0, m2
+    psrad        m0, 2
+    movu         m1, [pq + i]
+    psubd        m1, m0
+    movu  [pq + i], m1
+%assign i i + mmsize
+%endrep
+    add          pq, 128
+    dec          nd
+    jg .loop
+.end:
+    RET
+
+cglobal jpeg2000_lift53_odd, 2, 2, 2, p, n
+    test         nd, nd
+    jle .end
+.loop:
+%assign i 0
+%rep 64 / mmsize
+    movu         m0, [pq + i - 64]
+    movu         m1, [pq + i + 64]
+    paddd        m0, m1
+    psrad        m0, 1
+    movu         m1, [pq + i]
+    paddd        m1, m0
+    movu  [pq + i], m1
+%assign i i + mmsize
+%endrep
+    add          pq, 128
+    dec          nd
+    jg .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse2
+LIFT53
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+LIFT53
+%endif
@@ -278,6 +278,59 @@ INIT_XMM ssse3
 %define ABS_SUM_8x8 ABS_SUM_8x8_64
 HADAMARD8_DIFF 9
 
+; The AVX2 version transforms the two 8x8 blocks of a 16x8 area at once, one
+; per 128-bit lane. Both lanes are summed separately, so that each block
+; saturates at 64k exactly like in the SSE2/SSSE3 versions.
+%if HAVE_AVX2_EXTERNAL && ARCH_X86_64
+%macro DIFF_PIXELS_16 3
+    pmovzxbw        %1, %2
+    pmovzxbw        m8, %3
+    psubw           %1, m8
+%endmacro
+
+INIT_YMM avx2
+; r1, r2: src1, src2, advanced by 4 lines on return; r3: stride
+hadamard16x8_diff_avx2:
+    lea             r0, [r3*3]
+    DIFF_PIXELS_16  m0, [r1     ], [r2     ]
+    DIFF_PIXELS_16  m1, [r1+r3  ], [r2+r3  ]
+    DIFF_PIXELS_16  m2, [r1+r3*2], [r2+r3*2]
+    DIFF_PIXELS_16  m3, [r1+r0  ], [r2+r0  ]
+    lea             r1, [r1+r3*4]
+    lea             r2, [r2+r3*4]
+    DIFF_PIXELS_16  m4, [r1     ], [r2     ]
+    DIFF_PIXELS_16  m5, [r1+r3  ], [r2+r3  ]
+    DIFF_PIXELS_16  m6, [r1+r3*2], [r2+r3*2]
+    DIFF_PIXELS_16  m7, [r1+r0  ], [r2+r0  ]
+    HADAMARD8
+    TRANSPOSE8x8W    0,  1,  2,  3,  4,  5,  6,  7,  8
+    HADAMARD8
+    ABS_SUM_8x8_64   0
+    vextracti128   xm1, m0, 1
+    HSUM           xm0, xm2, eax
+    HSUM           xm1, xm2, r0d
+    and            eax, 0xFFFF
+    and            r0d, 0xFFFF
+    add            eax, r0d
+    ret
+
+cglobal hadamard8_diff16, 5, 6, 10
+    call hadamard16x8_diff_avx2
+    mov            r5d, eax
+
+    cmp            r4d, 16
+    jne .done
+
+    lea             r1, [r1+r3*4]
+    lea             r2, [r2+r3*4]
+    call hadamard16x8_diff_avx2
+    add            r5d, eax
+
+.done:
+    mov            eax, r5d
+    RET
+%endif
+
 ; int ff_sse*_*(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
 ;               ptrdiff_t line_size, int h)
 
@@ -667,6 +720,83 @@ SAD_Y2 16
 INIT_XMM sse2
 SAD_Y2 16
 
+;------------------------------------------------------------------------------------------
+;int ff_sad16{,_x2,_y2}_avx2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
+;                           ptrdiff_t stride, int h);
+;------------------------------------------------------------------------------------------
+; Two rows are packed into one ymm register, one per 128-bit lane.
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+cglobal sad16, 5, 5, 3, v, pix1, pix2, stride, h
+    pxor           m2, m2
+align 16
+.loop:
+    movu          xm0, [pix2q]
+    vinserti128    m0, m0, [pix2q+strideq], 1
+    movu          xm1, [pix1q]
+    vinserti128    m1, m1, [pix1q+strideq], 1
+    psadbw         m0, m1
+    paddw          m2, m0
+    lea         pix1q, [pix1q+2*strideq]
+    lea         pix2q, [pix2q+2*strideq]
+    sub            hd, 2
+    jg .loop
+    vextracti128  xm0, m2, 1
+    paddw         xm2, xm0
+    movhlps       xm0, xm2
+    paddw         xm2, xm0
+    movd          eax, xm2
+    RET
+
+cglobal sad16_x2, 5, 5, 3, v, pix1, pix2, stride, h
+    pxor           m2, m2
+align 16
+.loop:
+    movu          xm0, [pix2q]
+    vinserti128    m0, m0, [pix2q+strideq], 1
+    movu          xm1, [pix2q+1]
+    vinserti128    m1, m1, [pix2q+strideq+1], 1
+    pavgb          m0, m1
+    movu          xm1, [pix1q]
+    vinserti128    m1, m1, [pix1q+strideq], 1
+    psadbw         m0, m1
+    paddw          m2, m0
+    lea         pix1q, [pix1q+2*strideq]
+    lea         pix2q, [pix2q+2*strideq]
+    sub            hd, 2
+    jg .loop
+    vextracti128  xm0, m2, 1
+    paddw         xm2, xm0
+    movhlps       xm0, xm2
+    paddw         xm2, xm0
+    movd          eax, xm2
+    RET
+
+cglobal sad16_y2, 5, 5, 3, v, pix1, pix2, stride, h
+    pxor           m2, m2
+align 16
+.loop:
+    movu          xm0, [pix2q]
+    vinserti128    m0, m0, [pix2q+strideq], 1
+    movu          xm1, [pix2q+strideq]
+    vinserti128    m1, m1, [pix2q+2*strideq], 1
+    pavgb          m0, m1
+    movu          xm1, [pix1q]
+    vinserti128    m1, m1, [pix1q+strideq], 1
+    psadbw         m0, m1
+    paddw          m2, m0
+    lea         pix1q, [pix1q+2*strideq]
+    lea         pix2q, [pix2q+2*strideq]
+    sub            hd, 2
+    jg .loop
+    vextracti128  xm0, m2, 1
+    paddw         xm2, xm0
+    movhlps       xm0, xm2
+    paddw         xm2, xm0
+    movd          eax, xm2
+    RET
+%endif
+
 ;-------------------------------------------------------------------------------------------
 ;int ff_sad_approx_xy2_<opt>(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2, ptrdiff_t stride, int h);
 ;-------------------------------------------------------------------------------------------
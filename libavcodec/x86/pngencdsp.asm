@@ -0,0 +1,123 @@
+;******************************************************************************
+;* x86 optimizations for PNG encoding
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+cextern pb_1
+
+SECTION .text
+
+; The filters only depend on the source rows, so the last block is
+; realigned to end exactly at w and may overlap the previous one.
+; w must be at least one block wide.
+%macro NEXT_BLOCK 1 ; size
+    cmp                 iq, wq
+    jge .end
+    add                 iq, %1
+    cmp                 iq, wq
+    jle .loop
+    mov                 iq, wq
+    jmp .loop
+.end:
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_sub_png_avg_prediction(uint8_t *dst, const uint8_t *src,
+;                                const uint8_t *top, int w, int bpp)
+;------------------------------------------------------------------------------
+INIT_XMM sse2
+cglobal sub_png_avg_prediction, 5, 6, 4, dst, src, top, w, i, left
+    movsxdifnidn        wq, wd
+    movsxdifnidn        iq, id
+    mov              leftq, srcq
+    sub              leftq, iq            ; i holds bpp on entry
+    sub                 wq, mmsize
+    xor                 iq, iq
+    mova                m3, [pb_1]
+.loop:
+    movu                m0, [leftq+iq]
+    movu                m1, [topq+iq]
+    mova                m2, m0
+    pxor                m2, m1
+    pand                m2, m3
+    pavgb               m0, m1
+    psubb               m0, m2            ; (a + b) >> 1
+    movu                m1, [srcq+iq]
+    psubb               m1, m0
+    movu       [dstq+iq], m1
+    NEXT_BLOCK mmsize
+    RET
+
+;------------------------------------------------------------------------------
+; void ff_sub_png_paeth_prediction(uint8_t *dst, const uint8_t *src,
+;                                  const uint8_t *top, int w, int bpp)
+;------------------------------------------------------------------------------
+%macro SUB_PAETH 0
+cglobal sub_png_paeth_prediction, 5, 7, 8, dst, src, top, w, i, left, topleft
+    movsxdifnidn        wq, wd
+    movsxdifnidn        iq, id
+    mov              leftq, srcq
+    sub              leftq, iq            ; i holds bpp on entry
+    mov           topleftq, topq
+    sub           topleftq, iq
+    sub                 wq, mmsize/2
+    xor                 iq, iq
+    pxor                m7, m7
+.loop:
+    movh                m0, [leftq+iq]    ; a
+    movh                m1, [topq+iq]     ; b
+    movh                m2, [topleftq+iq] ; c
+    punpcklbw           m0, m7
+    punpcklbw           m1, m7
+    punpcklbw           m2, m7
+    mova                m3, m1
+    psubw               m3, m2            ; b - c
+    mova                m4, m0
+    psubw               m4, m2            ; a - c
+    mova                m5, m3
+    paddw               m5, m4            ; a + b - 2c
+    ABS1                m3, m6            ; pa
+    ABS1                m4, m6            ; pb
+    ABS1                m5, m6            ; pc
+    mova                m6, m3
+    pcmpgtw             m6, m4
+    pcmpgtw             m3, m5
+    por                 m3, m6            ; pa > pb || pa > pc
+    pcmpgtw             m4, m5            ; pb > pc
+    pand                m2, m4
+    pandn               m4, m1
+    por                 m4, m2            ; pb > pc ? c : b
+    pand                m4, m3
+    pandn               m3, m0
+    por                 m3, m4
+    packuswb            m3, m3
+    movh                m0, [srcq+iq]
+    psubb               m0, m3
+    movh       [dstq+iq], m0
+    NEXT_BLOCK mmsize/2
+    RET
+%endmacro
+
+INIT_XMM sse2
+SUB_PAETH
+INIT_XMM ssse3
+SUB_PAETH
@@ -0,0 +1,64 @@
+/*
+ * x86 PNG encoder DSP functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+#include "libavutil/attributes.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/pngencdsp.h"
+
+void ff_sub_png_avg_prediction_sse2(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *top, int w, int bpp);
+void ff_sub_png_paeth_prediction_sse2(uint8_t *dst, const uint8_t *src,
+                                      const uint8_t *top, int w, int bpp);
+void ff_sub_png_paeth_prediction_ssse3(uint8_t *dst, const uint8_t *src,
+                                       const uint8_t *top, int w, int bpp);
+
+/* The assembly needs at least one full block; narrower rows use C. */
+#define SUB_PRED_FUNC(name, opt, min_w)                                    \
+static void sub_png_ ## name ## _prediction_ ## opt(uint8_t *dst,          \
+                                                    const uint8_t *src,    \
+                                                    const uint8_t *top,    \
+                                                    int w, int bpp)        \
+{                                                                          \
+    if (w < min_w)                                                         \
+        ff_sub_png_ ## name ## _prediction(dst, src, top, w, bpp);         \
+    else                                                                   \
+        ff_sub_png_ ## name ## _prediction_ ## opt(dst, src, top, w, bpp); \
+}
+
+#if HAVE_X86ASM
+SUB_PRED_FUNC(avg,   sse2,  16)
+SUB_PRED_FUNC(paeth, sse2,  8)
+SUB_PRED_FUNC(paeth, ssse3, 8)
+#endif
+
+av_cold void ff_pngencdsp_init_x86(PNGEncDSPContext *c)
+{
+#if HAVE_X86ASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        c->sub_avg_prediction   = sub_png_avg_prediction_sse2;
+        c->sub_paeth_prediction = sub_png_paeth_prediction_sse2;
+    }
+    if (EXTERNAL_SSSE3(cpu_flags))
+        c->sub_paeth_prediction = sub_png_paeth_prediction_ssse3;
+#endif
+}
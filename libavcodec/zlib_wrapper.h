@@ -53,6 +53,14 @@ void ff_inflate_end(FFZStream *zstream);
  */
 int ff_deflate_init(FFZStream *zstream, int level, void *logctx);
 
+/**
+ * Wrapper around deflateInit2() with the default memory level and
+ * strategy; negative window_bits produce a raw deflate stream.
+ * It works analogously to ff_inflate_init().
+ */
+int ff_deflate_init2(FFZStream *zstream, int level, int window_bits,
+                     void *logctx);
+
 /**
  * Wrapper around deflateEnd(). It works analogously to ff_inflate_end().
  */
@@ -72,8 +72,11 @@ typedef struct EvalContext {
     uint64_t n;
     double var_values[VAR_VARS_NB];
     double *channel_values;
+    int uses_val;               ///< set if an expression reads the input with val()
 } EvalContext;
 
+#define SAMPLE_BATCH 256
+
 static double val(void *priv, double ch)
 {
     EvalContext *eval = priv;
@@ -145,6 +148,7 @@ static int parse_channel_expressions(AVFilterContext *ctx,
     }
     av_freep(&eval->expr);
     eval->nb_channels = 0;
+    eval->uses_val = 0;
 
     buf = args1;
     while (expr = av_strtok(buf, "|", &buf)) {
@@ -165,6 +169,14 @@ static int parse_channel_expressions(AVFilterContext *ctx,
         goto end;
     }
 
+    /* val() depends on the current sample, which prevents evaluating
+     * several samples at once */
+    for (i = 0; i < eval->nb_channels && func1; i++) {
+        unsigned counter[1] = { 0 };
+        av_expr_count_func(eval->expr[i], counter, FF_ARRAY_ELEMS(counter), 1);
+        eval->uses_val |= !!counter[0];
+    }
+
 end:
     av_free(args1);
     return ret;
@@ -269,7 +281,7 @@ static int activate(AVFilterContext *ctx)
     AVFilterLink *outlink = ctx->outputs[0];
     EvalContext *eval = outlink->src->priv;
     AVFrame *samplesref;
-    int i, j;
+    int i, j, k, ret;
     int64_t t = av_rescale(eval->n, AV_TIME_BASE, eval->sample_rate);
     int nb_samples;
 
@@ -294,16 +306,27 @@ static int activate(AVFilterContext *ctx)
     if (!samplesref)
         return AVERROR(ENOMEM);
 
-    /* evaluate expression for each single sample and for each channel */
-    for (i = 0; i < nb_samples; i++, eval->n++) {
-        eval->var_values[VAR_N] = eval->n;
-        eval->var_values[VAR_T] = eval->var_values[VAR_N] * (double)1/eval->sample_rate;
+    /* evaluate expression for runs of samples and for each channel */
+    for (i = 0; i < nb_samples; i += SAMPLE_BATCH) {
+        const int n = FFMIN(nb_samples - i, SAMPLE_BATCH);
+        double ns[SAMPLE_BATCH], ts[SAMPLE_BATCH];
+        const double *arrays[VAR_VARS_NB] = { [VAR_N] = ns, [VAR_T] = ts };
+
+        for (k = 0; k < n; k++) {
+            ns[k] = eval->n + i + k;
+            ts[k] = ns[k] * (double)1/eval->sample_rate;
+        }
 
         for (j = 0; j < eval->nb_channels; j++) {
-            *((double *) samplesref->extended_data[j] + i) =
-                av_expr_eval(eval->expr[j], eval->var_values, NULL);
+            ret = av_expr_eval_batch(eval->expr[j], (double *)samplesref->extended_data[j] + i,
+                                     n, eval->var_values, arrays, NULL);
+            if (ret < 0) {
+                av_frame_free(&samplesref);
+                return ret;
+            }
         }
     }
+    eval->n += nb_samples;
 
     samplesref->pts = eval->pts;
     samplesref->sample_rate = eval->sample_rate;
@@ -414,7 +437,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     int nb_samples        = in->nb_samples;
     AVFrame *out;
     double t0;
-    int i, j;
+    int i, j, k, ret;
 
     out = ff_get_audio_buffer(outlink, nb_samples);
     if (!out) {
@@ -425,19 +448,45 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
 
     t0 = TS2T(in->pts, inlink->time_base);
 
-    /* evaluate expression for each single sample and for each channel */
-    for (i = 0; i < nb_samples; i++, eval->n++) {
-        eval->var_values[VAR_N] = eval->n;
-        eval->var_values[VAR_T] = t0 + i * (double)1/inlink->sample_rate;
+    if (eval->uses_val) {
+        /* evaluate expression for each single sample and for each channel */
+        for (i = 0; i < nb_samples; i++, eval->n++) {
+            eval->var_values[VAR_N] = eval->n;
+            eval->var_values[VAR_T] = t0 + i * (double)1/inlink->sample_rate;
 
-        for (j = 0; j < inlink->ch_layout.nb_channels; j++)
-            eval->channel_values[j] = *((double *) in->extended_data[j] + i);
+            for (j = 0; j < inlink->ch_layout.nb_channels; j++)
+                eval->channel_values[j] = *((double *) in->extended_data[j] + i);
 
-        for (j = 0; j < outlink->ch_layout.nb_channels; j++) {
-            eval->var_values[VAR_CH] = j;
-            *((double *) out->extended_data[j] + i) =
-                av_expr_eval(eval->expr[j], eval->var_values, eval);
+            for (j = 0; j < outlink->ch_layout.nb_channels; j++) {
+                eval->var_values[VAR_CH] = j;
+                *((double *) out->extended_data[j] + i) =
+                    av_expr_eval(eval->expr[j], eval->var_values, eval);
+            }
+        }
+    } else {
+        /* evaluate expression for runs of samples and for each channel */
+        for (i = 0; i < nb_samples; i += SAMPLE_BATCH) {
+            const int n = FFMIN(nb_samples - i, SAMPLE_BATCH);
+            double ns[SAMPLE_BATCH], ts[SAMPLE_BATCH];
+            const double *arrays[VAR_VARS_NB] = { [VAR_N] = ns, [VAR_T] = ts };
+
+            for (k = 0; k < n; k++) {
+                ns[k] = eval->n + i + k;
+                ts[k] = t0 + (i + k) * (double)1/inlink->sample_rate;
+            }
+
+            for (j = 0; j < outlink->ch_layout.nb_channels; j++) {
+                eval->var_values[VAR_CH] = j;
+                ret = av_expr_eval_batch(eval->expr[j], (double *)out->extended_data[j] + i,
+                                         n, eval->var_values, arrays, eval);
+                if (ret < 0) {
+                    av_frame_free(&in);
+                    av_frame_free(&out);
+                    return ret;
+                }
+            }
         }
+        eval->n += nb_samples;
     }
 
     av_frame_free(&in);
@@ -35,12 +35,12 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/common.h"
 #include "libavutil/eval.h"
-#include "libavutil/float_dsp.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/samplefmt.h"
 
+#include "af_amixdsp.h"
 #include "audio.h"
 #include "avfilter.h"
 #include "filters.h"
@@ -156,7 +156,7 @@ static int frame_list_add_frame(FrameList *frame_list, int nb_samples, int64_t p
 
 typedef struct MixContext {
     const AVClass *class;       /**< class for AVOptions */
-    AVFloatDSPContext *fdsp;
+    AudioMixDSPContext dsp;
 
     int nb_inputs;              /**< number of inputs */
     int active_inputs;          /**< number of input currently active */
@@ -171,6 +171,10 @@ typedef struct MixContext {
     AVAudioFifo **fifos;        /**< audio fifo for each input */
     uint8_t *input_state;       /**< current state of each input */
     float *input_scale;         /**< mixing scale factor for each input */
+    AVFrame **in_bufs;          /**< samples read from each active input */
+    void *mix_scale;            /**< input_scale of each active input, in the sample type */
+    const void **mix_src;       /**< input pointers, one row per mixing job */
+    int nb_mix_jobs;            /**< number of rows in mix_src */
     float *weights;             /**< custom weights for every input */
     float weight_sum;           /**< sum of custom weights for every input */
     float *scale_norm;          /**< normalization factor for every input */
@@ -281,6 +285,13 @@ static int config_output(AVFilterLink *outlink)
         s->scale_norm[i] = s->weight_sum / FFABS(s->weights[i]);
     calculate_scales(s, 0);
 
+    s->nb_mix_jobs = ff_filter_get_nb_threads(ctx);
+    s->in_bufs   = av_calloc(s->nb_inputs, sizeof(*s->in_bufs));
+    s->mix_scale = av_calloc(s->nb_inputs, sizeof(double));
+    s->mix_src   = av_calloc(s->nb_inputs * s->nb_mix_jobs, sizeof(*s->mix_src));
+    if (!s->in_bufs || !s->mix_scale || !s->mix_src)
+        return AVERROR(ENOMEM);
+
     av_channel_layout_describe(&outlink->ch_layout, buf, sizeof(buf));
 
     av_log(ctx, AV_LOG_VERBOSE,
@@ -290,6 +301,60 @@ static int config_output(AVFilterLink *outlink)
     return 0;
 }
 
+typedef struct ThreadData {
+    AVFrame *out;
+    int nb_src;
+    int planes;
+    int plane_size;
+} ThreadData;
+
+/**
+ * Mix a range of planes, or a range of samples of the only plane with packed
+ * formats, from all active inputs in a single pass.
+ */
+static int mix_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    MixContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const int is_dbl = td->out->format == AV_SAMPLE_FMT_DBL ||
+                       td->out->format == AV_SAMPLE_FMT_DBLP;
+    const int bps = is_dbl ? sizeof(double) : sizeof(float);
+    const void **src = s->mix_src + jobnr * s->nb_inputs;
+    int start_plane, end_plane, start, len;
+
+    if (td->planes > 1) {
+        start_plane = (td->planes *  jobnr     ) / nb_jobs;
+        end_plane   = (td->planes * (jobnr + 1)) / nb_jobs;
+        start       = 0;
+        len         = td->plane_size;
+    } else {
+        const int blocks = td->plane_size / 16;
+
+        start_plane = 0;
+        end_plane   = 1;
+        start       = (blocks *  jobnr     ) / nb_jobs * 16;
+        len         = (blocks * (jobnr + 1)) / nb_jobs * 16 - start;
+        if (!len)
+            return 0;
+    }
+
+    for (int p = start_plane; p < end_plane; p++) {
+        uint8_t *dst = td->out->extended_data[p] + start * bps;
+
+        for (int i = 0; i < td->nb_src; i++)
+            src[i] = s->in_bufs[i]->extended_data[p] + start * bps;
+
+        if (is_dbl)
+            s->dsp.mix_double((double *)dst, (const double **)src,
+                              s->mix_scale, td->nb_src, len);
+        else
+            s->dsp.mix_float((float *)dst, (const float **)src,
+                             s->mix_scale, td->nb_src, len);
+    }
+
+    return 0;
+}
+
 /**
  * Read samples from the input FIFOs, mix, and write to the output link.
  */
@@ -297,8 +362,9 @@ static int output_frame(AVFilterLink *outlink)
 {
     AVFilterContext *ctx = outlink->src;
     MixContext      *s = ctx->priv;
-    AVFrame *out_buf, *in_buf;
-    int nb_samples, ns, i;
+    AVFrame *out_buf;
+    ThreadData td;
+    int nb_samples, ns, i, ret = 0;
 
     if (s->input_state[0] & INPUT_ON) {
         /* first input live: use the corresponding frame size */
@@ -343,40 +409,44 @@ static int output_frame(AVFilterLink *outlink)
     if (!out_buf)
         return AVERROR(ENOMEM);
 
-    in_buf = ff_get_audio_buffer(outlink, nb_samples);
-    if (!in_buf) {
-        av_frame_free(&out_buf);
-        return AVERROR(ENOMEM);
-    }
+    td.out        = out_buf;
+    td.nb_src     = 0;
+    td.planes     = s->planar ? s->nb_channels : 1;
+    td.plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
+    td.plane_size = FFALIGN(td.plane_size, 16);
 
     for (i = 0; i < s->nb_inputs; i++) {
         if (s->input_state[i] & INPUT_ON) {
-            int planes, plane_size, p;
+            AVFrame *in_buf = ff_get_audio_buffer(outlink, nb_samples);
+            if (!in_buf) {
+                ret = AVERROR(ENOMEM);
+                goto fail;
+            }
+            s->in_bufs[td.nb_src] = in_buf;
 
             av_audio_fifo_read(s->fifos[i], (void **)in_buf->extended_data,
                                nb_samples);
 
-            planes     = s->planar ? s->nb_channels : 1;
-            plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
-            plane_size = FFALIGN(plane_size, 16);
-
-            if (out_buf->format == AV_SAMPLE_FMT_FLT ||
-                out_buf->format == AV_SAMPLE_FMT_FLTP) {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_fmac_scalar((float *)out_buf->extended_data[p],
-                                                (float *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
-                }
-            } else {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_dmac_scalar((double *)out_buf->extended_data[p],
-                                                (double *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
-                }
-            }
+            if (out_buf->format == AV_SAMPLE_FMT_DBL ||
+                out_buf->format == AV_SAMPLE_FMT_DBLP)
+                ((double *)s->mix_scale)[td.nb_src] = s->input_scale[i];
+            else
+                ((float *)s->mix_scale)[td.nb_src] = s->input_scale[i];
+            td.nb_src++;
         }
     }
-    av_frame_free(&in_buf);
+
+    ff_filter_execute(ctx, mix_slice, &td, NULL,
+                      FFMIN(td.planes > 1 ? td.planes : td.plane_size / 16,
+                            s->nb_mix_jobs));
+
+fail:
+    for (i = 0; i < td.nb_src; i++)
+        av_frame_free(&s->in_bufs[i]);
+    if (ret < 0) {
+        av_frame_free(&out_buf);
+        return ret;
+    }
 
     out_buf->pts = s->next_pts;
     out_buf->duration = av_rescale_q(out_buf->nb_samples, av_make_q(1, outlink->sample_rate),
@@ -558,9 +628,7 @@ static av_cold int init(AVFilterContext *ctx)
             return ret;
     }
 
-    s->fdsp = avpriv_float_dsp_alloc(0);
-    if (!s->fdsp)
-        return AVERROR(ENOMEM);
+    ff_amix_init(&s->dsp);
 
     s->weights = av_calloc(s->nb_inputs, sizeof(*s->weights));
     if (!s->weights)
@@ -585,9 +653,11 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_freep(&s->frame_list);
     av_freep(&s->input_state);
     av_freep(&s->input_scale);
+    av_freep(&s->in_bufs);
+    av_freep(&s->mix_scale);
+    av_freep(&s->mix_src);
     av_freep(&s->scale_norm);
     av_freep(&s->weights);
-    av_freep(&s->fdsp);
 }
 
 static int process_command(AVFilterContext *ctx, const char *cmd, const char *args,
@@ -621,7 +691,8 @@ const FFFilter ff_af_amix = {
     .p.description  = NULL_IF_CONFIG_SMALL("Audio mixing."),
     .p.priv_class   = &amix_class,
     .p.inputs       = NULL,
-    .p.flags        = AVFILTER_FLAG_DYNAMIC_INPUTS,
+    .p.flags        = AVFILTER_FLAG_DYNAMIC_INPUTS |
+                      AVFILTER_FLAG_SLICE_THREADS,
     .priv_size      = sizeof(MixContext),
     .init           = init,
     .uninit         = uninit,
@@ -0,0 +1,136 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_AMIXDSP_H
+#define AVFILTER_AMIXDSP_H
+
+#include <stddef.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/macros.h"
+
+/* number of samples mixed at once by the C functions, small enough for
+ * the output block to stay in L1 while all inputs are accumulated into it */
+#define AMIX_BLOCK_SIZE 256
+
+typedef struct AudioMixDSPContext {
+    /**
+     * Set dst[n] to the sum of src[i][n] * scale[i] over the nb_src inputs,
+     * accumulated in input order. Implementations may fuse each
+     * multiplication with the following addition, so the result is only
+     * exact up to rounding. dst and all src must be aligned to
+     * av_cpu_max_align().
+     *
+     * @param len number of samples, a positive multiple of 16
+     */
+    void (*mix_float)(float *dst, const float **src, const float *scale,
+                      int nb_src, ptrdiff_t len);
+    void (*mix_double)(double *dst, const double **src, const double *scale,
+                       int nb_src, ptrdiff_t len);
+} AudioMixDSPContext;
+
+void ff_amix_init_x86(AudioMixDSPContext *s);
+
+static void mix_float_c(float *dst, const float **src, const float *scale,
+                        int nb_src, ptrdiff_t len)
+{
+    int i;
+
+    for (ptrdiff_t start = 0; start < len; start += AMIX_BLOCK_SIZE) {
+        const ptrdiff_t end = FFMIN(start + AMIX_BLOCK_SIZE, len);
+
+        for (ptrdiff_t n = start; n < end; n++)
+            dst[n] = 0.f;
+
+        for (i = 0; i + 4 <= nb_src; i += 4) {
+            const float *s0 = src[i    ], *s1 = src[i + 1];
+            const float *s2 = src[i + 2], *s3 = src[i + 3];
+            const float m0 = scale[i    ], m1 = scale[i + 1];
+            const float m2 = scale[i + 2], m3 = scale[i + 3];
+
+            for (ptrdiff_t n = start; n < end; n++) {
+                float v = dst[n];
+
+                v += s0[n] * m0;
+                v += s1[n] * m1;
+                v += s2[n] * m2;
+                v += s3[n] * m3;
+                dst[n] = v;
+            }
+        }
+
+        for (; i < nb_src; i++) {
+            const float *s = src[i];
+            const float  m = scale[i];
+
+            for (ptrdiff_t n = start; n < end; n++)
+                dst[n] += s[n] * m;
+        }
+    }
+}
+
+static void mix_double_c(double *dst, const double **src, const double *scale,
+                         int nb_src, ptrdiff_t len)
+{
+    int i;
+
+    for (ptrdiff_t start = 0; start < len; start += AMIX_BLOCK_SIZE) {
+        const ptrdiff_t end = FFMIN(start + AMIX_BLOCK_SIZE, len);
+
+        for (ptrdiff_t n = start; n < end; n++)
+            dst[n] = 0.0;
+
+        for (i = 0; i + 4 <= nb_src; i += 4) {
+            const double *s0 = src[i    ], *s1 = src[i + 1];
+            const double *s2 = src[i + 2], *s3 = src[i + 3];
+            const double m0 = scale[i    ], m1 = scale[i + 1];
+            const double m2 = scale[i + 2], m3 = scale[i + 3];
+
+            for (ptrdiff_t n = start; n < end; n++) {
+                double v = dst[n];
+
+                v += s0[n] * m0;
+                v += s1[n] * m1;
+                v += s2[n] * m2;
+                v += s3[n] * m3;
+                dst[n] = v;
+            }
+        }
+
+        for (; i < nb_src; i++) {
+            const double *s = src[i];
+            const double  m = scale[i];
+
+            for (ptrdiff_t n = start; n < end; n++)
+                dst[n] += s[n] * m;
+        }
+    }
+}
+
+static av_unused void ff_amix_init(AudioMixDSPContext *dsp)
+{
+    dsp->mix_float  = mix_float_c;
+    dsp->mix_double = mix_double_c;
+
+#if ARCH_X86
+    ff_amix_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_AMIXDSP_H */
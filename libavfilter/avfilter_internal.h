@@ -142,6 +142,8 @@ typedef struct FFFilterGraph {
 
     unsigned disable_auto_convert;
 
+    int hugepages;
+
     void *thread;
     avfilter_execute_func *thread_execute;
     FFFrameQueueGlobal frame_queues;
@@ -56,6 +56,8 @@ static const AVOption filtergraph_options[] = {
         AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, F|V },
     {"aresample_swr_opts"   , "default aresample filter options"    , OFFSET(aresample_swr_opts)    ,
         AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, F|A },
+    { "hugepages", "back the default video frame pools with huge pages",
+        offsetof(FFFilterGraph, hugepages), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, F|V },
     { NULL },
 };
 
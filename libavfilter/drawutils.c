@@ -498,6 +498,107 @@ static void blend_pixel(uint8_t *dst, unsigned src, unsigned alpha,
     *dst = ((0x1010101 - alpha) * *dst + alpha * src) >> 24;
 }
 
+/**
+ * Sum the 8-bit mask values of a (1 << hsub) x hband block,
+ * like blend_pixel() does for any mask depth.
+ */
+static av_always_inline unsigned mask_block_sum(const uint8_t *mask, int mask_linesize,
+                                                unsigned hsub, int hband)
+{
+    unsigned t = 0;
+
+    for (int y = 0; y < hband; y++) {
+        for (int i = 0; i < 1 << hsub; i++)
+            t += mask[i];
+        mask += mask_linesize;
+    }
+    return t;
+}
+
+/* Same as blend_line_hv16() for 8-bit masks, with the per pixel function
+   call and bit extraction removed from the loop. */
+static void blend_line_hv16_mask8(uint8_t *dst, int dst_delta,
+                                  unsigned src, unsigned alpha,
+                                  const uint8_t *mask, int mask_linesize, int w,
+                                  unsigned hsub, unsigned vsub,
+                                  int xm, int left, int right, int hband)
+{
+    const unsigned shift = hsub + vsub;
+    const uint8_t *m;
+    int x;
+
+    if (left) {
+        blend_pixel16(dst, src, alpha, mask, mask_linesize, 3,
+                      left, hband, shift, xm);
+        dst += dst_delta;
+        xm += left;
+    }
+    m = mask + xm;
+    if (!shift) {
+        for (x = 0; x < w; x++) {
+            unsigned a = m[x] * alpha;
+            uint16_t value = AV_RL16(dst);
+            AV_WL16(dst, ((0x10001 - a) * value + a * src) >> 16);
+            dst += dst_delta;
+        }
+    } else {
+        for (x = 0; x < w; x++) {
+            unsigned a = (mask_block_sum(m + (x << hsub), mask_linesize, hsub, hband) >> shift) * alpha;
+            uint16_t value = AV_RL16(dst);
+            AV_WL16(dst, ((0x10001 - a) * value + a * src) >> 16);
+            dst += dst_delta;
+        }
+    }
+    xm += w << hsub;
+    if (right)
+        blend_pixel16(dst, src, alpha, mask, mask_linesize, 3,
+                      right, hband, shift, xm);
+}
+
+/* Same as blend_line_hv() for 8-bit masks. */
+static void blend_line_hv_mask8(uint8_t *dst, int dst_delta,
+                                unsigned src, unsigned alpha,
+                                const uint8_t *mask, int mask_linesize, int w,
+                                unsigned hsub, unsigned vsub,
+                                int xm, int left, int right, int hband)
+{
+    const unsigned shift = hsub + vsub;
+    const uint8_t *m;
+    int x;
+
+    if (left) {
+        blend_pixel(dst, src, alpha, mask, mask_linesize, 3,
+                    left, hband, shift, xm);
+        dst += dst_delta;
+        xm += left;
+    }
+    m = mask + xm;
+    if (!shift && dst_delta == 1) {
+        /* planar formats without subsampling: plain loop, vectorizable */
+        for (x = 0; x < w; x++) {
+            unsigned a = m[x] * alpha;
+            dst[x] = ((0x1010101 - a) * dst[x] + a * src) >> 24;
+        }
+        dst += w;
+    } else if (!shift) {
+        for (x = 0; x < w; x++) {
+            unsigned a = m[x] * alpha;
+            *dst = ((0x1010101 - a) * *dst + a * src) >> 24;
+            dst += dst_delta;
+        }
+    } else {
+        for (x = 0; x < w; x++) {
+            unsigned a = (mask_block_sum(m + (x << hsub), mask_linesize, hsub, hband) >> shift) * alpha;
+            *dst = ((0x1010101 - a) * *dst + a * src) >> 24;
+            dst += dst_delta;
+        }
+    }
+    xm += w << hsub;
+    if (right)
+        blend_pixel(dst, src, alpha, mask, mask_linesize, 3,
+                    right, hband, shift, xm);
+}
+
 static void blend_line_hv16(uint8_t *dst, int dst_delta,
                             unsigned src, unsigned alpha,
                             const uint8_t *mask, int mask_linesize, int l2depth, int w,
@@ -506,6 +607,11 @@ static void blend_line_hv16(uint8_t *dst, int dst_delta,
 {
     int x;
 
+    if (l2depth == 3) {
+        blend_line_hv16_mask8(dst, dst_delta, src, alpha, mask, mask_linesize,
+                              w, hsub, vsub, xm, left, right, hband);
+        return;
+    }
     if (left) {
         blend_pixel16(dst, src, alpha, mask, mask_linesize, l2depth,
                       left, hband, hsub + vsub, xm);
@@ -531,6 +637,11 @@ static void blend_line_hv(uint8_t *dst, int dst_delta,
 {
     int x;
 
+    if (l2depth == 3) {
+        blend_line_hv_mask8(dst, dst_delta, src, alpha, mask, mask_linesize,
+                            w, hsub, vsub, xm, left, right, hband);
+        return;
+    }
     if (left) {
         blend_pixel(dst, src, alpha, mask, mask_linesize, l2depth,
                     left, hband, hsub + vsub, xm);
@@ -190,6 +190,7 @@ typedef struct HarfbuzzData {
 /** Information about a single glyph in a text line */
 typedef struct GlyphInfo {
     uint32_t code;                  ///< the glyph code point
+    struct Glyph *glyph;            ///< the cached glyph for this code point
     int x;                          ///< the x position of the glyph
     int y;                          ///< the y position of the glyph
     int shift_x64;                  ///< the horizontal shift of the glyph in 26.6 units
@@ -327,6 +328,12 @@ typedef struct DrawTextContext {
     int tab_count;                  ///< the number of tab characters
     int blank_advance64;            ///< the size of the space character
     int tab_warning_printed;        ///< ensure the tab warning to be printed only once
+
+    char *layout_text;              ///< text of the cached lines
+    unsigned int layout_fontsize;   ///< font size of the cached lines
+    TextMetrics layout_metrics;     ///< metrics of the cached lines
+    int layout_positioned;          ///< the glyphs of the cached lines are positioned
+    int layout_x64, layout_y64;     ///< position of the cached lines (in 26.6 units)
 } DrawTextContext;
 
 #define OFFSET(x) offsetof(DrawTextContext, x)
@@ -1126,6 +1133,31 @@ static int glyph_enu_free(void *opaque, void *elem)
     return 0;
 }
 
+static void hb_destroy(HarfbuzzData *hb)
+{
+    hb_font_destroy(hb->font);
+    hb_buffer_destroy(hb->buf);
+    hb->buf = NULL;
+    hb->font = NULL;
+    hb->glyph_info = NULL;
+    hb->glyph_pos = NULL;
+}
+
+// Frees the cached text lines, so that the text is measured again
+static void free_layout(DrawTextContext *s)
+{
+    for (int l = 0; l < s->line_count; ++l) {
+        TextLine *line = &s->lines[l];
+        av_freep(&line->glyphs);
+        hb_destroy(&line->hb_data);
+    }
+    av_freep(&s->lines);
+    av_freep(&s->tab_clusters);
+    av_freep(&s->layout_text);
+    s->line_count = 0;
+    s->layout_positioned = 0;
+}
+
 static av_cold void uninit(AVFilterContext *ctx)
 {
     DrawTextContext *s = ctx->priv;
@@ -1137,6 +1169,8 @@ static av_cold void uninit(AVFilterContext *ctx)
 
     s->x_pexpr = s->y_pexpr = s->a_pexpr = s->fontsize_pexpr = NULL;
 
+    free_layout(s);
+
     av_tree_enumerate(s->glyphs, NULL, NULL, glyph_enu_free);
     av_tree_destroy(s->glyphs);
     s->glyphs = NULL;
@@ -1250,6 +1284,8 @@ static int command(AVFilterContext *ctx, const char *cmd, const char *arg, char
             old->fontsize_pexpr = NULL;
             old->blank_advance64 = 0;
         }
+        // The options may change the layout of the text
+        free_layout(old);
         return config_input(ctx->inputs[0]);
     }
 
@@ -1281,15 +1317,15 @@ static void update_alpha(DrawTextContext *s)
         s->alpha = 256 * alpha;
 }
 
-static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
-                       FFDrawColor *color,
-                       TextMetrics *metrics,
-                       int x, int y, int borderw)
+static void draw_glyphs(DrawTextContext *s, AVFrame *frame,
+                        FFDrawColor *color,
+                        TextMetrics *metrics,
+                        int x, int y, int borderw,
+                        int slice_start, int slice_end)
 {
     int g, l, x1, y1, w1, h1, idx;
     int dx = 0, dy = 0, pdx = 0;
     GlyphInfo *info;
-    Glyph dummy = { 0 }, *glyph;
     FT_Bitmap bitmap;
     FT_BitmapGlyph b_glyph;
     uint8_t j_left = 0, j_right = 0, j_top = 0, j_bottom = 0;
@@ -1307,11 +1343,6 @@ static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
         offset_y = s->box_height - metrics->height;
     }
 
-    if ((!j_left || j_right) && !s->tab_warning_printed && s->tab_count > 0) {
-        s->tab_warning_printed = 1;
-        av_log(s, AV_LOG_WARNING, "Tab characters are only supported with left horizontal alignment\n");
-    }
-
     clip_x = FFMIN(metrics->rect_x + s->box_width + s->bb_right, frame->width);
     clip_y = FFMIN(metrics->rect_y + s->box_height + s->bb_bottom, frame->height);
 
@@ -1320,15 +1351,8 @@ static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
         line_w = POS_CEIL(line->width64, 64);
         for (g = 0; g < line->hb_data.glyph_count; ++g) {
             info = &line->glyphs[g];
-            dummy.fontsize = s->fontsize;
-            dummy.code = info->code;
-            glyph = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
-            if (!glyph) {
-                return AVERROR(EINVAL);
-            }
-
             idx = get_subpixel_idx(info->shift_x64, info->shift_y64);
-            b_glyph = borderw ? glyph->border_bglyph[idx] : glyph->bglyph[idx];
+            b_glyph = borderw ? info->glyph->border_bglyph[idx] : info->glyph->bglyph[idx];
             bitmap = b_glyph->bitmap;
             x1 = x + info->x + b_glyph->left;
             y1 = y + info->y - b_glyph->top + offset_y;
@@ -1361,10 +1385,68 @@ static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
             w1 = FFMIN(clip_x - x1, w1 - dx);
             h1 = FFMIN(clip_y - y1, h1 - dy);
 
+            // Only draw the rows of the current slice
+            if (y1 < slice_start) {
+                pdx += (slice_start - y1) * bitmap.pitch;
+                h1  -= slice_start - y1;
+                y1   = slice_start;
+            }
+            h1 = FFMIN(h1, slice_end - y1);
+            if (h1 <= 0) {
+                continue;
+            }
+
             ff_blend_mask(&s->dc, color, frame->data, frame->linesize, clip_x, clip_y,
                 bitmap.buffer + pdx, bitmap.pitch, w1, h1, 3, 0, x1, y1);
         }
     }
+}
+
+typedef struct ThreadData {
+    AVFrame *frame;
+    TextMetrics *metrics;
+    FFDrawColor *fontcolor;
+    FFDrawColor *shadowcolor;
+    FFDrawColor *bordercolor;
+    FFDrawColor *boxcolor;
+    int rec_x, rec_y, rec_width, rec_height;
+    int y_start, y_end;             ///< rows covered by the text and its box
+} ThreadData;
+
+// Draws the box and the text in a band of rows, aligned on the chroma subsampling
+static int draw_text_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    DrawTextContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *frame = td->frame;
+    const int vsub = s->dc.vsub_max;
+    const int nb_rows = (td->y_end - td->y_start + (1 << vsub) - 1) >> vsub;
+    const int slice_start = td->y_start + ((nb_rows *  jobnr     ) / nb_jobs << vsub);
+    const int slice_end   = FFMIN(td->y_start + ((nb_rows * (jobnr + 1)) / nb_jobs << vsub),
+                                  td->y_end);
+
+    if (s->draw_box) {
+        int y0 = FFMAX(td->rec_y, slice_start);
+        int y1 = FFMIN(td->rec_y + td->rec_height, slice_end);
+
+        if (y1 > y0)
+            ff_blend_rectangle(&s->dc, td->boxcolor,
+                frame->data, frame->linesize, frame->width, frame->height,
+                td->rec_x, y0, td->rec_width, y1 - y0);
+    }
+
+    if (s->shadowx || s->shadowy) {
+        draw_glyphs(s, frame, td->shadowcolor, td->metrics,
+                    s->shadowx, s->shadowy, s->borderw, slice_start, slice_end);
+    }
+
+    if (s->borderw) {
+        draw_glyphs(s, frame, td->bordercolor, td->metrics,
+                    0, 0, s->borderw, slice_start, slice_end);
+    }
+
+    draw_glyphs(s, frame, td->fontcolor, td->metrics,
+                0, 0, 0, slice_start, slice_end);
 
     return 0;
 }
@@ -1392,16 +1474,6 @@ static int shape_text_hb(DrawTextContext *s, HarfbuzzData* hb, const char* text,
     return 0;
 }
 
-static void hb_destroy(HarfbuzzData *hb)
-{
-    hb_font_destroy(hb->font);
-    hb_buffer_destroy(hb->buf);
-    hb->buf = NULL;
-    hb->font = NULL;
-    hb->glyph_info = NULL;
-    hb->glyph_pos = NULL;
-}
-
 static int measure_text(AVFilterContext *ctx, TextMetrics *metrics)
 {
     DrawTextContext *s = ctx->priv;
@@ -1583,7 +1655,6 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
 
     int width = frame->width;
     int height = frame->height;
-    int rec_x = 0, rec_y = 0, rec_width = 0, rec_height = 0;
     int is_outside = 0;
     int last_tab_idx = 0;
 
@@ -1636,9 +1707,22 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         return ret;
     }
 
-    if ((ret = measure_text(ctx, &metrics)) < 0) {
-        return ret;
+    // Shape and measure the text again only if it changed
+    if (!s->layout_text || s->layout_fontsize != s->fontsize ||
+        strcmp(s->layout_text, s->expanded_text.str)) {
+        free_layout(s);
+        if ((ret = measure_text(ctx, &s->layout_metrics)) < 0) {
+            free_layout(s);
+            return ret;
+        }
+        s->layout_text = av_strdup(s->expanded_text.str);
+        if (!s->layout_text) {
+            free_layout(s);
+            return AVERROR(ENOMEM);
+        }
+        s->layout_fontsize = s->fontsize;
     }
+    metrics = s->layout_metrics;
 
     s->max_glyph_h = POS_CEIL(metrics.max_y64 - metrics.min_y64, 64);
     s->max_glyph_w = POS_CEIL(metrics.max_x64 - metrics.min_x64, 64);
@@ -1729,45 +1813,59 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         y64 = (int)(s->y * 64. + metrics.offset_top64);
     }
 
-    for (int l = 0; l < s->line_count; ++l) {
-        TextLine *line = &s->lines[l];
-        HarfbuzzData *hb = &line->hb_data;
-        line->glyphs = av_mallocz(hb->glyph_count * sizeof(GlyphInfo));
-
-        for (int t = 0; t < hb->glyph_count; ++t) {
-            GlyphInfo *g_info = &line->glyphs[t];
-            uint8_t is_tab = last_tab_idx < s->tab_count &&
-                hb->glyph_info[t].cluster == s->tab_clusters[last_tab_idx] - line->cluster_offset;
-            int true_x, true_y;
-            if (is_tab) {
-                ++last_tab_idx;
-            }
-            true_x = x + hb->glyph_pos[t].x_offset;
-            true_y = y + hb->glyph_pos[t].y_offset;
-            shift_x64 = (((x64 + true_x) >> 4) & 0b0011) << 4;
-            shift_y64 = ((4 - (((y64 + true_y) >> 4) & 0b0011)) & 0b0011) << 4;
+    // Position the glyphs again only if the text moved
+    if (!s->layout_positioned || x64 != s->layout_x64 || y64 != s->layout_y64) {
+        s->layout_positioned = 0;
+        for (int l = 0; l < s->line_count; ++l) {
+            TextLine *line = &s->lines[l];
+            HarfbuzzData *hb = &line->hb_data;
 
-            ret = load_glyph(ctx, &glyph, hb->glyph_info[t].codepoint, shift_x64, shift_y64);
-            if (ret != 0) {
-                return ret;
+            if (!line->glyphs) {
+                line->glyphs = av_mallocz(hb->glyph_count * sizeof(GlyphInfo));
+                if (!line->glyphs)
+                    return AVERROR(ENOMEM);
             }
-            g_info->code = hb->glyph_info[t].codepoint;
-            g_info->x = (x64 + true_x) >> 6;
-            g_info->y = ((y64 + true_y) >> 6) + (shift_y64 > 0 ? 1 : 0);
-            g_info->shift_x64 = shift_x64;
-            g_info->shift_y64 = shift_y64;
-
-            if (!is_tab) {
-                x += hb->glyph_pos[t].x_advance;
-            } else {
-                int size = s->blank_advance64 * s->tabsize;
-                x = (x / size + 1) * size;
+
+            for (int t = 0; t < hb->glyph_count; ++t) {
+                GlyphInfo *g_info = &line->glyphs[t];
+                uint8_t is_tab = last_tab_idx < s->tab_count &&
+                    hb->glyph_info[t].cluster == s->tab_clusters[last_tab_idx] - line->cluster_offset;
+                int true_x, true_y;
+                if (is_tab) {
+                    ++last_tab_idx;
+                }
+                true_x = x + hb->glyph_pos[t].x_offset;
+                true_y = y + hb->glyph_pos[t].y_offset;
+                shift_x64 = (((x64 + true_x) >> 4) & 0b0011) << 4;
+                shift_y64 = ((4 - (((y64 + true_y) >> 4) & 0b0011)) & 0b0011) << 4;
+
+                ret = load_glyph(ctx, &glyph, hb->glyph_info[t].codepoint, shift_x64, shift_y64);
+                if (ret != 0) {
+                    return ret;
+                }
+                g_info->code = hb->glyph_info[t].codepoint;
+                g_info->glyph = glyph;
+                g_info->x = (x64 + true_x) >> 6;
+                g_info->y = ((y64 + true_y) >> 6) + (shift_y64 > 0 ? 1 : 0);
+                g_info->shift_x64 = shift_x64;
+                g_info->shift_y64 = shift_y64;
+
+                if (!is_tab) {
+                    x += hb->glyph_pos[t].x_advance;
+                } else {
+                    int size = s->blank_advance64 * s->tabsize;
+                    x = (x / size + 1) * size;
+                }
+                y += hb->glyph_pos[t].y_advance;
             }
-            y += hb->glyph_pos[t].y_advance;
+
+            y += metrics.line_height64 + s->line_spacing * 64;
+            x = 0;
         }
 
-        y += metrics.line_height64 + s->line_spacing * 64;
-        x = 0;
+        s->layout_x64 = x64;
+        s->layout_y64 = y64;
+        s->layout_positioned = 1;
     }
 
     metrics.rect_x = s->x;
@@ -1797,45 +1895,34 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
                     metrics.rect_y + s->box_height + s->bb_bottom <= 0;
 
     if (!is_outside) {
-        /* draw box */
-        if (s->draw_box) {
-            rec_x = metrics.rect_x - s->bb_left;
-            rec_y = metrics.rect_y - s->bb_top;
-            rec_width = s->box_width + s->bb_right + s->bb_left;
-            rec_height = s->box_height + s->bb_bottom + s->bb_top;
-            ff_blend_rectangle(&s->dc, &boxcolor,
-                frame->data, frame->linesize, width, height,
-                rec_x, rec_y, rec_width, rec_height);
-        }
-
-        if (s->shadowx || s->shadowy) {
-            if ((ret = draw_glyphs(s, frame, &shadowcolor, &metrics,
-                    s->shadowx, s->shadowy, s->borderw)) < 0) {
-                return ret;
-            }
-        }
-
-        if (s->borderw) {
-            if ((ret = draw_glyphs(s, frame, &bordercolor, &metrics,
-                    0, 0, s->borderw)) < 0) {
-                return ret;
-            }
-        }
-
-        if ((ret = draw_glyphs(s, frame, &fontcolor, &metrics, 0,
-                0, 0)) < 0) {
-            return ret;
+        ThreadData td = {
+            .frame       = frame,
+            .metrics     = &metrics,
+            .fontcolor   = &fontcolor,
+            .shadowcolor = &shadowcolor,
+            .bordercolor = &bordercolor,
+            .boxcolor    = &boxcolor,
+            .rec_x       = metrics.rect_x - s->bb_left,
+            .rec_y       = metrics.rect_y - s->bb_top,
+            .rec_width   = s->box_width + s->bb_right + s->bb_left,
+            .rec_height  = s->box_height + s->bb_bottom + s->bb_top,
+        };
+        int nb_jobs;
+
+        if ((!(s->text_align & TA_LEFT) || (s->text_align & TA_RIGHT)) &&
+            !s->tab_warning_printed && s->tab_count > 0) {
+            s->tab_warning_printed = 1;
+            av_log(s, AV_LOG_WARNING, "Tab characters are only supported with left horizontal alignment\n");
         }
-    }
 
-    // FREE data structures
-    for (int l = 0; l < s->line_count; ++l) {
-        TextLine *line = &s->lines[l];
-        av_freep(&line->glyphs);
-        hb_destroy(&line->hb_data);
+        /* the box, shadow, border and glyphs are all clipped to the box area */
+        td.y_start = FFMAX(td.rec_y, 0) >> s->dc.vsub_max << s->dc.vsub_max;
+        td.y_end   = FFMIN(td.rec_y + td.rec_height, height);
+        nb_jobs = FFMIN(ff_filter_get_nb_threads(ctx),
+                        (td.y_end - td.y_start + (1 << s->dc.vsub_max) - 1) >> s->dc.vsub_max);
+        if (nb_jobs > 0)
+            ff_filter_execute(ctx, draw_text_slice, &td, NULL, nb_jobs);
     }
-    av_freep(&s->lines);
-    av_freep(&s->tab_clusters);
 
     return 0;
 }
@@ -1923,7 +2010,7 @@ const FFFilter ff_vf_drawtext = {
     .p.name        = "drawtext",
     .p.description = NULL_IF_CONFIG_SMALL("Draw text on top of video frames using libfreetype library."),
     .p.priv_class  = &drawtext_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
     .priv_size     = sizeof(DrawTextContext),
     .init          = init,
     .uninit        = uninit,
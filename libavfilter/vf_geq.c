@@ -39,6 +39,7 @@
 
 #define MAX_NB_THREADS 32
 #define NB_PLANES 4
+#define ROW_BATCH 256
 
 enum InterpolationMethods {
     INTERP_NEAREST,
@@ -407,7 +408,10 @@ static int slice_geq_filter(AVFilterContext *ctx, void *arg, int jobnr, int nb_j
     const int linesize = td->linesize;
     const int slice_start = (height *  jobnr) / nb_jobs;
     const int slice_end = (height * (jobnr+1)) / nb_jobs;
-    int x, y;
+    AVExpr *e = geq->e[plane][jobnr];
+    double xs[ROW_BATCH], res[ROW_BATCH];
+    const double *arrays[VAR_VARS_NB] = { [VAR_X] = xs };
+    int x, y, ret;
 
     double values[VAR_VARS_NB];
     values[VAR_W] = geq->values[VAR_W];
@@ -417,36 +421,32 @@ static int slice_geq_filter(AVFilterContext *ctx, void *arg, int jobnr, int nb_j
     values[VAR_SH] = geq->values[VAR_SH];
     values[VAR_T] = geq->values[VAR_T];
 
-    if (geq->bps == 8) {
-        uint8_t *ptr = geq->dst + linesize * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
+    /* evaluate the rows in runs of up to ROW_BATCH pixels */
+    for (y = slice_start; y < slice_end; y++) {
+        values[VAR_Y] = y;
 
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
-            }
-            ptr += linesize;
-        }
-    } else if (geq->bps <= 16) {
-        uint16_t *ptr16 = geq->dst16 + (linesize/2) * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr16[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
-            }
-            ptr16 += linesize/2;
-        }
-    } else {
-        float *ptr32 = geq->dst32 + (linesize/4) * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr32[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
+        for (x = 0; x < width; x += ROW_BATCH) {
+            const int n = FFMIN(width - x, ROW_BATCH);
+
+            for (int i = 0; i < n; i++)
+                xs[i] = x + i;
+            ret = av_expr_eval_batch(e, res, n, values, arrays, geq);
+            if (ret < 0)
+                return ret;
+
+            if (geq->bps == 8) {
+                uint8_t *ptr = geq->dst + linesize * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr[i] = res[i];
+            } else if (geq->bps <= 16) {
+                uint16_t *ptr16 = geq->dst16 + (linesize/2) * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr16[i] = res[i];
+            } else {
+                float *ptr32 = geq->dst32 + (linesize/4) * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr32[i] = res[i];
             }
-            ptr32 += linesize/4;
         }
     }
 
@@ -0,0 +1,810 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Video quality control analysis: black, freeze, scene change and crop
+ * detection and signal statistics computed in a single pass.
+ *
+ * The metadata and the detection logic are the ones of the blackdetect,
+ * freezedetect, scdet, cropdetect (black mode) and signalstats filters,
+ * but every frame is only read once, in slices: the SAD with the previous
+ * frame is shared by the scene change and freeze detection and the
+ * signalstats differences, and the luma histogram provides both the
+ * statistics and the number of black pixels.
+ */
+
+#include <float.h>
+
+#include "libavutil/imgutils.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/timestamp.h"
+
+#include "avfilter.h"
+#include "filters.h"
+#include "formats.h"
+#include "scene_sad.h"
+#include "video.h"
+
+enum QCDetectors {
+    DETECT_BLACK  = 1 << 0,
+    DETECT_FREEZE = 1 << 1,
+    DETECT_SCENE  = 1 << 2,
+    DETECT_CROP   = 1 << 3,
+    DETECT_STATS  = 1 << 4,
+};
+
+typedef struct QCSlice {
+    uint64_t sad[3];        ///< SAD with the previous frame
+    uint64_t sad_last[3];   ///< part of sad[] from the last row of odd height chroma planes
+    uint64_t sad_ref[3];    ///< SAD with the freeze reference frame, if not the previous frame
+    unsigned *hist[4];      ///< Y, U, V and saturation histograms
+    unsigned histhue[360];
+    int64_t *colsum;        ///< sums of the luma columns of the slice
+} QCSlice;
+
+typedef struct QCDetectContext {
+    const AVClass *class;
+
+    int detect;
+
+    /* blackdetect */
+    double black_min_duration_time;
+    int64_t black_min_duration;
+    int64_t black_start;
+    int64_t black_end;
+    int black_started;
+    double picture_black_ratio_th;
+    double pixel_black_th;
+
+    /* freezedetect */
+    double noise;
+    int64_t freeze_duration;
+    AVFrame *reference_frame;
+    int reference_is_prev;
+    int64_t n;
+    int64_t reference_n;
+    int frozen;
+
+    /* scdet */
+    double sc_threshold;
+    double prev_mafd;
+
+    /* cropdetect */
+    float limit;
+    int round;
+    int reset_count;
+    int skip;
+    int max_outliers;
+    int frame_nb;
+    int x1, y1, x2, y2;
+    int *row_avg, *col_avg;
+    int64_t *rowsum;
+
+    int depth;
+    int hsub, vsub;
+    int maxsize;
+    int width[3];           ///< width of the planes
+    int height[3];          ///< height of the planes
+    int sad_height[3];      ///< height of the planes for freezedetect and scdet
+    AVRational time_base;
+    int64_t last_pts;
+    ff_scene_sad_fn sad;
+    AVFrame *prev_frame;
+
+    int nb_jobs;
+    QCSlice *slices;
+    unsigned *hist[4];
+    unsigned histhue[360];
+    uint8_t  *sat_lut;      ///< saturation of 8-bit (u, v) pairs
+    uint16_t *hue_lut;      ///< hue of 8-bit (u, v) pairs
+} QCDetectContext;
+
+typedef struct ThreadData {
+    const AVFrame *in, *prev, *ref;
+} ThreadData;
+
+#define OFFSET(x) offsetof(QCDetectContext, x)
+#define FLAGS AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_FILTERING_PARAM
+
+static const AVOption qcdetect_options[] = {
+    { "detect", "set the analyses to perform", OFFSET(detect), AV_OPT_TYPE_FLAGS, {.i64=DETECT_BLACK|DETECT_FREEZE|DETECT_SCENE|DETECT_CROP|DETECT_STATS}, 0, INT_MAX, FLAGS, .unit = "detect" },
+        { "black",  "detect black intervals",         0, AV_OPT_TYPE_CONST, {.i64=DETECT_BLACK},  0, 0, FLAGS, .unit = "detect" },
+        { "freeze", "detect frozen video",            0, AV_OPT_TYPE_CONST, {.i64=DETECT_FREEZE}, 0, 0, FLAGS, .unit = "detect" },
+        { "scene",  "detect scene changes",           0, AV_OPT_TYPE_CONST, {.i64=DETECT_SCENE},  0, 0, FLAGS, .unit = "detect" },
+        { "crop",   "detect black borders",           0, AV_OPT_TYPE_CONST, {.i64=DETECT_CROP},   0, 0, FLAGS, .unit = "detect" },
+        { "stats",  "compute the signalstats values", 0, AV_OPT_TYPE_CONST, {.i64=DETECT_STATS},  0, 0, FLAGS, .unit = "detect" },
+    { "black_min_duration", "set minimum detected black duration in seconds", OFFSET(black_min_duration_time), AV_OPT_TYPE_DOUBLE, {.dbl=2}, 0, DBL_MAX, FLAGS },
+    { "pic_th",   "set the picture black ratio threshold",  OFFSET(picture_black_ratio_th), AV_OPT_TYPE_DOUBLE, {.dbl=.98}, 0, 1, FLAGS },
+    { "pix_th",   "set the pixel black threshold",          OFFSET(pixel_black_th),         AV_OPT_TYPE_DOUBLE, {.dbl=.10}, 0, 1, FLAGS },
+    { "freeze_noise",    "set freeze noise tolerance",      OFFSET(noise),           AV_OPT_TYPE_DOUBLE,   {.dbl=0.001},   0, 1.0,       FLAGS },
+    { "freeze_duration", "set minimum freeze duration",     OFFSET(freeze_duration), AV_OPT_TYPE_DURATION, {.i64=2000000}, 0, INT64_MAX, FLAGS },
+    { "sc_threshold",    "set scene change detect threshold", OFFSET(sc_threshold),  AV_OPT_TYPE_DOUBLE,   {.dbl=10.},     0, 100.,      FLAGS },
+    { "crop_limit",  "set the crop black threshold",        OFFSET(limit),        AV_OPT_TYPE_FLOAT, {.dbl=24.0/255}, 0, 65535,   FLAGS },
+    { "crop_round",  "set the value the crop width/height should be divisible by", OFFSET(round), AV_OPT_TYPE_INT, {.i64=16}, 0, INT_MAX, FLAGS },
+    { "crop_reset",  "recalculate the crop area after this many frames", OFFSET(reset_count), AV_OPT_TYPE_INT, {.i64=0}, 0, INT_MAX, FLAGS },
+    { "crop_skip",   "set the number of initial frames to skip for crop detection", OFFSET(skip), AV_OPT_TYPE_INT, {.i64=2}, 0, INT_MAX, FLAGS },
+    { "crop_max_outliers", "set the threshold count of outliers", OFFSET(max_outliers), AV_OPT_TYPE_INT, {.i64=0}, 0, INT_MAX, FLAGS },
+    { NULL }
+};
+
+AVFILTER_DEFINE_CLASS(qcdetect);
+
+static const enum AVPixelFormat yuvj_formats[] = {
+    AV_PIX_FMT_YUVJ411P, AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_YUVJ422P,
+    AV_PIX_FMT_YUVJ444P, AV_PIX_FMT_YUVJ440P,
+    AV_PIX_FMT_NONE
+};
+
+static const enum AVPixelFormat pix_fmts[] = {
+    AV_PIX_FMT_YUV444P, AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV411P,
+    AV_PIX_FMT_YUV440P,
+    AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_YUVJ444P, AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_YUVJ411P,
+    AV_PIX_FMT_YUVJ440P,
+    AV_PIX_FMT_YUV444P9, AV_PIX_FMT_YUV422P9, AV_PIX_FMT_YUV420P9,
+    AV_PIX_FMT_YUV444P10, AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV420P10,
+    AV_PIX_FMT_YUV440P10,
+    AV_PIX_FMT_YUV444P12, AV_PIX_FMT_YUV422P12, AV_PIX_FMT_YUV420P12,
+    AV_PIX_FMT_YUV440P12,
+    AV_PIX_FMT_YUV444P14, AV_PIX_FMT_YUV422P14, AV_PIX_FMT_YUV420P14,
+    AV_PIX_FMT_YUV444P16, AV_PIX_FMT_YUV422P16, AV_PIX_FMT_YUV420P16,
+    AV_PIX_FMT_NONE
+};
+
+static av_cold int init(AVFilterContext *ctx)
+{
+    QCDetectContext *s = ctx->priv;
+
+    s->frame_nb = -1 * s->skip;
+    s->last_pts = AV_NOPTS_VALUE;
+    return 0;
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
+    QCDetectContext *s = ctx->priv;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
+
+    s->depth   = desc->comp[0].depth;
+    s->hsub    = desc->log2_chroma_w;
+    s->vsub    = desc->log2_chroma_h;
+    s->maxsize = 1 << s->depth;
+    s->time_base = inlink->time_base;
+    s->black_min_duration = s->black_min_duration_time / av_q2d(s->time_base);
+
+    s->width[0]  = inlink->w;
+    s->height[0] = s->sad_height[0] = inlink->h;
+    s->width[1]  = s->width[2]  = AV_CEIL_RSHIFT(inlink->w, s->hsub);
+    s->height[1] = s->height[2] = AV_CEIL_RSHIFT(inlink->h, s->vsub);
+    /* freezedetect and scdet ignore the last row of odd height chroma planes */
+    s->sad_height[1] = s->sad_height[2] = inlink->h >> s->vsub;
+
+    s->x1 = inlink->w - 1;
+    s->y1 = inlink->h - 1;
+    s->x2 = 0;
+    s->y2 = 0;
+
+    s->sad = ff_scene_sad_get_fn(s->depth == 8 ? 8 : 16);
+    if (!s->sad)
+        return AVERROR(EINVAL);
+
+    s->nb_jobs = FFMAX(1, FFMIN(inlink->h, ff_filter_get_nb_threads(ctx)));
+    s->slices  = av_calloc(s->nb_jobs, sizeof(*s->slices));
+    s->rowsum  = av_calloc(inlink->h, sizeof(*s->rowsum));
+    s->row_avg = av_calloc(inlink->h, sizeof(*s->row_avg));
+    s->col_avg = av_calloc(inlink->w, sizeof(*s->col_avg));
+    s->hist[0] = av_calloc(4 * s->maxsize, sizeof(*s->hist[0]));
+    if (!s->slices || !s->rowsum || !s->row_avg || !s->col_avg || !s->hist[0])
+        return AVERROR(ENOMEM);
+    for (int i = 1; i < 4; i++)
+        s->hist[i] = s->hist[0] + i * s->maxsize;
+
+    if (s->depth == 8 && (s->detect & DETECT_STATS)) {
+        /* same computations as signalstats, for all the (u, v) pairs */
+        s->sat_lut = av_malloc(256 * 256 * sizeof(*s->sat_lut));
+        s->hue_lut = av_malloc(256 * 256 * sizeof(*s->hue_lut));
+        if (!s->sat_lut || !s->hue_lut)
+            return AVERROR(ENOMEM);
+        for (int u = 0; u < 256; u++) {
+            for (int v = 0; v < 256; v++) {
+                s->sat_lut[u << 8 | v] = (uint8_t)hypotf(u - 128, v - 128);
+                s->hue_lut[u << 8 | v] = (int16_t)fmodf(floorf((180.f / M_PI) * atan2f(u - 128, v - 128) + 180.f), 360.f);
+            }
+        }
+    }
+
+    for (int j = 0; j < s->nb_jobs; j++) {
+        QCSlice *sl = &s->slices[j];
+
+        sl->hist[0] = av_calloc(4 * s->maxsize, sizeof(*sl->hist[0]));
+        sl->colsum  = av_calloc(inlink->w, sizeof(*sl->colsum));
+        if (!sl->hist[0] || !sl->colsum)
+            return AVERROR(ENOMEM);
+        for (int i = 1; i < 4; i++)
+            sl->hist[i] = sl->hist[0] + i * s->maxsize;
+    }
+
+    return 0;
+}
+
+#define DEFINE_ANALYZE_LUMA(name, type)                                         \
+static void analyze_luma_##name(QCDetectContext *s, QCSlice *sl,                \
+                                const AVFrame *in, int start, int end)          \
+{                                                                               \
+    const int linesize = in->linesize[0] / sizeof(type);                        \
+    const type *src = (const type *)in->data[0] + start * linesize;             \
+    const int w = s->width[0];                                                  \
+    unsigned *hist = sl->hist[0];                                               \
+    int64_t *colsum = sl->colsum;                                               \
+                                                                                \
+    if (s->detect & DETECT_CROP) {                                              \
+        for (int y = start; y < end; y++) {                                     \
+            int64_t sum = 0;                                                    \
+                                                                                \
+            for (int x = 0; x < w; x++) {                                       \
+                const int v = src[x];                                           \
+                                                                                \
+                hist[v]++;                                                      \
+                sum       += v;                                                 \
+                colsum[x] += v;                                                 \
+            }                                                                   \
+            s->rowsum[y] = sum;                                                 \
+            src += linesize;                                                    \
+        }                                                                       \
+    } else {                                                                    \
+        for (int y = start; y < end; y++) {                                     \
+            for (int x = 0; x < w; x++)                                         \
+                hist[src[x]]++;                                                 \
+            src += linesize;                                                    \
+        }                                                                       \
+    }                                                                           \
+}
+
+DEFINE_ANALYZE_LUMA(8,  uint8_t)
+DEFINE_ANALYZE_LUMA(16, uint16_t)
+
+static void analyze_chroma_8(QCDetectContext *s, QCSlice *sl,
+                             const AVFrame *in, int start, int end)
+{
+    const int lsz_u = in->linesize[1];
+    const int lsz_v = in->linesize[2];
+    const uint8_t *p_u = in->data[1] + start * lsz_u;
+    const uint8_t *p_v = in->data[2] + start * lsz_v;
+    const int w = s->width[1];
+    unsigned *histu = sl->hist[1], *histv = sl->hist[2], *histsat = sl->hist[3];
+
+    for (int y = start; y < end; y++) {
+        for (int x = 0; x < w; x++) {
+            const int yuvu = p_u[x];
+            const int yuvv = p_v[x];
+            const int uv   = yuvu << 8 | yuvv;
+
+            histu[yuvu]++;
+            histv[yuvv]++;
+            histsat[s->sat_lut[uv]]++;
+            sl->histhue[s->hue_lut[uv]]++;
+        }
+        p_u += lsz_u;
+        p_v += lsz_v;
+    }
+}
+
+static void analyze_chroma_16(QCDetectContext *s, QCSlice *sl,
+                              const AVFrame *in, int start, int end)
+{
+    const int lsz_u = in->linesize[1] / 2;
+    const int lsz_v = in->linesize[2] / 2;
+    const uint16_t *p_u = (const uint16_t *)in->data[1] + start * lsz_u;
+    const uint16_t *p_v = (const uint16_t *)in->data[2] + start * lsz_v;
+    const int mid = 1 << (s->depth - 1);
+    const int w = s->width[1];
+    unsigned *histu = sl->hist[1], *histv = sl->hist[2], *histsat = sl->hist[3];
+
+    for (int y = start; y < end; y++) {
+        for (int x = 0; x < w; x++) {
+            const int yuvu = p_u[x];
+            const int yuvv = p_v[x];
+            const uint16_t sat = hypotf(yuvu - mid, yuvv - mid);
+            const int16_t  hue = fmodf(floorf((180.f / M_PI) * atan2f(yuvu - mid, yuvv - mid) + 180.f), 360.f);
+
+            histu[yuvu]++;
+            histv[yuvv]++;
+            histsat[sat]++;
+            sl->histhue[hue]++;
+        }
+        p_u += lsz_u;
+        p_v += lsz_v;
+    }
+}
+
+static void plane_sad(QCDetectContext *s, const AVFrame *a, const AVFrame *b,
+                      int plane, int start, int end, uint64_t *sad, uint64_t *sad_last)
+{
+    const int last = s->sad_height[plane];
+    const int n = FFMIN(end, last) - start;
+    const uint8_t *pa = a->data[plane], *pb = b->data[plane];
+    const ptrdiff_t la = a->linesize[plane], lb = b->linesize[plane];
+
+    *sad = 0;
+    if (n > 0)
+        s->sad(pa + start * la, la, pb + start * lb, lb, s->width[plane], n, sad);
+    if (sad_last && end > last) {
+        *sad_last = 0;
+        s->sad(pa + last * la, la, pb + last * lb, lb, s->width[plane], 1, sad_last);
+    }
+}
+
+static int analyze_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    QCDetectContext *s = ctx->priv;
+    ThreadData *td = arg;
+    QCSlice *sl = &s->slices[jobnr];
+    const int hbd = s->depth > 8;
+    const int need_hist = s->detect & (DETECT_BLACK | DETECT_CROP | DETECT_STATS);
+
+    if (need_hist)
+        memset(sl->hist[0], 0, (s->detect & DETECT_STATS ? 4 : 1) *
+                               s->maxsize * sizeof(*sl->hist[0]));
+    if (s->detect & DETECT_CROP)
+        memset(sl->colsum, 0, s->width[0] * sizeof(*sl->colsum));
+    memset(sl->histhue, 0, sizeof(sl->histhue));
+
+    for (int p = 0; p < 3; p++) {
+        const int start = (s->height[p] *  jobnr   ) / nb_jobs;
+        const int end   = (s->height[p] * (jobnr+1)) / nb_jobs;
+
+        sl->sad[p] = sl->sad_last[p] = sl->sad_ref[p] = 0;
+        if (start >= end)
+            continue;
+
+        if (td->prev)
+            plane_sad(s, td->prev, td->in, p, start, end, &sl->sad[p], &sl->sad_last[p]);
+        if (td->ref)
+            plane_sad(s, td->ref, td->in, p, start, end, &sl->sad_ref[p], NULL);
+
+        if (p == 0 && need_hist) {
+            if (hbd)
+                analyze_luma_16(s, sl, td->in, start, end);
+            else
+                analyze_luma_8(s, sl, td->in, start, end);
+        } else if (p == 1 && (s->detect & DETECT_STATS)) {
+            if (hbd)
+                analyze_chroma_16(s, sl, td->in, start, end);
+            else
+                analyze_chroma_8(s, sl, td->in, start, end);
+        }
+    }
+
+    return 0;
+}
+
+static void check_black_end(AVFilterContext *ctx)
+{
+    QCDetectContext *s = ctx->priv;
+
+    if ((s->black_end - s->black_start) >= s->black_min_duration) {
+        av_log(ctx, AV_LOG_INFO,
+               "black_start:%s black_end:%s black_duration:%s\n",
+               av_ts2timestr(s->black_start, &s->time_base),
+               av_ts2timestr(s->black_end,   &s->time_base),
+               av_ts2timestr(s->black_end - s->black_start, &s->time_base));
+    }
+}
+
+static void detect_black(AVFilterContext *ctx, AVFrame *frame)
+{
+    QCDetectContext *s = ctx->priv;
+    const int max = (1 << s->depth) - 1;
+    const int factor = (1 << (s->depth - 8));
+    const int full = frame->color_range == AVCOL_RANGE_JPEG ||
+                     ff_fmt_is_in(frame->format, yuvj_formats);
+    const unsigned threshold = full ? s->pixel_black_th * max :
+        16 * factor + s->pixel_black_th * (235 - 16) * factor;
+    uint64_t nb_black_pixels = 0;
+    double picture_black_ratio;
+
+    for (int j = 0; j < s->nb_jobs; j++)
+        for (unsigned v = 0; v <= FFMIN(threshold, s->maxsize - 1); v++)
+            nb_black_pixels += s->slices[j].hist[0][v];
+
+    picture_black_ratio = (double)nb_black_pixels / (s->width[0] * s->height[0]);
+
+    if (picture_black_ratio >= s->picture_black_ratio_th) {
+        if (!s->black_started) {
+            s->black_started = 1;
+            s->black_start = frame->pts;
+            av_dict_set(&frame->metadata, "lavfi.black_start",
+                        av_ts2timestr(s->black_start, &s->time_base), 0);
+        }
+    } else if (s->black_started) {
+        s->black_started = 0;
+        s->black_end = frame->pts;
+        check_black_end(ctx);
+        av_dict_set(&frame->metadata, "lavfi.black_end",
+                    av_ts2timestr(s->black_end, &s->time_base), 0);
+    }
+}
+
+static int set_freeze_meta(AVFilterContext *ctx, AVFrame *frame, const char *key, const char *value)
+{
+    av_log(ctx, AV_LOG_INFO, "%s: %s\n", key, value);
+    return av_dict_set(&frame->metadata, key, value, 0);
+}
+
+static int detect_freeze(AVFilterContext *ctx, AVFrame *frame, const uint64_t *sad)
+{
+    QCDetectContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    FilterLink *l = ff_filter_link(inlink);
+    int frozen = 0;
+
+    s->n++;
+
+    if (s->reference_frame) {
+        const AVFrame *ref = s->reference_frame;
+        uint64_t total = 0, count = 0;
+        int64_t duration;
+        double mafd;
+
+        if (ref->pts == AV_NOPTS_VALUE || frame->pts == AV_NOPTS_VALUE || frame->pts < ref->pts)
+            duration = l->frame_rate.num > 0 ? av_rescale_q(s->n - s->reference_n, av_inv_q(l->frame_rate), AV_TIME_BASE_Q) : 0;
+        else
+            duration = av_rescale_q(frame->pts - ref->pts, inlink->time_base, AV_TIME_BASE_Q);
+
+        for (int p = 0; p < 3; p++) {
+            total += sad[p];
+            count += (uint64_t)s->width[p] * s->sad_height[p];
+        }
+        mafd = (double)total / count / (1ULL << s->depth);
+        frozen = mafd <= s->noise;
+
+        if (duration >= s->freeze_duration) {
+            if (!s->frozen)
+                set_freeze_meta(ctx, frame, "lavfi.freezedetect.freeze_start", av_ts2timestr(ref->pts, &inlink->time_base));
+            if (!frozen) {
+                set_freeze_meta(ctx, frame, "lavfi.freezedetect.freeze_duration", av_ts2timestr(duration, &AV_TIME_BASE_Q));
+                set_freeze_meta(ctx, frame, "lavfi.freezedetect.freeze_end", av_ts2timestr(frame->pts, &inlink->time_base));
+            }
+            s->frozen = frozen;
+        }
+    }
+
+    if (!frozen) {
+        av_frame_free(&s->reference_frame);
+        s->reference_frame = av_frame_clone(frame);
+        s->reference_n = s->n;
+        if (!s->reference_frame)
+            return AVERROR(ENOMEM);
+    }
+    s->reference_is_prev = !frozen;
+    return 0;
+}
+
+static void detect_scene(AVFilterContext *ctx, AVFrame *frame, const uint64_t *sad, int has_prev)
+{
+    QCDetectContext *s = ctx->priv;
+    double score = 0;
+    char buf[64];
+
+    if (has_prev) {
+        const double mafd = (double)sad[0] * 100. / ((uint64_t)s->width[0] * s->height[0]) / (1ULL << s->depth);
+        const double diff = fabs(mafd - s->prev_mafd);
+
+        score = av_clipf(FFMIN(mafd, diff), 0, 100.);
+        s->prev_mafd = mafd;
+    }
+
+    snprintf(buf, sizeof(buf), "%0.3f", s->prev_mafd);
+    av_dict_set(&frame->metadata, "lavfi.scd.mafd", buf, 0);
+    snprintf(buf, sizeof(buf), "%0.3f", score);
+    av_dict_set(&frame->metadata, "lavfi.scd.score", buf, 0);
+
+    if (score >= s->sc_threshold) {
+        av_log(ctx, AV_LOG_INFO, "lavfi.scd.score: %.3f, lavfi.scd.time: %s\n",
+               score, av_ts2timestr(frame->pts, &s->time_base));
+        av_dict_set(&frame->metadata, "lavfi.scd.time",
+                    av_ts2timestr(frame->pts, &s->time_base), 0);
+    }
+}
+
+static void detect_crop(AVFilterContext *ctx, AVFrame *frame)
+{
+    QCDetectContext *s = ctx->priv;
+    const float limit = s->limit < 1.0 ? s->limit * ((1 << s->depth) - 1) : s->limit;
+    AVDictionary **metadata = &frame->metadata;
+    int w, h, x, y, shrink_by, outliers, last_y;
+    char limit_str[22];
+
+    if (++s->frame_nb <= 0)
+        return;
+
+    if (s->reset_count > 0 && s->frame_nb > s->reset_count) {
+        s->x1 = frame->width  - 1;
+        s->y1 = frame->height - 1;
+        s->x2 = 0;
+        s->y2 = 0;
+        s->frame_nb = 1;
+    }
+
+    /* same as cropdetect, with the averages of the lines precomputed */
+    for (y = 0; y < frame->height; y++)
+        s->row_avg[y] = s->rowsum[y] / frame->width;
+    for (x = 0; x < frame->width; x++) {
+        int64_t sum = 0;
+        for (int j = 0; j < s->nb_jobs; j++)
+            sum += s->slices[j].colsum[x];
+        s->col_avg[x] = sum / frame->height;
+    }
+
+#define FIND(DST, FROM, NOEND, INC, AVG)                        \
+    outliers = 0;                                               \
+    for (last_y = y = FROM; NOEND; y = y INC) {                 \
+        if (AVG[y] > limit) {                                   \
+            if (++outliers > s->max_outliers) {                 \
+                DST = last_y;                                   \
+                break;                                          \
+            }                                                   \
+        } else                                                  \
+            last_y = y INC;                                     \
+    }
+
+    FIND(s->y1,                 0,               y < s->y1, +1, s->row_avg);
+    FIND(s->y2, frame->height - 1, y > FFMAX(s->y2, s->y1), -1, s->row_avg);
+    FIND(s->x1,                 0,               y < s->x1, +1, s->col_avg);
+    FIND(s->x2,  frame->width - 1, y > FFMAX(s->x2, s->x1), -1, s->col_avg);
+
+    x = (s->x1+1) & ~1;
+    y = (s->y1+1) & ~1;
+
+    w = s->x2 - x + 1;
+    h = s->y2 - y + 1;
+
+    if (s->round <= 1)
+        s->round = 16;
+    if (s->round % 2)
+        s->round *= 2;
+
+    shrink_by = w % s->round;
+    w -= shrink_by;
+    x += (shrink_by/2 + 1) & ~1;
+
+    shrink_by = h % s->round;
+    h -= shrink_by;
+    y += (shrink_by/2 + 1) & ~1;
+
+    av_dict_set_int(metadata, "lavfi.cropdetect.x1", s->x1, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.x2", s->x2, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.y1", s->y1, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.y2", s->y2, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.w",  w, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.h",  h, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.x",  x, 0);
+    av_dict_set_int(metadata, "lavfi.cropdetect.y",  y, 0);
+
+    snprintf(limit_str, sizeof(limit_str), "%f", s->limit);
+    av_dict_set(metadata, "lavfi.cropdetect.limit", limit_str, 0);
+
+    av_log(ctx, AV_LOG_INFO,
+           "x1:%d x2:%d y1:%d y2:%d w:%d h:%d x:%d y:%d pts:%"PRId64" t:%f limit:%f crop=%d:%d:%d:%d\n",
+           s->x1, s->x2, s->y1, s->y2, w, h, x, y, frame->pts,
+           frame->pts == AV_NOPTS_VALUE ? -1 : frame->pts * av_q2d(s->time_base),
+           s->limit, w, h, x, y);
+}
+
+static void compute_stats(AVFilterContext *ctx, AVFrame *frame,
+                          const uint64_t *sad, const uint64_t *sad_last)
+{
+    QCDetectContext *s = ctx->priv;
+    const int fs  = s->width[0] * s->height[0];
+    const int cfs = s->width[1] * s->height[1];
+    unsigned **hist = s->hist, *histhue = s->histhue;
+    int min[4], max[4], low[4], high[4];
+    int64_t tot[4] = { 0 }, tothue = 0;
+    unsigned acc[4] = { 0 }, acchue = 0, mask[3] = { 0 };
+    int medhue, maxhue;
+    char metabuf[128];
+
+    memset(hist[0], 0, 4 * s->maxsize * sizeof(*hist[0]));
+    memset(histhue, 0, sizeof(s->histhue));
+    for (int j = 0; j < s->nb_jobs; j++) {
+        const QCSlice *sl = &s->slices[j];
+
+        for (int i = 0; i < 4 * s->maxsize; i++)
+            hist[0][i] += sl->hist[0][i];
+        for (int i = 0; i < 360; i++)
+            histhue[i] += sl->histhue[i];
+    }
+
+    for (int c = 0; c < 4; c++) {
+        const int size = c ? cfs : fs;
+        const int lowp  = lrint(size * 10 / 100.);
+        const int highp = lrint(size * 90 / 100.);
+
+        min[c] = max[c] = low[c] = high[c] = -1;
+        for (int v = 0; v < s->maxsize; v++) {
+            if (min[c] < 0 && hist[c][v]) min[c] = v;
+            if (hist[c][v])               max[c] = v;
+            if (c < 3 && hist[c][v])      mask[c] |= v;
+
+            tot[c] += (uint64_t)hist[c][v] * v;
+            acc[c] += hist[c][v];
+
+            if (low[c]  == -1 && acc[c] >=  lowp) low[c]  = v;
+            if (high[c] == -1 && acc[c] >= highp) high[c] = v;
+        }
+    }
+
+    maxhue = histhue[0];
+    medhue = -1;
+    for (int v = 0; v < 360; v++) {
+        tothue += (uint64_t)histhue[v] * v;
+        acchue += histhue[v];
+
+        if (medhue == -1 && acchue > cfs / 2)
+            medhue = v;
+        if (histhue[v] > maxhue)
+            maxhue = histhue[v];
+    }
+
+#define SET_META(key, fmt, val) do {                                        \
+    snprintf(metabuf, sizeof(metabuf), fmt, val);                           \
+    av_dict_set(&frame->metadata, "lavfi.signalstats." key, metabuf, 0);    \
+} while (0)
+#define SET_META_INT(key, val) \
+    av_dict_set_int(&frame->metadata, "lavfi.signalstats." key, val, 0)
+
+    SET_META_INT("YMIN",  min[0]);
+    SET_META_INT("YLOW",  low[0]);
+    SET_META("YAVG", "%g", 1.0 * tot[0] / fs);
+    SET_META_INT("YHIGH", high[0]);
+    SET_META_INT("YMAX",  max[0]);
+
+    SET_META_INT("UMIN",  min[1]);
+    SET_META_INT("ULOW",  low[1]);
+    SET_META("UAVG", "%g", 1.0 * tot[1] / cfs);
+    SET_META_INT("UHIGH", high[1]);
+    SET_META_INT("UMAX",  max[1]);
+
+    SET_META_INT("VMIN",  min[2]);
+    SET_META_INT("VLOW",  low[2]);
+    SET_META("VAVG", "%g", 1.0 * tot[2] / cfs);
+    SET_META_INT("VHIGH", high[2]);
+    SET_META_INT("VMAX",  max[2]);
+
+    SET_META_INT("SATMIN",  min[3]);
+    SET_META_INT("SATLOW",  low[3]);
+    SET_META("SATAVG", "%g", 1.0 * tot[3] / cfs);
+    SET_META_INT("SATHIGH", high[3]);
+    SET_META_INT("SATMAX",  max[3]);
+
+    SET_META_INT("HUEMED", medhue);
+    SET_META("HUEAVG", "%g", 1.0 * tothue / cfs);
+
+    SET_META("YDIF", "%g", 1.0 * sad[0] / fs);
+    SET_META("UDIF", "%g", 1.0 * (sad[1] + sad_last[1]) / cfs);
+    SET_META("VDIF", "%g", 1.0 * (sad[2] + sad_last[2]) / cfs);
+
+    SET_META_INT("YBITDEPTH", av_popcount(mask[0]));
+    SET_META_INT("UBITDEPTH", av_popcount(mask[1]));
+    SET_META_INT("VBITDEPTH", av_popcount(mask[2]));
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
+{
+    AVFilterContext *ctx = inlink->dst;
+    QCDetectContext *s = ctx->priv;
+    const int need_prev = s->detect & (DETECT_SCENE | DETECT_STATS) ||
+                          (s->detect & DETECT_FREEZE && s->reference_is_prev);
+    uint64_t sad[3] = { 0 }, sad_last[3] = { 0 }, sad_ref[3] = { 0 };
+    ThreadData td = { .in = frame };
+    int ret;
+
+    if (need_prev)
+        td.prev = s->prev_frame;
+    if (s->detect & DETECT_FREEZE && !s->reference_is_prev)
+        td.ref = s->reference_frame;
+
+    ff_filter_execute(ctx, analyze_slice, &td, NULL, s->nb_jobs);
+
+    for (int j = 0; j < s->nb_jobs; j++) {
+        for (int p = 0; p < 3; p++) {
+            sad[p]      += s->slices[j].sad[p];
+            sad_last[p] += s->slices[j].sad_last[p];
+            sad_ref[p]  += s->slices[j].sad_ref[p];
+        }
+    }
+
+    if (s->detect & DETECT_BLACK)
+        detect_black(ctx, frame);
+    if (s->detect & DETECT_FREEZE) {
+        /* the reference is either the previous frame or an older frame */
+        ret = detect_freeze(ctx, frame, td.ref ? sad_ref : sad);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            return ret;
+        }
+    }
+    if (s->detect & DETECT_SCENE)
+        detect_scene(ctx, frame, sad, !!td.prev);
+    if (s->detect & DETECT_CROP)
+        detect_crop(ctx, frame);
+    if (s->detect & DETECT_STATS)
+        compute_stats(ctx, frame, sad, sad_last);
+
+    if (need_prev || s->detect & DETECT_FREEZE) {
+        av_frame_free(&s->prev_frame);
+        s->prev_frame = av_frame_clone(frame);
+        if (!s->prev_frame) {
+            av_frame_free(&frame);
+            return AVERROR(ENOMEM);
+        }
+    }
+
+    s->last_pts = frame->pts;
+    return ff_filter_frame(ctx->outputs[0], frame);
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    QCDetectContext *s = ctx->priv;
+
+    if (s->black_started) {
+        s->black_end = s->last_pts;
+        check_black_end(ctx);
+    }
+
+    av_frame_free(&s->prev_frame);
+    av_frame_free(&s->reference_frame);
+    for (int j = 0; s->slices && j < s->nb_jobs; j++) {
+        av_freep(&s->slices[j].hist[0]);
+        av_freep(&s->slices[j].colsum);
+    }
+    av_freep(&s->slices);
+    av_freep(&s->hist[0]);
+    av_freep(&s->rowsum);
+    av_freep(&s->row_avg);
+    av_freep(&s->col_avg);
+    av_freep(&s->sat_lut);
+    av_freep(&s->hue_lut);
+}
+
+static const AVFilterPad qcdetect_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .config_props = config_input,
+        .filter_frame = filter_frame,
+    },
+};
+
+const FFFilter ff_vf_qcdetect = {
+    .p.name        = "qcdetect",
+    .p.description = NULL_IF_CONFIG_SMALL("Detect black, frozen, scene change and crop areas and compute signal statistics in one pass."),
+    .p.priv_class  = &qcdetect_class,
+    .p.flags       = AVFILTER_FLAG_SLICE_THREADS | AVFILTER_FLAG_METADATA_ONLY,
+    .priv_size     = sizeof(QCDetectContext),
+    .init          = init,
+    .uninit        = uninit,
+    FILTER_INPUTS(qcdetect_inputs),
+    FILTER_OUTPUTS(ff_video_default_filterpad),
+    FILTER_PIXFMTS_ARRAY(pix_fmts),
+};
@@ -46,6 +46,11 @@ AVFrame *ff_null_get_video_buffer(AVFilterLink *link, int w, int h)
     return ff_get_video_buffer(link->dst->outputs[0], w, h);
 }
 
+static AVBufferRef *pool_alloc_hugepage(size_t size)
+{
+    return av_buffer_alloc_hugepage(size, 0);
+}
+
 AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int align)
 {
     FilterLinkInternal *const li = ff_link_internal(link);
@@ -54,6 +59,10 @@ AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int alig
     int pool_height = 0;
     int pool_align = 0;
     enum AVPixelFormat pool_format = AV_PIX_FMT_NONE;
+    AVBufferRef *(*pool_alloc)(size_t size) =
+        CONFIG_MEMORY_POISONING ? NULL :
+        fffiltergraph(li->l.graph)->hugepages ? pool_alloc_hugepage :
+                                                av_buffer_allocz;
 
     if (li->l.hw_frames_ctx &&
         ((AVHWFramesContext*)li->l.hw_frames_ctx->data)->format == link->format) {
@@ -71,10 +80,7 @@ AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int alig
     }
 
     if (!li->frame_pool) {
-        li->frame_pool = ff_frame_pool_video_init(CONFIG_MEMORY_POISONING
-                                                     ? NULL
-                                                     : av_buffer_allocz,
-                                                  w, h, link->format, align);
+        li->frame_pool = ff_frame_pool_video_init(pool_alloc, w, h, link->format, align);
         if (!li->frame_pool)
             return NULL;
     } else {
@@ -88,10 +94,8 @@ AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int alig
             pool_format != link->format || pool_align != align) {
 
             ff_frame_pool_uninit(&li->frame_pool);
-            li->frame_pool = ff_frame_pool_video_init(CONFIG_MEMORY_POISONING
-                                                         ? NULL
-                                                         : av_buffer_allocz,
-                                                      w, h, link->format, align);
+            li->frame_pool = ff_frame_pool_video_init(pool_alloc, w, h,
+                                                      link->format, align);
             if (!li->frame_pool)
                 return NULL;
         }
@@ -0,0 +1,118 @@
+;*****************************************************************************
+;* x86-optimized functions for amix filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+%if ARCH_X86_64
+
+;------------------------------------------------------------------------------
+; void ff_amix_mix_float(float *dst, const float **src, const float *scale,
+;                        int nb_src, ptrdiff_t len)
+; void ff_amix_mix_double(double *dst, const double **src, const double *scale,
+;                         int nb_src, ptrdiff_t len)
+;
+; 64 bytes of output are kept in registers while all inputs are accumulated
+; into them, so dst is written once and never read.
+;------------------------------------------------------------------------------
+
+; %1 = ps or pd, %2 = output register, %3 = input
+; %2 += m4 * %3, fused with FMA3 like vector_fmac_scalar
+%macro MIX_ACC 3
+%if cpuflag(fma3)
+    fmadd%1      %2, m4, %3, %2
+%else
+    mul%1        m5, m4, %3
+    add%1        %2, m5
+%endif
+%endmacro
+
+; %1 = ps or pd, %2 = element size
+%macro MIX 2
+%if %2 == 4
+cglobal amix_mix_float, 5, 8, 6, dst, src, scale, nb, len, i, ptr, off
+%else
+cglobal amix_mix_double, 5, 8, 6, dst, src, scale, nb, len, i, ptr, off
+%endif
+    movsxdifnidn nbq, nbd
+    shl        lenq, %2 / 4 + 1
+    xor        offq, offq
+.loop:
+    xor%1        m0, m0
+    xor%1        m1, m1
+%if mmsize == 16
+    xor%1        m2, m2
+    xor%1        m3, m3
+%endif
+    xor          iq, iq
+    test        nbq, nbq
+    jz .store
+.input:
+    mov        ptrq, [srcq + iq * 8]
+%if %2 == 4
+%if cpuflag(avx)
+    vbroadcastss m4, [scaleq + iq * 4]
+%else
+    movss        m4, [scaleq + iq * 4]
+    shufps       m4, m4, 0
+%endif
+%else
+%if cpuflag(avx)
+    vbroadcastsd m4, [scaleq + iq * 8]
+%else
+    movsd        m4, [scaleq + iq * 8]
+    unpcklpd     m4, m4
+%endif
+%endif
+    MIX_ACC      %1, m0, [ptrq + offq]
+    MIX_ACC      %1, m1, [ptrq + offq + mmsize]
+%if mmsize == 16
+    MIX_ACC      %1, m2, [ptrq + offq + 32]
+    MIX_ACC      %1, m3, [ptrq + offq + 48]
+%endif
+    inc          iq
+    cmp          iq, nbq
+    jl .input
+.store:
+    mova [dstq + offq], m0
+    mova [dstq + offq + mmsize], m1
+%if mmsize == 16
+    mova [dstq + offq + 32], m2
+    mova [dstq + offq + 48], m3
+%endif
+    add        offq, 64
+    cmp        offq, lenq
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse
+MIX ps, 4
+INIT_XMM sse2
+MIX pd, 8
+INIT_YMM avx
+MIX ps, 4
+MIX pd, 8
+INIT_YMM fma3
+MIX ps, 4
+MIX pd, 8
+
+%endif
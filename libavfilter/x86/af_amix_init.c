@@ -0,0 +1,58 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/af_amixdsp.h"
+
+void ff_amix_mix_float_sse(float *dst, const float **src, const float *scale,
+                           int nb_src, ptrdiff_t len);
+void ff_amix_mix_float_avx(float *dst, const float **src, const float *scale,
+                           int nb_src, ptrdiff_t len);
+void ff_amix_mix_float_fma3(float *dst, const float **src, const float *scale,
+                            int nb_src, ptrdiff_t len);
+void ff_amix_mix_double_sse2(double *dst, const double **src, const double *scale,
+                             int nb_src, ptrdiff_t len);
+void ff_amix_mix_double_avx(double *dst, const double **src, const double *scale,
+                            int nb_src, ptrdiff_t len);
+void ff_amix_mix_double_fma3(double *dst, const double **src, const double *scale,
+                             int nb_src, ptrdiff_t len);
+
+av_cold void ff_amix_init_x86(AudioMixDSPContext *s)
+{
+#if ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags)) {
+        s->mix_float  = ff_amix_mix_float_sse;
+    }
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        s->mix_double = ff_amix_mix_double_sse2;
+    }
+    if (EXTERNAL_AVX_FAST(cpu_flags)) {
+        s->mix_float  = ff_amix_mix_float_avx;
+        s->mix_double = ff_amix_mix_double_avx;
+    }
+    if (EXTERNAL_FMA3_FAST(cpu_flags)) {
+        s->mix_float  = ff_amix_mix_float_fma3;
+        s->mix_double = ff_amix_mix_double_fma3;
+    }
+#endif
+}
@@ -16,9 +16,21 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "config.h"
+
+#if HAVE_MMAP && HAVE_MADVISE
+/* for madvise() and MADV_HUGEPAGE */
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE
+#endif
+#endif
+
 #include <stdatomic.h>
 #include <stdint.h>
 #include <string.h>
+#if HAVE_MMAP && HAVE_MADVISE
+#include <sys/mman.h>
+#endif
 
 #include "avassert.h"
 #include "buffer_internal.h"
@@ -100,6 +112,51 @@ AVBufferRef *av_buffer_allocz(size_t size)
     return ret;
 }
 
+#if HAVE_MMAP && HAVE_MADVISE && defined(MADV_HUGEPAGE) && defined(MAP_ANONYMOUS)
+#define HUGEPAGE_SIZE (1 << 21)
+
+static void hugepage_free(void *opaque, uint8_t *data)
+{
+    munmap(data, (uintptr_t)opaque);
+}
+#endif
+
+AVBufferRef *av_buffer_alloc_hugepage(size_t size, int flags)
+{
+#ifdef HUGEPAGE_SIZE
+    if (size >= HUGEPAGE_SIZE && size <= SIZE_MAX - 2 * HUGEPAGE_SIZE) {
+        size_t map_size = FFALIGN(size, HUGEPAGE_SIZE);
+        /* map one extra huge page so that an aligned start can be picked */
+        uint8_t *map = mmap(NULL, map_size + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (map != MAP_FAILED) {
+            uint8_t *data = (uint8_t *)FFALIGN((uintptr_t)map, HUGEPAGE_SIZE);
+            size_t head   = data - map;
+            AVBufferRef *ret;
+
+            if (head)
+                munmap(map, head);
+            if (HUGEPAGE_SIZE - head)
+                munmap(data + map_size, HUGEPAGE_SIZE - head);
+
+            madvise(data, map_size, MADV_HUGEPAGE);
+#ifdef MADV_POPULATE_WRITE
+            if (flags & AV_BUFFER_HUGEPAGE_FLAG_POPULATE)
+                madvise(data, map_size, MADV_POPULATE_WRITE);
+#endif
+
+            ret = av_buffer_create(data, size, hugepage_free,
+                                   (void *)(uintptr_t)map_size, 0);
+            if (ret)
+                return ret;
+            munmap(data, map_size);
+        }
+    }
+#endif
+    return av_buffer_allocz(size);
+}
+
 AVBufferRef *av_buffer_ref(const AVBufferRef *buf)
 {
     AVBufferRef *ret = av_mallocz(sizeof(*ret));
@@ -107,6 +107,25 @@ AVBufferRef *av_buffer_alloc(size_t size);
  */
 AVBufferRef *av_buffer_allocz(size_t size);
 
+/**
+ * Fault in all pages of a huge page buffer at allocation time, where the
+ * system supports it, instead of on first access.
+ */
+#define AV_BUFFER_HUGEPAGE_FLAG_POPULATE (1 << 0)
+
+/**
+ * Same as av_buffer_allocz(), except that buffers of at least 2 MiB are
+ * mapped 2 MiB aligned and backed by transparent huge pages where the
+ * system supports it. This is meant for the alloc callback of
+ * av_buffer_pool_init() for pools of large, long-lived buffers such as
+ * video frames, where it reduces TLB misses.
+ *
+ * Falls back to av_buffer_allocz() for smaller sizes and on failure.
+ *
+ * @param flags a combination of AV_BUFFER_HUGEPAGE_FLAG_*
+ */
+AVBufferRef *av_buffer_alloc_hugepage(size_t size, int flags);
+
 /**
  * Always treat the buffer as read-only, even when it has only one
  * reference.
@@ -23,7 +23,9 @@
 #include "thread.h"
 #include "avassert.h"
 #include "bswap.h"
+#include "cpu.h"
 #include "crc.h"
+#include "crc_internal.h"
 #include "error.h"
 
 #if CONFIG_HARDCODED_TABLES
@@ -338,6 +340,23 @@ DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_32_IEEE_LE, 1, 32, 0xEDB88320)
 DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI_LE, 1, 16,     0xA001)
 #endif
 
+static const struct {
+    uint8_t le, bits;
+    uint32_t poly;
+} crc_params[AV_CRC_MAX] = {
+    [AV_CRC_8_ATM]      = { 0,  8,       0x07 },
+    [AV_CRC_8_EBU]      = { 0,  8,       0x1D },
+    [AV_CRC_16_ANSI]    = { 0, 16,     0x8005 },
+    [AV_CRC_16_CCITT]   = { 0, 16,     0x1021 },
+    [AV_CRC_24_IEEE]    = { 0, 24,   0x864CFB },
+    [AV_CRC_32_IEEE]    = { 0, 32, 0x04C11DB7 },
+    [AV_CRC_32_IEEE_LE] = { 1, 32, 0xEDB88320 },
+    [AV_CRC_16_ANSI_LE] = { 1, 16,     0xA001 },
+};
+
+static FFCRCContext crc_ctx[AV_CRC_MAX];
+static AVOnce crc_ctx_once = AV_ONCE_INIT;
+
 int av_crc_init(AVCRC *ctx, int le, int bits, uint32_t poly, int ctx_size)
 {
     unsigned i, j;
@@ -371,8 +390,59 @@ int av_crc_init(AVCRC *ctx, int le, int bits, uint32_t poly, int ctx_size)
     return 0;
 }
 
+static uint32_t crc_update(const AVCRC *ctx, uint32_t crc,
+                           const uint8_t *buffer, size_t length)
+{
+    const uint8_t *end = buffer + length;
+
+#if !CONFIG_SMALL
+    if (!ctx[256]) {
+        while (((intptr_t) buffer & 3) && buffer < end)
+            crc = ctx[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
+
+        while (buffer < end - 3) {
+            crc ^= av_le2ne32(*(const uint32_t *) buffer); buffer += 4;
+            crc = ctx[3 * 256 + ( crc        & 0xFF)] ^
+                  ctx[2 * 256 + ((crc >> 8 ) & 0xFF)] ^
+                  ctx[1 * 256 + ((crc >> 16) & 0xFF)] ^
+                  ctx[0 * 256 + ((crc >> 24)       )];
+        }
+    }
+#endif
+    while (buffer < end)
+        crc = ctx[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
+
+    return crc;
+}
+
+static uint32_t crc_update_c(const FFCRCContext *c, uint32_t crc,
+                             const uint8_t *buffer, size_t length)
+{
+    return crc_update(c->table, crc, buffer, length);
+}
+
+void ff_crc_init(FFCRCContext *c, AVCRCId crc_id, int cpu_flags)
+{
+    c->update    = crc_update_c;
+    c->table     = av_crc_table[crc_id];
+    c->cpu_flags = 0;
+#if ARCH_X86
+    ff_crc_init_x86(c, crc_params[crc_id].le, crc_params[crc_id].bits,
+                    crc_params[crc_id].poly, cpu_flags);
+#endif
+}
+
+static void crc_ctx_init(void)
+{
+    /* Set up the fastest version for any CPU, av_crc() checks on every
+     * call whether the current CPU flags allow using it. */
+    for (int i = 0; i < AV_CRC_MAX; i++)
+        ff_crc_init(&crc_ctx[i], i, -1);
+}
+
 const AVCRC *av_crc_get_table(AVCRCId crc_id)
 {
+    ff_thread_once(&crc_ctx_once, crc_ctx_init);
 #if !CONFIG_HARDCODED_TABLES
     switch (crc_id) {
     case AV_CRC_8_ATM:      CRC_INIT_TABLE_ONCE(AV_CRC_8_ATM); break;
@@ -392,24 +462,18 @@ const AVCRC *av_crc_get_table(AVCRCId crc_id)
 uint32_t av_crc(const AVCRC *ctx, uint32_t crc,
                 const uint8_t *buffer, size_t length)
 {
-    const uint8_t *end = buffer + length;
+    /* The built-in tables can only be obtained from av_crc_get_table(),
+     * which has set up their contexts. */
+    const uintptr_t idx = ((uintptr_t)ctx - (uintptr_t)av_crc_table) /
+                          sizeof(av_crc_table[0]);
 
-#if !CONFIG_SMALL
-    if (!ctx[256]) {
-        while (((intptr_t) buffer & 3) && buffer < end)
-            crc = ctx[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
+    if (idx < AV_CRC_MAX && ctx == av_crc_table[idx]) {
+        const FFCRCContext *c = &crc_ctx[idx];
 
-        while (buffer < end - 3) {
-            crc ^= av_le2ne32(*(const uint32_t *) buffer); buffer += 4;
-            crc = ctx[3 * 256 + ( crc        & 0xFF)] ^
-                  ctx[2 * 256 + ((crc >> 8 ) & 0xFF)] ^
-                  ctx[1 * 256 + ((crc >> 16) & 0xFF)] ^
-                  ctx[0 * 256 + ((crc >> 24)       )];
-        }
+        /* not resolved once, so that av_force_cpu_flags() is honored */
+        if ((av_get_cpu_flags() & c->cpu_flags) == c->cpu_flags)
+            return c->update(c, crc, buffer, length);
     }
-#endif
-    while (buffer < end)
-        crc = ctx[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
 
-    return crc;
+    return crc_update(ctx, crc, buffer, length);
 }
@@ -0,0 +1,66 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_CRC_INTERNAL_H
+#define AVUTIL_CRC_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc.h"
+#include "mem_internal.h"
+
+/**
+ * Implementation of one of the built-in CRCs, used by av_crc() when it is
+ * passed a table returned by av_crc_get_table().
+ */
+typedef struct FFCRCContext {
+    /**
+     * Same semantics as av_crc() with the table of this context.
+     */
+    uint32_t (*update)(const struct FFCRCContext *c, uint32_t crc,
+                       const uint8_t *buffer, size_t length);
+
+    const AVCRC *table;
+
+    /**
+     * CPU flags update needs, 0 for the C version.
+     */
+    int cpu_flags;
+
+    /**
+     * Constants for the SIMD update functions, filled in by the arch
+     * specific init functions.
+     */
+    DECLARE_ALIGNED(16, uint64_t, fold)[6];
+} FFCRCContext;
+
+/**
+ * Set up c for the built-in CRC crc_id with the fastest update function
+ * available with cpu_flags. The table of crc_id must have been initialized
+ * with av_crc_get_table() before c->update is called.
+ */
+void ff_crc_init(FFCRCContext *c, AVCRCId crc_id, int cpu_flags);
+
+/**
+ * @param le, bits, poly parameters of the CRC as passed to av_crc_init()
+ */
+void ff_crc_init_x86(FFCRCContext *c, int le, int bits, uint32_t poly,
+                     int cpu_flags);
+
+#endif /* AVUTIL_CRC_INTERNAL_H */
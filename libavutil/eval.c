@@ -176,8 +176,27 @@ struct AVExpr {
     struct AVExpr *param[3];
     double *var;
     FFSFC64 *prng_state;
+
+    /* only set in the root node */
+    struct ExprInsn *insns;     ///< program for av_expr_eval_batch(), NULL if not compiled
+    int nb_insns;
+    int nb_consts;              ///< highest constant index used + 1
+    double *batch_values;       ///< scratch values for evaluating lanes one by one
 };
 
+/**
+ * One node of a compiled expression. Registers are allocated like a stack:
+ * the parameters of a node whose result goes to register dst are in
+ * registers dst, dst + 1 and dst + 2.
+ */
+typedef struct ExprInsn {
+    const AVExpr *e;
+    int dst;
+} ExprInsn;
+
+#define BATCH_REGS 32
+#define BATCH_SIZE 32
+
 static double etime(double v)
 {
     return av_gettime() * 0.000001;
@@ -363,6 +382,8 @@ void av_expr_free(AVExpr *e)
     av_expr_free(e->param[2]);
     av_freep(&e->var);
     av_freep(&e->prng_state);
+    av_freep(&e->insns);
+    av_freep(&e->batch_values);
     av_freep(&e);
 }
 
@@ -707,6 +728,141 @@ static int verify_expr(AVExpr *e)
     }
 }
 
+/**
+ * @return 0 if evaluating e may depend on or change the state kept in the
+ * root node, i.e. if e cannot be evaluated for several sets of values at once
+ */
+static int expr_is_pure(const AVExpr *e)
+{
+    if (!e)
+        return 1;
+    switch (e->type) {
+    case e_ld:
+    case e_st:
+    case e_while:
+    case e_taylor:
+    case e_root:
+    case e_print:
+    case e_random:
+    case e_randomi:
+        return 0;
+    default:
+        return expr_is_pure(e->param[0]) &&
+               expr_is_pure(e->param[1]) &&
+               expr_is_pure(e->param[2]);
+    }
+}
+
+static int expr_is_constant(const AVExpr *e)
+{
+    if (!e)
+        return 1;
+    switch (e->type) {
+    case e_const:
+    case e_func1:
+    case e_func2:
+        return 0;
+    case e_func0:
+        if (e->a.func0 == etime)
+            return 0;
+        break;
+    default:
+        break;
+    }
+    return expr_is_pure(e) &&
+           expr_is_constant(e->param[0]) &&
+           expr_is_constant(e->param[1]) &&
+           expr_is_constant(e->param[2]);
+}
+
+/* replace the subexpressions which do not depend on anything by their value */
+static void fold_constants(Parser *p, AVExpr *e)
+{
+    if (!e || e->type == e_value)
+        return;
+
+    if (!expr_is_constant(e)) {
+        for (int i = 0; i < 3; i++)
+            fold_constants(p, e->param[i]);
+        return;
+    }
+
+    e->value = eval_expr(p, e);
+    e->type  = e_value;
+    for (int i = 0; i < 3; i++) {
+        av_expr_free(e->param[i]);
+        e->param[i] = NULL;
+    }
+}
+
+static int expr_count_nodes(const AVExpr *e)
+{
+    if (!e)
+        return 0;
+    return 1 + expr_count_nodes(e->param[0]) +
+               expr_count_nodes(e->param[1]) +
+               expr_count_nodes(e->param[2]);
+}
+
+static int expr_nb_consts(const AVExpr *e)
+{
+    int nb = 0;
+
+    if (!e)
+        return 0;
+    if (e->type == e_const)
+        return e->const_index + 1;
+    for (int i = 0; i < 3; i++) {
+        int n = expr_nb_consts(e->param[i]);
+        nb = FFMAX(nb, n);
+    }
+    return nb;
+}
+
+static int compile_expr(ExprInsn *insns, int *nb_insns, const AVExpr *e, int dst)
+{
+    if (dst >= BATCH_REGS)
+        return AVERROR(ENOSPC);
+
+    for (int i = 0; i < 3; i++) {
+        int ret;
+
+        /* the first operand of ';' has no effect in a pure expression */
+        if (!e->param[i] || (e->type == e_last && !i))
+            continue;
+        if ((ret = compile_expr(insns, nb_insns, e->param[i], dst + i)) < 0)
+            return ret;
+    }
+
+    insns[*nb_insns].e   = e;
+    insns[*nb_insns].dst = dst;
+    (*nb_insns)++;
+    return 0;
+}
+
+/**
+ * Lower the expression tree to the program run by av_expr_eval_batch().
+ * Expressions which are not pure or need too many registers are left
+ * without a program and evaluated one set of values at a time.
+ */
+static int compile_program(AVExpr *e)
+{
+    e->nb_consts = expr_nb_consts(e);
+
+    if (!expr_is_pure(e))
+        return 0;
+
+    e->insns = av_malloc_array(expr_count_nodes(e), sizeof(*e->insns));
+    if (!e->insns)
+        return AVERROR(ENOMEM);
+
+    if (compile_expr(e->insns, &e->nb_insns, e, 0) < 0) {
+        av_freep(&e->insns);
+        e->nb_insns = 0;
+    }
+    return 0;
+}
+
 int av_expr_parse(AVExpr **expr, const char *s,
                   const char * const *const_names,
                   const char * const *func1_names, double (* const *funcs1)(void *, double),
@@ -749,6 +905,9 @@ int av_expr_parse(AVExpr **expr, const char *s,
         ret = AVERROR(EINVAL);
         goto end;
     }
+    fold_constants(&p, e);
+    if ((ret = compile_program(e)) < 0)
+        goto end;
     e->var= av_mallocz(sizeof(double) *VARS);
     e->prng_state = av_mallocz(sizeof(*e->prng_state) *VARS);
     if (!e->var || !e->prng_state) {
@@ -802,6 +961,139 @@ double av_expr_eval(AVExpr *e, const double *const_values, void *opaque)
     return eval_expr(&p, e);
 }
 
+static void run_program(const AVExpr *root, double (*regs)[BATCH_SIZE], int n,
+                        const double *const_values,
+                        const double * const *const_arrays, int offset,
+                        void *opaque)
+{
+    for (int k = 0; k < root->nb_insns; k++) {
+        const AVExpr *e = root->insns[k].e;
+        double *d       = regs[root->insns[k].dst];
+        const double *a = d;
+        const double *b = d + BATCH_SIZE;
+        const double *c = d + 2 * BATCH_SIZE;
+        const double v  = e->value;
+        int i;
+
+        /* The operations must be done exactly as in eval_expr() so that
+         * both give the same results. */
+        switch (e->type) {
+        case e_value:
+            for (i = 0; i < n; i++) d[i] = v;
+            break;
+        case e_const:
+            if (const_arrays && const_arrays[e->const_index]) {
+                const double *src = const_arrays[e->const_index] + offset;
+                for (i = 0; i < n; i++) d[i] = v * src[i];
+            } else {
+                const double val = const_values[e->const_index];
+                for (i = 0; i < n; i++) d[i] = v * val;
+            }
+            break;
+        case e_func0:  for (i = 0; i < n; i++) d[i] = v * e->a.func0(a[i]); break;
+        case e_func1:  for (i = 0; i < n; i++) d[i] = v * e->a.func1(opaque, a[i]); break;
+        case e_func2:  for (i = 0; i < n; i++) d[i] = v * e->a.func2(opaque, a[i], b[i]); break;
+        case e_squish: for (i = 0; i < n; i++) d[i] = 1/(1+exp(4*a[i])); break;
+        case e_gauss:  for (i = 0; i < n; i++) d[i] = exp(-a[i]*a[i]/2)/sqrt(2*M_PI); break;
+        case e_isnan:  for (i = 0; i < n; i++) d[i] = v * !!isnan(a[i]); break;
+        case e_isinf:  for (i = 0; i < n; i++) d[i] = v * !!isinf(a[i]); break;
+        case e_floor:  for (i = 0; i < n; i++) d[i] = v * floor(a[i]); break;
+        case e_ceil:   for (i = 0; i < n; i++) d[i] = v * ceil (a[i]); break;
+        case e_trunc:  for (i = 0; i < n; i++) d[i] = v * trunc(a[i]); break;
+        case e_round:  for (i = 0; i < n; i++) d[i] = v * round(a[i]); break;
+        case e_sgn:    for (i = 0; i < n; i++) d[i] = v * FFDIFFSIGN(a[i], 0); break;
+        case e_sqrt:   for (i = 0; i < n; i++) d[i] = v * sqrt (a[i]); break;
+        case e_not:    for (i = 0; i < n; i++) d[i] = v * (a[i] == 0); break;
+        case e_if:
+            if (e->param[2])
+                for (i = 0; i < n; i++) d[i] = v * (a[i] ? b[i] : c[i]);
+            else
+                for (i = 0; i < n; i++) d[i] = v * (a[i] ? b[i] : 0);
+            break;
+        case e_ifnot:
+            if (e->param[2])
+                for (i = 0; i < n; i++) d[i] = v * (!a[i] ? b[i] : c[i]);
+            else
+                for (i = 0; i < n; i++) d[i] = v * (!a[i] ? b[i] : 0);
+            break;
+        case e_clip:
+            for (i = 0; i < n; i++) {
+                if (isnan(b[i]) || isnan(c[i]) || isnan(a[i]) || b[i] > c[i])
+                    d[i] = NAN;
+                else
+                    d[i] = v * av_clipd(a[i], b[i], c[i]);
+            }
+            break;
+        case e_between:
+            for (i = 0; i < n; i++) d[i] = v * (a[i] >= b[i] && a[i] <= c[i]);
+            break;
+        case e_lerp:   for (i = 0; i < n; i++) d[i] = a[i] + (b[i] - a[i]) * c[i]; break;
+        case e_mod:
+            for (i = 0; i < n; i++)
+                d[i] = v * (a[i] - floor(b[i] ? a[i] / b[i] : a[i] * INFINITY) * b[i]);
+            break;
+        case e_gcd:    for (i = 0; i < n; i++) d[i] = v * av_gcd(a[i], b[i]); break;
+        case e_max:    for (i = 0; i < n; i++) d[i] = v * (a[i] >  b[i] ?  a[i] : b[i]); break;
+        case e_min:    for (i = 0; i < n; i++) d[i] = v * (a[i] <  b[i] ?  a[i] : b[i]); break;
+        case e_eq:     for (i = 0; i < n; i++) d[i] = v * (a[i] == b[i] ? 1.0 : 0.0); break;
+        case e_gt:     for (i = 0; i < n; i++) d[i] = v * (a[i] >  b[i] ? 1.0 : 0.0); break;
+        case e_gte:    for (i = 0; i < n; i++) d[i] = v * (a[i] >= b[i] ? 1.0 : 0.0); break;
+        case e_lt:     for (i = 0; i < n; i++) d[i] = v * (a[i] <  b[i] ? 1.0 : 0.0); break;
+        case e_lte:    for (i = 0; i < n; i++) d[i] = v * (a[i] <= b[i] ? 1.0 : 0.0); break;
+        case e_pow:    for (i = 0; i < n; i++) d[i] = v * pow(a[i], b[i]); break;
+        case e_mul:    for (i = 0; i < n; i++) d[i] = v * (a[i] * b[i]); break;
+        case e_div:
+            for (i = 0; i < n; i++) d[i] = v * (b[i] ? (a[i] / b[i]) : a[i] * INFINITY);
+            break;
+        case e_add:    for (i = 0; i < n; i++) d[i] = v * (a[i] + b[i]); break;
+        case e_last:   for (i = 0; i < n; i++) d[i] = v * b[i]; break;
+        case e_hypot:  for (i = 0; i < n; i++) d[i] = v * hypot(a[i], b[i]); break;
+        case e_atan2:  for (i = 0; i < n; i++) d[i] = v * atan2(a[i], b[i]); break;
+        case e_bitand:
+            for (i = 0; i < n; i++)
+                d[i] = isnan(a[i]) || isnan(b[i]) ? NAN : v * ((long int)a[i] & (long int)b[i]);
+            break;
+        case e_bitor:
+            for (i = 0; i < n; i++)
+                d[i] = isnan(a[i]) || isnan(b[i]) ? NAN : v * ((long int)a[i] | (long int)b[i]);
+            break;
+        default:
+            for (i = 0; i < n; i++) d[i] = NAN;
+            break;
+        }
+    }
+}
+
+int av_expr_eval_batch(AVExpr *e, double *res, int nb,
+                       const double *const_values,
+                       const double * const *const_arrays, void *opaque)
+{
+    double regs[BATCH_REGS][BATCH_SIZE];
+
+    if (!e->insns) {
+        if (e->nb_consts && !e->batch_values) {
+            e->batch_values = av_malloc_array(e->nb_consts, sizeof(*e->batch_values));
+            if (!e->batch_values)
+                return AVERROR(ENOMEM);
+        }
+        for (int i = 0; i < nb; i++) {
+            for (int j = 0; j < e->nb_consts; j++)
+                e->batch_values[j] = const_arrays && const_arrays[j] ?
+                                     const_arrays[j][i] : const_values[j];
+            res[i] = av_expr_eval(e, e->batch_values, opaque);
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < nb; i += BATCH_SIZE) {
+        const int n = FFMIN(nb - i, BATCH_SIZE);
+
+        run_program(e, regs, n, const_values, const_arrays, i, opaque);
+        memcpy(res + i, regs[0], n * sizeof(*res));
+    }
+    return 0;
+}
+
 int av_expr_parse_and_eval(double *d, const char *s,
                            const char * const *const_names, const double *const_values,
                            const char * const *func1_names, double (* const *funcs1)(void *, double),
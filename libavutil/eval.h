@@ -87,6 +87,35 @@ int av_expr_parse(AVExpr **expr, const char *s,
  */
 double av_expr_eval(AVExpr *e, const double *const_values, void *opaque);
 
+/**
+ * Evaluate a previously parsed expression for several sets of values.
+ *
+ * This gives the same results as calling av_expr_eval() nb times, but is
+ * considerably faster for expressions that do not use ld(), st(), while(),
+ * taylor(), root(), print(), random() or randomi(), which are evaluated for
+ * many values at once. Expressions using them are evaluated for one set of
+ * values after the other, in order.
+ *
+ * In the first case, the functions from funcs1 and funcs2 are called in an
+ * unspecified order, and both branches of if() and ifnot() are evaluated,
+ * so the functions must not have side effects.
+ *
+ * @param e the AVExpr to evaluate
+ * @param res array where the nb results are stored
+ * @param nb number of sets of values to evaluate the expression for
+ * @param const_values array of values for the identifiers from
+ *                     av_expr_parse() const_names which do not vary,
+ *                     may be NULL if const_arrays provides all of them
+ * @param const_arrays NULL, or an array with an entry for each identifier
+ *                     from const_names, which is either NULL or an array of
+ *                     nb values to use instead of the one in const_values
+ * @param opaque a pointer which will be passed to all functions from funcs1 and funcs2
+ * @return 0 on success, a negative AVERROR code otherwise
+ */
+int av_expr_eval_batch(AVExpr *e, double *res, int nb,
+                       const double *const_values,
+                       const double * const *const_arrays, void *opaque);
+
 /**
  * Track the presence of variables and their number of occurrences in a parsed expression
  *
@@ -20,6 +20,7 @@
 
 #include "config.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #include "mem.h"
@@ -43,24 +44,39 @@
 
 #endif //!HAVE_THREADS
 
+/**
+ * Each worker owns a task list sorted by priority_higher(). Workers take
+ * the first ready task from their own list and steal from the other
+ * workers when theirs has none, so the list locks are only contended
+ * while stealing.
+ */
 typedef struct ThreadInfo {
     AVExecutor *e;
     ExecutorThread thread;
+
+    AVMutex lock;           ///< protects tasks
+    AVTask *tasks;
+    atomic_int nb_tasks;    ///< number of tasks in the list, read without the lock
+
+    AVCond cond;            ///< signalled to wake up this worker only
+    int idle;               ///< protected by AVExecutor.sleep_lock
 } ThreadInfo;
 
 struct AVExecutor {
     AVTaskCallbacks cb;
     int thread_count;
+    int nb_sync;            ///< number of threads with initialized lock and cond
     bool recursive;
 
     ThreadInfo *threads;
     uint8_t *local_contexts;
 
-    AVMutex lock;
-    AVCond cond;
-    int die;
-
-    AVTask *tasks;
+    AVMutex sleep_lock;
+    int has_sleep_lock;
+    atomic_uint gen;        ///< bumped by every av_executor_execute() call
+    atomic_int nb_idle;
+    atomic_uint next;       ///< round robin target for new tasks
+    atomic_int die;
 };
 
 static AVTask* remove_task(AVTask **prev, AVTask *t)
@@ -76,25 +92,69 @@ static void add_task(AVTask **prev, AVTask *t)
     *prev   = t;
 }
 
-static int run_one_task(AVExecutor *e, void *lc)
+static AVTask *get_task(AVExecutor *e, ThreadInfo *ti)
 {
     AVTaskCallbacks *cb = &e->cb;
-    AVTask **prev;
+    AVTask **prev, *t = NULL;
 
-    for (prev = &e->tasks; *prev && !cb->ready(*prev, cb->user_data); prev = &(*prev)->next)
+    if (e->thread_count)
+        ff_mutex_lock(&ti->lock);
+    for (prev = &ti->tasks; *prev && !cb->ready(*prev, cb->user_data); prev = &(*prev)->next)
         /* nothing */;
-    if (*prev) {
-        AVTask *t = remove_task(prev, *prev);
-        if (e->thread_count > 0)
-            ff_mutex_unlock(&e->lock);
-        cb->run(t, lc, cb->user_data);
-        if (e->thread_count > 0)
-            ff_mutex_lock(&e->lock);
-        return 1;
+    if (*prev)
+        t = remove_task(prev, *prev);
+    if (e->thread_count)
+        ff_mutex_unlock(&ti->lock);
+
+    if (t)
+        atomic_fetch_sub_explicit(&ti->nb_tasks, 1, memory_order_relaxed);
+    return t;
+}
+
+static int run_one_task(AVExecutor *e, ThreadInfo *ti, void *lc)
+{
+    AVTaskCallbacks *cb = &e->cb;
+    const int n = FFMAX(e->thread_count, 1);
+    const int self = ti - e->threads;
+
+    // own list first, then steal starting from the next worker
+    for (int i = 0; i < n; i++) {
+        ThreadInfo *victim = e->threads + (self + i) % n;
+        AVTask *t;
+
+        if (!atomic_load_explicit(&victim->nb_tasks, memory_order_relaxed))
+            continue;
+        t = get_task(e, victim);
+        if (t) {
+            cb->run(t, lc, cb->user_data);
+            return 1;
+        }
     }
     return 0;
 }
 
+static void wake_one(AVExecutor *e, ThreadInfo *prefer)
+{
+    ThreadInfo *ti = NULL;
+
+    if (!atomic_load(&e->nb_idle))
+        return;
+
+    ff_mutex_lock(&e->sleep_lock);
+    if (prefer->idle)
+        ti = prefer;
+    for (int i = 0; !ti && i < e->thread_count; i++) {
+        if (e->threads[i].idle)
+            ti = e->threads + i;
+    }
+    if (ti) {
+        ti->idle = 0;
+        atomic_fetch_sub(&e->nb_idle, 1);
+        ff_cond_signal(&ti->cond);
+    }
+    ff_mutex_unlock(&e->sleep_lock);
+}
+
 #if HAVE_THREADS
 static void *executor_worker_task(void *data)
 {
@@ -102,36 +162,49 @@ static void *executor_worker_task(void *data)
     AVExecutor *e  = ti->e;
     void *lc       = e->local_contexts + (ti - e->threads) * e->cb.local_context_size;
 
-    ff_mutex_lock(&e->lock);
-    while (1) {
-        if (e->die) break;
-
-        if (!run_one_task(e, lc)) {
-            //no task in one loop
-            ff_cond_wait(&e->cond, &e->lock);
+    while (!atomic_load(&e->die)) {
+        // tasks may become ready without being queued, so sleep only
+        // if nothing was submitted or signalled since the lists were scanned
+        const unsigned gen = atomic_load(&e->gen);
+
+        if (run_one_task(e, ti, lc))
+            continue;
+
+        ff_mutex_lock(&e->sleep_lock);
+        ti->idle = 1;
+        atomic_fetch_add(&e->nb_idle, 1);
+        // pairs with the gen increment before wake_one() in av_executor_execute()
+        while (ti->idle && !atomic_load(&e->die) && atomic_load(&e->gen) == gen)
+            ff_cond_wait(&ti->cond, &e->sleep_lock);
+        if (ti->idle) {
+            ti->idle = 0;
+            atomic_fetch_sub(&e->nb_idle, 1);
         }
+        ff_mutex_unlock(&e->sleep_lock);
     }
-    ff_mutex_unlock(&e->lock);
     return NULL;
 }
 #endif
 
-static void executor_free(AVExecutor *e, const int has_lock, const int has_cond)
+static void executor_free(AVExecutor *e)
 {
     if (e->thread_count) {
         //signal die
-        ff_mutex_lock(&e->lock);
-        e->die = 1;
-        ff_cond_broadcast(&e->cond);
-        ff_mutex_unlock(&e->lock);
+        ff_mutex_lock(&e->sleep_lock);
+        atomic_store(&e->die, 1);
+        for (int i = 0; i < e->thread_count; i++)
+            ff_cond_signal(&e->threads[i].cond);
+        ff_mutex_unlock(&e->sleep_lock);
 
         for (int i = 0; i < e->thread_count; i++)
             executor_thread_join(e->threads[i].thread, NULL);
     }
-    if (has_cond)
-        ff_cond_destroy(&e->cond);
-    if (has_lock)
-        ff_mutex_destroy(&e->lock);
+    for (int i = 0; i < e->nb_sync; i++) {
+        ff_cond_destroy(&e->threads[i].cond);
+        ff_mutex_destroy(&e->threads[i].lock);
+    }
+    if (e->has_sleep_lock)
+        ff_mutex_destroy(&e->sleep_lock);
 
     av_free(e->threads);
     av_free(e->local_contexts);
@@ -142,7 +215,7 @@ static void executor_free(AVExecutor *e, const int has_lock, const int has_cond)
 AVExecutor* av_executor_alloc(const AVTaskCallbacks *cb, int thread_count)
 {
     AVExecutor *e;
-    int has_lock = 0, has_cond = 0;
+    const int n = FFMAX(thread_count, 1);
     if (!cb || !cb->user_data || !cb->ready || !cb->run || !cb->priority_higher)
         return NULL;
 
@@ -151,62 +224,82 @@ AVExecutor* av_executor_alloc(const AVTaskCallbacks *cb, int thread_count)
         return NULL;
     e->cb = *cb;
 
-    e->local_contexts = av_calloc(FFMAX(thread_count, 1), e->cb.local_context_size);
+    e->local_contexts = av_calloc(n, e->cb.local_context_size);
     if (!e->local_contexts)
         goto free_executor;
 
-    e->threads = av_calloc(FFMAX(thread_count, 1), sizeof(*e->threads));
+    e->threads = av_calloc(n, sizeof(*e->threads));
     if (!e->threads)
         goto free_executor;
 
+    for (int i = 0; i < n; i++) {
+        e->threads[i].e = e;
+        atomic_init(&e->threads[i].nb_tasks, 0);
+    }
+    atomic_init(&e->gen, 0);
+    atomic_init(&e->nb_idle, 0);
+    atomic_init(&e->next, 0);
+    atomic_init(&e->die, 0);
+
     if (!thread_count)
         return e;
 
-    has_lock = !ff_mutex_init(&e->lock, NULL);
-    has_cond = !ff_cond_init(&e->cond, NULL);
-
-    if (!has_lock || !has_cond)
+    e->has_sleep_lock = !ff_mutex_init(&e->sleep_lock, NULL);
+    if (!e->has_sleep_lock)
         goto free_executor;
 
+    for (/* nothing */; e->nb_sync < thread_count; e->nb_sync++) {
+        ThreadInfo *ti = e->threads + e->nb_sync;
+        if (ff_mutex_init(&ti->lock, NULL))
+            goto free_executor;
+        if (ff_cond_init(&ti->cond, NULL)) {
+            ff_mutex_destroy(&ti->lock);
+            goto free_executor;
+        }
+    }
+
     for (/* nothing */; e->thread_count < thread_count; e->thread_count++) {
         ThreadInfo *ti = e->threads + e->thread_count;
-        ti->e = e;
         if (executor_thread_create(&ti->thread, NULL, executor_worker_task, ti))
             goto free_executor;
     }
     return e;
 
 free_executor:
-    executor_free(e, has_lock, has_cond);
+    executor_free(e);
     return NULL;
 }
 
 void av_executor_free(AVExecutor **executor)
 {
-    int thread_count;
-
     if (!executor || !*executor)
         return;
-    thread_count = (*executor)->thread_count;
-    executor_free(*executor, thread_count, thread_count);
+    executor_free(*executor);
     *executor = NULL;
 }
 
 void av_executor_execute(AVExecutor *e, AVTask *t)
 {
     AVTaskCallbacks *cb = &e->cb;
+    ThreadInfo *ti = e->threads;
     AVTask **prev;
 
     if (e->thread_count)
-        ff_mutex_lock(&e->lock);
+        ti += atomic_fetch_add_explicit(&e->next, 1, memory_order_relaxed) % e->thread_count;
+
     if (t) {
-        for (prev = &e->tasks; *prev && cb->priority_higher(*prev, t); prev = &(*prev)->next)
+        if (e->thread_count)
+            ff_mutex_lock(&ti->lock);
+        for (prev = &ti->tasks; *prev && cb->priority_higher(*prev, t); prev = &(*prev)->next)
             /* nothing */;
         add_task(prev, t);
+        if (e->thread_count)
+            ff_mutex_unlock(&ti->lock);
+        atomic_fetch_add_explicit(&ti->nb_tasks, 1, memory_order_relaxed);
     }
     if (e->thread_count) {
-        ff_cond_signal(&e->cond);
-        ff_mutex_unlock(&e->lock);
+        atomic_fetch_add(&e->gen, 1);
+        wake_one(e, ti);
     }
 
     if (!e->thread_count || !HAVE_THREADS) {
@@ -214,7 +307,7 @@ void av_executor_execute(AVExecutor *e, AVTask *t)
             return;
         e->recursive = true;
         // We are running in a single-threaded environment, so we must handle all tasks ourselves
-        while (run_one_task(e, e->local_contexts))
+        while (run_one_task(e, e->threads, e->local_contexts))
             /* nothing */;
         e->recursive = false;
     }
@@ -36,7 +36,7 @@ typedef struct AVTaskCallbacks {
     // return 1 if a's priority > b's priority
     int (*priority_higher)(const AVTask *a, const AVTask *b);
 
-    // task is ready for run
+    // task is ready for run, may be called from several threads at once
     int (*ready)(const AVTask *t, void *user_data);
 
     // run the task
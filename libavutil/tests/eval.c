@@ -23,6 +23,7 @@
 #include <string.h>
 
 #include "libavutil/libm.h"
+#include "libavutil/macros.h"
 #include "libavutil/eval.h"
 
 static const double const_values[] = {
@@ -37,6 +38,75 @@ static const char *const const_names[] = {
     0
 };
 
+static const char *const batch_names[] = {
+    "X",
+    "Y",
+    0
+};
+
+static int same(double a, double b)
+{
+    return a == b || (isnan(a) && isnan(b));
+}
+
+/* av_expr_eval_batch() must give the same results as av_expr_eval() */
+static void check_batch(void)
+{
+    static const char *const exprs[] = {
+        "X",
+        "-X*Y+3",
+        "1+(5-2)^(3-1)+1/2+sin(PI)-max(X,-3.1)",
+        "-(X;Y)",
+        "mod(X, Y) + gcd(X, 12) - hypot(X, Y)/atan2(Y, X)",
+        "X/Y - X^2 - sqrt(X)",
+        "if(gt(X, Y), X) + ifnot(lt(X, Y), -Y, 7) - if(X, 2, Y)",
+        "between(X, -3, Y) + clip(X, Y, 10) + clip(X, 0/0, 1)",
+        "squish(X/10) - gauss(Y/10) + lerp(X, Y, 0.25)",
+        "eq(X, Y) + gte(X, Y) + lte(X, Y) + not(X) + isnan(X/Y) + isinf(X/Y)",
+        "floor(X/3) + ceil(Y/3) + trunc(-X/3) + round(X/7) + sgn(X-Y)",
+        "bitand(X, 12) + bitor(X, 12) + abs(cos(X)) * exp(-Y)",
+        "st(0, ld(0) + X); ld(0) * Y",
+        /* needs more registers than available for batches */
+        "max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, max(Y, X))))))))))))))))))))))))))))))))))))))))",
+        NULL
+    };
+    double x[100], y[100], res[100];
+    const double *arrays[] = { x, NULL };
+    const double values[]  = { 0, 3 };
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(x); i++) {
+        x[i] = i - 50;
+        y[i] = (i * 7) % 13 - 5;
+    }
+
+    for (int i = 0; exprs[i]; i++) {
+        AVExpr *e, *e_ref;
+
+        if (av_expr_parse(&e,     exprs[i], batch_names, NULL, NULL, NULL, NULL, 0, NULL) < 0 ||
+            av_expr_parse(&e_ref, exprs[i], batch_names, NULL, NULL, NULL, NULL, 0, NULL) < 0) {
+            printf("Parsing '%s' failed\n", exprs[i]);
+            continue;
+        }
+
+        for (int k = 0; k < 2; k++) {
+            arrays[1] = k ? y : NULL;
+            av_expr_eval_batch(e, res, FF_ARRAY_ELEMS(res), values, arrays, NULL);
+            for (int j = 0; j < FF_ARRAY_ELEMS(res); j++) {
+                const double v[] = { x[j], k ? y[j] : values[1] };
+                const double ref = av_expr_eval(e_ref, v, NULL);
+
+                if (!same(res[j], ref)) {
+                    printf("'%s' X=%f Y=%f: batch %f != %f\n",
+                           exprs[i], v[0], v[1], res[j], ref);
+                    break;
+                }
+            }
+        }
+        av_expr_free(e);
+        av_expr_free(e_ref);
+    }
+}
+
 int main(int argc, char **argv)
 {
     int i;
@@ -168,6 +238,8 @@ int main(int argc, char **argv)
     if (ret < 0)
         printf("av_expr_parse_and_eval failed\n");
 
+    check_batch();
+
     if (argc > 1 && !strcmp(argv[1], "-t")) {
         for (i = 0; i < 1050; i++) {
             START_TIMER;
@@ -0,0 +1,104 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Run a tree of tasks and check every task runs exactly once, after its
+ * parent. Half of the tasks are queued up front and only become ready once
+ * their parent has run, the other half are submitted by their parent from
+ * inside the executor.
+ */
+
+#include "libavutil/executor.c"
+
+#include "libavutil/tests/executor_workload.h"
+
+typedef struct Task {
+    AVTask task;
+    int idx;
+} Task;
+
+static int priority_higher(const AVTask *_a, const AVTask *_b)
+{
+    const Task *a = (const Task *)_a, *b = (const Task *)_b;
+    return a->idx < b->idx;
+}
+
+static int ready(const AVTask *_t, void *user_data)
+{
+    const Task *t     = (const Task *)_t;
+    const Workload *w = user_data;
+    return !t->idx || atomic_load(&w->runs[parent(t->idx)]);
+}
+
+static int run(AVTask *_t, void *local_context, void *user_data)
+{
+    Task *t     = (Task *)_t;
+    Workload *w = user_data;
+
+    workload_run(w, t->idx);
+
+    // odd children are queued already and only need a wakeup
+    for (int i = 1; i <= FANOUT; i++) {
+        const int child = t->idx * FANOUT + i;
+        if (child < w->nb_tasks)
+            av_executor_execute(w->e, child & 1 ? NULL : &w->tasks[child].task);
+    }
+
+    workload_task_done(w);
+    return 0;
+}
+
+static int run_workload(int nb_tasks, int work, int thread_count, int64_t *elapsed)
+{
+    Workload w;
+    AVExecutor *e;
+    AVTaskCallbacks cb = {
+        .user_data          = &w,
+        .local_context_size = 1,
+        .priority_higher    = priority_higher,
+        .ready              = ready,
+        .run                = run,
+    };
+    int64_t start;
+
+    if (workload_init(&w, sizeof(Task), nb_tasks, work) < 0)
+        return -1;
+    for (int i = 0; i < nb_tasks; i++)
+        w.tasks[i].idx = i;
+
+    w.e = e = av_executor_alloc(&cb, thread_count);
+    if (!e) {
+        workload_uninit(&w, thread_count);
+        return -1;
+    }
+
+    start = av_gettime_relative();
+    for (int i = 1; i < nb_tasks; i += 2)
+        av_executor_execute(w.e, &w.tasks[i].task);
+    av_executor_execute(w.e, &w.tasks[0].task);
+    workload_wait(&w);
+    *elapsed = av_gettime_relative() - start;
+
+    av_executor_free(&e);
+    return workload_uninit(&w, thread_count);
+}
+
+int main(int argc, char **argv)
+{
+    return workload_main(argc, argv, 500);
+}
@@ -0,0 +1,186 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Task tree workload shared by the AVExecutor and FFExecutor tests. Task n
+ * has the children n * FANOUT + 1 to n * FANOUT + FANOUT; how they are
+ * submitted is up to the test.
+ *
+ * With arguments, the tests time the same workload for each given thread
+ * count:
+ *   executor <tasks> <work per task> <thread count>...
+ */
+
+#ifndef AVUTIL_TESTS_EXECUTOR_WORKLOAD_H
+#define AVUTIL_TESTS_EXECUTOR_WORKLOAD_H
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/error.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+#define FANOUT 4
+
+typedef struct Workload {
+    void *e;                    ///< the AVExecutor or FFExecutor
+    struct Task *tasks;
+    int nb_tasks;
+    int work;
+    atomic_int *runs;
+    atomic_int errors;          ///< tasks that ran before their parent
+
+    AVMutex lock;
+    AVCond cond;
+    int done;
+} Workload;
+
+static int parent(int idx)
+{
+    return (idx - 1) / FANOUT;
+}
+
+static int workload_init(Workload *w, size_t task_size, int nb_tasks, int work)
+{
+    memset(w, 0, sizeof(*w));
+    w->nb_tasks = nb_tasks;
+    w->work     = work;
+
+    w->tasks = av_calloc(nb_tasks, task_size);
+    w->runs  = av_calloc(nb_tasks, sizeof(*w->runs));
+    if (!w->tasks || !w->runs) {
+        av_freep(&w->tasks);
+        av_freep(&w->runs);
+        return AVERROR(ENOMEM);
+    }
+    for (int i = 0; i < nb_tasks; i++)
+        atomic_init(&w->runs[i], 0);
+    atomic_init(&w->errors, 0);
+
+    ff_mutex_init(&w->lock, NULL);
+    ff_cond_init(&w->cond, NULL);
+    return 0;
+}
+
+/**
+ * The body of task idx, to be called from the run() callback before the
+ * children are submitted.
+ */
+static void workload_run(Workload *w, int idx)
+{
+    volatile unsigned sum = idx;
+
+    for (int i = 0; i < w->work; i++)
+        sum = sum * 1664525 + 1013904223;
+
+    if (idx && !atomic_load(&w->runs[parent(idx)]))
+        atomic_fetch_add(&w->errors, 1);
+    atomic_fetch_add(&w->runs[idx], 1);
+}
+
+/**
+ * To be called at the end of the run() callback.
+ */
+static void workload_task_done(Workload *w)
+{
+    ff_mutex_lock(&w->lock);
+    if (++w->done == w->nb_tasks)
+        ff_cond_signal(&w->cond);
+    ff_mutex_unlock(&w->lock);
+}
+
+static void workload_wait(Workload *w)
+{
+    ff_mutex_lock(&w->lock);
+    while (w->done < w->nb_tasks)
+        ff_cond_wait(&w->cond, &w->lock);
+    ff_mutex_unlock(&w->lock);
+}
+
+/**
+ * Check that every task ran exactly once and after its parent, and free
+ * the workload.
+ *
+ * @return the number of errors found
+ */
+static int workload_uninit(Workload *w, int thread_count)
+{
+    int errors = 0;
+
+    if (atomic_load(&w->errors)) {
+        fprintf(stderr, "%d threads: %d tasks ran before their parent\n",
+                thread_count, atomic_load(&w->errors));
+        errors++;
+    }
+    for (int i = 0; i < w->nb_tasks; i++) {
+        if (atomic_load(&w->runs[i]) != 1) {
+            fprintf(stderr, "%d threads: task %d ran %d times\n",
+                    thread_count, i, atomic_load(&w->runs[i]));
+            errors++;
+        }
+    }
+
+    ff_cond_destroy(&w->cond);
+    ff_mutex_destroy(&w->lock);
+    av_freep(&w->tasks);
+    av_freep(&w->runs);
+    return errors;
+}
+
+static int run_workload(int nb_tasks, int work, int thread_count, int64_t *elapsed);
+
+static int workload_main(int argc, char **argv, int default_tasks)
+{
+    int errors = 0;
+    int64_t elapsed;
+
+    if (argc > 3) {
+        const int nb_tasks = atoi(argv[1]);
+        const int work     = atoi(argv[2]);
+        int64_t base       = 0;
+
+        for (int i = 3; i < argc; i++) {
+            const int thread_count = atoi(argv[i]);
+            errors += !!run_workload(nb_tasks, work, thread_count, &elapsed);
+            if (!base)
+                base = elapsed;
+            printf("%3d threads: %8"PRId64" us, %.2fx\n",
+                   thread_count, elapsed, (double)base / FFMAX(elapsed, 1));
+        }
+        return !!errors;
+    }
+
+    for (int thread_count = 0; thread_count <= 8; thread_count++) {
+        for (int iter = 0; iter < 20; iter++) {
+            int ret = run_workload(default_tasks, 100, thread_count, &elapsed);
+            if (ret) {
+                errors++;
+                break;
+            }
+        }
+    }
+    return !!errors;
+}
+
+#endif /* AVUTIL_TESTS_EXECUTOR_WORKLOAD_H */
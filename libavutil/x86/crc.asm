@@ -0,0 +1,139 @@
+;******************************************************************************
+;* CRC computation using carry-less multiplication
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pb_reverse: db 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+
+SECTION .text
+
+; Every CRC is handled as a 32-bit one, the polynomial of narrower CRCs being
+; multiplied by x^(32-bits). 128-bit blocks are folded into four accumulators
+; 64 bytes apart, which are then folded into one, and the result is reduced
+; to a 64-bit remainder that the caller finishes through the table.
+;
+; The constants at fold are x^n mod P for the two halves of a block folded
+; 512 and 128 bits ahead, followed by the two reduction steps. For the
+; bit-reflected CRCs they are bit-reflected 64-bit values, with n one lower
+; to account for the product of two reflected operands being one bit short.
+
+%macro LOAD 2 ; dst, src
+    movu            %1, %2
+%ifidn ENDIAN, be
+    pshufb          %1, m8
+%endif
+%endmacro
+
+; acc = (acc.lo * k.lo) ^ (acc.hi * k.hi) ^ data
+%macro FOLD 3 ; acc, k, data
+    pclmulqdq       m6, %1, %2, 0x00
+    pclmulqdq       %1, %2, 0x11
+    pxor            %1, m6
+    pxor            %1, %3
+%endmacro
+
+;-----------------------------------------------------------------------------
+; uint64_t ff_crc_{le,be}_clmul(const uint64_t *fold, uint32_t crc,
+;                               const uint8_t *buffer, size_t length);
+; length is a non-zero multiple of 16
+;-----------------------------------------------------------------------------
+%macro CRC 1
+%define ENDIAN %1
+cglobal crc_%1, 4, 4, 9, fold, crc, buf, len
+    mova            m4, [foldq]
+    mova            m5, [foldq + 16]
+    movd            m0, crcd
+%ifidn ENDIAN, be
+    mova            m8, [pb_reverse]
+    pslldq          m0, 12
+%endif
+    LOAD            m1, [bufq]
+    pxor            m0, m1
+    add           bufq, 16
+    sub           lenq, 16
+    cmp           lenq, 48
+    jb .fold1
+
+    LOAD            m1, [bufq]
+    LOAD            m2, [bufq + 16]
+    LOAD            m3, [bufq + 32]
+    add           bufq, 48
+    sub           lenq, 48
+    cmp           lenq, 64
+    jb .fold4_done
+.fold4:
+    LOAD            m7, [bufq]
+    FOLD            m0, m4, m7
+    LOAD            m7, [bufq + 16]
+    FOLD            m1, m4, m7
+    LOAD            m7, [bufq + 32]
+    FOLD            m2, m4, m7
+    LOAD            m7, [bufq + 48]
+    FOLD            m3, m4, m7
+    add           bufq, 64
+    sub           lenq, 64
+    cmp           lenq, 64
+    jae .fold4
+.fold4_done:
+    FOLD            m0, m5, m1
+    FOLD            m0, m5, m2
+    FOLD            m0, m5, m3
+
+.fold1:
+    test          lenq, lenq
+    jz .reduce
+.fold1_loop:
+    LOAD            m7, [bufq]
+    FOLD            m0, m5, m7
+    add           bufq, 16
+    sub           lenq, 16
+    jnz .fold1_loop
+
+.reduce:
+    mova            m4, [foldq + 32]
+%ifidn ENDIAN, le
+    ; multiply the high-order half by x^96 and the low-order one by x^32
+    pclmulqdq       m1, m0, m4, 0x00
+    psrldq          m0, 8
+    pslldq          m0, 4
+    pxor            m0, m1
+    ; fold the top 32 bits of the 96-bit result into the low 64
+    pclmulqdq       m1, m0, m4, 0x10
+    pxor            m0, m1
+    pextrq         rax, m0, 1
+%else
+    pclmulqdq       m1, m0, m4, 0x01
+    movq            m0, m0
+    pslldq          m0, 4
+    pxor            m0, m1
+    pclmulqdq       m1, m0, m4, 0x11
+    pxor            m0, m1
+    movq           rax, m0
+%endif
+    RET
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM clmul
+CRC le
+CRC be
+%endif
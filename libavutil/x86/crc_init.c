@@ -0,0 +1,130 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+
+#include "libavutil/attributes.h"
+#include "libavutil/bswap.h"
+#include "libavutil/crc_internal.h"
+#include "libavutil/x86/cpu.h"
+
+uint64_t ff_crc_le_clmul(const uint64_t *fold, uint32_t crc,
+                         const uint8_t *buffer, size_t length);
+uint64_t ff_crc_be_clmul(const uint64_t *fold, uint32_t crc,
+                         const uint8_t *buffer, size_t length);
+
+/* The SIMD functions only process whole 16-byte blocks and return the
+ * remainder as 64 bits; the top 32 bits of the remainder are reduced by
+ * running them through the table for 4 zero bytes. */
+static uint32_t crc_le_clmul(const FFCRCContext *c, uint32_t crc,
+                             const uint8_t *buffer, size_t length)
+{
+    const AVCRC *table = c->table;
+    const size_t blocks = length & ~(size_t)15;
+
+    if (blocks) {
+        uint64_t rem = ff_crc_le_clmul(c->fold, crc, buffer, blocks);
+
+        crc = rem;
+        for (int i = 0; i < 4; i++)
+            crc = table[crc & 0xFF] ^ (crc >> 8);
+        crc ^= rem >> 32;
+        buffer += blocks;
+        length -= blocks;
+    }
+    while (length--)
+        crc = table[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
+
+    return crc;
+}
+
+static uint32_t crc_be_clmul(const FFCRCContext *c, uint32_t crc,
+                             const uint8_t *buffer, size_t length)
+{
+    const AVCRC *table = c->table;
+    const size_t blocks = length & ~(size_t)15;
+
+    if (blocks) {
+        uint64_t rem = ff_crc_be_clmul(c->fold, av_bswap32(crc), buffer, blocks);
+
+        crc = av_bswap32(rem >> 32);
+        for (int i = 0; i < 4; i++)
+            crc = table[crc & 0xFF] ^ (crc >> 8);
+        crc ^= av_bswap32(rem);
+        buffer += blocks;
+        length -= blocks;
+    }
+    while (length--)
+        crc = table[((uint8_t) crc) ^ *buffer++] ^ (crc >> 8);
+
+    return crc;
+}
+
+static uint32_t reverse_bits(uint32_t x, int bits)
+{
+    uint32_t r = 0;
+
+    for (int i = 0; i < bits; i++)
+        r |= ((x >> i) & 1) << (bits - 1 - i);
+    return r;
+}
+
+/* x^n modulo x^32 + poly */
+static uint32_t xpow_mod(int n, uint32_t poly)
+{
+    uint32_t r = 1;
+
+    while (n--)
+        r = (r << 1) ^ (poly & -(r >> 31));
+    return r;
+}
+
+static uint64_t reflect(uint32_t x)
+{
+    return (uint64_t)reverse_bits(x, 32) << 32;
+}
+
+av_cold void ff_crc_init_x86(FFCRCContext *c, int le, int bits, uint32_t poly,
+                             int cpu_flags)
+{
+#if ARCH_X86_64
+    if (EXTERNAL_CLMUL(cpu_flags)) {
+        /* The polynomial as a 32-bit non-reflected one, see crc.asm. */
+        const uint32_t p = (le ? reverse_bits(poly, bits) : poly) << (32 - bits);
+
+        if (le) {
+            c->fold[0] = reflect(xpow_mod(64 + 512 - 1, p));
+            c->fold[1] = reflect(xpow_mod(     512 - 1, p));
+            c->fold[2] = reflect(xpow_mod(64 + 128 - 1, p));
+            c->fold[3] = reflect(xpow_mod(     128 - 1, p));
+            c->fold[4] = reflect(xpow_mod(96 - 1, p));
+            c->fold[5] = reflect(xpow_mod(64 - 1, p));
+            c->update  = crc_le_clmul;
+        } else {
+            c->fold[0] = xpow_mod(     512, p);
+            c->fold[1] = xpow_mod(64 + 512, p);
+            c->fold[2] = xpow_mod(     128, p);
+            c->fold[3] = xpow_mod(64 + 128, p);
+            c->fold[4] = xpow_mod(96, p);
+            c->fold[5] = xpow_mod(64, p);
+            c->update  = crc_be_clmul;
+        }
+        c->cpu_flags = AV_CPU_FLAG_CLMUL;
+    }
+#endif
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+#include <stdint.h>
+
+#include "libavfilter/af_amixdsp.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem_internal.h"
+#include "checkasm.h"
+
+#define LEN 512
+#define MAX_SRC 8
+
+#define randomize_buffer(buf, size)            \
+do {                                           \
+    double bmg[2], stddev = 10.0, mean = 0.0;  \
+                                               \
+    for (int n = 0; n < size; n += 2) {        \
+        av_bmg_get(&checkasm_lfg, bmg);        \
+        buf[n]     = bmg[0] * stddev + mean;   \
+        buf[n + 1] = bmg[1] * stddev + mean;   \
+    }                                          \
+} while (0)
+
+/* Each of the nb_src additions may round differently when the
+ * implementation fuses it with the multiplication, so the error is bounded
+ * relative to the magnitude of the products rather than of the result. */
+#define TEST_MIX(type, name, near_abs_eps, epsilon)                           \
+static void test_##name(AudioMixDSPContext *dsp)                              \
+{                                                                             \
+    LOCAL_ALIGNED_32(type, src_buf, [MAX_SRC * LEN]);                         \
+    LOCAL_ALIGNED_32(type, cdst, [LEN]);                                      \
+    LOCAL_ALIGNED_32(type, odst, [LEN]);                                      \
+    const type *src[MAX_SRC];                                                 \
+    type scale[MAX_SRC];                                                      \
+                                                                              \
+    declare_func(void, type *dst, const type **src, const type *scale,        \
+                 int nb_src, ptrdiff_t len);                                  \
+                                                                              \
+    randomize_buffer(src_buf, MAX_SRC * LEN);                                 \
+    for (int i = 0; i < MAX_SRC; i++) {                                       \
+        src[i]   = src_buf + i * LEN;                                         \
+        scale[i] = (rnd() & 0xFFFF) / 32768.0 - 1.0;                          \
+    }                                                                         \
+                                                                              \
+    if (check_func(dsp->name, #name)) {                                       \
+        for (int nb_src = 1; nb_src <= MAX_SRC; nb_src++) {                   \
+            const int len = 16 + (rnd() % (LEN / 16)) * 16;                   \
+                                                                              \
+            memset(cdst, 0, LEN * sizeof(type));                              \
+            memset(odst, 0, LEN * sizeof(type));                              \
+            call_ref(cdst, src, scale, nb_src, len);                          \
+            call_new(odst, src, scale, nb_src, len);                          \
+            for (int n = 0; n < LEN; n++) {                                   \
+                double t = 0.0;                                               \
+                for (int i = 0; i < nb_src; i++)                              \
+                    t += fabs(src[i][n] * scale[i]);                          \
+                t *= 2 * nb_src * epsilon;                                    \
+                if (!near_abs_eps(cdst[n], odst[n], t)) {                     \
+                    fprintf(stderr, "%d/%d: %- .12f - %- .12f = % .12g\n",    \
+                            nb_src, n, cdst[n], odst[n], cdst[n] - odst[n]);  \
+                    fail();                                                   \
+                    break;                                                    \
+                }                                                             \
+            }                                                                 \
+        }                                                                     \
+        bench_new(odst, src, scale, MAX_SRC, LEN);                            \
+    }                                                                         \
+                                                                              \
+    report(#name);                                                            \
+}
+
+TEST_MIX(float,  mix_float,  float_near_abs_eps,  FLT_EPSILON)
+TEST_MIX(double, mix_double, double_near_abs_eps, DBL_EPSILON)
+
+void checkasm_check_amix(void)
+{
+    AudioMixDSPContext dsp = { 0 };
+
+    ff_amix_init(&dsp);
+    test_mix_float(&dsp);
+    test_mix_double(&dsp);
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "checkasm.h"
+#include "libavutil/crc.h"
+#include "libavutil/crc_internal.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 4096
+
+static void check_crc(AVCRCId crc_id, const char *name, const uint8_t *buf)
+{
+    FFCRCContext c;
+
+    declare_func(uint32_t, const FFCRCContext *c, uint32_t crc,
+                 const uint8_t *buffer, size_t length);
+
+    av_crc_get_table(crc_id);
+    ff_crc_init(&c, crc_id, av_get_cpu_flags());
+
+    if (check_func(c.update, "crc_%s", name)) {
+        for (int i = 0; i < 64; i++) {
+            /* cover every tail length and both short and long buffers */
+            const int offset = rnd() % 16;
+            const int length = i < 32 ? rnd() % 160 : rnd() % (BUF_SIZE - 16);
+            const uint32_t crc = rnd();
+            uint32_t crc_ref, crc_new;
+
+            crc_ref = call_ref(&c, crc, buf + offset, length);
+            crc_new = call_new(&c, crc, buf + offset, length);
+            if (crc_ref != crc_new) {
+                fprintf(stderr, "crc_%s: length %d: %08x != %08x\n",
+                        name, length, (unsigned)crc_ref, (unsigned)crc_new);
+                fail();
+                break;
+            }
+        }
+        bench_new(&c, 0, buf, BUF_SIZE);
+    }
+}
+
+void checkasm_check_crc(void)
+{
+    static const struct {
+        AVCRCId id;
+        const char *name;
+    } crcs[] = {
+        { AV_CRC_8_ATM,      "8_atm"      },
+        { AV_CRC_8_EBU,      "8_ebu"      },
+        { AV_CRC_16_ANSI,    "16_ansi"    },
+        { AV_CRC_16_CCITT,   "16_ccitt"   },
+        { AV_CRC_24_IEEE,    "24_ieee"    },
+        { AV_CRC_32_IEEE,    "32_ieee"    },
+        { AV_CRC_32_IEEE_LE, "32_ieee_le" },
+        { AV_CRC_16_ANSI_LE, "16_ansi_le" },
+    };
+    LOCAL_ALIGNED_16(uint8_t, buf, [BUF_SIZE]);
+
+    for (int i = 0; i < BUF_SIZE; i++)
+        buf[i] = rnd();
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(crcs); i++)
+        check_crc(crcs[i].id, crcs[i].name, buf);
+    report("crc");
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/dnxhddsp.h"
+#include "libavutil/mem_internal.h"
+
+static void check_dequant_block(void)
+{
+    LOCAL_ALIGNED_32(int16_t, block,     [64]);
+    LOCAL_ALIGNED_32(int16_t, block_ref, [64]);
+    LOCAL_ALIGNED_32(int16_t, block_new, [64]);
+    LOCAL_ALIGNED_32(int32_t, scale,     [64]);
+    LOCAL_ALIGNED_32(int32_t, round,     [64]);
+    DNXHDDSPContext h;
+
+    declare_func(void, int16_t block[64], const int32_t scale[64],
+                 const int32_t round[64], int shift);
+
+    ff_dnxhddsp_init(&h);
+
+    for (int shift = 4; shift <= 6; shift += 2) {
+        if (!check_func(h.dequant_block, "dnxhd_dequant_block_shift%d", shift))
+            continue;
+
+        for (int iter = 0; iter < 16; iter++) {
+            int qscale = 1 + rnd() % (iter < 8 ? 64 : 2048);
+            int bias   = rnd() & 1 ? 32 : 8;
+
+            for (int i = 0; i < 64; i++) {
+                int weight = 32 + rnd() % 96;
+                int level  = rnd() % 3 ? 0 : 1 + (rnd() % 8319);
+
+                block[i] = rnd() & 1 ? -level : level;
+                scale[i] = qscale * weight;
+                round[i] = (scale[i] >> 1) + (weight != bias ? bias : 0);
+            }
+            memcpy(block_ref, block, 64 * sizeof(*block));
+            memcpy(block_new, block, 64 * sizeof(*block));
+            call_ref(block_ref, scale, round, shift);
+            call_new(block_new, scale, round, shift);
+            if (memcmp(block_ref, block_new, 64 * sizeof(*block)))
+                fail();
+        }
+        bench_new(block_new, scale, round, shift);
+    }
+}
+
+void checkasm_check_dnxhddsp(void)
+{
+    check_dequant_block();
+    report("dequant_block");
+}
@@ -74,6 +74,34 @@ static void check_predictor(void) {
     bench_new(dst_new, BUF_SIZE);
 }
 
+#define WAV_PAIRS 512
+
+static void check_wav_decode(void (*func)(uint16_t *row0, uint16_t *row1, ptrdiff_t n),
+                             const char *name)
+{
+    LOCAL_ALIGNED_32(uint16_t, src,     [4 * WAV_PAIRS]);
+    LOCAL_ALIGNED_32(uint16_t, dst_ref, [4 * WAV_PAIRS]);
+    LOCAL_ALIGNED_32(uint16_t, dst_new, [4 * WAV_PAIRS]);
+
+    declare_func(void, uint16_t *row0, uint16_t *row1, ptrdiff_t n);
+
+    if (!check_func(func, "%s", name))
+        return;
+
+    for (int n = 0; n <= WAV_PAIRS; n += WAV_PAIRS / 4 - 16) {
+        for (int i = 0; i < 4 * WAV_PAIRS; i += 2)
+            AV_WN32A(src + i, rnd());
+        memcpy(dst_ref, src, sizeof(*src) * 4 * WAV_PAIRS);
+        memcpy(dst_new, src, sizeof(*src) * 4 * WAV_PAIRS);
+        call_ref(dst_ref, dst_ref + 2 * WAV_PAIRS, n);
+        call_new(dst_new, dst_new + 2 * WAV_PAIRS, n);
+        if (memcmp(dst_ref, dst_new, sizeof(*src) * 4 * WAV_PAIRS))
+            fail();
+    }
+    memcpy(dst_new, src, sizeof(*src) * 4 * WAV_PAIRS);
+    bench_new(dst_new, dst_new + 2 * WAV_PAIRS, WAV_PAIRS);
+}
+
 void checkasm_check_exrdsp(void)
 {
     ExrDSPContext h;
@@ -89,4 +117,9 @@ void checkasm_check_exrdsp(void)
         check_predictor();
 
     report("predictor");
+
+    check_wav_decode(h.wav_decode14, "wav_decode14");
+    check_wav_decode(h.wav_decode16, "wav_decode16");
+
+    report("wav_decode");
 }
@@ -89,9 +89,55 @@ static void check_ict_float(void)
     bench_new(new0, new1, new2, BUF_SIZE);
 }
 
+#define LIFT_ROWS 67
+#define LIFT_SIZE (LIFT_ROWS * FF_DWT_STRIP)
+
+static void check_lift_float(void)
+{
+    LOCAL_ALIGNED_32(float, src, [LIFT_SIZE]);
+    LOCAL_ALIGNED_32(float, ref, [LIFT_SIZE]);
+    LOCAL_ALIGNED_32(float, new, [LIFT_SIZE]);
+    const float coef = -0.882911075530934f;
+    const int n = LIFT_ROWS / 2 - 1;
+
+    declare_func(void, float *p, float coef, int n);
+
+    for (int i = 0; i < LIFT_SIZE; i++)
+        src[i] = (float)rnd() / (UINT_MAX >> 5) - 16.0f;
+    memcpy(ref, src, sizeof(src[0]) * LIFT_SIZE);
+    memcpy(new, src, sizeof(src[0]) * LIFT_SIZE);
+    call_ref(ref + FF_DWT_STRIP, coef, n);
+    call_new(new + FF_DWT_STRIP, coef, n);
+    if (memcmp(ref, new, sizeof(src[0]) * LIFT_SIZE))
+        fail();
+    bench_new(new + FF_DWT_STRIP, coef, n);
+}
+
+static void check_lift53(void)
+{
+    LOCAL_ALIGNED_32(int32_t, src, [LIFT_SIZE]);
+    LOCAL_ALIGNED_32(int32_t, ref, [LIFT_SIZE]);
+    LOCAL_ALIGNED_32(int32_t, new, [LIFT_SIZE]);
+    const int n = LIFT_ROWS / 2 - 1;
+
+    declare_func(void, int32_t *p, int n);
+
+    for (int i = 0; i < LIFT_SIZE; i++)
+        src[i] = rnd();
+    memcpy(ref, src, sizeof(src[0]) * LIFT_SIZE);
+    memcpy(new, src, sizeof(src[0]) * LIFT_SIZE);
+    call_ref(ref + FF_DWT_STRIP, n);
+    call_new(new + FF_DWT_STRIP, n);
+    if (memcmp(ref, new, sizeof(src[0]) * LIFT_SIZE))
+        fail();
+    bench_new(new + FF_DWT_STRIP, n);
+}
+
 void checkasm_check_jpeg2000dsp(void)
 {
     Jpeg2000DSPContext h;
+    DWTContext dwt = { 0 };
+    int border[2][2] = { { 0, 64 }, { 0, 64 } };
 
     ff_jpeg2000dsp_init(&h);
 
@@ -101,4 +147,16 @@ void checkasm_check_jpeg2000dsp(void)
         check_ict_float();
 
     report("mct_decode");
+
+    if (ff_jpeg2000_dwt_init(&dwt, border, 1, FF_DWT97) < 0)
+        return;
+    if (check_func(dwt.lift_float, "jpeg2000_lift_float"))
+        check_lift_float();
+    if (check_func(dwt.lift53_even, "jpeg2000_lift53_even"))
+        check_lift53();
+    if (check_func(dwt.lift53_odd, "jpeg2000_lift53_odd"))
+        check_lift53();
+    ff_dwt_destroy(&dwt);
+
+    report("dwt_lift");
 }
@@ -0,0 +1,85 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/pngencdsp.h"
+
+#include "checkasm.h"
+
+#define randomize_buffers(buf, size)      \
+    do {                                  \
+        int j;                            \
+        for (j = 0; j < size; j += 4)     \
+            AV_WN32(buf + j, rnd());      \
+    } while (0)
+
+#define MAX_BPP   8
+#define MAX_WIDTH 256
+
+static const int widths[] = { 1, 7, 8, 15, 16, 17, 33, 250 };
+static const int bpps[]   = { 1, 2, 3, 4, 6, 8 };
+
+static void check_sub_pred(void (*func)(uint8_t *dst, const uint8_t *src,
+                                        const uint8_t *top, int w, int bpp),
+                           const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, src, [MAX_BPP + MAX_WIDTH]);
+    LOCAL_ALIGNED_16(uint8_t, top, [MAX_BPP + MAX_WIDTH]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [MAX_WIDTH]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [MAX_WIDTH]);
+
+    declare_func(void, uint8_t *dst, const uint8_t *src,
+                 const uint8_t *top, int w, int bpp);
+
+    randomize_buffers(src, MAX_BPP + MAX_WIDTH);
+    randomize_buffers(top, MAX_BPP + MAX_WIDTH);
+
+    for (int b = 0; b < FF_ARRAY_ELEMS(bpps); b++) {
+        const int bpp = bpps[b];
+
+        if (check_func(func, "%s_%d", name, bpp)) {
+            for (int i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+                const int w = widths[i];
+
+                memset(dst0, 0, MAX_WIDTH);
+                memset(dst1, 0, MAX_WIDTH);
+                call_ref(dst0, src + MAX_BPP, top + MAX_BPP, w, bpp);
+                call_new(dst1, src + MAX_BPP, top + MAX_BPP, w, bpp);
+                if (memcmp(dst0, dst1, MAX_WIDTH))
+                    fail();
+            }
+            bench_new(dst1, src + MAX_BPP, top + MAX_BPP, 250, bpp);
+        }
+    }
+}
+
+void checkasm_check_pngencdsp(void)
+{
+    PNGEncDSPContext c;
+    ff_pngencdsp_init(&c);
+
+    check_sub_pred(c.sub_avg_prediction, "sub_avg_prediction");
+    report("sub_avg_prediction");
+
+    check_sub_pred(c.sub_paeth_prediction, "sub_paeth_prediction");
+    report("sub_paeth_prediction");
+}
@@ -652,6 +652,56 @@ concat(){
     fi
 }
 
+adaptive_threads(){
+    srcfile=$(target_path $1)
+    input="concat:"
+    # small pictures are decoded with one thread, large ones with several
+    for size in 176x144 704x576 176x144; do
+        encfile="${outdir}/${test}.${size}.m4v"
+        cleanfiles="$cleanfiles $encfile"
+        ffmpeg -f rawvideo -s 352x288 -pix_fmt yuv420p -i $srcfile -frames:v 20 \
+            -vf scale=$size -sws_flags +accurate_rnd+bitexact -flags +bitexact \
+            -c:v mpeg4 -qscale:v 10 -bf 2 -threads 1 -f m4v -y $(target_path $encfile) || return
+        input="${input}$(target_path $encfile)|"
+    done
+    logfile="${outdir}/${test}.log"
+    cleanfiles="$cleanfiles $logfile"
+    run ffmpeg${PROGSUF}${EXECSUF} -nostdin -nostats -v debug -cpuflags $cpuflags \
+        -threads 8 -thread_type frame -flags2 +adaptive_threads -debug thread_ops \
+        -flags +bitexact -idct simple -i "${input%|}" -noautoscale \
+        -bitexact -f framecrc - 2>$logfile || return
+    # the thread counts chosen depend on timing, only check that the large
+    # pictures got more than one thread and the small ones went back to one
+    sed -n 's/.*Using \([0-9]*\) frame threads.*/\1/p' $logfile |
+        awk '$1 > max { max = $1 } { last = $1 }
+             END { print "frame threads:", (max > 1 ? "grew" : "did not grow") ",",
+                         (last == 1 ? "shrank to 1" : "ended at " last) }'
+}
+
+group_audio_dec(){
+    srcfile=$(target_path $1)
+    encfile="${outdir}/${test}.mkv"
+    sepfile="${outdir}/${test}.separate"
+    grpfile="${outdir}/${test}.grouped"
+    cleanfiles="$cleanfiles $encfile $sepfile $grpfile"
+    # one second of audio, as four tracks in different codecs
+    ffmpeg -auto_conversion_filters -i $srcfile -t 1 -map 0:a -map 0:a -map 0:a -map 0:a \
+        -c:a:0 pcm_s16le -c:a:1 flac -c:a:2 pcm_s24le -c:a:3 adpcm_ima_wav \
+        -fflags +bitexact -flags +bitexact -f matroska -y $(target_path $encfile) || return
+    # decoding on one thread must give the same frames as on one thread per stream
+    for opts in "" "-ss 0.5" "-stream_loop 1"; do
+        echo "input options: ${opts:-none}"
+        for group in "" "-group_audio_dec"; do
+            test -z "$group" && decfile=$sepfile || decfile=$grpfile
+            run ffmpeg${PROGSUF}${EXECSUF} -nostdin -nostats -cpuflags $cpuflags \
+                $opts $group -i $(target_path $encfile) -map 0 \
+                -bitexact -f framemd5 -y $(target_path $decfile) || return
+        done
+        diff -u $sepfile $grpfile || return
+        cat $grpfile
+    done
+}
+
 venc_data(){
     file=$1
     stream=$2
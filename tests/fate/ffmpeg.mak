@@ -96,6 +96,17 @@ FATE_FFMPEG-$(call FILTERDEMDEC, AMIX ARESAMPLE SINE, RAWVIDEO, \
 fate-shortest: tests/data/vsynth1.yuv
 fate-shortest: CMD = framecrc -auto_conversion_filters -f lavfi -i "sine=3000:d=10" -f lavfi -i "sine=1000:d=1" -sws_flags +accurate_rnd+bitexact -fflags +bitexact -flags +bitexact -idct simple -f rawvideo -s 352x288 -pix_fmt yuv420p -i $(TARGET_PATH)/tests/data/vsynth1.yuv -filter_complex "[0:a:0][1:a:0]amix=inputs=2[audio]" -map 2:v:0 -map "[audio]" -sws_flags +accurate_rnd+bitexact -fflags +bitexact -flags +bitexact -idct simple -dct fastint -qscale 10 -threads 1 -c:v mpeg4 -c:a ac3_fixed -shortest
 
+# Decode several audio streams on one thread with -group_audio_dec and check
+# the frames match those decoded with one thread per stream.
+FATE_FFMPEG-$(call ALLYES, WAV_DEMUXER PCM_S16LE_DECODER MATROSKA_MUXER \
+                           MATROSKA_DEMUXER PCM_S16LE_ENCODER FLAC_ENCODER  \
+                           FLAC_DECODER PCM_S24LE_ENCODER PCM_S24LE_DECODER \
+                           ADPCM_IMA_WAV_ENCODER ADPCM_IMA_WAV_DECODER      \
+                           ARESAMPLE_FILTER FRAMEMD5_MUXER FILE_PROTOCOL)   \
+                           += fate-ffmpeg-group-audio-dec
+fate-ffmpeg-group-audio-dec: tests/data/asynth-44100-2.wav
+fate-ffmpeg-group-audio-dec: CMD = group_audio_dec tests/data/asynth-44100-2.wav
+
 # test interleaving video with a sparse subtitle stream
 FATE_SAMPLES_FFMPEG-$(call ALLYES, COLOR_FILTER, VOBSUB_DEMUXER, MATROSKA_DEMUXER,, \
                            RAWVIDEO_ENCODER, MATROSKA_MUXER, FRAMECRC_MUXER) += fate-shortest-sub
@@ -740,6 +740,11 @@ FATE_METADATA_FILTER-$(call ALLYES, $(SIGNALSTATS_DEPS)) += fate-filter-metadata
 fate-filter-metadata-signalstats-yuv420p: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;color=white:duration=1:r=1,signalstats"
 fate-filter-metadata-signalstats-yuv420p10: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;color=white:duration=1:r=1,format=yuv420p10le,signalstats"
 
+QCDETECT_DEPS = LAVFI_INDEV COLOR_FILTER TESTSRC_FILTER PAD_FILTER CONCAT_FILTER \
+                FORMAT_FILTER SCALE_FILTER QCDETECT_FILTER
+FATE_METADATA_FILTER-$(call ALLYES, $(QCDETECT_DEPS)) += fate-filter-metadata-qcdetect
+fate-filter-metadata-qcdetect: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;color=black:s=64x48:r=5:d=3,format=yuv420p[a];testsrc=s=48x32:r=5:d=2,pad=64:48:8:8,format=yuv420p[b];[a][b]concat,qcdetect=black_min_duration=1:freeze_duration=1"
+
 SILENCEDETECT_DEPS = LAVFI_INDEV FILE_PROTOCOL AMOVIE_FILTER TTA_DEMUXER TTA_DECODER SILENCEDETECT_FILTER
 FATE_METADATA_FILTER-$(call ALLYES, $(SILENCEDETECT_DEPS)) += fate-filter-metadata-silencedetect
 fate-filter-metadata-silencedetect: SRC = $(TARGET_SAMPLES)/lossless-audio/inside.tta
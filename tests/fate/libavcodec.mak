@@ -80,11 +80,25 @@ fate-mpeg12framerate: libavcodec/tests/mpeg12framerate$(EXESUF)
 fate-mpeg12framerate: CMD = run libavcodec/tests/mpeg12framerate$(EXESUF)
 fate-mpeg12framerate: REF = /dev/null
 
+FATE_LIBAVCODEC-$(CONFIG_PRORES_DECODER) += fate-prores-ac-lut
+fate-prores-ac-lut: libavcodec/tests/proresdec$(EXESUF)
+fate-prores-ac-lut: CMD = run libavcodec/tests/proresdec$(EXESUF)
+fate-prores-ac-lut: CMP = null
+
+FATE_LIBAVCODEC-$(call ALLYES, FFV1_ENCODER FFV1_DECODER) += fate-libavcodec-ffv1
+fate-libavcodec-ffv1: libavcodec/tests/ffv1$(EXESUF)
+fate-libavcodec-ffv1: CMD = run libavcodec/tests/ffv1$(EXESUF)
+
 FATE_LIBAVCODEC-$(CONFIG_RANGECODER) += fate-rangecoder
 fate-rangecoder: libavcodec/tests/rangecoder$(EXESUF)
 fate-rangecoder: CMD = run libavcodec/tests/rangecoder$(EXESUF)
 fate-rangecoder: CMP = null
 
+FATE_LIBAVCODEC-yes += fate-executor
+fate-executor: libavcodec/tests/executor$(EXESUF)
+fate-executor: CMD = run libavcodec/tests/executor$(EXESUF)
+fate-executor: CMP = null
+
 FATE_LIBAVCODEC-yes += fate-mathops
 fate-mathops: libavcodec/tests/mathops$(EXESUF)
 fate-mathops: CMD = run libavcodec/tests/mathops$(EXESUF)
@@ -104,6 +118,20 @@ fate-libavcodec-huffman: libavcodec/tests/mjpegenc_huffman$(EXESUF)
 fate-libavcodec-huffman: CMD = run libavcodec/tests/mjpegenc_huffman$(EXESUF)
 fate-libavcodec-huffman: CMP = null
 
+FATE_LIBAVCODEC-$(CONFIG_HEVC_DECODER) += fate-libavcodec-hevc-picture-hash
+fate-libavcodec-hevc-picture-hash: libavcodec/tests/hevc_picture_hash$(EXESUF)
+fate-libavcodec-hevc-picture-hash: CMD = run libavcodec/tests/hevc_picture_hash$(EXESUF)
+fate-libavcodec-hevc-picture-hash: CMP = null
+
+FATE_LIBAVCODEC-$(CONFIG_MPEG2VIDEO_DECODER) += fate-libavcodec-mpeg2-fields
+fate-libavcodec-mpeg2-fields: libavcodec/tests/mpeg2_fields$(EXESUF)
+fate-libavcodec-mpeg2-fields: CMD = run libavcodec/tests/mpeg2_fields$(EXESUF)
+
+FATE_LIBAVCODEC-$(CONFIG_RAWVIDEO_DECODER) += fate-libavcodec-side-data-pool
+fate-libavcodec-side-data-pool: libavcodec/tests/side_data_pool$(EXESUF)
+fate-libavcodec-side-data-pool: CMD = run libavcodec/tests/side_data_pool$(EXESUF)
+fate-libavcodec-side-data-pool: CMP = null
+
 FATE_LIBAVCODEC-yes += fate-libavcodec-htmlsubtitles
 fate-libavcodec-htmlsubtitles: libavcodec/tests/htmlsubtitles$(EXESUF)
 fate-libavcodec-htmlsubtitles: CMD = run libavcodec/tests/htmlsubtitles$(EXESUF)
@@ -79,6 +79,11 @@ fate-encryption-info: libavutil/tests/encryption_info$(EXESUF)
 fate-encryption-info: CMD = run libavutil/tests/encryption_info$(EXESUF)
 fate-encryption-info: CMP = null
 
+FATE_LIBAVUTIL += fate-avutil-executor
+fate-avutil-executor: libavutil/tests/executor$(EXESUF)
+fate-avutil-executor: CMD = run libavutil/tests/executor$(EXESUF)
+fate-avutil-executor: CMP = null
+
 FATE_LIBAVUTIL += fate-eval
 fate-eval: libavutil/tests/eval$(EXESUF)
 fate-eval: CMD = run libavutil/tests/eval$(EXESUF)
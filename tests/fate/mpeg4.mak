@@ -22,5 +22,13 @@ fate-m4v:     CMD = framecrc -flags +bitexact -idct simple -i $(TARGET_SAMPLES)/
 FATE_MPEG4-$(call FRAMECRC, M4V, MPEG4, FPS_FILTER) += fate-m4v-cfr
 fate-m4v-cfr: CMD = framecrc -flags +bitexact -idct simple -i $(TARGET_SAMPLES)/mpeg4/demo.m4v -vf fps=5
 
+FATE_MPEG4_FFMPEG-$(call ALLYES, RAWVIDEO_DEMUXER RAWVIDEO_DECODER SCALE_FILTER \
+                                MPEG4_ENCODER M4V_MUXER FILE_PROTOCOL CONCAT_PROTOCOL \
+                                M4V_DEMUXER MPEG4_DECODER RAWVIDEO_ENCODER \
+                                FRAMECRC_MUXER PIPE_PROTOCOL) += fate-mpeg4-adaptive-threads
+fate-mpeg4-adaptive-threads: tests/data/vsynth1.yuv
+fate-mpeg4-adaptive-threads: CMD = adaptive_threads tests/data/vsynth1.yuv
+
 FATE_SAMPLES_AVCONV += $(FATE_MPEG4-yes)
-fate-mpeg4: $(FATE_MPEG4-yes)
+FATE_FFMPEG += $(FATE_MPEG4_FFMPEG-yes)
+fate-mpeg4: $(FATE_MPEG4-yes) $(FATE_MPEG4_FFMPEG-yes)
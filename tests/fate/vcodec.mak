@@ -252,6 +252,9 @@ fate-vsynth%-mpeg1b:             FMT     = mpeg1video
 
 FATE_MPEG2 := mpeg2                                                     \
               $(if $(CONFIG_SCALE_FILTER), mpeg2-422)                   \
+             mpeg2-bscenecut                                            \
+             mpeg2-bstrategy1                                           \
+             mpeg2-bstrategy2                                           \
              mpeg2-idct-int                                             \
              mpeg2-ilace                                                \
              mpeg2-ivlc-qprd                                            \
@@ -272,6 +275,9 @@ fate-vsynth%-mpeg2-422:          ENCOPTS = -b:v 1000k                   \
                                            -intra_vlc 1                 \
                                            -mbd rd                      \
                                            -pix_fmt yuv422p
+fate-vsynth%-mpeg2-bscenecut:    ENCOPTS = -qscale 10 -bf 3 -b_scenecut 1
+fate-vsynth%-mpeg2-bstrategy1:   ENCOPTS = -qscale 10 -bf 3 -b_strategy 1
+fate-vsynth%-mpeg2-bstrategy2:   ENCOPTS = -qscale 10 -bf 3 -b_strategy 2
 fate-vsynth%-mpeg2-idct-int:     ENCOPTS = -qscale 10 -idct int -dct int
 fate-vsynth%-mpeg2-ilace:        ENCOPTS = -qscale 10 -flags +ildct+ilme
 fate-vsynth%-mpeg2-ivlc-qprd:    ENCOPTS = -b:v 500k                    \
@@ -346,8 +352,10 @@ fate-vsynth%-msmpeg4v2:          ENCOPTS = -qscale 10
 FATE_VCODEC_SCALE-$(call ENCDEC, MSRLE, AVI) += msrle
 fate-vsynth%-msrle:              CODEC   = msrle
 
-FATE_VCODEC_SCALE-$(call ENCDEC, PNG, AVI) += mpng
+FATE_VCODEC_SCALE-$(call ENCDEC, PNG, AVI) += mpng mpng-slice
 fate-vsynth%-mpng:               CODEC   = png
+fate-vsynth%-mpng-slice:         CODEC   = png
+fate-vsynth%-mpng-slice:         ENCOPTS = -pred mixed -thread_type slice -threads 4
 
 FATE_VCODEC_SCALE-$(call ENCDEC, MSVIDEO1, AVI) += msvideo1
 
@@ -492,7 +500,12 @@ FATE_VCODEC += $(FATE_VCODEC-yes)
 FATE_VCODEC := $(if $(call ENCDEC, RAWVIDEO, RAWVIDEO),$(FATE_VCODEC))
 FATE_VSYNTH1 = $(FATE_VCODEC:%=fate-vsynth1-%)
 FATE_VSYNTH2 = $(FATE_VCODEC:%=fate-vsynth2-%)
-FATE_VSYNTH_LENA = $(FATE_VCODEC:%=fate-vsynth_lena-%)
+# Threading variants whose output only differs from the base test in the
+# container bytes
+LENA_OFF     = mpng-slice
+# B-frame decision tests, there are no vsynth_lena references for them
+LENA_OFF    += mpeg2-bscenecut mpeg2-bstrategy1 mpeg2-bstrategy2
+FATE_VSYNTH_LENA = $(filter-out $(LENA_OFF:%=fate-vsynth_lena-%),$(FATE_VCODEC:%=fate-vsynth_lena-%))
 # Redundant tests because they just resize the input
 RESIZE_OFF   = dnxhd-720p dnxhd-720p-rd dnxhd-720p-10bit dnxhd-1080i \
                dv dv-411 dv-50 avui snow snow-hpel snow-ll vc2-420p \
@@ -0,0 +1,591 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Decoder throughput benchmark, meant for HEVC but usable with any video
+ * decoder. All packets are read into memory first, so only decoding is
+ * timed. Every combination of the given thread types and counts is run and
+ * the results are printed as JSON.
+ *
+ *   hevc_bench [options] <input file>
+ *   hevc_bench [options] -g <width>x<height>
+ *
+ *   -t <types>    thread types, comma separated: frame, slice, frame+slice
+ *                 (default: all of them)
+ *   -n <counts>   thread counts, comma separated (default: 1,2,4,8)
+ *   -r <runs>     runs per configuration, the median is reported (default: 3)
+ *   -f <frames>   number of packets to read or frames to generate
+ *                 (default: all, 120 with -g)
+ *   -s <index>    stream index in the input file (default: 0)
+ *   -g <size>     instead of reading a file, encode a synthetic stream with
+ *                 the first available HEVC encoder
+ *   -e <options>  encoder options for -g, as key=value:key=value
+ *   -o <options>  decoder options, as key=value:key=value
+ *
+ * The hevc-conformance streams of the FATE suite make good inputs.
+ * peak_rss_kb is the peak resident set size while decoding that one
+ * configuration, including the packets held in memory. The peak is reset
+ * between configurations through /proc/self/clear_refs; where that is not
+ * available it falls back to the peak of the whole process so far, so run
+ * a single configuration per invocation there.
+ */
+
+#include "config.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h> /* for getopt */
+#endif
+#if !HAVE_GETOPT
+#include "compat/getopt.c"
+#endif
+
+#include "decode_simple.h"
+
+#include "libavutil/avstring.h"
+#include "libavutil/common.h"
+#include "libavutil/dict.h"
+#include "libavutil/error.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mem.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/time.h"
+
+#include "libavcodec/avcodec.h"
+
+#define MAX_COUNTS 32
+
+typedef struct Stream {
+    AVCodecParameters *par;
+    AVPacket         **pkts;
+    int             nb_pkts;
+} Stream;
+
+typedef struct RunResult {
+    int     frames;
+    int64_t time;
+    /* 50th, 90th and 99th percentile and maximum, in microseconds */
+    int64_t latency[4];
+} RunResult;
+
+static int add_packet(Stream *st, AVPacket *pkt)
+{
+    AVPacket **pkts = av_realloc_array(st->pkts, st->nb_pkts + 1, sizeof(*pkts));
+    if (!pkts)
+        return AVERROR(ENOMEM);
+    st->pkts = pkts;
+
+    pkts[st->nb_pkts] = av_packet_alloc();
+    if (!pkts[st->nb_pkts])
+        return AVERROR(ENOMEM);
+    av_packet_move_ref(pkts[st->nb_pkts], pkt);
+
+    /* passed on to the frame with AV_CODEC_FLAG_COPY_OPAQUE */
+    pkts[st->nb_pkts]->opaque = (void *)(intptr_t)(st->nb_pkts + 1);
+    st->nb_pkts++;
+    return 0;
+}
+
+static int load_file(Stream *st, const char *filename, int stream_idx,
+                     int max_packets)
+{
+    DecodeContext dc;
+    int ret;
+
+    ret = ds_open(&dc, filename, stream_idx);
+    if (ret < 0) {
+        fprintf(stderr, "Error opening the file\n");
+        goto end;
+    }
+
+    /* elementary streams carry no dimensions until probed */
+    ret = avformat_find_stream_info(dc.demuxer, NULL);
+    if (ret < 0)
+        goto end;
+
+    ret = avcodec_parameters_copy(st->par, dc.stream->codecpar);
+    if (ret < 0)
+        goto end;
+
+    while (!max_packets || st->nb_pkts < max_packets) {
+        ret = av_read_frame(dc.demuxer, dc.pkt);
+        if (ret < 0)
+            break;
+        if (dc.pkt->stream_index != dc.stream->index) {
+            av_packet_unref(dc.pkt);
+            continue;
+        }
+
+        ret = add_packet(st, dc.pkt);
+        if (ret < 0)
+            goto end;
+    }
+    ret = ret == AVERROR_EOF ? 0 : ret;
+
+end:
+    ds_free(&dc);
+    return ret;
+}
+
+/* A textured pattern moving diagonally, with some noise on top so that the
+ * encoder has to code residuals everywhere. */
+static void fill_frame(AVFrame *frame, int n)
+{
+    AVLFG lfg;
+
+    av_lfg_init(&lfg, n);
+
+    for (int y = 0; y < frame->height; y++) {
+        uint8_t *line = frame->data[0] + y * frame->linesize[0];
+
+        for (int x = 0; x < frame->width; x++) {
+            int u = x + 2 * n, v = y + n;
+            int checker = ((u >> 4) ^ (v >> 4)) & 1;
+
+            line[x] = (u * 3 + v * 2 + checker * 64 + (av_lfg_get(&lfg) & 15)) & 0xFF;
+        }
+    }
+
+    for (int y = 0; y < frame->height / 2; y++) {
+        uint8_t *cb = frame->data[1] + y * frame->linesize[1];
+        uint8_t *cr = frame->data[2] + y * frame->linesize[2];
+
+        for (int x = 0; x < frame->width / 2; x++) {
+            cb[x] = (x * 2 + n) & 0xFF;
+            cr[x] = (y * 2 - n) & 0xFF;
+        }
+    }
+}
+
+static int generate(Stream *st, const char *size, int nb_frames,
+                    const char *enc_opts)
+{
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_HEVC);
+    AVCodecContext *enc = NULL;
+    AVDictionary *opts = NULL;
+    AVFrame *frame = NULL;
+    AVPacket *pkt = NULL;
+    int width, height;
+    int ret;
+
+    if (!codec) {
+        fprintf(stderr, "No HEVC encoder available\n");
+        return AVERROR_ENCODER_NOT_FOUND;
+    }
+
+    ret = av_parse_video_size(&width, &height, size);
+    if (ret < 0) {
+        fprintf(stderr, "Invalid size: %s\n", size);
+        return ret;
+    }
+
+    enc   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    pkt   = av_packet_alloc();
+    if (!enc || !frame || !pkt) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    enc->width     = width;
+    enc->height    = height;
+    enc->pix_fmt   = AV_PIX_FMT_YUV420P;
+    enc->time_base = (AVRational){ 1, 25 };
+    enc->framerate = (AVRational){ 25, 1 };
+
+    if (enc_opts) {
+        ret = av_dict_parse_string(&opts, enc_opts, "=", ":", 0);
+        if (ret < 0)
+            goto end;
+    }
+
+    ret = avcodec_open2(enc, codec, &opts);
+    if (ret < 0) {
+        fprintf(stderr, "Error opening the %s encoder\n", codec->name);
+        goto end;
+    }
+
+    frame->width  = width;
+    frame->height = height;
+    frame->format = enc->pix_fmt;
+    ret = av_frame_get_buffer(frame, 0);
+    if (ret < 0)
+        goto end;
+
+    for (int i = 0; i <= nb_frames; i++) {
+        if (i < nb_frames) {
+            ret = av_frame_make_writable(frame);
+            if (ret < 0)
+                goto end;
+            fill_frame(frame, i);
+            frame->pts = i;
+        }
+
+        ret = avcodec_send_frame(enc, i < nb_frames ? frame : NULL);
+        if (ret < 0)
+            goto end;
+
+        while ((ret = avcodec_receive_packet(enc, pkt)) >= 0) {
+            ret = add_packet(st, pkt);
+            if (ret < 0)
+                goto end;
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+
+    ret = avcodec_parameters_from_context(st->par, enc);
+    fprintf(stderr, "Generated %d packets with %s\n", st->nb_pkts, codec->name);
+
+end:
+    av_dict_free(&opts);
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&enc);
+    return ret;
+}
+
+static int cmp_int64(const void *a, const void *b)
+{
+    return FFDIFFSIGN(*(const int64_t *)a, *(const int64_t *)b);
+}
+
+static int cmp_time(const void *a, const void *b)
+{
+    return FFDIFFSIGN(((const RunResult *)a)->time, ((const RunResult *)b)->time);
+}
+
+static int run(const Stream *st, int thread_type, int thread_count,
+               const AVDictionary *dec_opts, RunResult *r)
+{
+    const AVCodec *codec = avcodec_find_decoder(st->par->codec_id);
+    AVCodecContext *dec = NULL;
+    AVDictionary *opts = NULL;
+    AVFrame *frame = NULL;
+    int64_t *sent = NULL, *latency = NULL;
+    int nb_latency = 0;
+    int64_t start;
+    int ret;
+
+    memset(r, 0, sizeof(*r));
+
+    if (!codec)
+        return AVERROR_DECODER_NOT_FOUND;
+
+    dec     = avcodec_alloc_context3(codec);
+    frame   = av_frame_alloc();
+    sent    = av_calloc(st->nb_pkts, sizeof(*sent));
+    latency = av_calloc(st->nb_pkts, sizeof(*latency));
+    if (!dec || !frame || !sent || !latency) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ret = avcodec_parameters_to_context(dec, st->par);
+    if (ret < 0)
+        goto end;
+
+    dec->thread_type  = thread_type;
+    dec->thread_count = thread_count;
+    dec->flags       |= AV_CODEC_FLAG_COPY_OPAQUE;
+
+    ret = av_dict_copy(&opts, dec_opts, 0);
+    if (ret < 0)
+        goto end;
+
+    ret = avcodec_open2(dec, codec, &opts);
+    if (ret < 0)
+        goto end;
+
+    start = av_gettime_relative();
+    for (int i = 0; i <= st->nb_pkts; i++) {
+        if (i < st->nb_pkts)
+            sent[i] = av_gettime_relative();
+
+        ret = avcodec_send_packet(dec, i < st->nb_pkts ? st->pkts[i] : NULL);
+        if (ret < 0)
+            goto end;
+
+        while ((ret = avcodec_receive_frame(dec, frame)) >= 0) {
+            intptr_t idx = (intptr_t)frame->opaque;
+
+            if (idx > 0 && idx <= st->nb_pkts && nb_latency < st->nb_pkts)
+                latency[nb_latency++] = av_gettime_relative() - sent[idx - 1];
+            r->frames++;
+            av_frame_unref(frame);
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+    r->time = av_gettime_relative() - start;
+    ret = 0;
+
+    if (nb_latency) {
+        qsort(latency, nb_latency, sizeof(*latency), cmp_int64);
+        r->latency[0] = latency[(nb_latency - 1) * 50 / 100];
+        r->latency[1] = latency[(nb_latency - 1) * 90 / 100];
+        r->latency[2] = latency[(nb_latency - 1) * 99 / 100];
+        r->latency[3] = latency[nb_latency - 1];
+    }
+
+end:
+    av_dict_free(&opts);
+    av_freep(&sent);
+    av_freep(&latency);
+    av_frame_free(&frame);
+    avcodec_free_context(&dec);
+    return ret;
+}
+
+/* Make the next peak_rss_kb() start from the current resident set size;
+ * needs Linux 4.0 or later. */
+static void reset_peak_rss(void)
+{
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+
+    if (f) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+static int64_t peak_rss_kb(void)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    char line[256];
+    int64_t kb = -1;
+#if HAVE_GETRUSAGE
+    struct rusage rusage;
+#endif
+
+    /* unlike ru_maxrss, VmHWM follows reset_peak_rss() */
+    if (f) {
+        while (fgets(line, sizeof(line), f))
+            if (sscanf(line, "VmHWM: %"SCNd64, &kb) == 1)
+                break;
+        fclose(f);
+        if (kb >= 0)
+            return kb;
+    }
+
+#if HAVE_GETRUSAGE
+    if (!getrusage(RUSAGE_SELF, &rusage))
+        return rusage.ru_maxrss;
+#endif
+    return -1;
+}
+
+static void print_json_string(const char *s)
+{
+    putchar('"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            printf("\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            printf("\\u%04x", *s);
+        else
+            putchar(*s);
+    }
+    putchar('"');
+}
+
+static int parse_counts(int *counts, const char *arg)
+{
+    int nb = 0;
+
+    while (*arg) {
+        char *end;
+        long n = strtol(arg, &end, 10);
+
+        if (end == arg || n < 0 || n > INT_MAX || nb == MAX_COUNTS ||
+            (*end && *end != ','))
+            return AVERROR(EINVAL);
+        counts[nb++] = n;
+        arg = *end ? end + 1 : end;
+    }
+    return nb ? nb : AVERROR(EINVAL);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        int         type;
+    } thread_types[] = {
+        { "frame",       FF_THREAD_FRAME                   },
+        { "slice",       FF_THREAD_SLICE                   },
+        { "frame+slice", FF_THREAD_FRAME | FF_THREAD_SLICE },
+    };
+    unsigned types = (1 << FF_ARRAY_ELEMS(thread_types)) - 1;
+    int counts[MAX_COUNTS] = { 1, 2, 4, 8 };
+    int nb_counts = 4;
+    int runs = 3, max_frames = 0, stream_idx = 0;
+    const char *gen_size = NULL, *enc_opts = NULL, *input;
+    AVDictionary *dec_opts = NULL;
+    RunResult *results = NULL;
+    Stream st = { 0 };
+    int first = 1;
+    int ret, opt;
+
+    while ((opt = getopt(argc, argv, "t:n:r:f:s:g:e:o:h")) != -1) {
+        switch (opt) {
+        case 't': {
+            char *list = av_strdup(optarg), *saveptr = NULL, *tok;
+
+            if (!list)
+                return 1;
+            types = 0;
+            for (tok = av_strtok(list, ",", &saveptr); tok;
+                 tok = av_strtok(NULL, ",", &saveptr)) {
+                int i;
+                for (i = 0; i < FF_ARRAY_ELEMS(thread_types); i++)
+                    if (!strcmp(tok, thread_types[i].name))
+                        break;
+                if (i == FF_ARRAY_ELEMS(thread_types)) {
+                    fprintf(stderr, "Unknown thread type: %s\n", tok);
+                    av_free(list);
+                    return 1;
+                }
+                types |= 1 << i;
+            }
+            av_free(list);
+            break;
+        }
+        case 'n':
+            nb_counts = parse_counts(counts, optarg);
+            if (nb_counts < 0) {
+                fprintf(stderr, "Invalid thread counts: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'r':
+            runs = FFMAX(atoi(optarg), 1);
+            break;
+        case 'f':
+            max_frames = FFMAX(atoi(optarg), 0);
+            break;
+        case 's':
+            stream_idx = atoi(optarg);
+            break;
+        case 'g':
+            gen_size = optarg;
+            break;
+        case 'e':
+            enc_opts = optarg;
+            break;
+        case 'o':
+            if (av_dict_parse_string(&dec_opts, optarg, "=", ":", 0) < 0) {
+                fprintf(stderr, "Invalid decoder options: %s\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-t types] [-n counts] [-r runs] [-f frames] [-s index]\n"
+                    "       [-o decoder options] <input file>\n"
+                    "       %s [...] [-e encoder options] -g <width>x<height>\n",
+                    argv[0], argv[0]);
+            return opt != 'h';
+        }
+    }
+
+    if (!gen_size && optind >= argc) {
+        fprintf(stderr, "No input given, see -h\n");
+        return 1;
+    }
+    input = gen_size ? gen_size : argv[optind];
+
+    st.par  = avcodec_parameters_alloc();
+    results = av_calloc(runs, sizeof(*results));
+    if (!st.par || !results) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    if (gen_size)
+        ret = generate(&st, gen_size, max_frames ? max_frames : 120, enc_opts);
+    else
+        ret = load_file(&st, input, stream_idx, max_frames);
+    if (ret < 0)
+        goto end;
+    if (!st.nb_pkts) {
+        fprintf(stderr, "No packets to decode\n");
+        ret = AVERROR_INVALIDDATA;
+        goto end;
+    }
+
+    printf("{\n  \"input\": ");
+    print_json_string(input);
+    printf(",\n  \"codec\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n"
+           "  \"packets\": %d,\n  \"results\": [",
+           avcodec_get_name(st.par->codec_id), st.par->width, st.par->height,
+           st.nb_pkts);
+
+    for (int t = 0; t < FF_ARRAY_ELEMS(thread_types); t++) {
+        if (!(types & (1 << t)))
+            continue;
+
+        for (int c = 0; c < nb_counts; c++) {
+            const RunResult *r;
+            int64_t peak_rss;
+
+            reset_peak_rss();
+            for (int i = 0; i < runs; i++) {
+                ret = run(&st, thread_types[t].type, counts[c], dec_opts, &results[i]);
+                if (ret < 0) {
+                    fprintf(stderr, "Error decoding with %s threads, count %d: %s\n",
+                            thread_types[t].name, counts[c], av_err2str(ret));
+                    goto end;
+                }
+            }
+            peak_rss = peak_rss_kb();
+
+            /* the run with the median time */
+            qsort(results, runs, sizeof(*results), cmp_time);
+            r = &results[runs / 2];
+
+            printf("%s\n    { \"thread_type\": \"%s\", \"threads\": %d, \"frames\": %d, "
+                   "\"time_s\": %.6f, \"fps\": %.2f, \"latency_ms\": { \"p50\": %.3f, "
+                   "\"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }, \"peak_rss_kb\": %"PRId64" }",
+                   first ? "" : ",", thread_types[t].name, counts[c], r->frames,
+                   r->time / 1e6, r->frames * 1e6 / FFMAX(r->time, 1),
+                   r->latency[0] / 1e3, r->latency[1] / 1e3,
+                   r->latency[2] / 1e3, r->latency[3] / 1e3, peak_rss);
+            fflush(stdout);
+            first = 0;
+        }
+    }
+    printf("\n  ]\n}\n");
+    ret = 0;
+
+end:
+    for (int i = 0; i < st.nb_pkts; i++)
+        av_packet_free(&st.pkts[i]);
+    av_freep(&st.pkts);
+    avcodec_parameters_free(&st.par);
+    av_dict_free(&dec_opts);
+    av_freep(&results);
+    return ret < 0;
+}